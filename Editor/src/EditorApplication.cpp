@@ -114,6 +114,7 @@ void EditorApplication::Run() {
         // frustum (rendered on demand in DrawGameViewport)
         gameTarget_.Create(1280, 720);
         gameRenderer_.Setup(gameTarget_.width(), gameTarget_.height());
+        gameRenderer_.SetJobSystem(&jobs());
 
         // SAFE: capture 'this' (EditorApplication) whose lifetime spans the run loop
         SetUICaptureProvider([this] {
@@ -561,6 +562,12 @@ void EditorApplication::Run() {
             forceAllCSMUpdate_();
         }
         }
+        // The inspector edits materials and components in place, which no
+        // registry signal sees: a frame in which a widget above actually
+        // changed a value leaves the camera's recorded draws stale. Merely
+        // holding, hovering or scrolling a widget changes nothing and keeps
+        // the replay.
+        if (ImGui::GetCurrentContext()->ActiveIdHasBeenEditedThisFrame) scene.MarkChanged();
 
         // commit any edit whose widget stopped being submitted this frame
         // (deselect while a text field was focused, tab switch, collapse)
@@ -612,6 +619,7 @@ void EditorApplication::Run() {
     // Make GL ready before creating any GL objects (Shaders, Models)
     InitGL();
     assets_ = std::make_unique<AssetManager>(); // create after GL is ready
+    assets_->SetIOService(&io());               // model files are read by the app's I/O thread
 
     // Scene swapping goes through one place now. Created here because it needs
     // both the Scene and the AssetManager, and BEFORE the Install* calls below
@@ -1749,46 +1757,8 @@ void EditorApplication::pickEntity_(MyCoreEngine::Scene& scene, float u, float v
     const glm::vec3 origin(pn);
     const glm::vec3 dir = glm::normalize(glm::vec3(pf) - origin);
 
-    float bestT = FLT_MAX;
-    entt::entity best = entt::null;
-    auto entities = scene.registry.view<Transform, AABB>();
-    for (auto e : entities) {
-        const auto& t = entities.get<Transform>(e);
-        const auto& b = entities.get<AABB>(e);
-
-        // conservative world-space AABB of the transformed local box
-        glm::vec3 mn(FLT_MAX), mx(-FLT_MAX);
-        for (int c = 0; c < 8; ++c) {
-            const glm::vec3 corner(
-                (c & 1) ? b.max.x : b.min.x,
-                (c & 2) ? b.max.y : b.min.y,
-                (c & 4) ? b.max.z : b.min.z);
-            const glm::vec3 w = glm::vec3(t.modelMatrix * glm::vec4(corner, 1.f));
-            mn = glm::min(mn, w);
-            mx = glm::max(mx, w);
-        }
-
-        // ray/AABB slab test
-        float t0 = 0.f, t1 = FLT_MAX;
-        bool hit = true;
-        for (int a = 0; a < 3 && hit; ++a) {
-            if (std::abs(dir[a]) < 1e-8f) {
-                if (origin[a] < mn[a] || origin[a] > mx[a]) hit = false;
-            }
-            else {
-                float tA = (mn[a] - origin[a]) / dir[a];
-                float tB = (mx[a] - origin[a]) / dir[a];
-                if (tA > tB) std::swap(tA, tB);
-                t0 = std::max(t0, tA);
-                t1 = std::min(t1, tB);
-                if (t0 > t1) hit = false;
-            }
-        }
-        if (hit && t0 < bestT) {
-            bestT = t0;
-            best = e;
-        }
-    }
+    // nearest world AABB along the ray, through the scene's bounds octree
+    const entt::entity best = scene.RaycastBounds(origin, dir);
     selected_ = best; // entt::null on miss = deselect
 }
 
@@ -2465,8 +2435,8 @@ void EditorApplication::DrawRenderingToggles(MyCoreEngine::Scene& scene)
                           "have no sub-pixel coverage to recover and are left as-is.");
     }
 
-    // Post-process stack (tonemap -> effects -> FXAA). Effects chain through a
-    // ping-pong pair allocated only while at least one is enabled.
+    // Post-process stack (tonemap -> effects -> FXAA). Effects chain through
+    // render-graph targets that exist only while at least one is enabled.
     if (ImGui::TreeNodeEx("Post-process", ImGuiTreeNodeFlags_DefaultOpen)) {
         auto& pfx = scene.PostFX();
 
@@ -2506,6 +2476,10 @@ void EditorApplication::DrawRenderingToggles(MyCoreEngine::Scene& scene)
             ImGui::SliderFloat("Roundness##vig",  &v.roundness,  0.f, 1.f);
             ImGui::SliderFloat("Smoothness##vig", &v.smoothness, 0.f, 1.f);
         }
+
+        // Same image either way; off is for comparing the two.
+        ImGui::Checkbox("Fuse effects into one pass", &pfx.fused);
+        ImGui::SameLine(); ImGui::TextDisabled("(outline, grade, vignette)");
         ImGui::TreePop();
     }
 
@@ -2516,10 +2490,20 @@ void EditorApplication::DrawRenderingToggles(MyCoreEngine::Scene& scene)
     bool inst = scene.GetInstancingEnabled();
     if (ImGui::Checkbox("Enable instancing", &inst)) scene.SetInstancingEnabled(inst);
 
+    bool multiDraw = scene.GetMultiDrawEnabled();
+    if (ImGui::Checkbox("Multi-draw indirect", &multiDraw)) scene.SetMultiDrawEnabled(multiDraw);
+    ImGui::SameLine();
+    if (MyCoreEngine::GetGLCaps().multiDrawIndirect) ImGui::TextDisabled("(one call per material)");
+    else ImGui::TextDisabled("(unsupported here: per-run draws)");
+
     bool prepass = scene.GetDepthPrepassEnabled();
     if (ImGui::Checkbox("Depth prepass", &prepass)) { scene.SetDepthPrepassEnabled(prepass); demoteQualityToCustom_(scene); }
     ImGui::SameLine(); ImGui::TextDisabled("(shade each pixel once)");
 
+    bool clustered = scene.GetClusteredLightsEnabled();
+    if (ImGui::Checkbox("Clustered lights", &clustered)) scene.SetClusteredLightsEnabled(clustered);
+    ImGui::SameLine(); ImGui::TextDisabled("(up to 256, per-froxel lists)");
+
     bool lod = scene.GetLODEnabled();
     if (ImGui::Checkbox("Enable mesh LOD", &lod)) { scene.SetLODEnabled(lod); demoteQualityToCustom_(scene); }
     float lodScale = scene.GetLODDistanceScale();
@@ -2607,23 +2591,79 @@ void EditorApplication::DrawInformationPanel(const MyCoreEngine::Scene& scene, f
         ImGui::Text("  editor UI: %6.2f ms", frameUiMs());
         ImGui::Text("  swap/wait: %6.2f ms  (vsync %s)",
                     frameSwapMs(), vsyncEnabled() ? "ON" : "off");
+        ImGui::Text("  sim debt:  %d ticks (peak %d, dropped %llu)%s",
+                    fixedStepMetrics().debtTicks, fixedStepMetrics().peakDebtTicks,
+                    (unsigned long long)fixedStepMetrics().droppedTicks,
+                    fixedStepRunningBehind() ? "  RUNNING BEHIND" : "");
         ImGui::Text("Cascades: %d, res: %d", renderer().getCSMNumCascades(), renderer().getCSMBaseResolution());
         ImGui::Text("Draws:            %u", rs.draws);
         ImGui::Text("Instanced draws:  %u", rs.instancedDraws);
         ImGui::Text("Instances:        %u", rs.instances);
+        ImGui::Text("Multi-draws:      %u (%u draws saved)", rs.multiDraws, rs.drawsSaved);
         ImGui::Separator();
         ImGui::Text("Texture binds:    %u", rs.textureBinds);
         ImGui::Text("VAO binds:        %u", rs.vaoBinds);
+        {
+            const MyCoreEngine::TextureArrays::Stats ta = MyCoreEngine::TextureArrays::Get().GetStats();
+            ImGui::Text("Albedo arrays:    %u (%u layers, %u grows)", ta.arrays, ta.layers, ta.grows);
+            const MyCoreEngine::StreamBuffer::Stats ring = scene.GetInstanceStreamStats();
+            ImGui::Text("Instance ring:    %zu KB %s (%u waits, %u grows)", ring.capacity / 1024,
+                        ring.persistent ? "persistent" : "mapped", ring.waits, ring.grows);
+        }
         ImGui::Separator();
         ImGui::Text("Built items:      %u", rs.itemsBuilt);
         ImGui::Text("Culled (frustum): %u", rs.culled);
         ImGui::Text("Culled (size):    %u", rs.culledSmall);
         ImGui::Text("Submitted:        %u", rs.submitted);
         ImGui::Text("Lights (act/cull):%u / %u", rs.lightsActive, rs.lightsCulled);
+        if (scene.GetClusteredLightsEnabled()) {
+            ImGui::Text("Light clusters:   %u refs, %u dropped", rs.lightClusterRefs, rs.lightClusterDropped);
+        }
         ImGui::Text("LOD 0/1/2:        %u / %u / %u",
             rs.lodInstances[0], rs.lodInstances[1], rs.lodInstances[2]);
-        unsigned totalCalls = rs.draws + rs.instancedDraws;
+        unsigned totalCalls = rs.draws + rs.instancedDraws + rs.multiDraws;
         ImGui::Text("GPU draw calls:   %u", totalCalls);
+        ImGui::Text("Frame arena:      %u KB (peak %u KB)", rs.frameArenaKB, rs.frameArenaPeakKB);
+        ImGui::Text("Draw list:        %s", rs.replayed ? "replayed" : "built");
+    }
+    if (ImGui::CollapsingHeader("GPU Passes", ImGuiTreeNodeFlags_None)) {
+        // What each pass of the Scene view costs the GPU, which the CPU-side
+        // numbers above cannot say. A frame or two old, smoothed.
+        if (!GpuTimers::Supported()) {
+            ImGui::TextDisabled("no timer queries on this driver");
+        }
+        else {
+            bool on = renderer().GpuTimingEnabled();
+            if (ImGui::Checkbox("Time passes", &on)) renderer().SetGpuTimingEnabled(on);
+            float total = 0.f;
+            for (const GpuPassTime& t : renderer().GpuPassTimes()) {
+                ImGui::Text("  %-14s %6.2f ms", t.name, t.avgMs);
+                total += t.avgMs;
+            }
+            if (on) ImGui::Text("  %-14s %6.2f ms", "total", total);
+        }
+    }
+    if (ImGui::CollapsingHeader("CPU Profiler", ImGuiTreeNodeFlags_None)) {
+        // The rings always record (see Profiler.h), so a capture taken right
+        // after a hitch still contains it. Written next to the editor's
+        // working directory; open it in chrome://tracing or ui.perfetto.dev.
+        static std::string sLast;
+        if (!MyCoreEngine::Profiler::kCompiledIn) {
+            ImGui::TextDisabled("compiled out (CSE_ENABLE_PROFILER=OFF)");
+        }
+        else {
+            bool on = MyCoreEngine::Profiler::Enabled();
+            if (ImGui::Checkbox("Recording", &on)) MyCoreEngine::Profiler::SetEnabled(on);
+            ImGui::SameLine();
+            if (ImGui::Button("Save Chrome trace")) {
+                static int n = 0;
+                const std::string path = "editor-trace-" + std::to_string(++n) + ".json";
+                std::string err;
+                sLast = MyCoreEngine::Profiler::WriteChromeTrace(path, &err)
+                      ? "wrote " + path : "failed: " + err;
+            }
+            if (!sLast.empty()) ImGui::TextDisabled("%s", sLast.c_str());
+        }
     }
     ImGui::End();
 }
@@ -3358,8 +3398,10 @@ void EditorApplication::doUndo_(MyCoreEngine::Scene& scene)
     undo_.undo(scene.registry, assets_.get());
     if (!scene.registry.valid(selected_)) selected_ = entt::null;
     // snapshot restores overwrite the live matrix, so the departure pose
-    // never reaches the dirty-caster flow — rebuild shadows outright
+    // never reaches the dirty-caster flow — rebuild shadows outright, and
+    // the camera's recorded draws with them
     forceAllCSMUpdate_();
+    scene.MarkChanged();
 }
 
 void EditorApplication::doRedo_(MyCoreEngine::Scene& scene)
@@ -3368,6 +3410,7 @@ void EditorApplication::doRedo_(MyCoreEngine::Scene& scene)
     undo_.redo(scene.registry, assets_.get());
     if (!scene.registry.valid(selected_)) selected_ = entt::null;
     forceAllCSMUpdate_();
+    scene.MarkChanged();
 }
 
 void EditorApplication::DrawEditHistory(MyCoreEngine::Scene& scene)
@@ -3432,6 +3475,7 @@ void EditorApplication::DrawEditHistory(MyCoreEngine::Scene& scene)
                 undo_.jumpTo(scene.registry, assets_.get(), target);
                 if (!scene.registry.valid(selected_)) selected_ = entt::null;
                 forceAllCSMUpdate_(); // see doUndo_
+                scene.MarkChanged();
             }
         }
     }
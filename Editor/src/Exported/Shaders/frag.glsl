@@ -5,6 +5,7 @@ in VS_OUT {
     mat3  TBN;
     vec3  worldPos;
     float viewDepth;
+    flat float albedoLayer;
 } fs_in;
 
 out vec4 FragColor;
@@ -14,82 +15,97 @@ uniform mat4 view;
 
 // base material inputs (same as before)
 uniform sampler2D diffuseMap;
+// The same albedo map as a layer of a shared array (TextureArrays), so
+// materials differing only in it draw as one batch. uAlbedoArray picks.
+uniform sampler2DArray diffuseArray;
+uniform int uAlbedoArray;
 uniform sampler2D normalMap;
 uniform sampler2D metallicMap;
 uniform sampler2D roughnessMap;
 uniform sampler2D aoMap;
-uniform int uHasNormalMap;
-uniform int uNormalMapEnabled;
 
-uniform int uShadowsOn;   // 0 = skip shadowing, 1 = use CSM
-uniform int  uUsePBR;
-uniform vec3 uCamPos;
-uniform vec3 uLightDir;
-uniform vec3 uLightColor;
-uniform float uLightIntensity;
+// -------- per-frame state (UniformBlocks.h: FrameGlobalsBlock) --------
+// One block, uploaded once per frame: the cascades and the IBL mip count
+// from the forward passes, the camera, sun and switches from Scene. The
+// per-cascade scalars are vec4s indexed by cascade.
+layout(std140) uniform FrameGlobals {
+    mat4  uLightVP[4];
+    vec4  uCSMSplits;        // view-space distances (end of each split)
+    vec4  uCascadeTexel;     // 1 / cascade resolution
+    ivec4 uCascadeKernel;    // PCF radius per cascade: 1x1, 3x3, 5x5, 7x7 ...
+    vec3  uCamPos;       float uLightIntensity;
+    vec3  uLightDir;     float uIBLIntensity;
+    vec3  uLightColor;   float uPrefilterMipCount;
+    float uSplitBlend;       // world-space meters to blend across splits
+    float uShadowBiasConst;  // in texels (scaled by uCascadeTexel)
+    float uShadowBiasSlope;  // scales with (1 - dot(N,L))
+    int   uCascadeCount;
+    int   uShadowsOn;        // 0 = skip shadowing, 1 = use CSM
+    int   uCSMDebug;         // 0=off, 1=cascade index, 2=shadow factor, 3=light depth
+    int   uUsePBR;
+    int   uUseIBL;
+    int   uNormalMapEnabled;
+    int   uUseMetallicMap;
+    int   uUseRoughnessMap;
+    int   uUseAOMap;
+    int   uUseClusters;
+    int   uNumLights;        // the array path's live lights
+};
+
+// -------- per-material state (UniformBlocks.h: MaterialBlockData) --------
+// One small buffer per material, bound with it; re-uploaded only when the
+// material changed.
+layout(std140) uniform MaterialBlock {
+    vec3  uBaseColor;    float uMetallic;
+    vec3  uEmissive;     float uRoughness;
+    float uAO;
+    float uOpacity;          // Blend: multiplies the albedo alpha
+    float uAlphaCutoff;      // Mask: discard below this
+    float uToonBands;        // diffuse quantization steps
+    float uToonSpecStrength; // specular intensity
+    float uToonSpecSize;     // 0 = sharp small dot .. 1 = broad soft sheen
+    float uToonRimStrength;  // rim-light intensity
+    int   uShadingModel;     // 0 PBR, 1 Toon/cel
+    int   uAlphaMode;        // 0 Opaque, 1 Mask, 2 Blend
+    int   uHasNormalMap;
+    int   uHasMetallicMap;
+    int   uHasRoughnessMap;
+    int   uHasAOMap;
+};
 
 // --- punctual lights (point / spot) ---------------------------------------
 // The directional light above is the SUN: it is the one that casts the
 // cascaded shadow maps. These extra lights are unshadowed, which is why they
-// are a separate, bounded array rather than an extension of the sun path.
-// Packed into vec4s to keep the uniform component count down.
+// are a separate, bounded list rather than an extension of the sun path.
+// Four vec4s per light in world space (posRange, colorInt, spotDir,
+// spotMisc), in one block for both paths: without clusters every fragment
+// loops over the first uNumLights (at most MAX_PUNCTUAL_LIGHTS).
 #define MAX_PUNCTUAL_LIGHTS 16
-uniform int  uNumLights;                              // how many are live
-uniform vec4 uLightPosRange[MAX_PUNCTUAL_LIGHTS];     // xyz world pos, w range
-uniform vec4 uLightColorInt[MAX_PUNCTUAL_LIGHTS];     // rgb colour,   a intensity
-uniform vec4 uLightSpotDir[MAX_PUNCTUAL_LIGHTS];      // xyz spot dir, w cos(outer)
-uniform vec4 uLightSpotMisc[MAX_PUNCTUAL_LIGHTS];     // x cos(inner), y type (0 point, 1 spot)
-uniform float uMetallic;
-uniform float uRoughness;
-uniform float uAO;
-
-uniform int uHasMetallicMap;
-uniform int uHasRoughnessMap;
-uniform int uHasAOMap;
-
-uniform int uUseMetallicMap;
-uniform int uUseRoughnessMap;
-uniform int uUseAOMap;
+//
+// Clustered lights (uUseClusters == 1) use the whole block: up to
+// MAX_CLUSTER_LIGHTS lights, binned on the CPU into froxels (screen tiles x
+// exponential depth slices), and each fragment loops over its froxel's list
+// only. Layout and packing are LightClusters.h's.
+#define MAX_CLUSTER_LIGHTS 256
+layout(std140) uniform PunctualLights {
+    vec4 uLightRecord[MAX_CLUSTER_LIGHTS * 4]; // posRange, colorInt, spotDir, spotMisc
+};
+layout(std140) uniform ClusterGrid {
+    uvec4 uClusterDims;       // tiles x, tiles y, slices
+    vec4  uClusterSlice;      // slice scale, slice bias, tile width px, tile height px
+    uvec4 uClusterRecord[1022]; // per cluster: first index | count << 16
+};
+layout(std140) uniform ClusterIndices {
+    uvec4 uClusterIndex[1024];  // 8-bit light indices, 16 per uvec4
+};
 
 // IBL
 uniform samplerCube irradianceMap;
 uniform samplerCube prefilteredMap;
 uniform sampler2D  brdfLUT;
-uniform int   uUseIBL;
-uniform float uIBLIntensity;
-uniform float uPrefilterMipCount;
-
-uniform vec3 uBaseColor;
-uniform vec3 uEmissive;
-uniform int   uShadingModel;   // per-material: 0 PBR, 1 Toon/cel
-// Toon look (per-material; only read on the toon path).
-uniform float uToonBands;        // diffuse quantization steps
-uniform float uToonSpecStrength; // specular intensity
-uniform float uToonSpecSize;     // 0 = sharp small dot .. 1 = broad soft sheen
-uniform float uToonRimStrength;  // rim-light intensity
-
-// Transparency. 0 Opaque, 1 Mask, 2 Blend.
-uniform int   uAlphaMode;
-uniform float uOpacity;
-uniform float uAlphaCutoff;
-
-// -------- CSM uniforms (4 cascades) --------
-uniform mat4 uLightVP[4];
-uniform sampler2D uShadowCascade[4];
-uniform float uCSMSplits[4];   // view-space distances (end of each split)
-uniform int   uCascadeCount;
-
-uniform float uShadowBiasConst;   // in light clip depth units (start with ~0.001�0.01)
-uniform float uShadowBiasSlope;   // scales with (1 - dot(N,L))
-
-uniform int   uCascadeKernel[4];   // e.g. {1,2,3,4}  => 1x1, 3x3, 5x5, 7x7
-uniform float uSplitBlend;         // world-space meters to blend across splits
-
-// -------------------------------------------
-// debug mode
-uniform int uCSMDebug;   // 0=off, 1=cascade index, 2=shadow factor, 3=light depth
 
-uniform float uCascadeTexel[4];
+// -------- CSM (4 cascades; the rest is in FrameGlobals) --------
+uniform sampler2D uShadowCascade[4];
 
 // choose cascade by comparing *view-space* depth with split FARs
 int chooseCascade(float inViewDepth)
@@ -222,6 +238,37 @@ vec3 pbrDirect(vec3 N, vec3 V, vec3 L, vec3 albedo, float metallic, float roughn
     return (diff + spec) * NdotL;
 }
 
+// The punctual lights a fragment shades with. ClusterRange is this
+// fragment's slice of the index list (x first entry, y count); the global
+// array ignores it.
+struct Punctual { vec4 posRange; vec4 colorInt; vec4 spotDir; vec4 spotMisc; };
+
+ivec2 clusterRange(float viewZ)
+{
+    if (uUseClusters != 1) return ivec2(0, min(uNumLights, MAX_PUNCTUAL_LIGHTS));
+    uvec2 tile  = min(uvec2(gl_FragCoord.xy / uClusterSlice.zw), uClusterDims.xy - 1u);
+    float s     = floor(log(max(viewZ, 1e-4)) * uClusterSlice.x + uClusterSlice.y);
+    uint  slice = uint(clamp(s, 0.0, float(uClusterDims.z - 1u)));
+    uint  c     = (slice * uClusterDims.y + tile.y) * uClusterDims.x + tile.x;
+    uint  rec   = uClusterRecord[c >> 2][c & 3u];
+    return ivec2(int(rec & 0xffffu), int(rec >> 16));
+}
+
+Punctual punctualLight(ivec2 range, int k)
+{
+    int i = k * 4;
+    if (uUseClusters == 1) {
+        uint j = uint(range.x + k);
+        i = int((uClusterIndex[j >> 4][(j >> 2) & 3u] >> ((j & 3u) * 8u)) & 0xffu) * 4;
+    }
+    Punctual p;
+    p.posRange = uLightRecord[i];
+    p.colorInt = uLightRecord[i + 1];
+    p.spotDir  = uLightRecord[i + 2];
+    p.spotMisc = uLightRecord[i + 3];
+    return p;
+}
+
 // Distance falloff: physically-plausible inverse square, windowed so a light
 // reaches exactly zero at its range instead of being clipped mid-gradient
 // (a hard cutoff shows up as a visible disc edge on the floor).
@@ -235,7 +282,9 @@ float distanceAttenuation(float dist, float range)
 
 void main()
 {
-    vec4 albedoSample = texture(diffuseMap, fs_in.uv);
+    vec4 albedoSample = (uAlbedoArray == 1)
+        ? texture(diffuseArray, vec3(fs_in.uv, fs_in.albedoLayer))
+        : texture(diffuseMap, fs_in.uv);
     vec3 albedo = albedoSample.rgb * uBaseColor;
 
     // Alpha coverage. uAlphaMode: 0 Opaque, 1 Mask, 2 Blend. The albedo
@@ -267,6 +316,7 @@ void main()
         if (viewZ < uCSMSplits[i]) { ci = i; break; }
         ci = i + 1;
     }
+    ivec2 lights = clusterRange(viewZ);
 
     // light-space position for the chosen cascade
     vec4 lightClip = uLightVP[ci] * vec4(fs_in.worldPos, 1.0);
@@ -335,21 +385,22 @@ void main()
         vec3  sun     = albedo * uLightColor * uLightIntensity * sunStep * sh;
 
         vec3 pl = vec3(0.0);
-        for (int i = 0; i < uNumLights && i < MAX_PUNCTUAL_LIGHTS; ++i) {
-            vec3  toL  = uLightPosRange[i].xyz - fs_in.worldPos;
+        for (int k = 0; k < lights.y; ++k) {
+            Punctual P = punctualLight(lights, k);
+            vec3  toL  = P.posRange.xyz - fs_in.worldPos;
             float dist = length(toL);
-            float rng  = uLightPosRange[i].w;
+            float rng  = P.posRange.w;
             if (dist > rng) continue;
             vec3  Li = toL / max(dist, 1e-4);
             float at = distanceAttenuation(dist, rng);
-            if (uLightSpotMisc[i].y > 0.5) {
-                float cd = dot(normalize(uLightSpotDir[i].xyz), -Li);
-                at *= smoothstep(uLightSpotDir[i].w, uLightSpotMisc[i].x, cd);
+            if (P.spotMisc.y > 0.5) {
+                float cd = dot(normalize(P.spotDir.xyz), -Li);
+                at *= smoothstep(P.spotDir.w, P.spotMisc.x, cd);
             }
             if (at <= 0.0) continue;
             // Band the diffuse direction; keep the distance falloff continuous.
             float nl = max(dot(N, Li), 0.0);
-            pl += albedo * uLightColorInt[i].rgb * uLightColorInt[i].a
+            pl += albedo * P.colorInt.rgb * P.colorInt.a
                 * (floor(nl * bands + 0.5) / bands) * at;
         }
 
@@ -448,10 +499,12 @@ void main()
     // --- punctual lights (unshadowed) ---
     // Bounded loop: the CPU already sorted by influence and uploaded at most
     // MAX_PUNCTUAL_LIGHTS, so this is the strongest set, not an arbitrary one.
-    for (int i = 0; i < uNumLights && i < MAX_PUNCTUAL_LIGHTS; ++i) {
-        vec3  toLight = uLightPosRange[i].xyz - fs_in.worldPos;
+    // Clustered, it is this froxel's list: only the lights that reach it.
+    for (int k = 0; k < lights.y; ++k) {
+        Punctual P = punctualLight(lights, k);
+        vec3  toLight = P.posRange.xyz - fs_in.worldPos;
         float dist    = length(toLight);
-        float range   = uLightPosRange[i].w;
+        float range   = P.posRange.w;
         if (dist > range) continue;
 
         vec3  Li    = toLight / max(dist, 1e-4);
@@ -460,14 +513,14 @@ void main()
         // spot cone: angle between the light's aim and the direction from the
         // light TO this fragment (-Li), softened between the inner and outer
         // cone so the edge is not a hard stencil.
-        if (uLightSpotMisc[i].y > 0.5) {
-            float cd = dot(normalize(uLightSpotDir[i].xyz), -Li);
-            atten *= smoothstep(uLightSpotDir[i].w, uLightSpotMisc[i].x, cd);
+        if (P.spotMisc.y > 0.5) {
+            float cd = dot(normalize(P.spotDir.xyz), -Li);
+            atten *= smoothstep(P.spotDir.w, P.spotMisc.x, cd);
         }
         if (atten <= 0.0) continue;
 
         Lo += pbrDirect(N, V, Li, albedo, metallic, roughness)
-            * uLightColorInt[i].rgb * uLightColorInt[i].a * atten;
+            * P.colorInt.rgb * P.colorInt.a * atten;
     }
 
     // IBL
@@ -0,0 +1,106 @@
+#version 330 core
+// Outline, colour grade and vignette on the tonemapped (gamma-space) image.
+// Each is per-pixel on the colour at this texel (the outline's neighbour taps
+// are on depth, not colour), so running them back to back in one shader is
+// the chain without its intermediate targets. POST_OUTLINE / POST_GRADE /
+// POST_VIGNETTE pick the effects: OutlinePass, ColorGradePass and
+// VignettePass each compile it with their one define, PostUberPass with the
+// combination it fuses. One source, so the fused and separate chains cannot
+// drift apart (test_post_chain compares them).
+in vec2 vUV;
+out vec4 FragColor;
+
+uniform sampler2D uScene;   // tonemapped colour (chain input)
+
+#ifdef POST_OUTLINE
+// Ink outline from scene-depth discontinuities. A depth-only edge detect
+// (no normal buffer in a forward renderer) catches silhouettes and depth
+// steps -- the contour "ink" that completes a cel-shaded look.
+uniform sampler2D uDepth;   // scene depth (DEPTH_COMPONENT24)
+uniform vec2  uTexel;       // 1 / viewport
+uniform float uOutlineThickness; // neighbour tap offset, in pixels
+uniform float uOutlineThreshold; // edge sensitivity on relative depth
+uniform float uOutlineStrength;  // ink opacity, 0..1
+uniform vec3  uOutlineColor;     // ink colour
+uniform float uNear;
+uniform float uFar;
+
+float linearDepth(vec2 uv) {
+    float d = texture(uDepth, uv).r;      // [0,1] non-linear
+    float z = d * 2.0 - 1.0;              // -> NDC
+    return (2.0 * uNear * uFar) / (uFar + uNear - z * (uFar - uNear));
+}
+#endif
+
+#ifdef POST_GRADE
+// Procedural colour grade: white balance -> lift/gain -> contrast ->
+// saturation. A self-contained stand-in for a LUT workflow that needs no
+// external asset.
+uniform float uContrast;    // 1 = neutral
+uniform float uSaturation;  // 1 = neutral, 0 = greyscale
+uniform float uTemperature; // -1 cool .. +1 warm
+uniform float uTint;        // -1 green .. +1 magenta
+uniform float uLift;        // black-point offset
+uniform float uGain;        // white-point scale
+#endif
+
+#ifdef POST_VIGNETTE
+// Radial edge darkening.
+uniform float uVignetteIntensity;  // 0 = off .. 1 = corners fully darkened
+uniform float uVignetteRoundness;  // 0 = follows the frame rectangle .. 1 = circular
+uniform float uVignetteSmoothness; // width of the falloff band (0 hard .. 1 soft)
+uniform float uAspect;      // viewport width / height
+#endif
+
+void main() {
+    vec3 col = texture(uScene, vUV).rgb;
+
+#ifdef POST_OUTLINE
+    {
+        vec2 o = uTexel * max(uOutlineThickness, 0.0);
+        float c  = linearDepth(vUV);
+        float l  = linearDepth(vUV - vec2(o.x, 0.0));
+        float r  = linearDepth(vUV + vec2(o.x, 0.0));
+        float u  = linearDepth(vUV - vec2(0.0, o.y));
+        float dn = linearDepth(vUV + vec2(0.0, o.y));
+        // RELATIVE gradient (divide by centre depth): keeps the threshold
+        // scale-invariant so distant geometry isn't blanket-outlined.
+        float g = (abs(c - l) + abs(c - r) + abs(c - u) + abs(c - dn)) / max(c, 1e-3);
+        float edge = smoothstep(uOutlineThreshold, uOutlineThreshold * 2.0, g);
+        col = mix(col, uOutlineColor, edge * clamp(uOutlineStrength, 0.0, 1.0));
+        // the chain stores each stage in RGBA8
+        col = clamp(col, 0.0, 1.0);
+    }
+#endif
+
+#ifdef POST_GRADE
+    {
+        // white balance: warm pushes red up / blue down; tint trades green/magenta
+        col.r *= 1.0 + uTemperature * 0.2;
+        col.b *= 1.0 - uTemperature * 0.2;
+        col.g *= 1.0 + uTint * 0.2;
+        // lift (shadows) + gain (overall scale), then contrast, about mid-grey
+        col = (col - 0.5) * uGain + 0.5 + uLift;
+        col = (col - 0.5) * uContrast + 0.5;
+        // saturation toward Rec.709 luma
+        float luma = dot(col, vec3(0.2126, 0.7152, 0.0722));
+        col = clamp(mix(vec3(luma), col, uSaturation), 0.0, 1.0);
+    }
+#endif
+
+#ifdef POST_VIGNETTE
+    {
+        // Distance from centre. Correcting x by aspect (scaled in by
+        // roundness) makes the darkened region a circle, not an ellipse.
+        vec2 d = vUV - vec2(0.5);
+        d.x *= mix(1.0, uAspect, clamp(uVignetteRoundness, 0.0, 1.0));
+        float dist = length(d) * 1.41421356; // ~1.0 at the corners
+        // 1 in the clear centre, ramping to 0 at the corners
+        float band = clamp(uVignetteSmoothness, 0.001, 1.0);
+        float vig = 1.0 - smoothstep(1.0 - band, 1.0, dist);
+        col *= mix(1.0, vig, clamp(uVignetteIntensity, 0.0, 1.0));
+    }
+#endif
+
+    FragColor = vec4(col, 1.0);
+}
@@ -8,23 +8,27 @@ invariant gl_Position;
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTex;
-layout (location = 3) in vec3 aTangent;
+// w: bitangent handedness. Packed meshes carry it (-1 where the UVs are
+// mirrored); the Full layout streams xyz only, so w reads the default 1.
+layout (location = 3) in vec4 aTangent;
 
 // Instancing: 4..7 for per-instance model matrix
 layout (location = 8) in mat4 iModel;  // 8,9,10,11
+// Albedo array layer per instance (TextureArrays); 0 when unused
+layout (location = 12) in float iAlbedoLayer;
 
 uniform mat4 model;        // used when not instancing
 uniform mat4 view;
 uniform mat4 projection;
 uniform int  uUseInstancing; // 0/1
-
-uniform mat4 uLightVP[4];
+uniform float uAlbedoLayer;  // used when not instancing
 
 out VS_OUT {
     vec2  uv;
     mat3  TBN;              // to fragment
     vec3  worldPos;         // keep if your lighting needs it
     float viewDepth;
+    flat float albedoLayer;
 } vs_out;
 
 void main()
@@ -37,13 +41,15 @@ void main()
 
     // TBN in world space
     mat3 M3 = mat3(M);
-    vec3 T = normalize(M3 * aTangent);
+    vec3 T = normalize(M3 * aTangent.xyz);
     vec3 N = normalize(M3 * aNormal);
     T = normalize(T - dot(T, N) * N);
-    vec3 B = normalize(cross(N, T));
+    // sign, not the value: a 2-bit snorm -1 can fetch as -1/3 on GL 3.3
+    vec3 B = normalize(cross(N, T)) * (aTangent.w < 0.0 ? -1.0 : 1.0);
     vs_out.TBN = mat3(T, B, N);
 
     vs_out.uv = aTex;
+    vs_out.albedoLayer = (uUseInstancing == 1) ? iAlbedoLayer : uAlbedoLayer;
     vs_out.worldPos = wpos.xyz;
     vs_out.viewDepth = -viewPos.z;  
 }
\ No newline at end of file
@@ -36,12 +36,28 @@
 #include "../src/core/TitleFrontEnd.h"
 #include "../src/core/InputMap.h"
 #include "../src/core/JobSystem.h"
+#include "../src/core/Profiler.h"
+#include "../src/core/FrameAllocator.h"
+#include "../src/core/IOService.h"
+#include "../src/core/TransformHierarchy.h"
+#include "../src/core/CullKernel.h"
+#include "../src/core/LooseOctree.h"
+#include "../src/core/BoundsCache.h"
+#include "../src/core/DrawSort.h"
+#include "../src/core/LightClusters.h"
+#include "../src/core/MeshArena.h"
+#include "../src/core/TextureArrays.h"
+#include "../src/core/StreamBuffer.h"
+#include "../src/core/UniformBlocks.h"
+#include "../src/core/ShaderCache.h"
 #include "../src/core/RenderTarget.h"
 #include "../src/core/GLInit.h"
 #include "../src/assets/AssetIndex.h"
 #include "../src/assets/AssetValidator.h"
 #include "../src/assets/ImportSettings.h"
 #include "../src/render/CSMSplits.h"
+#include "../src/render/RenderGraph.h"
+#include "../src/render/GpuTimers.h"
 // physics: backend-agnostic core. The concrete backends (Jolt/PhysX) are
 // deliberately NOT exported — callers select one by name through the
 // registry, so no consumer ever includes an SDK header.
@@ -2,8 +2,10 @@
 
 #include "Application.h"
 #include "GLInit.h"
+#include "Profiler.h"
 #include "Scene.h"
 #include "Shader.h"
+#include "ShaderCache.h"
 #include "WindowIcon.h"
 
 #include <chrono>
@@ -16,6 +18,10 @@ namespace MyCoreEngine
 		, input_(std::make_unique<InputMap>())
 	{
 		bindDefaultInput_();
+		// A hitch is paid back over the next frames instead of teleporting
+		// the simulation forward; see FixedTimestep. Hosts that need the old
+		// behaviour call setFixedCatchUpPolicy(DropBacklog).
+		fixedStep_.setCatchUpPolicy(FixedTimestep::CatchUpPolicy::SpreadBacklog);
 	}
 
 	Application::~Application() = default;
@@ -40,10 +46,14 @@ namespace MyCoreEngine
 			throw std::runtime_error("Failed to initialize GLAD");
 		}
 		glfwSwapInterval(vsync_ ? 1 : 0);
+		// Linked programs persist next to Exported/ and load as binaries on
+		// the next run; before Setup, which builds the renderer's shaders.
+		ShaderCache::SetDirectory("ShaderCache");
 
 		int w = 0, h = 0;
 		window_.getFramebufferSize(w, h);
 		renderer_.Setup(w, h);
+		renderer_.SetJobSystem(&jobs_); // per-view draw lists build on the pool
 
 		glfwSetWindowUserPointer(window_.getGLFWwindow(), this);
 		glfwSetScrollCallback(window_.getGLFWwindow(), &Application::ScrollThunk_);
@@ -79,7 +89,12 @@ namespace MyCoreEngine
 
 	void Application::RunLoop(Scene& scene, Shader& shader)
 	{
+		CSE_PROFILE_THREAD("Main");
 		while (!window_.shouldClose()) {
+			// One zone per frame: everything below nests under it in the
+			// trace, so a hitch reads as one fat "Frame" with its culprit
+			// inside rather than as a gap between unrelated zones.
+			CSE_PROFILE_ZONE("Frame");
 			updateDeltaTime_();
 
 			bool capK = false, capM = false;
@@ -185,6 +200,7 @@ namespace MyCoreEngine
 					// and every subscriber (physics), so they always see the
 					// same step count and never drift apart.
 					fixedSteps = fixedStep_.advance(gameDt, [this](float fixedDt) {
+						CSE_PROFILE_ZONE("FixedUpdate");
 						// Each tick is its own consumption phase: every
 						// consumer within it observes the same input edges.
 						input_->beginInputPhase();
@@ -225,7 +241,8 @@ namespace MyCoreEngine
 			// focus -- from a key pressed while the user was in the Scene view.
 			if (!awaitingTick) input_->clearPressLatches();
 
-			scene.UpdateTransforms();
+			// the pool helps with large hierarchies; output matches the serial pass
+			scene.UpdateTransforms(&jobs_);
 
 			// After UpdateTransforms so the camera entities' world matrices
 			// are current — the view tracks gameplay with no frame lag. The
@@ -266,10 +283,16 @@ namespace MyCoreEngine
 			const auto tRender1_ = perfClock_::now();
 
 			// Editor UI (after 3D draw)
-			if (uiDraw_) uiDraw_(deltaTime_);
+			if (uiDraw_) {
+				CSE_PROFILE_ZONE("UI callback");
+				uiDraw_(deltaTime_);
+			}
 
 			const auto tUi1_ = perfClock_::now();
-			window_.swapBuffers();
+			{
+				CSE_PROFILE_ZONE("SwapBuffers");
+				window_.swapBuffers();
+			}
 			const auto tSwap1_ = perfClock_::now();
 
 			using ms_ = std::chrono::duration<float, std::milli>;
@@ -293,7 +316,12 @@ namespace MyCoreEngine
 		// that runs ZERO completions proves nothing was submitted since —
 		// the pool is quiescent. A single pass would return with workers
 		// still running chained decodes.
+		//
+		// The I/O thread goes first each pass: a finished read's callback
+		// is what submits its decode, so the pool is only worth waiting on
+		// once no read is still about to feed it.
 		do {
+			io_.waitIdle();
 			jobs_.waitIdle();
 		} while (jobs_.pumpCompletions(1e6f) > 0);
 	}
@@ -14,6 +14,7 @@
 #include "CameraDirector.h"
 #include "FixedTimestep.h"
 #include "JobSystem.h"
+#include "IOService.h"
 #include "SceneLoader.h"
 #include "Renderer.h"
 #include "RenderTarget.h"
@@ -68,6 +69,10 @@ namespace MyCoreEngine
 		// completions run on the main thread each frame (RunLoop pumps
 		// them with the GL context current — that's where uploads go).
 		JobSystem& jobs() { return jobs_; }
+		// The engine's file reader: one I/O thread, coalesced reads, model
+		// directory read-ahead. Hosts attach it to their AssetManager
+		// (SetIOService) so decode jobs start from bytes already in memory.
+		IOService& io() { return io_; }
 
 		// ---- scene loading ----
 		// The loader is owned by the HOST, because it needs a Scene and an
@@ -232,6 +237,16 @@ namespace MyCoreEngine
 		void  setFixedTimestepHz(float hz) { fixedStep_.setStep(1.f / std::max(1.f, hz)); }
 		float fixedTimestepHz() const { return 1.f / fixedStep_.step(); }
 		float fixedAlpha() const { return fixedStep_.alpha(); }
+		// What happens to fixed ticks owed past the per-frame cap. Application
+		// defaults to SpreadBacklog (FixedTimestep's own default is Drop).
+		void  setFixedCatchUpPolicy(FixedTimestep::CatchUpPolicy p) { fixedStep_.setCatchUpPolicy(p); }
+		FixedTimestep::CatchUpPolicy fixedCatchUpPolicy() const { return fixedStep_.catchUpPolicy(); }
+		void  setFixedMaxDebtTicks(int ticks) { fixedStep_.setMaxDebtTicks(ticks); }
+		// True while the simulation ends frames owing ticks: the cue to shed
+		// optional work (a lower CSM cascade budget, a skipped UI relayout)
+		// until it catches up. The metrics carry the debt in ticks.
+		bool  fixedStepRunningBehind() const { return fixedStep_.runningBehind(); }
+		const FixedTimestep::Metrics& fixedStepMetrics() const { return fixedStep_.metrics(); }
 		void  setTimeScale(float s) { timeScale_ = std::max(0.f, s); }
 		float timeScale() const { return timeScale_; }
 		void  setPaused(bool p) { paused_ = p; }
@@ -272,6 +287,8 @@ namespace MyCoreEngine
 		Camera   camera_{ glm::vec3(0.0f, 0.0f, 3.0f) };
 		CameraDirector director_;
 		JobSystem jobs_; // constructed on the main thread (captures its id)
+		// After jobs_, so it is destroyed FIRST: its callbacks submit to the pool.
+		IOService io_;
 		// NON-OWNING: the host owns it (it needs a Scene and an AssetManager).
 		// Null is a perfectly good state — a host that never switches scenes
 		// simply does not set one, and LoadScene then answers false.
@@ -1,5 +1,7 @@
 #include "AssetManager.h"
+#include "IOService.h"
 #include "JobSystem.h"
+#include "MeshArena.h"
 #include "Model.h"
 
 #include <algorithm>
@@ -31,7 +33,16 @@ namespace MyCoreEngine {
 
         // IMPORTANT: ensure Renderer::InitGL() has been called earlier in the app,
         // so Model construction is safe to create GL resources.
-        auto sp = std::make_shared<Model>(path, gamma);
+        std::shared_ptr<Model> sp;
+        if (io_) {
+            // the textures are read while the mesh parses, not after it
+            io_->ReadAheadSiblings(path);
+            const auto cached = Model::CachedTextureKeys();
+            sp = std::make_shared<Model>(Model::Decode(path, gamma, &cached, *io_));
+        }
+        else {
+            sp = std::make_shared<Model>(path, gamma);
+        }
         models_[key] = sp;
         return sp;
     }
@@ -95,52 +106,74 @@ namespace MyCoreEngine {
             // RunLoop's pump or its exit drain (which loops until chained
             // submissions are quiescent), while the app and this manager
             // are alive — see the JobSystem lifetime contract.
-            jobs.submit(
-                [js, rawPath, gamma, skipKeys] {
-                    js->cpu = Model::Decode(rawPath, gamma, skipKeys.get());
-                },
-                [this, &jobs, js, req] {
-                    // finalize may throw (bad_alloc on a huge model is the
-                    // realistic one) and the pump swallows completion
-                    // exceptions — the bookkeeping below must run REGARDLESS
-                    // or the decode slot leaks and the path wedges forever
-                    std::shared_ptr<Model> model;
-                    try {
-                        model = std::make_shared<Model>(std::move(js->cpu));
-                    }
-                    catch (const std::exception& e) {
-                        std::fprintf(stderr, "[AssetManager] finalize failed for '%s': %s\n",
-                                     req->path.c_str(), e.what());
-                    }
-                    catch (...) {
-                        std::fprintf(stderr, "[AssetManager] finalize failed for '%s'\n",
-                                     req->path.c_str());
-                    }
-                    if (!model) {
-                        // Failed-with-empty-model parity (invalid cpu data
-                        // constructs without touching GL)
-                        try { model = std::make_shared<Model>(ModelCPUData{}); }
-                        catch (...) {} // truly out of memory: req->model stays null
-                    }
-
-                    // pending_ is the ownership token: ReloadModel/Clear may
-                    // have superseded this load — a stale result must not
-                    // clobber the newer cache entry (the handle still gets
-                    // its result; it just isn't cached)
-                    const std::string key = NormalizePath(req->path);
-                    auto pit = pending_.find(key);
-                    const bool owns = (pit != pending_.end() && pit->second == req);
-                    if (owns && model) {
-                        std::lock_guard<std::mutex> lock(mtx_);
-                        models_[key] = model;
-                    }
-                    req->model = std::move(model);
-                    req->state = (req->model && !req->model->Meshes().empty())
-                               ? LoadState::Live : LoadState::Failed;
-                    if (owns) pending_.erase(key);
-                    --inFlight_;
-                    launchQueued_(jobs); // free slot: start the next queued load
+            auto finalize = [this, &jobs, js, req] {
+                // finalize may throw (bad_alloc on a huge model is the
+                // realistic one) and the pump swallows completion
+                // exceptions — the bookkeeping below must run REGARDLESS
+                // or the decode slot leaks and the path wedges forever
+                std::shared_ptr<Model> model;
+                try {
+                    model = std::make_shared<Model>(std::move(js->cpu));
+                }
+                catch (const std::exception& e) {
+                    std::fprintf(stderr, "[AssetManager] finalize failed for '%s': %s\n",
+                                 req->path.c_str(), e.what());
+                }
+                catch (...) {
+                    std::fprintf(stderr, "[AssetManager] finalize failed for '%s'\n",
+                                 req->path.c_str());
+                }
+                if (!model) {
+                    // Failed-with-empty-model parity (invalid cpu data
+                    // constructs without touching GL)
+                    try { model = std::make_shared<Model>(ModelCPUData{}); }
+                    catch (...) {} // truly out of memory: req->model stays null
+                }
+
+                // pending_ is the ownership token: ReloadModel/Clear may
+                // have superseded this load — a stale result must not
+                // clobber the newer cache entry (the handle still gets
+                // its result; it just isn't cached)
+                const std::string key = NormalizePath(req->path);
+                auto pit = pending_.find(key);
+                const bool owns = (pit != pending_.end() && pit->second == req);
+                if (owns && model) {
+                    std::lock_guard<std::mutex> lock(mtx_);
+                    models_[key] = model;
+                }
+                req->model = std::move(model);
+                req->state = (req->model && !req->model->Meshes().empty())
+                           ? LoadState::Live : LoadState::Failed;
+                if (owns) pending_.erase(key);
+                --inFlight_;
+                launchQueued_(jobs); // free slot: start the next queued load
+            };
+
+            if (!io_) {
+                jobs.submit(
+                    [js, rawPath, gamma, skipKeys] {
+                        js->cpu = Model::Decode(rawPath, gamma, skipKeys.get());
+                    },
+                    std::move(finalize));
+                continue;
+            }
+
+            // Read, THEN decode: the callback runs on the I/O thread once
+            // the model's bytes are in memory and only then hands the
+            // decode to a worker. The sibling read-ahead queues behind the
+            // model itself, so its textures arrive while the mesh parses.
+            // The decode slot is held from here, so the cap still bounds
+            // the bytes and pixels in flight.
+            IOService* io = io_;
+            io->Read(rawPath,
+                [&jobs, io, js, rawPath, gamma, skipKeys, finalize](const IOBlobPtr& bytes) mutable {
+                    jobs.submit(
+                        [io, js, rawPath, gamma, skipKeys, bytes] {
+                            js->cpu = Model::Decode(rawPath, gamma, skipKeys.get(), *io, bytes);
+                        },
+                        std::move(finalize));
                 });
+            io->ReadAheadSiblings(rawPath);
         }
     }
 
@@ -158,11 +191,16 @@ namespace MyCoreEngine {
     }
 
     void AssetManager::GarbageCollect() {
-        std::lock_guard<std::mutex> lock(mtx_);
-        for (auto it = models_.begin(); it != models_.end(); ) {
-            if (it->second.expired()) it = models_.erase(it);
-            else ++it;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            for (auto it = models_.begin(); it != models_.end(); ) {
+                if (it->second.expired()) it = models_.erase(it);
+                else ++it;
+            }
         }
+        // the unloaded models' meshes left holes in the shared buffers;
+        // repack them if they are worth it
+        MeshArena::CompactAll();
     }
 
     void AssetManager::Clear() {
@@ -11,6 +11,7 @@ namespace MyCoreEngine {
 
     class Model;
     class JobSystem;
+    class IOService;
 
     // Model asset manager: dedupe by normalized path.
     //
@@ -30,6 +31,14 @@ namespace MyCoreEngine {
     // handles from the main loop, never from workers). GetModel keeps the
     // coarse mutex it always had for the shared cache map.
     //
+    // File reads: with an IOService attached (SetIOService — both apps
+    // attach the Application's), every model file is read by the I/O
+    // thread. RequestModel reads the model FIRST and submits its decode
+    // only once the bytes are in memory, so a worker never waits on the
+    // disk; both paths read ahead the model's directory (textures, .mtl,
+    // .bin) so those are in memory by the time the import asks. Without
+    // one, Assimp and stb open the files themselves, as before.
+    //
     // Mixing GetModel and RequestModel on the SAME path can duplicate a
     // load (sync can't wait on an in-flight decode) — never wrong (the
     // texture cache still dedupes GPU ids), just wasted CPU. Prefer one
@@ -73,11 +82,17 @@ namespace MyCoreEngine {
         // phase 2) — two keeps the pipeline busy without memory spikes.
         static constexpr std::size_t kMaxConcurrentDecodes = 2;
 
+        // Route model/texture file reads through `io` (null: read directly).
+        // `io` must outlive this manager's pending requests, like `jobs`.
+        void SetIOService(IOService* io) { io_ = io; }
+        IOService* ioService() const { return io_; }
+
         // Force reload of a model from disk and replace the cache entry.
         // Existing holders keep their old shared_ptr (you can retarget them manually).
         std::shared_ptr<Model> ReloadModel(const std::string& path, bool gamma = false);
 
-        // Remove expired entries from the cache.
+        // Remove expired entries from the cache, then compact the mesh
+        // arenas (MeshArena::CompactAll). MAIN THREAD: the repack is GL.
         void GarbageCollect();
 
         // Clear cache map (dangerous if callers still hold shared_ptrs, but safe: they keep their instances).
@@ -101,6 +116,7 @@ namespace MyCoreEngine {
         std::unordered_map<std::string, ModelRequestHandle> pending_; // key -> in-flight/queued
         std::deque<QueuedLoad> queued_;
         std::size_t inFlight_ = 0;
+        IOService* io_ = nullptr; // non-owning; see SetIOService
     };
 
 } // namespace MyCoreEngine
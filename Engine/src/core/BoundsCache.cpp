@@ -0,0 +1,345 @@
+#include "BoundsCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Components.h"
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        // Settling is spread over frames so a level that just loaded does
+        // not build its whole tree in one hitch; the rest stays dynamic
+        // (culled linearly) meanwhile.
+        constexpr std::size_t kMaxSettlesPerSync = 32768;
+
+        bool rayHitsBox(const float o[3], const float d[3], float maxT,
+                        const float c[3], const float e[3], float& tOut) {
+            float t0 = 0.f, t1 = maxT;
+            for (int a = 0; a < 3; ++a) {
+                const float mn = c[a] - e[a], mx = c[a] + e[a];
+                if (std::abs(d[a]) < 1e-8f) {
+                    if (o[a] < mn || o[a] > mx) return false;
+                }
+                else {
+                    float tA = (mn - o[a]) / d[a];
+                    float tB = (mx - o[a]) / d[a];
+                    if (tA > tB) std::swap(tA, tB);
+                    t0 = std::max(t0, tA);
+                    t1 = std::min(t1, tB);
+                    if (t0 > t1) return false;
+                }
+            }
+            tOut = t0;
+            return true;
+        }
+    } // namespace
+
+    BoundsCache::BoundsCache(entt::registry& reg) : reg_(reg) {
+        reg_.on_construct<Transform>().connect<&BoundsCache::onMaybeJoin_>(*this);
+        reg_.on_construct<AABB>().connect<&BoundsCache::onMaybeJoin_>(*this);
+        reg_.on_construct<ModelComponent>().connect<&BoundsCache::onMaybeJoin_>(*this);
+        reg_.on_destroy<Transform>().connect<&BoundsCache::onLeave_>(*this);
+        reg_.on_destroy<AABB>().connect<&BoundsCache::onLeave_>(*this);
+        reg_.on_destroy<ModelComponent>().connect<&BoundsCache::onLeave_>(*this);
+        reg_.on_update<Transform>().connect<&BoundsCache::onChanged_>(*this);
+        reg_.on_update<AABB>().connect<&BoundsCache::onChanged_>(*this);
+        reg_.on_update<ModelComponent>().connect<&BoundsCache::onChanged_>(*this);
+
+        // whatever the registry already holds
+        for (auto e : reg_.view<Transform, AABB, ModelComponent>()) onMaybeJoin_(reg_, e);
+    }
+
+    BoundsCache::~BoundsCache() {
+        reg_.on_construct<Transform>().disconnect(*this);
+        reg_.on_construct<AABB>().disconnect(*this);
+        reg_.on_construct<ModelComponent>().disconnect(*this);
+        reg_.on_destroy<Transform>().disconnect(*this);
+        reg_.on_destroy<AABB>().disconnect(*this);
+        reg_.on_destroy<ModelComponent>().disconnect(*this);
+        reg_.on_update<Transform>().disconnect(*this);
+        reg_.on_update<AABB>().disconnect(*this);
+        reg_.on_update<ModelComponent>().disconnect(*this);
+    }
+
+    int32_t BoundsCache::SlotOf(entt::entity e) const {
+        const auto idx = static_cast<std::size_t>(entt::to_entity(e));
+        if (idx >= slotByIndex_.size()) return -1;
+        const int32_t s = slotByIndex_[idx];
+        // the index may belong to an older version of the entity
+        return (s >= 0 && entities_[s] == e) ? s : -1;
+    }
+
+    bool BoundsCache::IsSettled(entt::entity e) const {
+        const int32_t s = SlotOf(e);
+        return s >= 0 && static_cast<std::size_t>(s) >= dynamicCount_;
+    }
+
+    BoundsCache::Stats BoundsCache::stats() const {
+        Stats s;
+        s.members = entities_.size();
+        s.dynamic = dynamicCount_;
+        s.tree = tree_.stats();
+        return s;
+    }
+
+    void BoundsCache::Update(entt::entity e, const glm::mat4& m, const AABB& local) {
+        const int32_t slot = SlotOf(e);
+        if (slot < 0) return;
+        write_(static_cast<std::size_t>(slot), m, local);
+        // Listed once per Sync; the slot is this caller's alone, so the flag
+        // needs no atomics, only the shared append index does.
+        if (!queued_[slot]) {
+            queued_[slot] = 1;
+            moved_[movedCount_.fetch_add(1, std::memory_order_relaxed)] = e;
+        }
+    }
+
+    void BoundsCache::Sync() {
+        CSE_PROFILE_ZONE("BoundsCache::Sync");
+        for (auto e : pending_) {
+            const int32_t slot = SlotOf(e);
+            if (slot < 0) continue; // left again since it was queued
+            write_(static_cast<std::size_t>(slot), reg_.get<Transform>(e).modelMatrix, reg_.get<AABB>(e));
+            markMoved_(static_cast<std::size_t>(slot));
+        }
+        pending_.clear();
+
+        const std::size_t moved = movedCount_.load(std::memory_order_relaxed);
+        for (std::size_t k = 0; k < moved; ++k) {
+            const int32_t slot = SlotOf(moved_[k]);
+            if (slot < 0) continue;
+            queued_[slot] = 0;
+            markMoved_(static_cast<std::size_t>(slot));
+        }
+        movedCount_.store(0, std::memory_order_relaxed);
+
+        // Settle what has sat still long enough (swapping it to the end of
+        // the dynamic range, so slot i is looked at again).
+        std::size_t settled = 0;
+        for (std::size_t i = 0; i < dynamicCount_ && settled < kMaxSettlesPerSync;) {
+            if (frame_ - lastMoved_[i] >= kSettleFrames) {
+                const float c[3] = { cx_[i], cy_[i], cz_[i] };
+                const float e[3] = { ex_[i], ey_[i], ez_[i] };
+                if (tree_.Insert(keyOf_(i), c, e, r_[i])) { // refuses non-finite bounds
+                    swapSlots_(i, dynamicCount_ - 1);
+                    --dynamicCount_;
+                    ++settled;
+                    continue;
+                }
+                lastMoved_[i] = frame_; // try again in kSettleFrames, not every Sync
+            }
+            ++i;
+        }
+        if (settled > 0) ++settledEpoch_;
+    }
+
+    CullInput BoundsCache::dynamicInput_() const {
+        CullInput in;
+        in.cx = cx_.data(); in.cy = cy_.data(); in.cz = cz_.data();
+        in.ex = ex_.data(); in.ey = ey_.data(); in.ez = ez_.data();
+        in.radius = r_.data();
+        in.count = dynamicCount_;
+        return in;
+    }
+
+    void BoundsCache::Cull(const CullPlanes& planes, const CullParams& params) {
+        CSE_PROFILE_ZONE("BoundsCache::Cull");
+        ++frame_;
+        hits_.clear();
+
+        result_.resize(dynamicCount_);
+        lod_.resize(dynamicCount_);
+        CullBounds(dynamicInput_(), planes, params, result_.data(), lod_.data());
+        for (std::size_t i = 0; i < dynamicCount_; ++i) {
+            if (result_[i] != kCullFrustum) hits_.push_back({ entities_[i], result_[i], lod_[i] });
+        }
+
+        const CullPlanes all = CullPlanesAcceptAll();
+        tree_.Query(planes, [&](const LooseOctree::Batch& b) {
+            result_.resize(b.bounds.count);
+            lod_.resize(b.bounds.count);
+            CullBounds(b.bounds, b.inside ? all : planes, params, result_.data(), lod_.data());
+            for (std::size_t i = 0; i < b.bounds.count; ++i) {
+                if (result_[i] == kCullFrustum) continue;
+                hits_.push_back({ entities_[slotByIndex_[b.keys[i]]], result_[i], lod_[i] });
+            }
+        });
+    }
+
+    void BoundsCache::Query(const CullPlanes& planes, std::vector<entt::entity>& out,
+                            QueryScratch& scratch, Members which) const {
+        CSE_PROFILE_ZONE("BoundsCache::Query");
+        const CullParams frustumOnly; // no size cull, no LOD
+        std::vector<uint8_t>& result = scratch.result;
+        std::vector<uint8_t>& lod = scratch.lod;
+        auto cull = [&](const CullInput& in, auto&& entityAt) {
+            result.resize(in.count);
+            lod.resize(in.count);
+            CullBounds(in, planes, frustumOnly, result.data(), lod.data());
+            for (std::size_t i = 0; i < in.count; ++i) {
+                if (result[i] != kCullFrustum) out.push_back(entityAt(i));
+            }
+        };
+        if (which != Members::Settled) cull(dynamicInput_(), [&](std::size_t i) { return entities_[i]; });
+        if (which == Members::Dynamic) return;
+        tree_.Query(planes, [&](const LooseOctree::Batch& b) {
+            auto entityAt = [&](std::size_t i) { return entities_[slotByIndex_[b.keys[i]]]; };
+            if (b.inside) {
+                for (std::size_t i = 0; i < b.bounds.count; ++i) out.push_back(entityAt(i));
+            }
+            else {
+                cull(b.bounds, entityAt);
+            }
+        });
+    }
+
+    void BoundsCache::Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT,
+                              std::vector<RayHit>& out) const {
+        const float o[3] = { origin.x, origin.y, origin.z };
+        const float d[3] = { dir.x, dir.y, dir.z };
+        float t = 0.f;
+        for (std::size_t i = 0; i < dynamicCount_; ++i) {
+            const float c[3] = { cx_[i], cy_[i], cz_[i] };
+            const float e[3] = { ex_[i], ey_[i], ez_[i] };
+            if (rayHitsBox(o, d, maxT, c, e, t)) out.push_back({ entities_[i], t });
+        }
+        tree_.QueryRay(o, d, maxT, [&](const LooseOctree::Batch& b) {
+            const CullInput& in = b.bounds;
+            for (std::size_t i = 0; i < in.count; ++i) {
+                const float c[3] = { in.cx[i], in.cy[i], in.cz[i] };
+                const float e[3] = { in.ex[i], in.ey[i], in.ez[i] };
+                if (rayHitsBox(o, d, maxT, c, e, t)) out.push_back({ entities_[slotByIndex_[b.keys[i]]], t });
+            }
+        });
+    }
+
+    CullPlanes BoundsCache::PlanesFrom(const Frustum& f) {
+        const Plane* src[6] = { &f.leftFace, &f.rightFace, &f.topFace,
+                                &f.bottomFace, &f.nearFace, &f.farFace };
+        CullPlanes out{};
+        for (int k = 0; k < 6; ++k) {
+            out.nx[k] = src[k]->normal.x;
+            out.ny[k] = src[k]->normal.y;
+            out.nz[k] = src[k]->normal.z;
+            out.d[k] = src[k]->distance;
+        }
+        return out;
+    }
+
+    CullPlanes BoundsCache::PlanesFromClip(const glm::mat4& m) {
+        // Gribb/Hartmann: row3 ± row0..2. Unnormalized, which the AABB test
+        // does not mind (both sides scale by |n|).
+        const glm::vec4 row0{ m[0][0], m[1][0], m[2][0], m[3][0] };
+        const glm::vec4 row1{ m[0][1], m[1][1], m[2][1], m[3][1] };
+        const glm::vec4 row2{ m[0][2], m[1][2], m[2][2], m[3][2] };
+        const glm::vec4 row3{ m[0][3], m[1][3], m[2][3], m[3][3] };
+        const glm::vec4 p[6] = { row3 + row0, row3 - row0, row3 + row1,
+                                 row3 - row1, row3 + row2, row3 - row2 };
+        CullPlanes out{};
+        for (int k = 0; k < 6; ++k) {
+            out.nx[k] = p[k].x;
+            out.ny[k] = p[k].y;
+            out.nz[k] = p[k].z;
+            out.d[k] = -p[k].w; // dot(n, x) + w >= 0  <=>  dot(n, x) - d >= 0
+        }
+        return out;
+    }
+
+    // --- signals ----------------------------------------------------------------
+
+    void BoundsCache::onMaybeJoin_(entt::registry& reg, entt::entity e) {
+        if (SlotOf(e) >= 0 || !reg.all_of<Transform, AABB, ModelComponent>(e)) return;
+        const auto idx = static_cast<std::size_t>(entt::to_entity(e));
+        if (idx >= slotByIndex_.size()) slotByIndex_.resize(idx + 1, -1);
+        const std::size_t slot = entities_.size();
+        slotByIndex_[idx] = static_cast<int32_t>(slot);
+        entities_.push_back(e);
+        cx_.push_back(0.f); cy_.push_back(0.f); cz_.push_back(0.f);
+        ex_.push_back(0.f); ey_.push_back(0.f); ez_.push_back(0.f);
+        r_.push_back(0.f);
+        lastMoved_.push_back(frame_);
+        queued_.push_back(0);
+        swapSlots_(slot, dynamicCount_); // newcomers start dynamic
+        ++dynamicCount_;
+        // Every live slot can add one moved_ entry on top of what is there.
+        const std::size_t need = movedCount_.load(std::memory_order_relaxed) + entities_.size();
+        if (moved_.size() < need) moved_.resize(std::max(need, moved_.size() * 2));
+        pending_.push_back(e); // not every component is necessarily final yet
+    }
+
+    void BoundsCache::onLeave_(entt::registry&, entt::entity e) {
+        const int32_t found = SlotOf(e);
+        if (found < 0) return;
+        std::size_t slot = static_cast<std::size_t>(found);
+        if (slot >= dynamicCount_) {
+            tree_.Remove(keyOf_(slot));
+            ++settledEpoch_;
+        }
+        else {
+            // to the first settled position, so one swap-with-last finishes it
+            swapSlots_(slot, dynamicCount_ - 1);
+            slot = --dynamicCount_;
+        }
+        const std::size_t last = entities_.size() - 1;
+        swapSlots_(slot, last);
+        entities_.pop_back();
+        cx_.pop_back(); cy_.pop_back(); cz_.pop_back();
+        ex_.pop_back(); ey_.pop_back(); ez_.pop_back();
+        r_.pop_back();
+        lastMoved_.pop_back();
+        queued_.pop_back();
+        slotByIndex_[static_cast<std::size_t>(entt::to_entity(e))] = -1;
+    }
+
+    void BoundsCache::onChanged_(entt::registry&, entt::entity e) {
+        if (SlotOf(e) >= 0) pending_.push_back(e);
+    }
+
+    // --- slots ------------------------------------------------------------------
+
+    void BoundsCache::swapSlots_(std::size_t a, std::size_t b) {
+        if (a == b) return;
+        std::swap(entities_[a], entities_[b]);
+        std::swap(cx_[a], cx_[b]); std::swap(cy_[a], cy_[b]); std::swap(cz_[a], cz_[b]);
+        std::swap(ex_[a], ex_[b]); std::swap(ey_[a], ey_[b]); std::swap(ez_[a], ez_[b]);
+        std::swap(r_[a], r_[b]);
+        std::swap(lastMoved_[a], lastMoved_[b]);
+        std::swap(queued_[a], queued_[b]);
+        slotByIndex_[static_cast<std::size_t>(entt::to_entity(entities_[a]))] = static_cast<int32_t>(a);
+        slotByIndex_[static_cast<std::size_t>(entt::to_entity(entities_[b]))] = static_cast<int32_t>(b);
+    }
+
+    void BoundsCache::markMoved_(std::size_t slot) {
+        lastMoved_[slot] = frame_;
+        if (slot < dynamicCount_) return;
+        tree_.Remove(keyOf_(slot));
+        ++settledEpoch_;
+        swapSlots_(slot, dynamicCount_);
+        ++dynamicCount_;
+    }
+
+    // --- bounds -----------------------------------------------------------------
+
+    void BoundsCache::write_(std::size_t s, const glm::mat4& m, const AABB& local) {
+        // AABB::isOnFrustum's world box: center through the matrix, extents
+        // as the sum of the absolute scaled axes.
+        const glm::vec3 c{ m * glm::vec4(local.center, 1.f) };
+        const glm::vec3 right = glm::vec3(m[0]) * local.extents.x;
+        const glm::vec3 up = glm::vec3(m[1]) * local.extents.y;
+        const glm::vec3 forward = -glm::vec3(m[2]) * local.extents.z;
+        cx_[s] = c.x; cy_[s] = c.y; cz_[s] = c.z;
+        ex_[s] = std::abs(right.x) + std::abs(up.x) + std::abs(forward.x);
+        ey_[s] = std::abs(right.y) + std::abs(up.y) + std::abs(forward.y);
+        ez_[s] = std::abs(right.z) + std::abs(up.z) + std::abs(forward.z);
+
+        // RenderScene's bounding sphere, for the size cull and LOD
+        const float maxScale = std::max({ glm::length(glm::vec3(m[0])),
+                                          glm::length(glm::vec3(m[1])),
+                                          glm::length(glm::vec3(m[2])) });
+        r_[s] = std::max(0.01f, glm::length(local.max - local.min) * 0.5f * maxScale);
+    }
+
+} // namespace MyCoreEngine
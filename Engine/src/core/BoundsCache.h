@@ -0,0 +1,174 @@
+#pragma once
+#include "Core.h"
+#include "CullKernel.h"
+#include "LooseOctree.h"
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AABB;
+struct Frustum;
+
+namespace MyCoreEngine {
+
+    // World-space bounds of every renderable entity (Transform + AABB +
+    // ModelComponent), one array per component, ready for CullBounds(), and
+    // the spatial index that answers visibility, light-frustum and ray
+    // queries over them.
+    //
+    //   bounds_.Sync();                            // main thread, before any query
+    //   bounds_.Cull(planes, params);              // camera: Hits() = not frustum-culled
+    //   bounds_.Query(lightPlanes, out, scratch);  // e.g. one shadow cascade
+    //
+    // The world bounds are computed when a matrix changes (UpdateTransforms
+    // calls Update() for the entities it recomputes), not per query, and a
+    // query only visits what it can see.
+    //
+    // SETTLED vs DYNAMIC. An entity whose bounds have not changed for
+    // kSettleFrames camera culls is settled: it moves into a LooseOctree, and
+    // queries reach it only through the branches they overlap. Everything
+    // else stays in a flat dynamic list that is tested linearly with the
+    // SIMD kernel — it is small, since it is whatever moved recently. Moving
+    // (or a replaced AABB/Transform) takes a settled entity straight back
+    // out at the next Sync(). Nothing has to be tagged static: the split
+    // follows what actually moves, and a level that just loaded is fully
+    // dynamic (culled linearly) for its first few frames.
+    //
+    // Membership follows registry signals: an entity joins when it has all
+    // three components and leaves when it loses one (slots are swap-removed,
+    // so Entity(i) order is not stable across edits). Joining, a replaced
+    // AABB, a replaced Transform (undo restores one with a clean dirty flag)
+    // or a replaced ModelComponent (new meshes, usually new bounds) queue the
+    // entity; Sync() refreshes the queued ones from their current matrix and
+    // a queued settled entity counts as moved. Writes that bypass the
+    // signals (get<AABB>(e) = b) are not seen — go through
+    // emplace_or_replace/patch.
+    //
+    // The stored values are exactly what AABB::isOnFrustum and the
+    // per-entity bounding sphere compute, so the cull makes the same decisions:
+    // center = M * aabb.center, half-extents = Σ |M column| * extent, and
+    // radius = max(0.01, |max - min| / 2 * largest column length).
+    //
+    // Main thread, with two exceptions: Update() may run on job workers for
+    // distinct entities while no structural change can happen
+    // (UpdateTransforms' parallel pass), and the const queries may run
+    // concurrently with each other. Scene owns one for its own registry; it
+    // must not outlive that registry.
+    class ENGINE_API BoundsCache {
+    public:
+        // Camera culls a bounds entry has to sit still through to settle.
+        static constexpr uint32_t kSettleFrames = 8;
+
+        // An entity the camera frustum did not reject: kCullSmall or kCullVisible.
+        struct Hit {
+            entt::entity entity;
+            uint8_t result;
+            uint8_t lod;
+        };
+        struct RayHit {
+            entt::entity entity;
+            float t; // entry distance along the ray (0 if it starts inside)
+        };
+        // Which members a Query() visits.
+        enum class Members { All, Settled, Dynamic };
+        // The kernel's per-item output for one Query(). Owned by the caller,
+        // one per thread that queries, so a query per cascade per frame
+        // reuses its capacity instead of allocating.
+        struct QueryScratch {
+            std::vector<uint8_t> result, lod;
+        };
+        struct Stats {
+            std::size_t members = 0;
+            std::size_t dynamic = 0;
+            LooseOctree::Stats tree; // the settled ones
+        };
+
+        explicit BoundsCache(entt::registry& reg);
+        ~BoundsCache();
+
+        BoundsCache(const BoundsCache&) = delete;
+        BoundsCache& operator=(const BoundsCache&) = delete;
+
+        // Recomputes e's world bounds from m. No-op for non-members.
+        void Update(entt::entity e, const glm::mat4& m, const AABB& local);
+        // Applies everything queued since the last call: signal-driven
+        // refreshes, Update()s of settled entities (back to dynamic), and
+        // settling. Call before querying.
+        void Sync();
+
+        // Camera cull: frustum test, then the size cull and LOD pick for
+        // what survives. Hits() holds every member not frustum-culled, so
+        // Size() - Hits().size() were. Advances the settle clock.
+        void Cull(const CullPlanes& planes, const CullParams& params);
+        const std::vector<Hit>& Hits() const { return hits_; }
+
+        // Appends every member (of `which`) whose world AABB is not entirely
+        // outside one of the planes. Conservative: nothing inside is missed.
+        void Query(const CullPlanes& planes, std::vector<entt::entity>& out,
+                   QueryScratch& scratch, Members which = Members::All) const;
+        // Appends every member whose world AABB the ray enters within maxT
+        // (dir need not be unit length; t is in its units). Unsorted.
+        void Raycast(const glm::vec3& origin, const glm::vec3& dir, float maxT,
+                     std::vector<RayHit>& out) const;
+
+        std::size_t Size() const { return entities_.size(); }
+        entt::entity Entity(std::size_t i) const { return entities_[i]; }
+        // world center / half-extents / sphere radius of slot i
+        glm::vec3 Center(std::size_t i) const { return { cx_[i], cy_[i], cz_[i] }; }
+        glm::vec3 Extents(std::size_t i) const { return { ex_[i], ey_[i], ez_[i] }; }
+        float Radius(std::size_t i) const { return r_[i]; }
+        // Slot of e, or -1.
+        int32_t SlotOf(entt::entity e) const;
+        bool IsSettled(entt::entity e) const;
+        // Changes whenever the settled set does: an entity settles, a settled
+        // one moves (or is queued) or leaves. Settled bounds cannot change in
+        // place, so anything derived from the settled members alone — e.g. a
+        // cascade's static casters — stays valid while this holds.
+        uint64_t SettledEpoch() const { return settledEpoch_; }
+        Stats stats() const;
+
+        static CullPlanes PlanesFrom(const Frustum& f);
+        // The six clip planes of a view-projection matrix (GL clip space,
+        // -w <= x, y, z <= w), e.g. a shadow cascade's light VP.
+        static CullPlanes PlanesFromClip(const glm::mat4& viewProj);
+
+    private:
+        void onMaybeJoin_(entt::registry& reg, entt::entity e);
+        void onLeave_(entt::registry& reg, entt::entity e);
+        void onChanged_(entt::registry& reg, entt::entity e);
+        void write_(std::size_t slot, const glm::mat4& m, const AABB& local);
+        void swapSlots_(std::size_t a, std::size_t b);
+        // A settled slot goes back to the dynamic list.
+        void markMoved_(std::size_t slot);
+        uint32_t keyOf_(std::size_t slot) const { return static_cast<uint32_t>(entt::to_entity(entities_[slot])); }
+        CullInput dynamicInput_() const;
+
+        entt::registry& reg_;
+        // Slots [0, dynamicCount_) are dynamic, the rest are settled and
+        // mirrored in tree_ (keyed by entity index).
+        std::vector<float> cx_, cy_, cz_, ex_, ey_, ez_, r_;
+        std::vector<entt::entity> entities_;
+        std::vector<uint32_t> lastMoved_; // settle clock value of the last change
+        std::vector<uint8_t> queued_;     // Update() already listed it in moved_
+        std::size_t dynamicCount_ = 0;
+        std::vector<int32_t> slotByIndex_; // by entt::to_entity(e); -1 = absent
+        std::vector<entt::entity> pending_; // may hold duplicates and leavers
+        LooseOctree tree_;
+        uint32_t frame_ = 0;
+        uint64_t settledEpoch_ = 0;
+
+        // Update() appends here lock-free; sized so it can never overflow
+        // (one entry per queued_ flag set since the last Sync).
+        std::vector<entt::entity> moved_;
+        std::atomic<std::size_t> movedCount_{ 0 };
+
+        std::vector<Hit> hits_;
+        std::vector<uint8_t> result_, lod_; // Cull() scratch
+    };
+
+} // namespace MyCoreEngine
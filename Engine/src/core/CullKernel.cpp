@@ -0,0 +1,203 @@
+#include "CullKernel.h"
+
+#include <cmath>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define CSE_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define CSE_CULL_SSE2 1
+#endif
+
+namespace MyCoreEngine {
+
+    namespace {
+        constexpr float kLod1Ratio = 25.f;
+        constexpr float kLod2Ratio = 60.f;
+        constexpr float kMinScreenCullDist = 1e-3f; // closer than this: never size-culled
+
+        // Entity i, the reference every vector path has to agree with.
+        // Written as the scalar code in AABB::isOnFrustum and the old
+        // RenderScene loop evaluates it, operation for operation.
+        void cullOne(const CullInput& in, const CullPlanes& pl, const CullParams& p,
+                     std::size_t i, uint8_t* result, uint8_t* lod) {
+            const float cx = in.cx[i], cy = in.cy[i], cz = in.cz[i];
+            const float ex = in.ex[i], ey = in.ey[i], ez = in.ez[i];
+            bool inside = true;
+            for (int k = 0; k < 6; ++k) {
+                const float r = ex * std::abs(pl.nx[k]) + ey * std::abs(pl.ny[k]) + ez * std::abs(pl.nz[k]);
+                const float s = pl.nx[k] * cx + pl.ny[k] * cy + pl.nz[k] * cz - pl.d[k];
+                inside = inside && (-r <= s);
+            }
+            lod[i] = 0;
+            if (!inside) { result[i] = kCullFrustum; return; }
+
+            const float dx = cx - p.camX, dy = cy - p.camY, dz = cz - p.camZ;
+            const float dist = std::sqrt(dx * dx + dy * dy + dz * dz);
+            const float radius = in.radius[i];
+            if (p.screenCull && dist > kMinScreenCullDist) {
+                const float pixelH = p.viewportHeightPx * radius / (dist * p.tanHalfFov);
+                if (pixelH < p.minPixels) { result[i] = kCullSmall; return; }
+            }
+            result[i] = kCullVisible;
+            if (p.lodEnabled) {
+                const float ratio = dist / (radius * p.lodDistanceScale);
+                lod[i] = (ratio > kLod2Ratio) ? 2 : (ratio > kLod1Ratio) ? 1 : 0;
+            }
+        }
+
+        // Turns the per-lane masks of one vector step into result/lod bytes.
+        inline void writeLanes(int lanes, int insideBits, int smallBits, int lod1Bits, int lod2Bits,
+                               uint8_t* result, uint8_t* lod) {
+            for (int l = 0; l < lanes; ++l) {
+                const int bit = 1 << l;
+                if (!(insideBits & bit))     { result[l] = kCullFrustum; lod[l] = 0; continue; }
+                if (smallBits & bit)         { result[l] = kCullSmall;   lod[l] = 0; continue; }
+                result[l] = kCullVisible;
+                lod[l] = (lod2Bits & bit) ? 2 : (lod1Bits & bit) ? 1 : 0;
+            }
+        }
+
+#if defined(CSE_CULL_AVX)
+        // 8 entities per step. Returns how many were done; the caller
+        // finishes the tail with cullOne.
+        std::size_t cullAvx(const CullInput& in, const CullPlanes& pl, const CullParams& p,
+                            uint8_t* result, uint8_t* lod) {
+            const __m256 sign = _mm256_set1_ps(-0.f);
+            __m256 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+            for (int k = 0; k < 6; ++k) {
+                nx[k] = _mm256_set1_ps(pl.nx[k]); ax[k] = _mm256_andnot_ps(sign, nx[k]);
+                ny[k] = _mm256_set1_ps(pl.ny[k]); ay[k] = _mm256_andnot_ps(sign, ny[k]);
+                nz[k] = _mm256_set1_ps(pl.nz[k]); az[k] = _mm256_andnot_ps(sign, nz[k]);
+                d[k] = _mm256_set1_ps(pl.d[k]);
+            }
+            const __m256 camX = _mm256_set1_ps(p.camX), camY = _mm256_set1_ps(p.camY), camZ = _mm256_set1_ps(p.camZ);
+            const __m256 vh = _mm256_set1_ps(p.viewportHeightPx), tanHalf = _mm256_set1_ps(p.tanHalfFov);
+            const __m256 minPx = _mm256_set1_ps(p.minPixels), minDist = _mm256_set1_ps(kMinScreenCullDist);
+            const __m256 lodScale = _mm256_set1_ps(p.lodDistanceScale);
+            const __m256 lod1 = _mm256_set1_ps(kLod1Ratio), lod2 = _mm256_set1_ps(kLod2Ratio);
+
+            std::size_t i = 0;
+            for (; i + 8 <= in.count; i += 8) {
+                const __m256 cx = _mm256_loadu_ps(in.cx + i), cy = _mm256_loadu_ps(in.cy + i), cz = _mm256_loadu_ps(in.cz + i);
+                const __m256 ex = _mm256_loadu_ps(in.ex + i), ey = _mm256_loadu_ps(in.ey + i), ez = _mm256_loadu_ps(in.ez + i);
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int k = 0; k < 6; ++k) {
+                    const __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, ax[k]), _mm256_mul_ps(ey, ay[k])),
+                                                   _mm256_mul_ps(ez, az[k]));
+                    const __m256 s = _mm256_sub_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[k], cx), _mm256_mul_ps(ny[k], cy)),
+                                                                 _mm256_mul_ps(nz[k], cz)), d[k]);
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_xor_ps(r, sign), s, _CMP_LE_OQ));
+                }
+                const int insideBits = _mm256_movemask_ps(inside);
+                if (insideBits == 0) { // the common case on a big level
+                    for (int l = 0; l < 8; ++l) { result[i + l] = kCullFrustum; lod[i + l] = 0; }
+                    continue;
+                }
+
+                const __m256 dx = _mm256_sub_ps(cx, camX), dy = _mm256_sub_ps(cy, camY), dz = _mm256_sub_ps(cz, camZ);
+                const __m256 dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+                                                                 _mm256_mul_ps(dz, dz)));
+                const __m256 radius = _mm256_loadu_ps(in.radius + i);
+                int smallBits = 0, lod1Bits = 0, lod2Bits = 0;
+                if (p.screenCull) {
+                    const __m256 pixelH = _mm256_div_ps(_mm256_mul_ps(vh, radius), _mm256_mul_ps(dist, tanHalf));
+                    smallBits = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(dist, minDist, _CMP_GT_OQ),
+                                                                 _mm256_cmp_ps(pixelH, minPx, _CMP_LT_OQ)));
+                }
+                if (p.lodEnabled) {
+                    const __m256 ratio = _mm256_div_ps(dist, _mm256_mul_ps(radius, lodScale));
+                    lod1Bits = _mm256_movemask_ps(_mm256_cmp_ps(ratio, lod1, _CMP_GT_OQ));
+                    lod2Bits = _mm256_movemask_ps(_mm256_cmp_ps(ratio, lod2, _CMP_GT_OQ));
+                }
+                writeLanes(8, insideBits, smallBits, lod1Bits, lod2Bits, result + i, lod + i);
+            }
+            return i;
+        }
+#endif
+
+#if defined(CSE_CULL_SSE2)
+        // 4 entities per step; see cullAvx.
+        std::size_t cullSse2(const CullInput& in, const CullPlanes& pl, const CullParams& p,
+                             uint8_t* result, uint8_t* lod) {
+            const __m128 sign = _mm_set1_ps(-0.f);
+            __m128 nx[6], ny[6], nz[6], ax[6], ay[6], az[6], d[6];
+            for (int k = 0; k < 6; ++k) {
+                nx[k] = _mm_set1_ps(pl.nx[k]); ax[k] = _mm_andnot_ps(sign, nx[k]);
+                ny[k] = _mm_set1_ps(pl.ny[k]); ay[k] = _mm_andnot_ps(sign, ny[k]);
+                nz[k] = _mm_set1_ps(pl.nz[k]); az[k] = _mm_andnot_ps(sign, nz[k]);
+                d[k] = _mm_set1_ps(pl.d[k]);
+            }
+            const __m128 camX = _mm_set1_ps(p.camX), camY = _mm_set1_ps(p.camY), camZ = _mm_set1_ps(p.camZ);
+            const __m128 vh = _mm_set1_ps(p.viewportHeightPx), tanHalf = _mm_set1_ps(p.tanHalfFov);
+            const __m128 minPx = _mm_set1_ps(p.minPixels), minDist = _mm_set1_ps(kMinScreenCullDist);
+            const __m128 lodScale = _mm_set1_ps(p.lodDistanceScale);
+            const __m128 lod1 = _mm_set1_ps(kLod1Ratio), lod2 = _mm_set1_ps(kLod2Ratio);
+
+            std::size_t i = 0;
+            for (; i + 4 <= in.count; i += 4) {
+                const __m128 cx = _mm_loadu_ps(in.cx + i), cy = _mm_loadu_ps(in.cy + i), cz = _mm_loadu_ps(in.cz + i);
+                const __m128 ex = _mm_loadu_ps(in.ex + i), ey = _mm_loadu_ps(in.ey + i), ez = _mm_loadu_ps(in.ez + i);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int k = 0; k < 6; ++k) {
+                    const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, ax[k]), _mm_mul_ps(ey, ay[k])),
+                                                _mm_mul_ps(ez, az[k]));
+                    const __m128 s = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[k], cx), _mm_mul_ps(ny[k], cy)),
+                                                           _mm_mul_ps(nz[k], cz)), d[k]);
+                    inside = _mm_and_ps(inside, _mm_cmple_ps(_mm_xor_ps(r, sign), s));
+                }
+                const int insideBits = _mm_movemask_ps(inside);
+                if (insideBits == 0) {
+                    for (int l = 0; l < 4; ++l) { result[i + l] = kCullFrustum; lod[i + l] = 0; }
+                    continue;
+                }
+
+                const __m128 dx = _mm_sub_ps(cx, camX), dy = _mm_sub_ps(cy, camY), dz = _mm_sub_ps(cz, camZ);
+                const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                                                           _mm_mul_ps(dz, dz)));
+                const __m128 radius = _mm_loadu_ps(in.radius + i);
+                int smallBits = 0, lod1Bits = 0, lod2Bits = 0;
+                if (p.screenCull) {
+                    const __m128 pixelH = _mm_div_ps(_mm_mul_ps(vh, radius), _mm_mul_ps(dist, tanHalf));
+                    smallBits = _mm_movemask_ps(_mm_and_ps(_mm_cmpgt_ps(dist, minDist), _mm_cmplt_ps(pixelH, minPx)));
+                }
+                if (p.lodEnabled) {
+                    const __m128 ratio = _mm_div_ps(dist, _mm_mul_ps(radius, lodScale));
+                    lod1Bits = _mm_movemask_ps(_mm_cmpgt_ps(ratio, lod1));
+                    lod2Bits = _mm_movemask_ps(_mm_cmpgt_ps(ratio, lod2));
+                }
+                writeLanes(4, insideBits, smallBits, lod1Bits, lod2Bits, result + i, lod + i);
+            }
+            return i;
+        }
+#endif
+    } // namespace
+
+    void CullBoundsScalar(const CullInput& in, const CullPlanes& planes,
+                          const CullParams& params, uint8_t* result, uint8_t* lod) {
+        for (std::size_t i = 0; i < in.count; ++i) cullOne(in, planes, params, i, result, lod);
+    }
+
+    void CullBounds(const CullInput& in, const CullPlanes& planes,
+                    const CullParams& params, uint8_t* result, uint8_t* lod) {
+        std::size_t done = 0;
+#if defined(CSE_CULL_AVX)
+        done = cullAvx(in, planes, params, result, lod);
+#elif defined(CSE_CULL_SSE2)
+        done = cullSse2(in, planes, params, result, lod);
+#endif
+        for (std::size_t i = done; i < in.count; ++i) cullOne(in, planes, params, i, result, lod);
+    }
+
+    const char* CullBackendName() {
+#if defined(CSE_CULL_AVX)
+        return "avx";
+#elif defined(CSE_CULL_SSE2)
+        return "sse2";
+#else
+        return "scalar";
+#endif
+    }
+
+} // namespace MyCoreEngine
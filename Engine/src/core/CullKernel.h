@@ -0,0 +1,78 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace MyCoreEngine {
+
+    // The per-frame visibility kernel behind Scene::RenderScene: frustum test,
+    // projected-size cull and LOD pick for a batch of world-space bounds, in
+    // one pass over structure-of-arrays input. Knows nothing about entt, glm
+    // or GL, so it can be tested and benchmarked on its own; BoundsCache
+    // owns the arrays it reads.
+    //
+    // CullBounds() runs 8 entities per step with AVX when the build enables
+    // it (/arch:AVX, -mavx), otherwise 4 with SSE2 — the x64 baseline, so
+    // every 64-bit build gets at least that — and plain scalar code elsewhere
+    // and for the tail of a batch. CullBoundsScalar() is that scalar path on
+    // its own; it is the reference the SIMD paths must match exactly, and
+    // they do: the same operations in the same order, no fused multiply-add.
+    //
+    // The tests per entity are the ones RenderScene used to do inline:
+    // - frustum: the world AABB (center + half-extents) is kept when, for
+    //   every plane, -r <= dot(n, c) - d with r = Σ ext·|n| (AABB::isOnFrustum);
+    // - size: dropped when viewportHeight * radius / (dist * tanHalfFov) is
+    //   below minPixels, dist being the camera-to-center distance;
+    // - LOD: ratio = dist / (radius * lodScale), 2 past 60, 1 past 25, else 0.
+
+    enum CullResult : uint8_t {
+        kCullFrustum = 0, // outside a plane
+        kCullSmall = 1,   // inside, but below the projected-size floor
+        kCullVisible = 2,
+    };
+
+    // Six planes, one array per component. Each plane keeps the points
+    // with dot(n, p) - d >= 0 (the same convention as Plane).
+    struct CullPlanes {
+        float nx[6], ny[6], nz[6], d[6];
+    };
+
+    // Planes nothing is outside of: the size cull and LOD pick without a
+    // frustum test (a batch already known to be inside).
+    inline CullPlanes CullPlanesAcceptAll() {
+        CullPlanes p{};
+        for (int k = 0; k < 6; ++k) p.d[k] = -3.0e38f; // dot(0, c) - d is huge for any finite c
+        return p;
+    }
+
+    // Parallel arrays, `count` long: world AABB center and half-extents,
+    // and the bounding-sphere radius used for distance-based decisions.
+    struct CullInput {
+        const float* cx; const float* cy; const float* cz;
+        const float* ex; const float* ey; const float* ez;
+        const float* radius;
+        std::size_t count = 0;
+    };
+
+    struct CullParams {
+        float camX = 0.f, camY = 0.f, camZ = 0.f;
+        bool  screenCull = false;     // projected-size cull on/off
+        float viewportHeightPx = 0.f;
+        float tanHalfFov = 1.f;
+        float minPixels = 0.f;
+        bool  lodEnabled = false;     // off: every LOD is 0
+        float lodDistanceScale = 1.f;
+    };
+
+    // Writes result[i] (a CullResult) and lod[i] for every input. lod is
+    // only meaningful for visible entries.
+    ENGINE_API void CullBounds(const CullInput& in, const CullPlanes& planes,
+                               const CullParams& params, uint8_t* result, uint8_t* lod);
+    ENGINE_API void CullBoundsScalar(const CullInput& in, const CullPlanes& planes,
+                                     const CullParams& params, uint8_t* result, uint8_t* lod);
+
+    // "avx", "sse2" or "scalar": what CullBounds() was compiled to use.
+    ENGINE_API const char* CullBackendName();
+
+} // namespace MyCoreEngine
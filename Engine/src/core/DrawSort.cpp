@@ -0,0 +1,192 @@
+#include "DrawSort.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        constexpr int kLodBits = 2;
+        constexpr int kModeBits = 2; // alpha mode and shading model each
+
+        // splitmix64's finalizer: pointers and FNV hashes both spread well
+        inline uint64_t mix64(uint64_t x) {
+            x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+            x ^= x >> 27; x *= 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+    } // namespace
+
+    void RadixSortKeys(std::vector<SortKey>& keys, std::vector<SortKey>& scratch) {
+        const std::size_t n = keys.size();
+        if (n < 2) return;
+        scratch.resize(n);
+
+        // All eight histograms in one read of the keys.
+        std::size_t hist[8][256] = {};
+        for (const SortKey& k : keys) {
+            for (int d = 0; d < 8; ++d) ++hist[d][(k.key >> (8 * d)) & 0xff];
+        }
+
+        SortKey* src = keys.data();
+        SortKey* dst = scratch.data();
+        for (int d = 0; d < 8; ++d) {
+            std::size_t* h = hist[d];
+            // every key has the same digit here: the pass would be a copy
+            if (h[(src[0].key >> (8 * d)) & 0xff] == n) continue;
+            std::size_t sum = 0;
+            for (int b = 0; b < 256; ++b) {
+                const std::size_t c = h[b];
+                h[b] = sum;
+                sum += c;
+            }
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[h[(src[i].key >> (8 * d)) & 0xff]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+        if (src != keys.data()) std::memcpy(keys.data(), src, n * sizeof(SortKey));
+    }
+
+    uint32_t DepthKey(float depth) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        // negatives: flip everything (larger magnitude sorts first);
+        // positives: set the sign bit so they sort after every negative
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+
+    // --- Ranker -----------------------------------------------------------------
+
+    void DrawSorter::Ranker::clear() {
+        std::fill(slotId.begin(), slotId.end(), ~0u);
+        values.clear();
+    }
+
+    uint32_t DrawSorter::Ranker::intern(uint64_t v) {
+        // open addressing, linear probing, kept at most half full
+        if ((values.size() + 1) * 2 > slotId.size()) {
+            const std::size_t cap = std::max<std::size_t>(64, slotId.size() * 2);
+            slotValue.assign(cap, 0);
+            slotId.assign(cap, ~0u);
+            for (uint32_t id = 0; id < values.size(); ++id) {
+                std::size_t s = mix64(values[id]) & (cap - 1);
+                while (slotId[s] != ~0u) s = (s + 1) & (cap - 1);
+                slotValue[s] = values[id];
+                slotId[s] = id;
+            }
+        }
+        const std::size_t mask = slotId.size() - 1;
+        for (std::size_t s = mix64(v) & mask;; s = (s + 1) & mask) {
+            if (slotId[s] == ~0u) {
+                slotValue[s] = v;
+                slotId[s] = static_cast<uint32_t>(values.size());
+                values.push_back(v);
+                return slotId[s];
+            }
+            if (slotValue[s] == v) return slotId[s];
+        }
+    }
+
+    void DrawSorter::Ranker::rank() {
+        // Few distinct values (materials, meshes), so sorting them is cheap.
+        std::vector<uint32_t> byValue(values.size());
+        std::iota(byValue.begin(), byValue.end(), 0u);
+        std::sort(byValue.begin(), byValue.end(),
+            [&](uint32_t a, uint32_t b) { return values[a] < values[b]; });
+        rankById.resize(values.size());
+        for (uint32_t r = 0; r < byValue.size(); ++r) rankById[byValue[r]] = r;
+    }
+
+    // --- DrawSorter -------------------------------------------------------------
+
+    void DrawSorter::Clear() {
+        alphaMode_.clear(); doubleSided_.clear(); shadingModel_.clear(); lod_.clear();
+        texKey_.clear(); mesh_.clear(); depth_.clear();
+        order_.clear();
+        outOfRange_ = false;
+        fellBack_ = false;
+    }
+
+    void DrawSorter::Add(const DrawKeyFields& f) {
+        alphaMode_.push_back(f.alphaMode);
+        doubleSided_.push_back(f.doubleSided ? 1 : 0);
+        shadingModel_.push_back(f.shadingModel);
+        texKey_.push_back(f.texKey);
+        mesh_.push_back(f.mesh);
+        lod_.push_back(f.lod);
+        depth_.push_back(f.depth);
+        constexpr int kModeMax = (1 << kModeBits) - 1;
+        constexpr int kLodMax = (1 << kLodBits) - 1;
+        if (f.alphaMode < 0 || f.alphaMode > kModeMax ||
+            f.shadingModel < 0 || f.shadingModel > kModeMax ||
+            f.lod < 0 || f.lod > kLodMax) {
+            outOfRange_ = true;
+        }
+    }
+
+    void DrawSorter::Sort() {
+        CSE_PROFILE_ZONE("DrawSorter::Sort");
+        const std::size_t n = Size();
+        fellBack_ = false;
+        order_.resize(n);
+        if (n == 0) return;
+
+        texRanks_.clear();
+        meshRanks_.clear();
+        texId_.resize(n);
+        meshId_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            texId_[i] = texRanks_.intern(texKey_[i]);
+            meshId_[i] = meshRanks_.intern(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(mesh_[i])));
+        }
+        if (outOfRange_ ||
+            texRanks_.values.size() > (std::size_t(1) << kTextureBits) ||
+            meshRanks_.values.size() > (std::size_t(1) << kMeshBits)) {
+            sortByComparison_();
+            return;
+        }
+        texRanks_.rank();
+        meshRanks_.rank();
+
+        constexpr int kLodShift = kDepthBits;
+        constexpr int kMeshShift = kLodShift + kLodBits;
+        constexpr int kTexShift = kMeshShift + kMeshBits;
+        constexpr int kShadingShift = kTexShift + kTextureBits;
+        constexpr int kSidedShift = kShadingShift + kModeBits;
+        constexpr int kAlphaShift = kSidedShift + 1;
+        static_assert(kAlphaShift + kModeBits == 64, "draw key fields must fill 64 bits");
+
+        keys_.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            uint64_t k = uint64_t(alphaMode_[i]) << kAlphaShift;
+            k |= uint64_t(doubleSided_[i]) << kSidedShift;
+            k |= uint64_t(shadingModel_[i]) << kShadingShift;
+            k |= uint64_t(texRanks_.rankById[texId_[i]]) << kTexShift;
+            k |= uint64_t(meshRanks_.rankById[meshId_[i]]) << kMeshShift;
+            k |= uint64_t(lod_[i]) << kLodShift;
+            k |= uint64_t(DepthKey(depth_[i]) >> (32 - kDepthBits));
+            keys_[i] = { k, static_cast<uint32_t>(i) };
+        }
+        RadixSortKeys(keys_, scratch_);
+        for (std::size_t i = 0; i < n; ++i) order_[i] = keys_[i].index;
+    }
+
+    void DrawSorter::sortByComparison_() {
+        fellBack_ = true;
+        std::iota(order_.begin(), order_.end(), 0u);
+        std::stable_sort(order_.begin(), order_.end(), [&](uint32_t a, uint32_t b) {
+            if (alphaMode_[a] != alphaMode_[b]) return alphaMode_[a] < alphaMode_[b];
+            if (doubleSided_[a] != doubleSided_[b]) return doubleSided_[a] < doubleSided_[b];
+            if (shadingModel_[a] != shadingModel_[b]) return shadingModel_[a] < shadingModel_[b];
+            if (texKey_[a] != texKey_[b]) return texKey_[a] < texKey_[b];
+            if (mesh_[a] != mesh_[b]) return reinterpret_cast<uintptr_t>(mesh_[a]) < reinterpret_cast<uintptr_t>(mesh_[b]);
+            if (lod_[a] != lod_[b]) return lod_[a] < lod_[b];
+            return depth_[a] < depth_[b];
+        });
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,105 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Draw-list ordering: every field the opaque pass sorts by, packed into
+    // one 64-bit key, and the keys radix-sorted with the item index riding
+    // along. Knows nothing about GL, glm or entt, so it can be tested and
+    // benchmarked on its own; Scene feeds it the fields of its DrawItems and
+    // walks Order() instead of sorting the items themselves.
+    //
+    //   sorter.Clear();
+    //   for (item : items) sorter.Add(fieldsOf(item));
+    //   sorter.Sort();
+    //   for (uint32_t i : sorter.Order()) draw(items[i]);
+    //
+    // KEY LAYOUT, high bit to low — the same precedence as the comparator
+    // RenderScene used:
+    //
+    //   alpha mode 2 | double-sided 1 | shading model 2 | texture 14 | mesh 16 | LOD 2 | depth 27
+    //
+    // texKey (a 64-bit material hash) and the mesh pointer do not fit, so
+    // Sort() first ranks the distinct values of each in ascending order and
+    // packs the rank. Ranks preserve order, so the sorted sequence is the
+    // comparator's, with one difference: depth keeps its top 27 bits, so
+    // two items closer than about 1/2^18 of their depth tie and stay in
+    // Add() order (the sort is stable; std::sort was not). More distinct
+    // materials or meshes than the fields hold (or a mode or LOD past its
+    // two bits) falls back to a comparison sort of the indices, same order.
+    struct DrawKeyFields {
+        int         alphaMode = 0;     // 0 Opaque, 1 Mask (Blend sorts elsewhere)
+        bool        doubleSided = false;
+        int         shadingModel = 0;  // 0 PBR, 1 Toon
+        uint64_t    texKey = 0;
+        const void* mesh = nullptr;
+        int         lod = 0;
+        float       depth = 0.f;       // ascending: front to back
+    };
+
+    struct SortKey {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Stable ascending LSD radix sort on key, 8 bits per pass; a pass whose
+    // digit is the same for every key is skipped. scratch is resized as
+    // needed and its contents are garbage afterwards.
+    ENGINE_API void RadixSortKeys(std::vector<SortKey>& keys, std::vector<SortKey>& scratch);
+
+    // Order-preserving map of a float onto an unsigned integer
+    // (a < b  <=>  DepthKey(a) < DepthKey(b), for non-NaN values).
+    ENGINE_API uint32_t DepthKey(float depth);
+
+    class ENGINE_API DrawSorter {
+    public:
+        static constexpr int kTextureBits = 14;
+        static constexpr int kMeshBits = 16;
+        static constexpr int kDepthBits = 27;
+
+        void Clear();
+        // The item's index is the number of Add() calls before it.
+        void Add(const DrawKeyFields& f);
+        std::size_t Size() const { return texKey_.size(); }
+
+        void Sort();
+        // Item indices in draw order. Valid until the next Clear().
+        const std::vector<uint32_t>& Order() const { return order_; }
+        // Whether the last Sort() had to fall back to comparisons.
+        bool FellBack() const { return fellBack_; }
+
+    private:
+        // Distinct values, numbered in first-seen order, then ranked in
+        // ascending order of value. Kept across frames for its capacity.
+        struct Ranker {
+            std::vector<uint64_t> slotValue;
+            std::vector<uint32_t> slotId;   // ~0u = empty
+            std::vector<uint64_t> values;   // by id
+            std::vector<uint32_t> rankById;
+            void clear();
+            uint32_t intern(uint64_t v);
+            void rank();
+        };
+
+        void sortByComparison_();
+
+        // The fields, one array each (by item index).
+        std::vector<int> alphaMode_, shadingModel_, lod_;
+        std::vector<uint8_t> doubleSided_;
+        std::vector<uint64_t> texKey_;
+        std::vector<const void*> mesh_;
+        std::vector<float> depth_;
+
+        std::vector<uint32_t> texId_, meshId_;
+        Ranker texRanks_, meshRanks_;
+        std::vector<SortKey> keys_, scratch_;
+        std::vector<uint32_t> order_;
+        bool outOfRange_ = false; // a small field does not fit its bits
+        bool fellBack_ = false;
+    };
+
+} // namespace MyCoreEngine
@@ -1,5 +1,7 @@
 #pragma once
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
 
 namespace MyCoreEngine {
 
@@ -12,15 +14,46 @@ namespace MyCoreEngine {
     // advance() runs the callback once per whole step consumed, capped at
     // maxSteps per call so a long stall can't trigger a spiral of death
     // (sim falling behind -> more steps -> longer frame -> further behind).
-    // When the cap is hit the remaining backlog is dropped.
+    // What happens to the backlog left over when the cap is hit is the
+    // catch-up policy:
+    //
+    // - DropBacklog (the default): the backlog is discarded. Simulated time
+    //   is lost, which after a hitch reads as everything teleporting.
+    // - SpreadBacklog: the backlog is kept and paid off over the following
+    //   frames, still at most maxSteps per frame, so a spike is absorbed as a
+    //   short stretch of slightly faster simulation. The debt itself is
+    //   capped at maxDebtTicks — past that even this policy drops the excess,
+    //   because a machine that can NEVER keep up would otherwise run ever
+    //   further behind real time. That cap is the spiral-of-death guard for
+    //   this policy; maxSteps only bounds a single frame.
+    //
+    // Either way runningBehind() says the last frame ended owing ticks. A
+    // host uses it to shed optional work (a CSM refresh, a UI relayout)
+    // until the simulation catches up.
     class FixedTimestep {
     public:
+        enum class CatchUpPolicy { DropBacklog, SpreadBacklog };
+
+        struct Metrics {
+            int      lastSteps = 0;     // steps the last advance ran
+            int      debtTicks = 0;     // whole steps still owed after it
+            int      peakDebtTicks = 0; // largest debtTicks since reset()
+            int      behindFrames = 0;  // consecutive advances that ended owing
+            uint64_t droppedTicks = 0;  // whole steps discarded since reset()
+        };
+
         explicit FixedTimestep(float stepSeconds = 1.f / 60.f)
             : step_(std::max(kMinStep, stepSeconds)) {}
 
         void setStep(float stepSeconds) { step_ = std::max(kMinStep, stepSeconds); }
         float step() const { return step_; }
 
+        void setCatchUpPolicy(CatchUpPolicy p) { policy_ = p; }
+        CatchUpPolicy catchUpPolicy() const { return policy_; }
+        // SpreadBacklog only: the most whole steps carried into later frames.
+        void setMaxDebtTicks(int ticks) { maxDebtTicks_ = std::max(0, ticks); }
+        int  maxDebtTicks() const { return maxDebtTicks_; }
+
         template <typename Fn>
         int advance(float dt, Fn&& fn, int maxSteps = 8) {
             accumulator_ += std::max(0.f, dt);
@@ -30,22 +63,57 @@ namespace MyCoreEngine {
                 accumulator_ -= step_;
                 ++steps;
             }
-            if (steps == maxSteps && accumulator_ >= step_) {
-                accumulator_ = 0.f; // drop backlog instead of spiraling
+            const bool capped = steps == maxSteps && accumulator_ >= step_;
+            if (capped) {
+                const float keep = (policy_ == CatchUpPolicy::SpreadBacklog)
+                                 ? float(maxDebtTicks_) * step_ : 0.f;
+                if (accumulator_ > keep) {
+                    // droppedTicks counts whole steps either way. SpreadBacklog
+                    // drops only those and keeps the fraction, so alpha() does
+                    // not jump; DropBacklog empties the accumulator, fraction
+                    // included, and alpha() restarts from 0.
+                    const float excess = accumulator_ - keep;
+                    const float whole = std::floor(excess / step_);
+                    metrics_.droppedTicks += (uint64_t)whole;
+                    accumulator_ = (policy_ == CatchUpPolicy::SpreadBacklog)
+                                 ? accumulator_ - whole * step_
+                                 : 0.f; // drop backlog instead of spiraling
+                }
             }
+            metrics_.lastSteps = steps;
+            metrics_.debtTicks = int(accumulator_ / step_);
+            metrics_.peakDebtTicks = std::max(metrics_.peakDebtTicks, metrics_.debtTicks);
+            metrics_.behindFrames = capped ? metrics_.behindFrames + 1 : 0;
             return steps;
         }
 
         // Fraction of a step accumulated but not yet simulated, in [0,1).
-        // A renderer can use this to interpolate between sim states.
-        float alpha() const { return accumulator_ / step_; }
+        // A renderer can use this to interpolate between sim states. Owed
+        // whole steps (SpreadBacklog) are not part of it.
+        float alpha() const {
+            const float a = std::fmod(accumulator_, step_) / step_;
+            return a < 1.f ? a : 0.f;
+        }
 
-        void reset() { accumulator_ = 0.f; }
+        // True when the last advance hit maxSteps with ticks still owed
+        // (carried or dropped, depending on the policy).
+        bool runningBehind() const { return metrics_.behindFrames > 0; }
+        // Whole steps owed right now.
+        int  debtTicks() const { return metrics_.debtTicks; }
+        const Metrics& metrics() const { return metrics_; }
+
+        void reset() {
+            accumulator_ = 0.f;
+            metrics_ = Metrics{};
+        }
 
     private:
         static constexpr float kMinStep = 1e-4f; // 10 kHz ceiling; guards div-by-zero
         float step_;
         float accumulator_ = 0.f;
+        CatchUpPolicy policy_ = CatchUpPolicy::DropBacklog;
+        int maxDebtTicks_ = 30;
+        Metrics metrics_;
     };
 
 } // namespace MyCoreEngine
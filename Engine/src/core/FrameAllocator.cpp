@@ -0,0 +1,190 @@
+#include "FrameAllocator.h"
+
+#include <algorithm>
+
+namespace MyCoreEngine {
+
+namespace {
+
+    std::atomic<uint64_t> g_nextAllocatorId{ 1 };
+
+    // The few allocators a thread talks to (the scene's, a Renderer2D's),
+    // remembered so Local() is a thread_local scan instead of a locked
+    // lookup. An evicted entry just costs the next call one lock.
+    struct LocalCacheEntry {
+        uint64_t id = 0;
+        void* arenas = nullptr;
+    };
+    constexpr unsigned kLocalCacheEntries = 4;
+    thread_local LocalCacheEntry t_cache[kLocalCacheEntries];
+    thread_local unsigned t_cacheNext = 0;
+
+    inline std::size_t alignUp(std::uintptr_t p, std::size_t align) {
+        return (std::size_t)((p + (align - 1)) & ~(std::uintptr_t)(align - 1));
+    }
+
+} // namespace
+
+    // --- LinearArena -------------------------------------------------------
+
+    LinearArena::LinearArena(std::size_t chunkBytes)
+        : chunkBytes_(std::max<std::size_t>(chunkBytes, 256))
+    {
+    }
+
+    bool LinearArena::fitsIn_(std::size_t chunk, std::size_t bytes, std::size_t align) const
+    {
+        const std::uintptr_t base = (std::uintptr_t)chunks_[chunk].mem.get();
+        return alignUp(base, align) - base + bytes <= chunks_[chunk].size;
+    }
+
+    void* LinearArena::allocate(std::size_t bytes, std::size_t align)
+    {
+        if (bytes == 0) bytes = 1;
+        if (cur_ < chunks_.size()) {
+            const std::uintptr_t base = (std::uintptr_t)chunks_[cur_].mem.get();
+            const std::size_t at = alignUp(base + offset_, align) - base;
+            if (at + bytes <= chunks_[cur_].size) {
+                offset_ = at + bytes;
+                return (void*)(base + at);
+            }
+        }
+
+        // Move to the next chunk that fits. Chunks kept from earlier frames
+        // are reused in order; one that is too small for this request is
+        // stepped over (swapped behind the one used) rather than freed, since
+        // the next small request will want it.
+        const std::size_t next = (cur_ < chunks_.size()) ? cur_ + 1 : cur_;
+        std::size_t found = chunks_.size();
+        for (std::size_t i = next; i < chunks_.size(); ++i) {
+            if (fitsIn_(i, bytes, align)) { found = i; break; }
+        }
+        if (found == chunks_.size()) {
+            Chunk c;
+            c.size = std::max(chunkBytes_, bytes + align);
+            c.mem.reset(new unsigned char[c.size]);
+            reserved_ += c.size;
+            chunks_.insert(chunks_.begin() + (std::ptrdiff_t)next, std::move(c));
+        }
+        else if (found != next) {
+            std::swap(chunks_[found], chunks_[next]);
+        }
+        if (cur_ < chunks_.size() && cur_ != next) usedBefore_ += offset_;
+        cur_ = next;
+        offset_ = 0;
+
+        const std::uintptr_t base = (std::uintptr_t)chunks_[cur_].mem.get();
+        const std::size_t at = alignUp(base, align) - base;
+        offset_ = at + bytes;
+        return (void*)(base + at);
+    }
+
+    void LinearArena::deallocate(void* p, std::size_t bytes, uint64_t generation)
+    {
+        if (!p || generation != generation_ || cur_ >= chunks_.size()) return;
+        unsigned char* base = chunks_[cur_].mem.get();
+        unsigned char* q = static_cast<unsigned char*>(p);
+        if (q >= base && q + bytes == base + offset_) offset_ = (std::size_t)(q - base);
+    }
+
+    void LinearArena::reset()
+    {
+        windowPeak_ = std::max(windowPeak_, used());
+        if (++windowFrames_ >= kTrimWindowFrames) {
+            prevWindowPeak_ = windowPeak_;
+            windowPeak_ = 0;
+            windowFrames_ = 0;
+        }
+        trim_();
+        cur_ = 0;
+        offset_ = 0;
+        usedBefore_ = 0;
+        ++generation_;
+    }
+
+    void LinearArena::trim_()
+    {
+        // Release from the back — where a spike's extra chunks were appended —
+        // for as long as what remains still covers the recent peak plus half
+        // again. The headroom is for chunk tails: `used` does not count the
+        // end of a chunk a request skipped, so keeping exactly the peak could
+        // free a chunk every reset and allocate it again the next frame.
+        const std::size_t peak = std::max(windowPeak_, prevWindowPeak_);
+        const std::size_t keep = peak + peak / 2;
+        while (!chunks_.empty() && reserved_ - chunks_.back().size >= keep) {
+            reserved_ -= chunks_.back().size;
+            chunks_.pop_back();
+        }
+    }
+
+    // --- FrameAllocator ----------------------------------------------------
+
+    FrameAllocator::FrameAllocator(std::size_t chunkBytes)
+        : id_(g_nextAllocatorId.fetch_add(1, std::memory_order_relaxed))
+        , chunkBytes_(chunkBytes)
+    {
+    }
+
+    FrameAllocator::~FrameAllocator() = default;
+
+    FrameAllocator::ThreadArenas& FrameAllocator::registerThread_()
+    {
+        const std::thread::id me = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lk(mutex_);
+        // A thread id is reused once its thread has exited, so a recycled
+        // pool adopts its predecessor's (already rewound) arenas instead of
+        // growing the list.
+        for (auto& t : threads_) {
+            if (t->owner == me) return *t;
+        }
+        auto t = std::make_unique<ThreadArenas>();
+        t->owner = me;
+        t->frame[0] = std::make_unique<LinearArena>(chunkBytes_);
+        t->frame[1] = std::make_unique<LinearArena>(chunkBytes_);
+        threads_.push_back(std::move(t));
+        return *threads_.back();
+    }
+
+    LinearArena& FrameAllocator::Local()
+    {
+        ThreadArenas* ta = nullptr;
+        for (const LocalCacheEntry& e : t_cache) {
+            if (e.id == id_) { ta = static_cast<ThreadArenas*>(e.arenas); break; }
+        }
+        if (!ta) {
+            ta = &registerThread_();
+            t_cache[t_cacheNext++ % kLocalCacheEntries] = { id_, ta };
+        }
+        return *ta->frame[current_.load(std::memory_order_acquire)];
+    }
+
+    void FrameAllocator::BeginFrame()
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        // `current_` is the frame that just ended: jobs may still be writing
+        // into it. `other` is the frame before, finished by contract, so it
+        // is the one measured, rewound, and handed out next.
+        const unsigned other = current_.load(std::memory_order_relaxed) ^ 1u;
+        std::size_t used = 0, reserved = 0;
+        for (auto& t : threads_) {
+            LinearArena& a = *t->frame[other];
+            used += a.used();
+            a.reset();
+            t->reservedAtRewind[other] = a.reserved();
+            reserved += t->reservedAtRewind[0] + t->reservedAtRewind[1];
+        }
+        stats_.lastFrameBytes = used;
+        stats_.peakFrameBytes = std::max(stats_.peakFrameBytes, used);
+        stats_.reservedBytes = reserved;
+        stats_.threads = (unsigned)threads_.size();
+        ++stats_.frames;
+        current_.store(other, std::memory_order_release);
+    }
+
+    FrameAllocator::Stats FrameAllocator::stats() const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return stats_;
+    }
+
+} // namespace MyCoreEngine
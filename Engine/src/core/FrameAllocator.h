@@ -0,0 +1,245 @@
+#pragma once
+#include "Core.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Per-frame memory: a bump allocator that is rewound instead of freed,
+    // double-buffered across frames, with one sub-arena per thread.
+    //
+    //   frameMem_.BeginFrame();                               // frame boundary
+    //   items_ = frameMem_.MakeVector<DrawItem>(lastCount);   // this frame's list
+    //
+    // For the lists the renderer rebuilds every frame: Scene's draw items,
+    // runs and instance matrices, the shadow buckets, Renderer2D's quad
+    // commands. They are carved out of chunks that are rewound at the frame
+    // boundary, and chunks nobody needed for kTrimWindowFrames frames are
+    // released, so the footprint follows the RECENT peak, not the all-time
+    // one: a spike frame (a streaming burst, the editor's "select all") does
+    // not set it for the rest of the session.
+    //
+    // DOUBLE-BUFFERED. BeginFrame rewinds the arenas of the frame BEFORE the
+    // one that just ended, not of that frame itself, so anything allocated in
+    // frame N stays readable through frame N+1. That slack is what lets a list
+    // built by one pass be consumed later (RenderScene builds the transparent
+    // list, RenderTransparent draws it after the skybox), and what lets a job
+    // that allocated for frame N still be finishing when frame N+1 begins.
+    //
+    // PER-THREAD. Local() is the CALLING thread's arena for the current frame;
+    // a JobSystem worker gets its own the first time it asks, so building
+    // lists in parallel never shares a bump pointer and never takes a lock
+    // after that first call.
+    //
+    // Contracts:
+    // - BeginFrame is called by the owner, on the thread that owns the frame,
+    //   while no other thread is allocating from the frame it is about to
+    //   rewind (i.e. jobs that allocate frame memory finish within one frame).
+    // - Memory from frame N is invalid after the second BeginFrame that follows
+    //   it. A FrameVector that outlives that is detected (its allocator's
+    //   generation is stale) and must be re-made with MakeVector/Refresh, not
+    //   grown — see Refresh.
+    // - A frame container GROWS only on the thread whose arena it lives in.
+    //   Handing a finished list to another thread to read is fine.
+    // - Nothing is destroyed at rewind: only trivially destructible types
+    //   belong here (Refresh enforces it).
+
+    // A chunked bump allocator. Single-threaded: one owner thread allocates,
+    // and reset() happens while that owner is not allocating.
+    class ENGINE_API LinearArena {
+    public:
+        static constexpr std::size_t kDefaultChunkBytes = 64 * 1024;
+        // Frames (resets) a chunk may go unneeded before it is released.
+        static constexpr unsigned kTrimWindowFrames = 64;
+
+        explicit LinearArena(std::size_t chunkBytes = kDefaultChunkBytes);
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        // Never returns null: a request bigger than the chunk size gets a
+        // chunk of its own. `align` must be a power of two.
+        void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t));
+
+        // Gives the bytes back only when `p` is the most recent allocation
+        // (the common "scratch, then drop it" shape); otherwise a no-op — the
+        // memory comes back at the next reset. Stale pointers (from before the
+        // last reset) are ignored.
+        void deallocate(void* p, std::size_t bytes, uint64_t generation);
+
+        // Rewinds to empty and releases chunks beyond the recent peak.
+        // Invalidates every pointer handed out since the previous reset.
+        void reset();
+
+        // Bumped by every reset: an allocation made under generation G is
+        // valid exactly while generation() == G.
+        uint64_t generation() const { return generation_; }
+
+        std::size_t used() const { return usedBefore_ + offset_; } // bytes handed out since reset
+        std::size_t reserved() const { return reserved_; }         // bytes held in chunks
+
+    private:
+        struct Chunk {
+            std::unique_ptr<unsigned char[]> mem;
+            std::size_t size = 0;
+        };
+        bool fitsIn_(std::size_t chunk, std::size_t bytes, std::size_t align) const;
+        void trim_();
+
+        std::vector<Chunk> chunks_;
+        std::size_t chunkBytes_;
+        std::size_t cur_ = 0;        // chunk being bumped (== chunks_.size() when none)
+        std::size_t offset_ = 0;     // bump offset inside chunks_[cur_]
+        std::size_t usedBefore_ = 0; // bytes consumed in chunks before cur_
+        std::size_t reserved_ = 0;
+        uint64_t generation_ = 1;
+
+        // Peak of the current and the previous trim window: whatever is held
+        // beyond max(both) has gone unneeded for at least a full window.
+        std::size_t windowPeak_ = 0;
+        std::size_t prevWindowPeak_ = 0;
+        unsigned windowFrames_ = 0;
+    };
+
+    // std::allocator-compatible view of a LinearArena, stamped with the
+    // arena's generation so a stale container can be recognised. A default-
+    // constructed adapter (no arena) falls back to the heap, which is what a
+    // FrameVector member holds before its first frame.
+    template <typename T>
+    class FrameStlAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        FrameStlAllocator() noexcept = default;
+        explicit FrameStlAllocator(LinearArena* arena) noexcept
+            : arena_(arena), generation_(arena ? arena->generation() : 0) {}
+        template <typename U>
+        FrameStlAllocator(const FrameStlAllocator<U>& o) noexcept
+            : arena_(o.arena()), generation_(o.generation()) {}
+
+        T* allocate(std::size_t n) {
+            if (!arena_) return static_cast<T*>(::operator new(n * sizeof(T)));
+            return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+        }
+        void deallocate(T* p, std::size_t n) noexcept {
+            if (!arena_) { ::operator delete(p); return; }
+            arena_->deallocate(p, n * sizeof(T), generation_);
+        }
+
+        LinearArena* arena() const noexcept { return arena_; }
+        uint64_t generation() const noexcept { return generation_; }
+        // True while the memory this allocator hands out is still live.
+        bool current() const noexcept { return arena_ && arena_->generation() == generation_; }
+
+        template <typename U>
+        bool operator==(const FrameStlAllocator<U>& o) const noexcept {
+            return arena_ == o.arena() && generation_ == o.generation();
+        }
+        template <typename U>
+        bool operator!=(const FrameStlAllocator<U>& o) const noexcept { return !(*this == o); }
+
+    private:
+        LinearArena* arena_ = nullptr;
+        uint64_t generation_ = 0;
+    };
+
+    template <typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+
+    class ENGINE_API FrameAllocator {
+    public:
+        struct Stats {
+            // Bytes every thread used in the most recently REWOUND frame. One
+            // frame behind on purpose: the frame that just ended may still
+            // have jobs writing to it, the one before may not.
+            std::size_t lastFrameBytes = 0;
+            std::size_t peakFrameBytes = 0; // high-water mark of lastFrameBytes
+            std::size_t reservedBytes = 0;  // held in chunks, both frames, all threads, as of each rewind
+            unsigned    threads = 0;        // threads that have allocated from this allocator
+            uint64_t    frames = 0;         // BeginFrame calls so far
+        };
+
+        explicit FrameAllocator(std::size_t chunkBytes = LinearArena::kDefaultChunkBytes);
+        ~FrameAllocator();
+        FrameAllocator(const FrameAllocator&) = delete;
+        FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+        // The frame boundary: publishes the finished frame's usage to stats()
+        // and rewinds the frame before it (see the contracts above).
+        void BeginFrame();
+
+        // The calling thread's arena for the current frame. Registers the
+        // thread on first use (one mutex acquisition, then a thread_local hit).
+        LinearArena& Local();
+
+        // An empty vector on the calling thread's arena, with room for
+        // `reserve` elements already carved out.
+        template <typename T>
+        FrameVector<T> MakeVector(std::size_t reserve = 0) {
+            FrameVector<T> v{ FrameStlAllocator<T>(&Local()) };
+            if (reserve) v.reserve(reserve);
+            return v;
+        }
+
+        // Per-frame reuse of a member list: cleared in place while its memory
+        // is still this frame's and this thread's, re-made on the current
+        // arena otherwise. Capacity is topped up to `reserve` either way —
+        // pass last frame's size so the list is carved once, not grown by
+        // doubling through the arena. Safe to call on a list another thread
+        // built last time: its old storage is abandoned, never freed here.
+        template <typename T>
+        void Refresh(FrameVector<T>& v, std::size_t reserve = 0) {
+            static_assert(std::is_trivially_destructible<T>::value,
+                          "frame memory is rewound, never destroyed");
+            LinearArena* here = &Local();
+            if (v.get_allocator().arena() == here && v.get_allocator().current()) {
+                v.clear();
+            }
+            else if (v.get_allocator().arena()) {
+                // The old storage is frame memory, possibly in another
+                // thread's arena (the list was built on another worker last
+                // time), and freeing it would move that arena's bump pointer
+                // from this thread. Its generation does not stop that: the
+                // arena keeps it until it is rewound. So the storage is
+                // abandoned instead -- the vector is re-made in place without
+                // its destructor running (the elements are trivial), and the
+                // bytes come back when their arena is rewound.
+                ::new (static_cast<void*>(&v)) FrameVector<T>{ FrameStlAllocator<T>(here) };
+            }
+            else {
+                // heap storage from before the first frame: freed as usual
+                v = FrameVector<T>{ FrameStlAllocator<T>(here) };
+            }
+            if (reserve > v.capacity()) v.reserve(reserve);
+        }
+
+        Stats stats() const;
+
+    private:
+        struct ThreadArenas {
+            std::thread::id owner;
+            std::unique_ptr<LinearArena> frame[2];
+            std::size_t reservedAtRewind[2] = { 0, 0 };
+        };
+        ThreadArenas& registerThread_();
+
+        const uint64_t id_;           // never reused, so a thread's cache cannot alias a dead allocator
+        const std::size_t chunkBytes_;
+        mutable std::mutex mutex_;    // threads_ membership and stats
+        std::vector<std::unique_ptr<ThreadArenas>> threads_;
+        std::atomic<unsigned> current_{ 0 }; // 0/1; written by BeginFrame only
+        Stats stats_;
+    };
+
+} // namespace MyCoreEngine
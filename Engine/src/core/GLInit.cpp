@@ -2,6 +2,18 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cstring>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
 namespace MyCoreEngine {
 	bool EnsureGLADLoaded() {
 		static bool s_loaded = false;
@@ -11,4 +23,118 @@ namespace MyCoreEngine {
 		}
 		return s_loaded;
 	}
-}
\ No newline at end of file
+
+	namespace {
+		// Not in the 3.3 loader: fetched by hand when the context has it.
+		typedef void (APIENTRYP MultiDrawElementsIndirectProc)(GLenum mode, GLenum type,
+			const void* indirect, GLsizei drawcount, GLsizei stride);
+		typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size,
+			const void* data, GLbitfield flags);
+		typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+		typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize,
+			GLsizei* length, GLenum* binaryFormat, void* binary);
+		typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat,
+			const void* binary, GLsizei length);
+
+		struct CapsState {
+			GLFWwindow* context = nullptr;
+			GLCaps caps;
+			MultiDrawElementsIndirectProc multiDrawElementsIndirect = nullptr;
+			BufferStorageProc bufferStorage = nullptr;
+			ProgramParameteriProc programParameteri = nullptr;
+			GetProgramBinaryProc getProgramBinary = nullptr;
+			ProgramBinaryProc programBinary = nullptr;
+		};
+		CapsState s_caps;
+
+		bool hasExtension(const char* name) {
+			GLint n = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+			for (GLint i = 0; i < n; ++i) {
+				const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+				if (ext && std::strcmp(ext, name) == 0) return true;
+			}
+			return false;
+		}
+	}
+
+	const GLCaps& GetGLCaps() {
+		GLFWwindow* ctx = glfwGetCurrentContext();
+		if (ctx && ctx != s_caps.context && EnsureGLADLoaded()) {
+			s_caps = CapsState{};
+			s_caps.context = ctx;
+
+			GLint major = 0, minor = 0;
+			glGetIntegerv(GL_MAJOR_VERSION, &major);
+			glGetIntegerv(GL_MINOR_VERSION, &minor);
+			const bool core43 = major > 4 || (major == 4 && minor >= 3);
+			if (core43 || (hasExtension("GL_ARB_multi_draw_indirect") &&
+			               hasExtension("GL_ARB_base_instance"))) {
+				// the ARB extension shares the core name (no suffix)
+				s_caps.multiDrawElementsIndirect = reinterpret_cast<MultiDrawElementsIndirectProc>(
+					glfwGetProcAddress("glMultiDrawElementsIndirect"));
+				s_caps.caps.multiDrawIndirect = s_caps.multiDrawElementsIndirect != nullptr;
+			}
+			const bool core44 = major > 4 || (major == 4 && minor >= 4);
+			if (core44 || hasExtension("GL_ARB_buffer_storage")) {
+				s_caps.bufferStorage = reinterpret_cast<BufferStorageProc>(
+					glfwGetProcAddress("glBufferStorage"));
+				s_caps.caps.bufferStorage = s_caps.bufferStorage != nullptr;
+			}
+			{
+				GLint bits = 0;
+				glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+				s_caps.caps.timerQuery = bits > 0;
+			}
+			const bool core41 = major > 4 || (major == 4 && minor >= 1);
+			if (core41 || hasExtension("GL_ARB_get_program_binary")) {
+				// a driver may offer the entry points and no format to use them with
+				GLint formats = 0;
+				glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+				s_caps.programParameteri = reinterpret_cast<ProgramParameteriProc>(
+					glfwGetProcAddress("glProgramParameteri"));
+				s_caps.getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(
+					glfwGetProcAddress("glGetProgramBinary"));
+				s_caps.programBinary = reinterpret_cast<ProgramBinaryProc>(
+					glfwGetProcAddress("glProgramBinary"));
+				s_caps.caps.programBinary = formats > 0 && s_caps.programParameteri &&
+					s_caps.getProgramBinary && s_caps.programBinary;
+			}
+		}
+		return s_caps.caps;
+	}
+
+	void MultiDrawElementsIndirect(std::size_t byteOffset, int drawCount) {
+		s_caps.multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+			reinterpret_cast<const void*>(byteOffset), drawCount, 0);
+	}
+
+	void BufferStorage(unsigned target, std::size_t bytes, unsigned flags) {
+		s_caps.bufferStorage(target, static_cast<GLsizeiptr>(bytes), nullptr, flags);
+	}
+
+	void ProgramBinaryRetrievable(unsigned program) {
+		s_caps.programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	bool GetProgramBinary(unsigned program, std::vector<uint8_t>& binary, unsigned& format) {
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return false;
+		binary.resize(static_cast<std::size_t>(length));
+		GLsizei written = 0;
+		GLenum fmt = 0;
+		s_caps.getProgramBinary(program, length, &written, &fmt, binary.data());
+		binary.resize(static_cast<std::size_t>(written));
+		format = fmt;
+		return written > 0;
+	}
+
+	bool ProgramBinary(unsigned program, unsigned format, const void* binary, std::size_t bytes) {
+		// a refused binary (new driver, other GPU) leaves the program unlinked
+		s_caps.programBinary(program, format, binary, static_cast<GLsizei>(bytes));
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		return linked == GL_TRUE;
+	}
+}
@@ -1,8 +1,58 @@
 #pragma once
 #include "Core.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 namespace MyCoreEngine {
 	// Call this once per process AFTER a GL context is current on the calling thread.
 	// Returns true if GLAD is initialized in the Engine module.
 	ENGINE_API bool EnsureGLADLoaded();
-}
\ No newline at end of file
+
+	// What the current context offers beyond the 3.3 core the engine targets.
+	// Queried the first time it is asked for under each context (main thread,
+	// context current); everything stays false without one.
+	struct GLCaps {
+		// glMultiDrawElementsIndirect with a per-command baseInstance: GL 4.3,
+		// or ARB_multi_draw_indirect + ARB_base_instance.
+		bool multiDrawIndirect = false;
+		// glBufferStorage with persistent, coherent mapping: GL 4.4, or
+		// ARB_buffer_storage.
+		bool bufferStorage = false;
+		// glGetProgramBinary / glProgramBinary with at least one binary
+		// format: GL 4.1, or ARB_get_program_binary.
+		bool programBinary = false;
+		// GL_TIME_ELAPSED queries that actually count: core in 3.3, but a
+		// driver may report zero counter bits (some virtual GPUs do).
+		bool timerQuery = false;
+	};
+	ENGINE_API const GLCaps& GetGLCaps();
+
+	// One draw in a GL_DRAW_INDIRECT_BUFFER, in the layout GL reads.
+	struct DrawElementsIndirectCommand {
+		uint32_t count;         // indices
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t  baseVertex;
+		uint32_t baseInstance;  // offsets divisor-1 attribute fetches
+	};
+
+	// glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT) over drawCount
+	// tightly packed commands at byteOffset in the bound GL_DRAW_INDIRECT_BUFFER.
+	// Only valid when GetGLCaps().multiDrawIndirect.
+	ENGINE_API void MultiDrawElementsIndirect(std::size_t byteOffset, int drawCount);
+
+	// glBufferStorage(target, bytes, nullptr, flags): immutable storage for
+	// the buffer bound to target. Only valid when GetGLCaps().bufferStorage.
+	ENGINE_API void BufferStorage(unsigned target, std::size_t bytes, unsigned flags);
+
+	// glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE):
+	// asked before linking a program whose binary will be read back.
+	// The three below are only valid when GetGLCaps().programBinary.
+	ENGINE_API void ProgramBinaryRetrievable(unsigned program);
+	// The linked program's binary and its format; false if the driver has none.
+	ENGINE_API bool GetProgramBinary(unsigned program, std::vector<uint8_t>& binary, unsigned& format);
+	// glProgramBinary; true when the driver accepted it and the program linked.
+	ENGINE_API bool ProgramBinary(unsigned program, unsigned format, const void* binary, std::size_t bytes);
+}
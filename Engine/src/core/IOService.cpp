@@ -0,0 +1,414 @@
+#include "IOService.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CSE_IO_PREAD 1
+#else
+#include <fstream>
+#define CSE_IO_PREAD 0
+#endif
+
+namespace MyCoreEngine {
+
+namespace {
+
+    IOBlobPtr failedBlob(std::string why) {
+        auto b = std::make_shared<IOBlob>();
+        b->error = std::move(why);
+        return b;
+    }
+
+    // What a model import opens next to the model file: stb's image formats
+    // for textures, OBJ's .mtl, glTF's external buffers.
+    bool isSiblingWorthReading(const std::filesystem::path& p) {
+        std::string ext = p.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        static const char* const kExts[] = {
+            ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif", ".hdr",
+            ".pic", ".pgm", ".ppm", ".mtl", ".bin",
+        };
+        for (const char* e : kExts) {
+            if (ext == e) return true;
+        }
+        return false;
+    }
+
+    // A model directory with hundreds of files is a texture library, not a
+    // model's own files: read-ahead stops here rather than reading it all.
+    constexpr std::size_t kMaxSiblings = 64;
+
+} // namespace
+
+    // --- IORequest ---------------------------------------------------------
+
+    bool IORequest::ready() const
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        return blob_ != nullptr;
+    }
+
+    IOBlobPtr IORequest::wait() const
+    {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&] { return blob_ != nullptr; });
+        return blob_;
+    }
+
+    void IORequest::publish_(IOBlobPtr blob)
+    {
+        {
+            std::lock_guard<std::mutex> lk(m_);
+            blob_ = std::move(blob);
+        }
+        cv_.notify_all();
+    }
+
+    // --- IOService ---------------------------------------------------------
+
+    IOService::IOService(std::size_t queueCapacity, std::size_t readAheadBudgetBytes)
+        : capacity_(std::max<std::size_t>(queueCapacity, 2))
+        , budget_(readAheadBudgetBytes)
+    {
+        thread_ = std::thread([this] { ioLoop_(); });
+    }
+
+    IOService::~IOService()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            stopping_ = true;
+        }
+        workCv_.notify_all();
+        spaceCv_.notify_all();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    std::string IOService::key_(const std::string& path)
+    {
+        // Coalescing is by FILE, so "a/./b.png" and "a\\b.png" must meet.
+        std::string p = path;
+        std::replace(p.begin(), p.end(), '\\', '/');
+        return std::filesystem::path(p).lexically_normal().generic_string();
+    }
+
+    IOTicket IOService::Read(const std::string& path, Callback onDone)
+    {
+        const std::string key = key_(path);
+        std::unique_lock<std::mutex> lk(mutex_);
+        for (;;) {
+            if (stopping_) {
+                lk.unlock();
+                auto req = std::make_shared<IORequest>();
+                req->path_ = key;
+                req->publish_(failedBlob("I/O service is shutting down"));
+                return req;
+            }
+
+            // Read ahead and nobody has claimed it yet: take it.
+            if (auto it = resident_.find(key); it != resident_.end()) {
+                IOBlobPtr blob = std::move(it->second);
+                resident_.erase(it);
+                residentOrder_.erase(std::find(residentOrder_.begin(), residentOrder_.end(), key));
+                stats_.residentBytes -= blob->bytes.size();
+                ++stats_.readAheadHits;
+                lk.unlock();
+                auto req = std::make_shared<IORequest>();
+                req->path_ = key;
+                req->publish_(blob);
+                if (onDone) onDone(blob);
+                return req;
+            }
+
+            // Queued or being read: join it. A read-ahead that a Read now
+            // wants jumps the hint queue (a duplicate entry in demand_; the
+            // I/O thread skips whichever of the two it meets second).
+            if (auto it = inFlight_.find(key); it != inFlight_.end()) {
+                IOTicket req = it->second;
+                if (!req->demanded_) {
+                    req->demanded_ = true;
+                    ++stats_.readAheadHits;
+                    if (!req->started_) {
+                        demand_.push_back(Job{ Kind::Read, req, {}, {} });
+                        workCv_.notify_one();
+                    }
+                }
+                else {
+                    ++stats_.coalesced;
+                }
+                if (onDone) req->callbacks_.push_back(std::move(onDone));
+                return req;
+            }
+
+            const std::size_t pending = demand_.size() + ahead_.size();
+            if (pending < capacity_ || onIOThread_()) break;
+            ++stats_.queueFullWaits;
+            spaceCv_.wait(lk, [&] {
+                return stopping_ || demand_.size() + ahead_.size() < capacity_;
+            });
+            // Re-check everything: the path may have been queued (or read
+            // ahead) by someone else while this caller waited.
+        }
+
+        auto req = std::make_shared<IORequest>();
+        req->path_ = key;
+        req->demanded_ = true;
+        if (onDone) req->callbacks_.push_back(std::move(onDone));
+        inFlight_.emplace(key, req);
+        demand_.push_back(Job{ Kind::Read, req, {}, {} });
+        stats_.queuePeak = std::max(stats_.queuePeak, demand_.size() + ahead_.size());
+        workCv_.notify_one();
+        return req;
+    }
+
+    bool IOService::queueReadAhead_(const std::string& key)
+    {
+        if (stopping_ || resident_.count(key) || inFlight_.count(key)) return false;
+        if (demand_.size() + ahead_.size() >= capacity_ / 2) {
+            ++stats_.readAheadDropped;
+            return false;
+        }
+        auto req = std::make_shared<IORequest>();
+        req->path_ = key;
+        inFlight_.emplace(key, req);
+        ahead_.push_back(Job{ Kind::Read, std::move(req), {}, {} });
+        ++stats_.readAheadIssued;
+        stats_.queuePeak = std::max(stats_.queuePeak, demand_.size() + ahead_.size());
+        workCv_.notify_one();
+        return true;
+    }
+
+    void IOService::ReadAhead(const std::string& path)
+    {
+        const std::string key = key_(path);
+        std::lock_guard<std::mutex> lk(mutex_);
+        queueReadAhead_(key);
+    }
+
+    void IOService::ReadAheadSiblings(const std::string& modelPath)
+    {
+        const std::filesystem::path p(key_(modelPath));
+        std::string dir = p.parent_path().generic_string();
+        if (dir.empty()) dir = ".";
+
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (stopping_) return;
+        if (demand_.size() + ahead_.size() >= capacity_ / 2) {
+            ++stats_.readAheadDropped;
+            return;
+        }
+        ahead_.push_back(Job{ Kind::ListSiblings, nullptr, std::move(dir), p.filename().string() });
+        workCv_.notify_one();
+    }
+
+    void IOService::waitIdle()
+    {
+        std::unique_lock<std::mutex> lk(mutex_);
+        idleCv_.wait(lk, [&] { return demand_.empty() && ahead_.empty() && !busy_; });
+    }
+
+    IOService::Stats IOService::stats() const
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return stats_;
+    }
+
+    void IOService::evictOver_(std::size_t budget)
+    {
+        while (stats_.residentBytes > budget && !residentOrder_.empty()) {
+            auto it = resident_.find(residentOrder_.front());
+            stats_.residentBytes -= it->second->bytes.size();
+            resident_.erase(it);
+            residentOrder_.pop_front();
+            ++stats_.readAheadEvicted;
+        }
+    }
+
+    void IOService::ioLoop_()
+    {
+        CSE_PROFILE_THREAD("IOService");
+        std::unique_lock<std::mutex> lk(mutex_);
+        for (;;) {
+            workCv_.wait(lk, [&] { return stopping_ || !demand_.empty() || !ahead_.empty(); });
+            if (stopping_) break;
+
+            std::deque<Job>& from = !demand_.empty() ? demand_ : ahead_;
+            Job job = std::move(from.front());
+            from.pop_front();
+            spaceCv_.notify_all();
+
+            const bool skip = job.kind == Kind::Read && job.req->started_;
+            if (!skip) {
+                if (job.kind == Kind::Read) job.req->started_ = true;
+                busy_ = true;
+                lk.unlock();
+                if (job.kind == Kind::Read) runRead_(job.req);
+                else listSiblings_(job.dir, job.skipName);
+                lk.lock();
+                busy_ = false;
+            }
+            if (demand_.empty() && ahead_.empty()) idleCv_.notify_all();
+        }
+
+        // Shutdown: nothing queued will be read. Waiters wake with a failure
+        // (a decode blocked in wait() must not hang the join); callbacks do
+        // NOT run — like unpumped JobSystem completions, whatever they would
+        // have handed work to may already be gone.
+        std::vector<IOTicket> dropped;
+        for (std::deque<Job>* q : { &demand_, &ahead_ }) {
+            for (Job& j : *q) {
+                if (j.kind == Kind::Read && !j.req->started_) {
+                    j.req->started_ = true;
+                    j.req->callbacks_.clear();
+                    dropped.push_back(std::move(j.req));
+                }
+            }
+            q->clear();
+        }
+        inFlight_.clear();
+        lk.unlock();
+        for (const IOTicket& r : dropped) r->publish_(failedBlob("I/O service shut down before the read"));
+        idleCv_.notify_all();
+    }
+
+    void IOService::runRead_(const IOTicket& req)
+    {
+        CSE_PROFILE_ZONE("IOService::read");
+        IOBlobPtr blob = std::make_shared<const IOBlob>(readFile_(req->path_));
+
+        std::vector<Callback> callbacks;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            ++stats_.reads;
+            stats_.bytesRead += blob->bytes.size();
+            inFlight_.erase(req->path_);
+            callbacks.swap(req->callbacks_);
+            // Nobody asked for it yet: hold it for the Read that read-ahead
+            // is betting on, within the budget.
+            if (!req->demanded_ && blob->ok) {
+                resident_[req->path_] = blob;
+                residentOrder_.push_back(req->path_);
+                stats_.residentBytes += blob->bytes.size();
+                evictOver_(budget_);
+            }
+        }
+        req->publish_(blob);
+        for (Callback& cb : callbacks) {
+            // A throwing callback must not take the I/O thread down with it:
+            // every later read would then wait forever.
+            try { cb(blob); }
+            catch (const std::exception& e) {
+                std::fprintf(stderr, "[IOService] callback for '%s' threw: %s\n",
+                             req->path_.c_str(), e.what());
+            }
+            catch (...) {
+                std::fprintf(stderr, "[IOService] callback for '%s' threw\n", req->path_.c_str());
+            }
+        }
+    }
+
+    void IOService::listSiblings_(const std::string& dir, const std::string& skipName)
+    {
+        CSE_PROFILE_ZONE("IOService::listSiblings");
+        namespace fs = std::filesystem;
+        std::vector<std::string> found;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            const fs::path& p = it->path();
+            if (p.filename() == skipName || !isSiblingWorthReading(p)) continue;
+            std::error_code sec;
+            if (!it->is_regular_file(sec)) continue;
+            // one file bigger than a quarter of the budget would just evict
+            // the rest of the model's files on arrival
+            const std::uintmax_t size = it->file_size(sec);
+            if (sec || size > budget_ / 4) continue;
+            found.push_back(key_(p.string()));
+            if (found.size() == kMaxSiblings) break;
+        }
+        // Directory order is arbitrary; name order at least makes two runs
+        // of the same boot read the same files.
+        std::sort(found.begin(), found.end());
+
+        std::lock_guard<std::mutex> lk(mutex_);
+        for (const std::string& key : found) queueReadAhead_(key);
+    }
+
+    IOBlob IOService::readFile_(const std::string& path)
+    {
+        IOBlob b;
+#if CSE_IO_PREAD
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            b.error = std::strerror(errno); // only ever called on the I/O thread
+            return b;
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            b.error = "not a regular file";
+            return b;
+        }
+        if ((std::uint64_t)st.st_size > kMaxFileBytes) {
+            ::close(fd);
+            b.error = "file is larger than the I/O service's cap";
+            return b;
+        }
+        b.bytes.resize((std::size_t)st.st_size);
+        std::size_t done = 0;
+        while (done < b.bytes.size()) {
+            const ssize_t n = ::pread(fd, b.bytes.data() + done, b.bytes.size() - done, (off_t)done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                b.error = std::strerror(errno);
+                break;
+            }
+            if (n == 0) break; // truncated under us: keep what is there
+            done += (std::size_t)n;
+        }
+        ::close(fd);
+        if (!b.error.empty()) {
+            b.bytes.clear();
+            return b;
+        }
+        b.bytes.resize(done);
+#else
+        std::error_code ec;
+        const std::uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec) {
+            b.error = ec.message();
+            return b;
+        }
+        if (size > kMaxFileBytes) {
+            b.error = "file is larger than the I/O service's cap";
+            return b;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            b.error = "cannot be opened for reading";
+            return b;
+        }
+        b.bytes.resize((std::size_t)size);
+        in.read(reinterpret_cast<char*>(b.bytes.data()), (std::streamsize)b.bytes.size());
+        b.bytes.resize((std::size_t)in.gcount());
+        if (in.bad()) {
+            b.bytes.clear();
+            b.error = "read failed";
+            return b;
+        }
+#endif
+        b.ok = true;
+        return b;
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,194 @@
+#pragma once
+#include "Core.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // A whole file, read into memory. Immutable once published, so one blob
+    // is shared by every request that coalesced onto the read.
+    struct IOBlob {
+        std::vector<unsigned char> bytes;
+        bool ok = false;
+        std::string error; // why not, when !ok
+    };
+    using IOBlobPtr = std::shared_ptr<const IOBlob>;
+
+    class IOService;
+
+    // One pending (or finished) read. Every Read of the same path while it
+    // is queued or in progress gets the SAME request.
+    class ENGINE_API IORequest {
+    public:
+        const std::string& path() const { return path_; }
+        bool ready() const;
+        // Blocks until the bytes (or the error) are in. Never call it on the
+        // I/O thread, i.e. from a Read callback.
+        IOBlobPtr wait() const;
+
+    private:
+        friend class IOService;
+        void publish_(IOBlobPtr blob);
+
+        std::string path_;
+        mutable std::mutex m_;
+        mutable std::condition_variable cv_;
+        IOBlobPtr blob_;
+
+        // guarded by the owning IOService's mutex
+        std::vector<std::function<void(const IOBlobPtr&)>> callbacks_;
+        bool demanded_ = false; // a Read wants it, not only read-ahead
+        bool started_ = false;  // the I/O thread has picked it up
+    };
+    using IOTicket = std::shared_ptr<IORequest>;
+
+    // The engine's file reader: one dedicated I/O thread in front of a
+    // bounded request queue.
+    //
+    //   io.ReadAheadSiblings(path);                 // warm the model's directory
+    //   io.Read(path, [&jobs](const IOBlobPtr& b) {  // I/O thread
+    //       jobs.submit([b] { Decode(b->bytes); }, ...);
+    //   });
+    //
+    // The disk is this one thread's job. Decode work is submitted once its
+    // bytes are in memory, so a JobSystem worker never blocks in the kernel
+    // on a cold load, and the files a model is about to ask for are already
+    // being read while its mesh is still parsing.
+    //
+    // COALESCING. A Read of a path that is already queued or being read
+    // joins that request: one disk read, one blob, every caller's callback.
+    // A Read that finds the path in the read-ahead set takes those bytes
+    // instead of touching the disk.
+    //
+    // READ-AHEAD is a hint, never a promise. ReadAhead/ReadAheadSiblings
+    // queue behind every demand Read, are dropped outright when the queue is
+    // half full, and what they read is held only up to kReadAheadBudgetBytes
+    // (oldest dropped first) until a Read claims it. A claimed blob leaves
+    // the set: the service caches nothing a caller has already been given.
+    //
+    // BOUNDED. At most `queueCapacity` requests wait for the I/O thread. A
+    // Read past that blocks its caller until there is room — backpressure on
+    // whoever is flooding the queue, instead of an unbounded list of paths.
+    // Callbacks issuing further Reads (on the I/O thread) are exempt, since
+    // nothing else would ever make room for them.
+    //
+    // Threading:
+    // - Read / ReadAhead / ReadAheadSiblings / stats are safe from any thread.
+    // - A Read callback runs ON THE I/O THREAD, or inline on the calling
+    //   thread when the bytes were already resident. Keep it short (hand off
+    //   to the JobSystem); it must not wait() on another read.
+    // - The destructor fails everything still queued, finishes the read in
+    //   progress, and joins. A queued read is DISCARDED: a wait() on it wakes
+    //   with ok=false, but its callbacks never run, because what they would
+    //   hand work to may already be gone. A caller that only learns of
+    //   completion through a callback hears nothing, so it must either
+    //   outlive the service's work (waitIdle() first) or keep the ticket and
+    //   wait() on it.
+    //
+    // Backend: open + pread into a buffer sized by fstat on POSIX, a binary
+    // ifstream elsewhere — one whole file per request, sequentially. That is
+    // the seam an io_uring (or overlapped-I/O) backend would replace by
+    // keeping several of the queue's reads in flight at once.
+    class ENGINE_API IOService {
+    public:
+        using Callback = std::function<void(const IOBlobPtr&)>;
+
+        struct Stats {
+            uint64_t    reads = 0;            // files read from disk
+            uint64_t    bytesRead = 0;
+            uint64_t    coalesced = 0;        // Reads that joined a queued/in-progress read
+            uint64_t    readAheadIssued = 0;  // read-ahead files queued
+            uint64_t    readAheadHits = 0;    // Reads served from (or joined) read-ahead
+            uint64_t    readAheadDropped = 0; // hints refused: queue too busy
+            uint64_t    readAheadEvicted = 0; // read ahead, then dropped unclaimed
+            uint64_t    queueFullWaits = 0;   // Reads that blocked on a full queue
+            std::size_t queuePeak = 0;        // most requests waiting at once
+            std::size_t residentBytes = 0;    // read-ahead bytes held right now
+        };
+
+        static constexpr std::size_t kDefaultQueueCapacity = 256;
+        static constexpr std::size_t kReadAheadBudgetBytes = 64u * 1024 * 1024;
+        // Files bigger than this are never read whole (a corrupt size, a
+        // stray video): the read fails instead of allocating.
+        static constexpr std::size_t kMaxFileBytes = std::size_t(1) << 30;
+
+        explicit IOService(std::size_t queueCapacity = kDefaultQueueCapacity,
+                           std::size_t readAheadBudgetBytes = kReadAheadBudgetBytes);
+        ~IOService();
+
+        IOService(const IOService&) = delete;
+        IOService& operator=(const IOService&) = delete;
+
+        // Queue a whole-file read. `onDone` (optional) gets the blob — see
+        // the threading notes above for where it runs, and for the reads a
+        // shutdown discards without calling it.
+        IOTicket Read(const std::string& path, Callback onDone = {});
+
+        // Read(path)->wait(), for code that is about to block on the bytes
+        // anyway (a decode job asking for a texture read-ahead already has).
+        IOBlobPtr ReadNow(const std::string& path) { return Read(path)->wait(); }
+
+        // Hint: `path` will probably be Read soon.
+        void ReadAhead(const std::string& path);
+
+        // Hint: the files next to `modelPath` that a model import asks for —
+        // textures, .mtl, .bin — will probably be Read soon. The directory
+        // is listed on the I/O thread, not the caller's.
+        void ReadAheadSiblings(const std::string& modelPath);
+
+        // Blocks until nothing is queued or being read and every callback
+        // has returned. Shutdown/test aid; never call it from a callback.
+        void waitIdle();
+
+        Stats stats() const;
+
+    private:
+        enum class Kind { Read, ListSiblings };
+        struct Job {
+            Kind kind = Kind::Read;
+            IOTicket req;          // Kind::Read
+            std::string dir;       // Kind::ListSiblings
+            std::string skipName;  // the model file itself
+        };
+
+        static std::string key_(const std::string& path);
+        static IOBlob readFile_(const std::string& path);
+
+        void ioLoop_();
+        void runRead_(const IOTicket& req);
+        void listSiblings_(const std::string& dir, const std::string& skipName);
+        bool queueReadAhead_(const std::string& key); // mutex_ held
+        void evictOver_(std::size_t budget);          // mutex_ held
+        bool onIOThread_() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+        const std::size_t capacity_;
+        const std::size_t budget_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable workCv_;  // I/O thread waits for jobs
+        std::condition_variable spaceCv_; // full-queue Reads wait for room
+        std::condition_variable idleCv_;  // waitIdle
+        std::deque<Job> demand_;          // Reads: always served first
+        std::deque<Job> ahead_;           // read-ahead hints
+        std::unordered_map<std::string, IOTicket> inFlight_; // queued or being read
+        // Read-ahead results nobody has claimed yet, oldest first.
+        std::unordered_map<std::string, IOBlobPtr> resident_;
+        std::deque<std::string> residentOrder_;
+        bool busy_ = false; // the I/O thread is working on a job
+        bool stopping_ = false;
+        Stats stats_;
+
+        std::thread thread_; // last: starts once everything above exists
+    };
+
+} // namespace MyCoreEngine
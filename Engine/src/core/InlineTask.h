@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace MyCoreEngine {
+
+    // A move-only `void()` callable with inline storage — the JobSystem's
+    // job and completion type.
+    //
+    // WHY NOT std::function. Every job used to carry two of them, and the
+    // engine's real closures (AssetManager's decode captures a path string
+    // and three shared_ptrs, ~72 bytes) are past every standard library's
+    // small-object buffer (16 bytes on MSVC and libstdc++), so each submit
+    // cost two heap allocations on top of the deque node. A validator run
+    // over a few hundred models is a few hundred of those; tens of
+    // thousands of tiny parallel jobs made the allocator the contended
+    // lock instead of the queue.
+    //
+    // kInlineBytes covers every closure the engine submits today. A bigger
+    // one (or one whose move can throw) still works — it falls back to ONE
+    // heap allocation, the same cost std::function always paid — so this
+    // never refuses a callable, it only stops charging the common case.
+    //
+    // Move-only on purpose: a job runs exactly once, and copying a closure
+    // that owns a shared_ptr to its decode state is how two completions end
+    // up finalizing the same model.
+    class InlineTask {
+    public:
+        static constexpr std::size_t kInlineBytes = 80;
+
+        InlineTask() noexcept = default;
+        InlineTask(std::nullptr_t) noexcept {}
+
+        // An EMPTY std::function stays empty. Without this overload it would
+        // be wrapped like any other callable, test as non-empty, and throw
+        // bad_function_call on the worker — the old `Completion onComplete =
+        // {}` idiom spelled with a std::function must keep meaning "none".
+        InlineTask(std::function<void()> f) {
+            if (f) emplace_(std::move(f));
+        }
+
+        template <typename F,
+                  typename D = std::decay_t<F>,
+                  typename = std::enable_if_t<!std::is_same<D, InlineTask>::value &&
+                                              !std::is_same<D, std::function<void()>>::value &&
+                                              std::is_invocable_r<void, D&>::value>>
+        InlineTask(F&& f) {
+            emplace_(std::forward<F>(f));
+        }
+
+        InlineTask(InlineTask&& o) noexcept { moveFrom_(o); }
+        InlineTask& operator=(InlineTask&& o) noexcept {
+            if (this != &o) {
+                reset();
+                moveFrom_(o);
+            }
+            return *this;
+        }
+        InlineTask(const InlineTask&) = delete;
+        InlineTask& operator=(const InlineTask&) = delete;
+
+        ~InlineTask() { reset(); }
+
+        explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+        void operator()() { ops_->invoke(storage_()); }
+
+        // Destroys the held closure (and whatever it owns) now rather than
+        // when the slot is reused — a finished job must not keep its decode
+        // state alive while it waits in the completion queue.
+        void reset() noexcept {
+            if (ops_) {
+                ops_->destroy(storage_());
+                ops_ = nullptr;
+            }
+        }
+
+    private:
+        struct Ops {
+            void (*invoke)(void* self);
+            void (*moveTo)(void* from, void* to) noexcept; // leaves `from` destroyed
+            void (*destroy)(void* self) noexcept;
+        };
+
+        // Stored inline when it fits, is suitably aligned, and moves without
+        // throwing (the queue relocates tasks inside noexcept moves).
+        template <typename D>
+        static constexpr bool fitsInline_ =
+            sizeof(D) <= kInlineBytes &&
+            alignof(D) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible<D>::value;
+
+        template <typename D>
+        static const Ops* inlineOps_() {
+            static const Ops ops = {
+                [](void* self) { (*static_cast<D*>(self))(); },
+                [](void* from, void* to) noexcept {
+                    D* f = static_cast<D*>(from);
+                    ::new (to) D(std::move(*f));
+                    f->~D();
+                },
+                [](void* self) noexcept { static_cast<D*>(self)->~D(); },
+            };
+            return &ops;
+        }
+
+        // Heap fallback: the inline bytes hold a single D*.
+        template <typename D>
+        static const Ops* heapOps_() {
+            static const Ops ops = {
+                [](void* self) { (**static_cast<D**>(self))(); },
+                [](void* from, void* to) noexcept {
+                    *static_cast<D**>(to) = *static_cast<D**>(from);
+                },
+                [](void* self) noexcept { delete *static_cast<D**>(self); },
+            };
+            return &ops;
+        }
+
+        template <typename F>
+        void emplace_(F&& f) {
+            using D = std::decay_t<F>;
+            if constexpr (fitsInline_<D>) {
+                ::new (storage_()) D(std::forward<F>(f));
+                ops_ = inlineOps_<D>();
+            }
+            else {
+                *static_cast<D**>(storage_()) = new D(std::forward<F>(f));
+                ops_ = heapOps_<D>();
+            }
+        }
+
+        void moveFrom_(InlineTask& o) noexcept {
+            if (o.ops_) {
+                o.ops_->moveTo(o.storage_(), storage_());
+                ops_ = o.ops_;
+                o.ops_ = nullptr;
+            }
+        }
+
+        void* storage_() noexcept { return &buf_; }
+
+        const Ops* ops_ = nullptr;
+        std::aligned_storage_t<kInlineBytes, alignof(std::max_align_t)> buf_;
+    };
+
+} // namespace MyCoreEngine
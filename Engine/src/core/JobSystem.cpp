@@ -1,8 +1,10 @@
 #include "JobSystem.h"
+#include "Profiler.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cstdio>
+#include <exception>
 
 namespace MyCoreEngine {
 
@@ -29,6 +31,48 @@ namespace MyCoreEngine {
         for (auto& t : workers_) {
             if (t.joinable()) t.join();
         }
+        // slabs_ goes with the members: queued jobs and unpumped
+        // completions are destroyed there, never executed
+    }
+
+    void JobSystem::pushStack_(std::atomic<Node*>& head, Node* n)
+    {
+        // Treiber push. Safe with any number of pushers because the only
+        // pop is exchange(nullptr) of the whole list — no pop-one, so no
+        // ABA to guard against.
+        Node* old = head.load(std::memory_order_relaxed);
+        do {
+            n->next = old;
+        } while (!head.compare_exchange_weak(old, n,
+                     std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    JobSystem::Node* JobSystem::allocNode_()
+    {
+        if (!freeList_) {
+            freeList_ = freeReturned_.exchange(nullptr, std::memory_order_acquire);
+        }
+        if (!freeList_) {
+            // grow by a chunk, not a node: the burst that emptied the pool
+            // is usually still arriving
+            auto slab = std::make_unique<Node[]>(kSlabNodes);
+            for (std::size_t i = 0; i < kSlabNodes; ++i) {
+                slab[i].next = (i + 1 < kSlabNodes) ? &slab[i + 1] : nullptr;
+            }
+            freeList_ = &slab[0];
+            slabs_.push_back(std::move(slab));
+        }
+        Node* n = freeList_;
+        freeList_ = n->next;
+        n->next = nullptr;
+        return n;
+    }
+
+    void JobSystem::recycleNode_(Node* n)
+    {
+        n->work.reset();
+        n->done.reset();
+        pushStack_(freeReturned_, n);
     }
 
     void JobSystem::submit(Job work, Completion onComplete)
@@ -36,26 +80,44 @@ namespace MyCoreEngine {
         {
             std::lock_guard<std::mutex> lk(qMutex_);
             if (stopping_) return; // shutting down: dropped (documented)
-            jobs_.emplace_back(std::move(work), std::move(onComplete));
+            Node* n = allocNode_();
+            n->work = std::move(work);
+            n->done = std::move(onComplete);
+            if (jobsTail_) jobsTail_->next = n;
+            else jobsHead_ = n;
+            jobsTail_ = n;
+            ++jobCount_;
         }
         qCv_.notify_one();
     }
 
     void JobSystem::workerLoop_()
     {
+        CSE_PROFILE_THREAD("JobSystem worker");
+        bool finishedOne = false;
         for (;;) {
-            std::pair<Job, Completion> item;
+            Node* n = nullptr;
             {
+                // ONE lock per job: retiring the previous job's in-flight
+                // count rides on the same acquisition that pops the next
                 std::unique_lock<std::mutex> lk(qMutex_);
-                qCv_.wait(lk, [this] { return stopping_ || !jobs_.empty(); });
+                if (finishedOne) {
+                    --inFlight_;
+                    finishedOne = false;
+                    if (inFlight_ == 0 && !jobsHead_) idleCv_.notify_all();
+                }
+                qCv_.wait(lk, [this] { return stopping_ || jobsHead_ != nullptr; });
                 if (stopping_) return; // pending jobs are dropped on shutdown
-                item = std::move(jobs_.front());
-                jobs_.pop_front();
+                n = jobsHead_;
+                jobsHead_ = n->next;
+                if (!jobsHead_) jobsTail_ = nullptr;
+                --jobCount_;
                 ++inFlight_;
             }
 
             try {
-                if (item.first) item.first();
+                CSE_PROFILE_ZONE("Job");
+                if (n->work) n->work();
             }
             catch (const std::exception& e) {
                 std::fprintf(stderr, "[JobSystem] job threw: %s\n", e.what());
@@ -63,24 +125,25 @@ namespace MyCoreEngine {
             catch (...) {
                 std::fprintf(stderr, "[JobSystem] job threw (non-std exception)\n");
             }
+            n->work.reset(); // the job's captures die with the job, not the pump
 
             // completion becomes visible BEFORE the in-flight count drops:
             // after waitIdle() returns, every finished job's completion is
             // already queued for the pump
-            if (item.second) {
-                std::lock_guard<std::mutex> lk(cMutex_);
-                completions_.push_back(std::move(item.second));
+            if (n->done) {
+                pendingCompletions_.fetch_add(1, std::memory_order_relaxed);
+                pushStack_(completed_, n);
             }
-            {
-                std::lock_guard<std::mutex> lk(qMutex_);
-                --inFlight_;
+            else {
+                recycleNode_(n);
             }
-            idleCv_.notify_all();
+            finishedOne = true;
         }
     }
 
     int JobSystem::pumpCompletions(float budgetMs)
     {
+        CSE_PROFILE_ZONE("JobSystem::pumpCompletions");
         using clock = std::chrono::steady_clock;
         const auto deadline = clock::now() +
             std::chrono::duration_cast<clock::duration>(
@@ -88,17 +151,28 @@ namespace MyCoreEngine {
 
         int ran = 0;
         for (;;) {
-            Completion c;
-            {
-                std::lock_guard<std::mutex> lk(cMutex_);
-                if (completions_.empty()) break;
-                c = std::move(completions_.front());
-                completions_.pop_front();
+            if (!batch_) {
+                // take everything finished so far in one exchange; the stack
+                // is newest-first, so reverse it into completion order
+                Node* taken = completed_.exchange(nullptr, std::memory_order_acquire);
+                Node* fifo = nullptr;
+                while (taken) {
+                    Node* next = taken->next;
+                    taken->next = fifo;
+                    fifo = taken;
+                    taken = next;
+                }
+                batch_ = fifo;
+                if (!batch_) break;
             }
-            // executed OUTSIDE the lock: a completion may submit follow-up
-            // jobs or queue further completions without deadlocking
+            Node* n = batch_;
+            batch_ = n->next;
+
+            // executed with no lock held: a completion may submit follow-up
+            // jobs (which may finish and queue completions) freely
             try {
-                c();
+                CSE_PROFILE_ZONE("Completion");
+                n->done();
             }
             catch (const std::exception& e) {
                 std::fprintf(stderr, "[JobSystem] completion threw: %s\n", e.what());
@@ -106,28 +180,100 @@ namespace MyCoreEngine {
             catch (...) {
                 std::fprintf(stderr, "[JobSystem] completion threw (non-std exception)\n");
             }
+            recycleNode_(n);
+            pendingCompletions_.fetch_sub(1, std::memory_order_relaxed);
             ++ran;
             if (clock::now() >= deadline) break; // ≥1 ran even on a 0 budget
         }
         return ran;
     }
 
+    namespace {
+        // One parallelFor call. Shared with the helper jobs because a helper
+        // can start AFTER the call has returned (it was queued behind a long
+        // decode): it then finds no chunk left and touches nothing but this.
+        // The body pointer is only followed for a claimed chunk, and the
+        // caller does not return until every claimed chunk has finished.
+        struct ForState {
+            void (*fn)(void*, std::size_t, std::size_t, std::size_t) = nullptr;
+            void* ctx = nullptr;
+            std::size_t count = 0, grain = 1, chunks = 0;
+            std::atomic<std::size_t> next{ 0 };
+            std::atomic<std::size_t> done{ 0 };
+            std::mutex m;
+            std::condition_variable cv;
+            std::exception_ptr error; // first one; m held
+        };
+
+        void runChunks(ForState& s) {
+            for (;;) {
+                const std::size_t c = s.next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= s.chunks) return;
+                const std::size_t begin = c * s.grain;
+                try {
+                    s.fn(s.ctx, begin, std::min(s.count, begin + s.grain), c);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lk(s.m);
+                    if (!s.error) s.error = std::current_exception();
+                }
+                // release: the chunk's writes are visible to whoever sees
+                // the final count
+                if (s.done.fetch_add(1, std::memory_order_acq_rel) + 1 == s.chunks) {
+                    std::lock_guard<std::mutex> lk(s.m);
+                    s.cv.notify_all();
+                }
+            }
+        }
+    } // namespace
+
+    void JobSystem::parallelFor_(std::size_t count, std::size_t grain, RangeFn fn, void* ctx)
+    {
+        if (count == 0) return;
+        grain = grain ? grain : 1;
+        const std::size_t chunks = chunkCount(count, grain);
+        if (chunks == 1) {
+            fn(ctx, 0, count, 0);
+            return;
+        }
+
+        auto state = std::make_shared<ForState>();
+        state->fn = fn;
+        state->ctx = ctx;
+        state->count = count;
+        state->grain = grain;
+        state->chunks = chunks;
+
+        // the caller takes a share, so one helper fewer than chunks is enough
+        const std::size_t helpers = std::min<std::size_t>(workers_.size(), chunks - 1);
+        for (std::size_t i = 0; i < helpers; ++i) {
+            submit([state] { runChunks(*state); });
+        }
+        runChunks(*state);
+        {
+            std::unique_lock<std::mutex> lk(state->m);
+            state->cv.wait(lk, [&] {
+                return state->done.load(std::memory_order_acquire) == state->chunks;
+            });
+        }
+        if (state->error) std::rethrow_exception(state->error);
+    }
+
     void JobSystem::waitIdle()
     {
         std::unique_lock<std::mutex> lk(qMutex_);
-        idleCv_.wait(lk, [this] { return jobs_.empty() && inFlight_ == 0; });
+        idleCv_.wait(lk, [this] { return !jobsHead_ && inFlight_ == 0; });
     }
 
     std::size_t JobSystem::pendingJobs() const
     {
         std::lock_guard<std::mutex> lk(qMutex_);
-        return jobs_.size();
+        return jobCount_;
     }
 
     std::size_t JobSystem::pendingCompletions() const
     {
-        std::lock_guard<std::mutex> lk(cMutex_);
-        return completions_.size();
+        return pendingCompletions_.load(std::memory_order_relaxed);
     }
 
 } // namespace MyCoreEngine
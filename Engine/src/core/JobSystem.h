@@ -1,13 +1,14 @@
 #pragma once
 #include "Core.h"
+#include "InlineTask.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <cstddef>
-#include <deque>
-#include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
-#include <utility>
+#include <type_traits>
 #include <vector>
 
 namespace MyCoreEngine {
@@ -23,7 +24,8 @@ namespace MyCoreEngine {
     // - `work` runs on a WORKER thread and must never touch GL, the entt
     //   registry, or ImGui. GL function-pointer tables are per-module and
     //   the context is current on the main thread only; the registry and
-    //   ImGui are single-threaded by design.
+    //   ImGui are single-threaded by design. The one exception is a
+    //   parallelFor body (see "Data parallelism" below).
     // - `onComplete` runs on the MAIN thread, inside pumpCompletions(),
     //   with the GL context current — this is where uploads belong.
     // - Closures OWN their transient state (shared_ptr, like the example
@@ -38,10 +40,25 @@ namespace MyCoreEngine {
     //
     // Threading model: fixed worker pool (default ~hardware/3, capped at 4
     // — leave headroom for the driver and OS on the 6c/12t target), one
-    // mutex+condvar job queue (contention is per-asset, not per-item; no
-    // lock-free heroics needed at this scale), and a completion queue the
-    // main loop drains under a per-frame time budget so a burst of
-    // finished decodes cannot hitch a frame.
+    // mutex+condvar job queue (contention is per-asset, not per-item), and
+    // a completion queue the main loop drains under a per-frame time budget
+    // so a burst of finished decodes cannot hitch a frame.
+    //
+    // THE COMPLETION PATH TAKES NO LOCK, so a burst of finished jobs (the
+    // cooker's parallel validation finishing a few hundred decodes at once)
+    // never convoys workers behind the pumping main thread. A finished job
+    // is pushed onto an intrusive lock-free stack (one CAS, any number of
+    // producers) and the pump takes the WHOLE stack with one exchange,
+    // reverses it to submission-of-completion order, and works through that
+    // private batch. Leftovers from a budget cut stay in the batch and run
+    // first next pump, so order is FIFO across pumps too.
+    //
+    // Allocation: a job and its completion live together in one Node, and
+    // Nodes come from a slab pool owned by this object (grown in chunks,
+    // never shrunk, recycled through a second lock-free stack). The
+    // closures themselves are InlineTasks, stored in the Node without a
+    // heap allocation when they fit. Steady state, a submit allocates
+    // nothing.
     //
     // Failure containment: an exception escaping `work` is logged and
     // swallowed and the completion STILL runs — closures carry their own
@@ -52,12 +69,24 @@ namespace MyCoreEngine {
     // finish, drops jobs that never started, and joins. Completions not
     // yet pumped never run.
     //
+    // Data parallelism: parallelFor splits an index range into fixed chunks
+    // and runs them on the workers AND the calling thread, returning when
+    // all are done. It is a fork/join over memory the caller owns, so the
+    // hard contract above bends in exactly one way: while the caller is
+    // blocked in it, bodies may READ entt components of any entity
+    // concurrently, through a const registry (a mutable one may create a
+    // pool), and WRITE components only of disjoint entities (the caller
+    // resolved which ones, and nothing another body reads). Structural
+    // registry changes (create/destroy/emplace/remove) stay main-thread
+    // only.
+    //
     // Planned (NOT implemented — this is the seam): job priorities,
-    // dependencies/continuations, parallel_for, cancellation tokens.
+    // dependencies/continuations, cancellation tokens.
     class ENGINE_API JobSystem {
     public:
-        using Job = std::function<void()>;
-        using Completion = std::function<void()>;
+        // Anything callable as void(); lambdas convert implicitly.
+        using Job = InlineTask;
+        using Completion = InlineTask;
 
         // Construct on the main thread (it captures the thread id that
         // pumpCompletions/isMainThread treat as "main").
@@ -79,6 +108,29 @@ namespace MyCoreEngine {
         // budget still makes progress). Returns how many ran.
         int pumpCompletions(float budgetMs = 2.0f);
 
+        // Runs body(begin, end, chunk) over [0, count) in chunks of `grain`
+        // items: chunk c is always [c*grain, min(count, (c+1)*grain)), so
+        // results a body files under its chunk index merge back in a stable
+        // order however the chunks were scheduled. The calling thread works
+        // through chunks too, so this never waits on a worker that is busy
+        // elsewhere (a long decode, a nested parallelFor): at worst the
+        // caller runs every chunk itself. One chunk runs inline, with no
+        // worker involved. The first exception a body throws is rethrown
+        // here once every chunk has finished. Any thread.
+        template <typename Fn>
+        void parallelFor(std::size_t count, std::size_t grain, Fn&& body) {
+            using Body = std::remove_reference_t<Fn>;
+            parallelFor_(count, grain,
+                [](void* ctx, std::size_t b, std::size_t e, std::size_t c) {
+                    (*static_cast<Body*>(ctx))(b, e, c);
+                },
+                const_cast<void*>(static_cast<const void*>(&body)));
+        }
+        static std::size_t chunkCount(std::size_t count, std::size_t grain) {
+            grain = grain ? grain : 1;
+            return (count + grain - 1) / grain;
+        }
+
         // Block until every submitted job has finished EXECUTING. Their
         // completions may still be queued — pump afterwards. Test/teardown
         // aid; never call it from a worker or a completion.
@@ -90,20 +142,51 @@ namespace MyCoreEngine {
         bool isMainThread() const { return std::this_thread::get_id() == mainThread_; }
 
     private:
+        // One submission, from submit() to its recycling. `next` is reused
+        // by every list the node passes through (job FIFO, completion
+        // stack, pump batch, free list) — it is only ever on one at a time.
+        struct Node {
+            Job work;
+            Completion done;
+            Node* next = nullptr;
+        };
+        static constexpr std::size_t kSlabNodes = 64;
+
+        using RangeFn = void (*)(void* ctx, std::size_t begin, std::size_t end,
+                                 std::size_t chunk);
+        void parallelFor_(std::size_t count, std::size_t grain, RangeFn fn, void* ctx);
+
         void workerLoop_();
+        Node* allocNode_();            // qMutex_ held
+        void recycleNode_(Node* n);    // any thread, lock-free
+        static void pushStack_(std::atomic<Node*>& head, Node* n);
 
         std::thread::id mainThread_;
         std::vector<std::thread> workers_;
 
-        mutable std::mutex qMutex_; // guards jobs_, inFlight_, stopping_
+        // guards jobsHead_/jobsTail_/jobCount_, inFlight_, stopping_, the
+        // slab list and freeList_
+        mutable std::mutex qMutex_;
         std::condition_variable qCv_;    // workers wait for jobs
         std::condition_variable idleCv_; // waitIdle waits for drain
-        std::deque<std::pair<Job, Completion>> jobs_;
+        Node* jobsHead_ = nullptr;       // FIFO: pop head, push tail
+        Node* jobsTail_ = nullptr;
+        std::size_t jobCount_ = 0;
         std::size_t inFlight_ = 0;
         bool stopping_ = false;
 
-        mutable std::mutex cMutex_; // guards completions_
-        std::deque<Completion> completions_;
+        // Slab pool. Node storage is owned here and only released by the
+        // destructor, which is what destroys unexecuted closures (queued
+        // jobs, unpumped completions) without ever running them.
+        std::vector<std::unique_ptr<Node[]>> slabs_;
+        Node* freeList_ = nullptr;                // qMutex_ held
+        std::atomic<Node*> freeReturned_{ nullptr }; // lock-free push, taken whole
+
+        // Finished jobs awaiting the pump: pushed by workers, taken whole
+        // by the main thread. batch_ is the main thread's private FIFO.
+        std::atomic<Node*> completed_{ nullptr };
+        Node* batch_ = nullptr;                     // main thread only
+        std::atomic<std::size_t> pendingCompletions_{ 0 };
     };
 
 } // namespace MyCoreEngine
@@ -0,0 +1,181 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        // Tile column (or row) of a normalized device coordinate, unclamped.
+        inline int tileOf(float ndc, uint32_t tiles) {
+            return static_cast<int>(std::floor((ndc + 1.f) * 0.5f * float(tiles)));
+        }
+    } // namespace
+
+    bool ClusterGridDesc::operator==(const ClusterGridDesc& o) const {
+        return tilesX == o.tilesX && tilesY == o.tilesY && slices == o.slices &&
+               nearZ == o.nearZ && farZ == o.farZ && tanHalfFovY == o.tanHalfFovY &&
+               aspect == o.aspect && viewportW == o.viewportW && viewportH == o.viewportH;
+    }
+
+    void LightClusters::layout_() {
+        const uint32_t n = ClusterCount();
+        const float logRatio = std::log(grid_.farZ / grid_.nearZ);
+        sliceScale_ = float(grid_.slices) / logRatio;
+        sliceBias_ = -float(grid_.slices) * std::log(grid_.nearZ) / logRatio;
+
+        sliceDepth_.resize(grid_.slices + 1);
+        for (uint32_t k = 0; k <= grid_.slices; ++k) {
+            sliceDepth_[k] = grid_.nearZ * std::pow(grid_.farZ / grid_.nearZ, float(k) / float(grid_.slices));
+        }
+        // the last froxels reach past the far plane: SliceOf clamps there
+        sliceDepth_[grid_.slices] = grid_.farZ;
+
+        const float sx = grid_.tanHalfFovY * grid_.aspect; // view x per unit depth at ndc 1
+        const float sy = grid_.tanHalfFovY;
+        boxMin_.resize(std::size_t(n) * 3);
+        boxMax_.resize(std::size_t(n) * 3);
+        for (uint32_t k = 0; k < grid_.slices; ++k) {
+            const float d0 = sliceDepth_[k], d1 = sliceDepth_[k + 1];
+            for (uint32_t y = 0; y < grid_.tilesY; ++y) {
+                const float ny0 = -1.f + 2.f * float(y) / float(grid_.tilesY);
+                const float ny1 = -1.f + 2.f * float(y + 1) / float(grid_.tilesY);
+                for (uint32_t x = 0; x < grid_.tilesX; ++x) {
+                    const float nx0 = -1.f + 2.f * float(x) / float(grid_.tilesX);
+                    const float nx1 = -1.f + 2.f * float(x + 1) / float(grid_.tilesX);
+                    const std::size_t c = std::size_t(ClusterIndex(x, y, k)) * 3;
+                    // the froxel's edges are straight lines through the eye:
+                    // its extremes sit at the near or the far depth
+                    boxMin_[c + 0] = std::min(nx0 * d0, nx0 * d1) * sx;
+                    boxMax_[c + 0] = std::max(nx1 * d0, nx1 * d1) * sx;
+                    boxMin_[c + 1] = std::min(ny0 * d0, ny0 * d1) * sy;
+                    boxMax_[c + 1] = std::max(ny1 * d0, ny1 * d1) * sy;
+                    boxMin_[c + 2] = -d1;
+                    boxMax_[c + 2] = -d0;
+                }
+            }
+        }
+        laidOut_ = true;
+    }
+
+    uint32_t LightClusters::SliceOf(float viewDepth) const {
+        if (!(viewDepth > grid_.nearZ)) return 0;
+        const float s = std::floor(std::log(viewDepth) * sliceScale_ + sliceBias_);
+        return static_cast<uint32_t>(std::clamp(s, 0.f, float(grid_.slices - 1)));
+    }
+
+    uint32_t LightClusters::ClusterAt(float px, float py, float viewDepth) const {
+        const float tileW = grid_.viewportW / float(grid_.tilesX);
+        const float tileH = grid_.viewportH / float(grid_.tilesY);
+        const uint32_t x = std::min(uint32_t(std::max(px / tileW, 0.f)), grid_.tilesX - 1);
+        const uint32_t y = std::min(uint32_t(std::max(py / tileH, 0.f)), grid_.tilesY - 1);
+        return ClusterIndex(x, y, SliceOf(viewDepth));
+    }
+
+    void LightClusters::Build(const ClusterGridDesc& grid, const LightSphere* lights, std::size_t count) {
+        CSE_PROFILE_ZONE("LightClusters::Build");
+        ClusterGridDesc g = grid;
+        g.tilesX = std::clamp<uint32_t>(g.tilesX, 1, kMaxClusters);
+        g.tilesY = std::clamp<uint32_t>(g.tilesY, 1, kMaxClusters / g.tilesX);
+        g.slices = std::clamp<uint32_t>(g.slices, 1, kMaxClusters / (g.tilesX * g.tilesY));
+        g.nearZ = std::max(g.nearZ, 1e-4f);
+        g.farZ = std::max(g.farZ, g.nearZ * 1.001f);
+        if (!laidOut_ || !(g == grid_)) {
+            grid_ = g;
+            layout_();
+        }
+
+        const uint32_t n = ClusterCount();
+        ranges_.assign(n, Range{});
+        pairs_.clear();
+        dropped_ = 0;
+        count = std::min<std::size_t>(count, kMaxLights);
+
+        const float sx = grid_.tanHalfFovY * grid_.aspect;
+        const float sy = grid_.tanHalfFovY;
+        for (std::size_t li = 0; li < count; ++li) {
+            const LightSphere& L = lights[li];
+            const float r = L.radius;
+            const float d = -L.z;
+            if (!(r > 0.f) || d + r <= grid_.nearZ || d - r >= grid_.farZ) continue;
+
+            // Screen rectangle of the sphere's box: x/d is most extreme at
+            // the nearest depth on the side of the eye the edge lies on.
+            const float dMin = std::max(d - r, grid_.nearZ);
+            const float dMax = d + r;
+            const float xLo = (L.x - r) / ((L.x - r) < 0.f ? dMin : dMax) / sx;
+            const float xHi = (L.x + r) / ((L.x + r) > 0.f ? dMin : dMax) / sx;
+            const float yLo = (L.y - r) / ((L.y - r) < 0.f ? dMin : dMax) / sy;
+            const float yHi = (L.y + r) / ((L.y + r) > 0.f ? dMin : dMax) / sy;
+            if (xHi < -1.f || xLo > 1.f || yHi < -1.f || yLo > 1.f) continue; // off screen
+
+            const uint32_t x0 = uint32_t(std::clamp(tileOf(xLo, grid_.tilesX), 0, int(grid_.tilesX) - 1));
+            const uint32_t x1 = uint32_t(std::clamp(tileOf(xHi, grid_.tilesX), 0, int(grid_.tilesX) - 1));
+            const uint32_t y0 = uint32_t(std::clamp(tileOf(yLo, grid_.tilesY), 0, int(grid_.tilesY) - 1));
+            const uint32_t y1 = uint32_t(std::clamp(tileOf(yHi, grid_.tilesY), 0, int(grid_.tilesY) - 1));
+            const uint32_t k0 = SliceOf(dMin);
+            const uint32_t k1 = SliceOf(std::min(dMax, grid_.farZ));
+
+            const float r2 = r * r;
+            for (uint32_t k = k0; k <= k1; ++k) {
+                for (uint32_t y = y0; y <= y1; ++y) {
+                    for (uint32_t x = x0; x <= x1; ++x) {
+                        const uint32_t c = ClusterIndex(x, y, k);
+                        const float* mn = &boxMin_[std::size_t(c) * 3];
+                        const float* mx = &boxMax_[std::size_t(c) * 3];
+                        // squared distance from the centre to the box
+                        const float p[3] = { L.x, L.y, L.z };
+                        float dist2 = 0.f;
+                        for (int a = 0; a < 3; ++a) {
+                            const float q = std::clamp(p[a], mn[a], mx[a]) - p[a];
+                            dist2 += q * q;
+                        }
+                        if (dist2 > r2) continue;
+                        if (pairs_.size() == kMaxIndices) { ++dropped_; continue; }
+                        pairs_.push_back((c << 8) | uint32_t(li));
+                        ++ranges_[c].count;
+                    }
+                }
+            }
+        }
+
+        // offsets by prefix sum, then each cluster's lights in light order
+        uint32_t offset = 0;
+        for (Range& rg : ranges_) {
+            rg.offset = offset;
+            offset += rg.count;
+            rg.count = 0;
+        }
+        indices_.resize(pairs_.size());
+        for (uint32_t pr : pairs_) {
+            Range& rg = ranges_[pr >> 8];
+            indices_[rg.offset + rg.count++] = static_cast<uint8_t>(pr & 0xff);
+        }
+    }
+
+    void LightClusters::PackGrid(std::vector<uint32_t>& words) const {
+        words.assign(kGridBlockBytes / 4, 0u);
+        words[0] = grid_.tilesX;
+        words[1] = grid_.tilesY;
+        words[2] = grid_.slices;
+        const float slice[4] = { sliceScale_, sliceBias_,
+                                 grid_.viewportW / float(grid_.tilesX),
+                                 grid_.viewportH / float(grid_.tilesY) };
+        static_assert(sizeof(float) == sizeof(uint32_t), "std140 floats are 32-bit");
+        for (int i = 0; i < 4; ++i) std::memcpy(&words[4 + i], &slice[i], sizeof(float));
+        for (std::size_t c = 0; c < ranges_.size(); ++c) {
+            words[8 + c] = ranges_[c].offset | (ranges_[c].count << 16);
+        }
+    }
+
+    void LightClusters::PackIndices(std::vector<uint32_t>& words) const {
+        words.assign(kIndexBlockBytes / 4, 0u);
+        for (std::size_t j = 0; j < indices_.size(); ++j) {
+            words[j >> 2] |= uint32_t(indices_[j]) << ((j & 3) * 8);
+        }
+    }
+
+} // namespace MyCoreEngine
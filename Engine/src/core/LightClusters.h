@@ -0,0 +1,127 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Clustered light assignment: the view frustum cut into froxels (screen
+    // tiles x depth slices), and for each froxel the punctual lights whose
+    // range reaches it. Built on the CPU each frame from the lights'
+    // view-space bounding spheres; the forward shader finds its froxel from
+    // gl_FragCoord and view depth and loops over that froxel's lights only.
+    // Knows nothing about GL, glm or entt, so the binning is tested on its
+    // own; Scene feeds it the lights and uploads the packed blocks.
+    //
+    //   clusters.Build(grid, spheres, count);   // spheres in priority order
+    //   clusters.PackGrid(words);                // -> uniform block ClusterGrid
+    //   clusters.PackIndices(words);             // -> uniform block ClusterIndices
+    //
+    // WHY. A global top-N hands every fragment the same N lights: a stage
+    // with hundreds of small lamps shades each pixel against lamps across
+    // the map, and drops the ones next to it once N overflows. Per froxel,
+    // a pixel only pays for the lights that can reach it.
+    //
+    // SLICES are exponential in view depth, so near froxels are thin and far
+    // ones deep, about the same shape on screen:
+    //
+    //   slice = floor(log(depth) * SliceScale() + SliceBias())
+    //
+    // A froxel is tested as its view-space bounding box, so the lists are
+    // conservative: a light may be listed where it does not quite reach
+    // (the shader's range window zeroes it), but never missing where it does.
+    // Spot lights are binned by the sphere of their range.
+    //
+    // UNIFORM LAYOUT (std140; GL 3.3 has no storage buffers). Each block fits
+    // the 16 KB GL_MAX_UNIFORM_BLOCK_SIZE every implementation guarantees:
+    //
+    //   ClusterGrid      uvec4 dims     tilesX, tilesY, slices, 0
+    //                    vec4  slice    SliceScale, SliceBias, tile width px, tile height px
+    //                    uvec4 record[kRecordVec4s]   per cluster: offset | count << 16
+    //   ClusterIndices   uvec4 index[kIndexVec4s]     8-bit light indices, 16 per uvec4
+    //
+    // Cluster i's record is record[i / 4][i % 4]; its lights are index
+    // entries [offset, offset + count). Light indices point into Scene's
+    // ClusterLights block (4 vec4 per light, kMaxLights of them).
+    struct ClusterGridDesc {
+        uint32_t tilesX = 16;
+        uint32_t tilesY = 9;
+        uint32_t slices = 24;
+        float nearZ = 0.1f;               // view depth range the slices cover
+        float farZ = 1000.f;
+        float tanHalfFovY = 0.41421356f;  // tan(45 deg / 2)
+        float aspect = 16.f / 9.f;
+        float viewportW = 1920.f;         // pixels, for the shader's tile size
+        float viewportH = 1080.f;
+        bool operator==(const ClusterGridDesc& o) const;
+    };
+
+    // A light's reach in view space (the camera looks down -z).
+    struct LightSphere {
+        float x, y, z, radius;
+    };
+
+    class ENGINE_API LightClusters {
+    public:
+        static constexpr uint32_t kMaxLights = 256;     // 8-bit indices
+        static constexpr uint32_t kRecordVec4s = 1022;  // 32-byte header + records = 16 KB
+        static constexpr uint32_t kMaxClusters = kRecordVec4s * 4;
+        static constexpr uint32_t kIndexVec4s = 1024;   // 16 KB
+        static constexpr uint32_t kMaxIndices = kIndexVec4s * 16;
+        static constexpr std::size_t kGridBlockBytes = 32 + kRecordVec4s * 16;
+        static constexpr std::size_t kIndexBlockBytes = kIndexVec4s * 16;
+
+        struct Range {
+            uint32_t offset = 0;
+            uint32_t count = 0;
+        };
+
+        // Bins lights[0, count) (past kMaxLights they are ignored). When the
+        // index list fills, the remaining light-cluster pairs are dropped in
+        // light order, so pass the lights most important first. A grid with
+        // more than kMaxClusters froxels loses depth slices until it fits.
+        void Build(const ClusterGridDesc& grid, const LightSphere* lights, std::size_t count);
+
+        const ClusterGridDesc& Grid() const { return grid_; }
+        uint32_t ClusterCount() const { return grid_.tilesX * grid_.tilesY * grid_.slices; }
+        uint32_t ClusterIndex(uint32_t x, uint32_t y, uint32_t slice) const {
+            return (slice * grid_.tilesY + y) * grid_.tilesX + x;
+        }
+        // The slice of a view depth (distance in front of the camera),
+        // clamped to the grid.
+        uint32_t SliceOf(float viewDepth) const;
+        // The cluster a fragment reads: window pixel (origin bottom-left, as
+        // gl_FragCoord) and view depth. The shader's arithmetic, on the CPU.
+        uint32_t ClusterAt(float px, float py, float viewDepth) const;
+        float SliceScale() const { return sliceScale_; }
+        float SliceBias() const { return sliceBias_; }
+
+        Range Cluster(uint32_t i) const { return ranges_[i]; }
+        const std::vector<uint8_t>& Indices() const { return indices_; }
+        // Light-cluster pairs left out because the index list was full.
+        uint32_t Dropped() const { return dropped_; }
+
+        // The two blocks as 32-bit words, exactly kGridBlockBytes and
+        // kIndexBlockBytes long.
+        void PackGrid(std::vector<uint32_t>& words) const;
+        void PackIndices(std::vector<uint32_t>& words) const;
+
+    private:
+        // Froxel bounding boxes for grid_; redone only when the grid changes.
+        void layout_();
+
+        ClusterGridDesc grid_;
+        bool laidOut_ = false;
+        float sliceScale_ = 0.f;
+        float sliceBias_ = 0.f;
+        std::vector<float> boxMin_, boxMax_; // 3 per cluster
+        std::vector<float> sliceDepth_;      // slices + 1 boundaries
+        std::vector<Range> ranges_;
+        std::vector<uint8_t> indices_;
+        std::vector<uint32_t> pairs_;        // accepted (cluster << 8 | light), in light order
+        uint32_t dropped_ = 0;
+    };
+
+} // namespace MyCoreEngine
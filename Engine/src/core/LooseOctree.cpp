@@ -0,0 +1,289 @@
+#include "LooseOctree.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    namespace {
+        // Smallest nominal half-size a node is split down to. Items smaller
+        // than this share the node; deeper levels would only add traversal.
+        constexpr float kMinNodeHalf = 0.5f;
+        // Items a node holds before it splits. About one SIMD-friendly batch:
+        // fewer means more nodes to visit per query, more means more items
+        // tested in straddling nodes.
+        constexpr std::size_t kMaxNodeItems = 32;
+        // The first root, before growth. Roughly a room; grows as needed.
+        constexpr float kInitialRootHalf = 64.f;
+        // A root past this is a broken coordinate, not a level.
+        constexpr float kMaxRootHalf = 1.0e9f;
+    } // namespace
+
+    int32_t LooseOctree::newNode_(float cx, float cy, float cz, float half, int32_t parent) {
+        Node n;
+        n.cx = cx; n.cy = cy; n.cz = cz; n.half = half;
+        n.parent = parent;
+        nodes_.push_back(std::move(n));
+        return static_cast<int32_t>(nodes_.size() - 1);
+    }
+
+    bool LooseOctree::rootCovers_(const float c[3], float maxExt) const {
+        const Node& n = nodes_[root_];
+        return maxExt <= n.half &&
+               std::abs(c[0] - n.cx) <= n.half &&
+               std::abs(c[1] - n.cy) <= n.half &&
+               std::abs(c[2] - n.cz) <= n.half;
+    }
+
+    void LooseOctree::growToward_(const float c[3]) {
+        // The new root is twice the size, shifted half a root toward c; the
+        // old root is exactly one of its octants.
+        const Node old = nodes_[root_]; // copy: newNode_ may reallocate
+        const float h = old.half;
+        const float sx = c[0] >= old.cx ? 1.f : -1.f;
+        const float sy = c[1] >= old.cy ? 1.f : -1.f;
+        const float sz = c[2] >= old.cz ? 1.f : -1.f;
+        const int32_t grown = newNode_(old.cx + sx * h, old.cy + sy * h, old.cz + sz * h, 2.f * h, -1);
+        // the old root sits on the far side from c
+        const int octant = (sx > 0.f ? 1 : 0) | (sy > 0.f ? 2 : 0) | (sz > 0.f ? 4 : 0);
+        nodes_[grown].child[octant] = root_;
+        nodes_[grown].subtree = old.subtree;
+        nodes_[grown].split = true;
+        nodes_[root_].parent = grown;
+        root_ = grown;
+    }
+
+    bool LooseOctree::Insert(uint32_t key, const float c[3], const float e[3], float radius) {
+        for (int a = 0; a < 3; ++a) {
+            if (!std::isfinite(c[a]) || !std::isfinite(e[a])) return false;
+        }
+        if (!std::isfinite(radius)) return false;
+        if (Contains(key)) Remove(key);
+
+        const float maxExt = std::max({ e[0], e[1], e[2] });
+        if (root_ < 0) root_ = newNode_(c[0], c[1], c[2], std::max(kInitialRootHalf, maxExt), -1);
+        while (!rootCovers_(c, maxExt)) {
+            if (nodes_[root_].half > kMaxRootHalf) return false;
+            growToward_(c);
+        }
+
+        // Descend through existing children while the item still fits one;
+        // children are only created when a node overflows (split_).
+        int32_t n = root_;
+        for (;;) {
+            const Node& node = nodes_[n];
+            const float childHalf = node.half * 0.5f;
+            if (childHalf < kMinNodeHalf || maxExt > childHalf) break;
+            const int octant = octantOf_(node, c);
+            int32_t child = node.child[octant];
+            if (child < 0) {
+                if (!node.split) break; // still a leaf: collect here
+                child = newChild_(n, octant);
+            }
+            n = child;
+        }
+
+        append_(n, key, c, e, radius);
+        for (int32_t p = n; p >= 0; p = nodes_[p].parent) ++nodes_[p].subtree;
+        ++items_;
+        if (!nodes_[n].split && nodes_[n].keys.size() > kMaxNodeItems) split_(n);
+        return true;
+    }
+
+    int32_t LooseOctree::newChild_(int32_t n, int octant) {
+        const Node& node = nodes_[n];
+        const float h = node.half * 0.5f;
+        const float cx = node.cx + ((octant & 1) ? -h : h); // read before newNode_ reallocates
+        const float cy = node.cy + ((octant & 2) ? -h : h);
+        const float cz = node.cz + ((octant & 4) ? -h : h);
+        const int32_t child = newNode_(cx, cy, cz, h, n);
+        nodes_[n].child[octant] = child;
+        return child;
+    }
+
+    int LooseOctree::octantOf_(const Node& n, const float c[3]) {
+        return (c[0] >= n.cx ? 0 : 1) | (c[1] >= n.cy ? 0 : 2) | (c[2] >= n.cz ? 0 : 4);
+    }
+
+    void LooseOctree::append_(int32_t n, uint32_t key, const float c[3], const float e[3], float radius) {
+        Node& node = nodes_[n];
+        if (key >= locByKey_.size()) locByKey_.resize(key + 1);
+        locByKey_[key] = { n, static_cast<uint32_t>(node.keys.size()) };
+        node.x.push_back(c[0]); node.y.push_back(c[1]); node.z.push_back(c[2]);
+        node.ex.push_back(e[0]); node.ey.push_back(e[1]); node.ez.push_back(e[2]);
+        node.r.push_back(radius);
+        node.keys.push_back(key);
+    }
+
+    void LooseOctree::split_(int32_t n) {
+        // Push every item that fits a child one level down; big items stay.
+        // A child that overflows in turn splits too (bounded by kMinNodeHalf).
+        // Once split, a node sends new items that fit straight to a child.
+        const float childHalf = nodes_[n].half * 0.5f;
+        if (childHalf < kMinNodeHalf) return;
+        nodes_[n].split = true;
+
+        Node items; // what leaves n, in the same layout
+        std::size_t keep = 0;
+        {
+            Node& node = nodes_[n];
+            for (std::size_t i = 0; i < node.keys.size(); ++i) {
+                const float maxExt = std::max({ node.ex[i], node.ey[i], node.ez[i] });
+                if (maxExt <= childHalf) {
+                    items.x.push_back(node.x[i]); items.y.push_back(node.y[i]); items.z.push_back(node.z[i]);
+                    items.ex.push_back(node.ex[i]); items.ey.push_back(node.ey[i]); items.ez.push_back(node.ez[i]);
+                    items.r.push_back(node.r[i]); items.keys.push_back(node.keys[i]);
+                    continue;
+                }
+                node.x[keep] = node.x[i]; node.y[keep] = node.y[i]; node.z[keep] = node.z[i];
+                node.ex[keep] = node.ex[i]; node.ey[keep] = node.ey[i]; node.ez[keep] = node.ez[i];
+                node.r[keep] = node.r[i]; node.keys[keep] = node.keys[i];
+                locByKey_[node.keys[keep]].index = static_cast<uint32_t>(keep);
+                ++keep;
+            }
+            for (auto* v : { &node.x, &node.y, &node.z, &node.ex, &node.ey, &node.ez, &node.r }) v->resize(keep);
+            node.keys.resize(keep);
+        }
+        if (items.keys.empty()) return; // all too big to go deeper
+
+        int32_t touched[8];
+        int touchedCount = 0;
+        for (std::size_t i = 0; i < items.keys.size(); ++i) {
+            const float c[3] = { items.x[i], items.y[i], items.z[i] };
+            const float e[3] = { items.ex[i], items.ey[i], items.ez[i] };
+            const int octant = octantOf_(nodes_[n], c);
+            int32_t child = nodes_[n].child[octant];
+            if (child < 0) child = newChild_(n, octant);
+            append_(child, items.keys[i], c, e, items.r[i]);
+            ++nodes_[child].subtree; // n's own count already includes it
+            if (std::find(touched, touched + touchedCount, child) == touched + touchedCount) touched[touchedCount++] = child;
+        }
+        for (int i = 0; i < touchedCount; ++i) {
+            if (nodes_[touched[i]].keys.size() > kMaxNodeItems) split_(touched[i]);
+        }
+    }
+
+    void LooseOctree::Remove(uint32_t key) {
+        if (!Contains(key)) return;
+        const Loc loc = locByKey_[key];
+        Node& node = nodes_[loc.node];
+        const uint32_t last = static_cast<uint32_t>(node.keys.size() - 1);
+        if (loc.index != last) {
+            node.x[loc.index] = node.x[last]; node.y[loc.index] = node.y[last]; node.z[loc.index] = node.z[last];
+            node.ex[loc.index] = node.ex[last]; node.ey[loc.index] = node.ey[last]; node.ez[loc.index] = node.ez[last];
+            node.r[loc.index] = node.r[last];
+            node.keys[loc.index] = node.keys[last];
+            locByKey_[node.keys[loc.index]].index = loc.index;
+        }
+        node.x.pop_back(); node.y.pop_back(); node.z.pop_back();
+        node.ex.pop_back(); node.ey.pop_back(); node.ez.pop_back();
+        node.r.pop_back();
+        node.keys.pop_back();
+        for (int32_t p = loc.node; p >= 0; p = nodes_[p].parent) --nodes_[p].subtree;
+        locByKey_[key] = {};
+        --items_;
+    }
+
+    bool LooseOctree::Contains(uint32_t key) const {
+        return key < locByKey_.size() && locByKey_[key].node >= 0;
+    }
+
+    void LooseOctree::Clear() {
+        nodes_.clear();
+        locByKey_.clear();
+        root_ = -1;
+        items_ = 0;
+    }
+
+    LooseOctree::Stats LooseOctree::stats() const {
+        Stats s;
+        s.items = items_;
+        s.nodes = nodes_.size();
+        s.rootHalf = root_ >= 0 ? nodes_[root_].half : 0.f;
+        return s;
+    }
+
+    LooseOctree::Batch LooseOctree::batchOf_(const Node& n, bool inside) const {
+        Batch b;
+        b.bounds.cx = n.x.data(); b.bounds.cy = n.y.data(); b.bounds.cz = n.z.data();
+        b.bounds.ex = n.ex.data(); b.bounds.ey = n.ey.data(); b.bounds.ez = n.ez.data();
+        b.bounds.radius = n.r.data();
+        b.bounds.count = n.keys.size();
+        b.keys = n.keys.data();
+        b.inside = inside;
+        return b;
+    }
+
+    void LooseOctree::query_(const CullPlanes& pl, BatchFn fn, void* ctx) const {
+        if (root_ < 0) return;
+        std::vector<std::pair<int32_t, bool>> stack; // local: queries may run concurrently
+        stack.reserve(64);
+        stack.push_back({ root_, false });
+        while (!stack.empty()) {
+            const auto [ni, parentInside] = stack.back();
+            stack.pop_back();
+            const Node& n = nodes_[ni];
+            if (n.subtree == 0) continue;
+
+            bool inside = parentInside;
+            if (!inside) {
+                // the loose box against each plane: out, straddling or in
+                const float loose = 2.f * n.half;
+                inside = true;
+                bool out = false;
+                for (int k = 0; k < 6 && !out; ++k) {
+                    const float r = loose * (std::abs(pl.nx[k]) + std::abs(pl.ny[k]) + std::abs(pl.nz[k]));
+                    const float s = pl.nx[k] * n.cx + pl.ny[k] * n.cy + pl.nz[k] * n.cz - pl.d[k];
+                    if (s < -r) out = true;
+                    else if (s < r) inside = false;
+                }
+                if (out) continue;
+            }
+            if (!n.keys.empty()) fn(ctx, batchOf_(n, inside));
+            for (int32_t c : n.child) {
+                if (c >= 0) stack.push_back({ c, inside });
+            }
+        }
+    }
+
+    void LooseOctree::queryRay_(const float o[3], const float d[3], float maxT, BatchFn fn, void* ctx) const {
+        if (root_ < 0) return;
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(root_);
+        while (!stack.empty()) {
+            const int32_t ni = stack.back();
+            stack.pop_back();
+            const Node& n = nodes_[ni];
+            if (n.subtree == 0) continue;
+
+            // slab test against the loose box
+            const float loose = 2.f * n.half;
+            const float c[3] = { n.cx, n.cy, n.cz };
+            float t0 = 0.f, t1 = maxT;
+            bool hit = true;
+            for (int a = 0; a < 3 && hit; ++a) {
+                const float mn = c[a] - loose, mx = c[a] + loose;
+                if (std::abs(d[a]) < 1e-8f) {
+                    if (o[a] < mn || o[a] > mx) hit = false;
+                }
+                else {
+                    float tA = (mn - o[a]) / d[a];
+                    float tB = (mx - o[a]) / d[a];
+                    if (tA > tB) std::swap(tA, tB);
+                    t0 = std::max(t0, tA);
+                    t1 = std::min(t1, tB);
+                    if (t0 > t1) hit = false;
+                }
+            }
+            if (!hit) continue;
+            if (!n.keys.empty()) fn(ctx, batchOf_(n, false));
+            for (int32_t ch : n.child) {
+                if (ch >= 0) stack.push_back(ch);
+            }
+        }
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,114 @@
+#pragma once
+#include "Core.h"
+#include "CullKernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // A loose octree of world AABBs (center + half-extents), for the parts of
+    // a level that do not move. BoundsCache keeps its settled entities here
+    // so a query only pays for the branches the query volume reaches.
+    //
+    //   tree.Insert(key, center, extents, radius);
+    //   tree.Query(planes, [&](const LooseOctree::Batch& b) {
+    //       // b.bounds: the node's items, ready for CullBounds()
+    //       // b.inside: the node is entirely inside every plane
+    //   });
+    //
+    // LOOSE means every node's box is twice its nominal size (center ± 2 *
+    // half), so an item can live in any node whose nominal half-size covers
+    // its largest half-extent, picked by its center alone. No item straddles
+    // two siblings and insert/remove are O(depth), which is what makes
+    // moving things in and out every few frames cheap. A node keeps up to a
+    // small batch of items and only then splits, pushing down the ones that
+    // fit a child; the root grows (doubling, old root as one octant) when an
+    // item lands outside it.
+    //
+    // Items are keyed by a caller-chosen small integer (BoundsCache uses the
+    // entity index); each node keeps its items as parallel float arrays, so
+    // a node that straddles the query volume is tested with the SIMD kernel
+    // like any other batch. Nodes are never freed, only emptied: a subtree
+    // count lets queries skip them.
+    //
+    // Queries are const and may run concurrently with each other; writes
+    // need the tree to themselves.
+    class ENGINE_API LooseOctree {
+    public:
+        // One node's items. Valid only during the callback.
+        struct Batch {
+            CullInput bounds;
+            const uint32_t* keys;
+            bool inside; // whole node inside the query volume: no test needed
+        };
+
+        struct Stats {
+            std::size_t items = 0;
+            std::size_t nodes = 0;     // allocated, empty ones included
+            float       rootHalf = 0.f;
+        };
+
+        // Non-finite bounds are refused (returns false); the caller keeps
+        // such an item elsewhere.
+        bool Insert(uint32_t key, const float center[3], const float extents[3], float radius);
+        void Remove(uint32_t key);
+        bool Contains(uint32_t key) const;
+        std::size_t Size() const { return items_; }
+        void Clear();
+        Stats stats() const;
+
+        // Every node whose loose box is not entirely outside one of the
+        // planes, as batches. Same plane convention as CullBounds.
+        template <typename Fn>
+        void Query(const CullPlanes& planes, Fn&& fn) const {
+            using Body = std::remove_reference_t<Fn>;
+            query_(planes,
+                [](void* ctx, const Batch& b) { (*static_cast<Body*>(ctx))(b); },
+                const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+        // Every node whose loose box the ray [origin, origin + dir * maxT]
+        // enters. inside is always false: the caller tests the items.
+        template <typename Fn>
+        void QueryRay(const float origin[3], const float dir[3], float maxT, Fn&& fn) const {
+            using Body = std::remove_reference_t<Fn>;
+            queryRay_(origin, dir, maxT,
+                [](void* ctx, const Batch& b) { (*static_cast<Body*>(ctx))(b); },
+                const_cast<void*>(static_cast<const void*>(&fn)));
+        }
+
+    private:
+        using BatchFn = void (*)(void* ctx, const Batch& b);
+
+        struct Node {
+            float cx = 0.f, cy = 0.f, cz = 0.f, half = 0.f;
+            int32_t parent = -1;
+            int32_t child[8] = { -1, -1, -1, -1, -1, -1, -1, -1 };
+            std::size_t subtree = 0; // items here and below
+            bool split = false;      // has handed items to children
+            std::vector<float> x, y, z, ex, ey, ez, r;
+            std::vector<uint32_t> keys;
+        };
+        struct Loc { int32_t node = -1; uint32_t index = 0; };
+
+        int32_t newNode_(float cx, float cy, float cz, float half, int32_t parent);
+        int32_t newChild_(int32_t n, int octant);
+        static int octantOf_(const Node& n, const float c[3]);
+        void append_(int32_t n, uint32_t key, const float c[3], const float e[3], float radius);
+        void split_(int32_t n);
+        void growToward_(const float c[3]);
+        bool rootCovers_(const float c[3], float maxExt) const;
+        void query_(const CullPlanes& planes, BatchFn fn, void* ctx) const;
+        void queryRay_(const float origin[3], const float dir[3], float maxT, BatchFn fn, void* ctx) const;
+        Batch batchOf_(const Node& n, bool inside) const;
+
+        std::vector<Node> nodes_;
+        int32_t root_ = -1;
+        std::vector<Loc> locByKey_;
+        std::size_t items_ = 0;
+    };
+
+} // namespace MyCoreEngine
@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <glm/glm.hpp>
 
+#include "UniformBlocks.h"
+
 namespace MyCoreEngine {
 
     // Fixed slots for now; easy to expand later
@@ -73,6 +75,11 @@ namespace MyCoreEngine {
 
         bool isBlended() const { return alphaMode == AlphaMode::Blend; }
         bool isMasked()  const { return alphaMode == AlphaMode::Mask; }
+
+        // The scalars above as the shader's MaterialBlock, re-uploaded by
+        // Mesh::BindForDrawWith only when they change. Not part of the
+        // material's value: a copy starts without one.
+        mutable UniformBuffer block;
     };
 
     using MaterialHandle = std::shared_ptr<Material>;
@@ -0,0 +1,304 @@
+#include <glad/glad.h>
+#include "MeshArena.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        // Leaked on purpose: meshes may still unregister during static
+        // teardown, and the GL objects die with the context anyway.
+        MeshArena* sArenas[2] = {};
+
+        inline int slotOf(VertexFormat f) { return f == VertexFormat::Packed ? 1 : 0; }
+    } // namespace
+
+    // ---- RangeAllocator ----
+
+    void RangeAllocator::Reset(uint32_t capacity) {
+        free_.clear();
+        capacity_ = capacity;
+        used_ = 0;
+        if (capacity) free_.emplace(0u, capacity);
+    }
+
+    uint32_t RangeAllocator::Allocate(uint32_t count) {
+        if (count == 0) return kNone;
+        for (auto it = free_.begin(); it != free_.end(); ++it) {
+            if (it->second < count) continue;
+            const uint32_t offset = it->first;
+            const uint32_t rest = it->second - count;
+            free_.erase(it);
+            if (rest) free_.emplace(offset + count, rest);
+            used_ += count;
+            return offset;
+        }
+        return kNone;
+    }
+
+    void RangeAllocator::Free(uint32_t offset, uint32_t count) {
+        if (count == 0) return;
+        used_ -= count;
+        uint32_t start = offset, len = count;
+        auto next = free_.lower_bound(offset);
+        if (next != free_.begin()) {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset) {
+                start = prev->first;
+                len += prev->second;
+                free_.erase(prev);
+            }
+        }
+        if (next != free_.end() && next->first == offset + count) {
+            len += next->second;
+            free_.erase(next);
+        }
+        free_.emplace(start, len);
+    }
+
+    void RangeAllocator::Grow(uint32_t capacity) {
+        if (capacity <= capacity_) return;
+        uint32_t start = capacity_, len = capacity - capacity_;
+        if (!free_.empty()) {
+            auto last = std::prev(free_.end());
+            if (last->first + last->second == capacity_) {
+                start = last->first;
+                len += last->second;
+                free_.erase(last);
+            }
+        }
+        free_.emplace(start, len);
+        capacity_ = capacity;
+    }
+
+    uint32_t RangeAllocator::End() const {
+        if (!free_.empty()) {
+            const auto last = std::prev(free_.end());
+            if (last->first + last->second == capacity_) return last->first;
+        }
+        return capacity_;
+    }
+
+    uint32_t RangeAllocator::LargestFree() const {
+        uint32_t best = 0;
+        for (const auto& [offset, count] : free_) best = std::max(best, count);
+        return best;
+    }
+
+    // ---- vertex layout ----
+
+    void ApplyVertexLayout(VertexFormat format) {
+        if (format == VertexFormat::Packed) {
+            // Same locations and shader inputs as the Full layout; the fetch
+            // does the decode (10:10:10:2 -> [-1,1], half -> float). The
+            // packed formats must be fetched as 4 components.
+            const GLsizei stride = sizeof(PackedVertex);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, Position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PackedVertex, Normal));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, TexCoords));
+            glEnableVertexAttribArray(3);
+            glVertexAttribPointer(3, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PackedVertex, Tangent));
+            // no bitangent stream: vertex.glsl rebuilds it from N, T and T.w
+            return;
+        }
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
+
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
+
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+    }
+
+    // ---- MeshArena ----
+
+    MeshArena::MeshArena(VertexFormat format)
+        : format_(format),
+          stride_(format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(Vertex)) {}
+
+    MeshArena& MeshArena::For(VertexFormat format) {
+        MeshArena*& arena = sArenas[slotOf(format)];
+        if (!arena) arena = new MeshArena(format);
+        return *arena;
+    }
+
+    void MeshArena::CompactAll() {
+        for (MeshArena* arena : sArenas) {
+            if (arena) arena->Compact();
+        }
+    }
+
+    void MeshArena::ensureContext_() {
+        void* context = glfwGetCurrentContext();
+        if (vao_ && context == context_) return;
+
+        // first upload, or our objects went with another context
+        context_ = context;
+        ++generation_;
+        slots_.clear();
+        freeSlots_.clear();
+
+        glGenVertexArrays(1, &vao_);
+        glGenBuffers(1, &vbo_);
+        glGenBuffers(1, &ebo_);
+        glBindVertexArray(vao_);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        glBufferData(GL_ARRAY_BUFFER, kInitialVertices * stride_, nullptr, GL_STATIC_DRAW);
+        ApplyVertexLayout(format_);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, kInitialIndices * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+        glBindVertexArray(0);
+
+        vertices_.Reset(kInitialVertices);
+        indices_.Reset(kInitialIndices);
+    }
+
+    void MeshArena::respecify_(unsigned buffer, std::size_t newBytes, const std::vector<Move>& moves) {
+        // Gather the kept ranges into a scratch buffer, re-create the
+        // storage behind the same name, copy them back. COPY targets only:
+        // no VAO's bindings are touched.
+        std::size_t span = 0;
+        for (const Move& m : moves) span = std::max(span, m.dst + m.bytes);
+
+        unsigned scratch = 0;
+        if (span) {
+            glGenBuffers(1, &scratch);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+            glBufferData(GL_COPY_WRITE_BUFFER, span, nullptr, GL_STREAM_COPY);
+            glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+            for (const Move& m : moves) {
+                if (m.bytes) glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, m.src, m.dst, m.bytes);
+            }
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+        if (span) {
+            glBindBuffer(GL_COPY_READ_BUFFER, scratch);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, span);
+            glDeleteBuffers(1, &scratch);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    MeshArena::Handle MeshArena::Add(const void* vertices, uint32_t vertexCount,
+                                     const uint32_t* indices, uint32_t indexCount) {
+        if (vertexCount == 0 || indexCount == 0) return kNoHandle;
+        ensureContext_();
+
+        uint32_t firstVertex = vertices_.Allocate(vertexCount);
+        if (firstVertex == RangeAllocator::kNone) {
+            const uint32_t cap = std::max(vertices_.Capacity() * 2, vertices_.Capacity() + vertexCount);
+            respecify_(vbo_, cap * stride_, { { 0, 0, vertices_.End() * stride_ } });
+            vertices_.Grow(cap);
+            ++grows_;
+            firstVertex = vertices_.Allocate(vertexCount);
+        }
+        uint32_t firstIndex = indices_.Allocate(indexCount);
+        if (firstIndex == RangeAllocator::kNone) {
+            const uint32_t cap = std::max(indices_.Capacity() * 2, indices_.Capacity() + indexCount);
+            respecify_(ebo_, cap * sizeof(uint32_t), { { 0, 0, indices_.End() * sizeof(uint32_t) } });
+            indices_.Grow(cap);
+            ++grows_;
+            firstIndex = indices_.Allocate(indexCount);
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo_);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, firstVertex * stride_, vertexCount * stride_, vertices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ebo_);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, firstIndex * sizeof(uint32_t), indexCount * sizeof(uint32_t), indices);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        Handle h;
+        if (!freeSlots_.empty()) {
+            h = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        else {
+            h = static_cast<Handle>(slots_.size());
+            slots_.emplace_back();
+        }
+        slots_[h].range = { firstVertex, vertexCount, firstIndex, indexCount };
+        slots_[h].live = true;
+        return h;
+    }
+
+    void MeshArena::Remove(Handle h, uint32_t generation) {
+        if (generation != generation_ || h >= slots_.size() || !slots_[h].live) return;
+        Slot& s = slots_[h];
+        vertices_.Free(s.range.firstVertex, s.range.vertexCount);
+        indices_.Free(s.range.firstIndex, s.range.indexCount);
+        s = Slot{};
+        freeSlots_.push_back(h);
+    }
+
+    bool MeshArena::Compact(bool force) {
+        if (!vao_ || context_ != glfwGetCurrentContext()) return false;
+        const uint32_t vEnd = vertices_.End(), iEnd = indices_.End();
+        const bool holey = (vEnd - vertices_.Used()) * 4 > vEnd ||
+                           (iEnd - indices_.Used()) * 4 > iEnd;
+        if (!force && !holey) return false;
+        CSE_PROFILE_ZONE("MeshArena::Compact");
+
+        // live ranges in buffer order, so the repack keeps their locality
+        std::vector<Handle> live;
+        for (Handle h = 0; h < slots_.size(); ++h) {
+            if (slots_[h].live) live.push_back(h);
+        }
+        std::sort(live.begin(), live.end(), [&](Handle a, Handle b) {
+            return slots_[a].range.firstVertex < slots_[b].range.firstVertex;
+        });
+
+        const uint32_t vCap = std::min(vertices_.Capacity(), std::max(kInitialVertices, vertices_.Used() * 2));
+        const uint32_t iCap = std::min(indices_.Capacity(), std::max(kInitialIndices, indices_.Used() * 2));
+        vertices_.Reset(vCap);
+        indices_.Reset(iCap);
+
+        std::vector<Move> vMoves, iMoves;
+        vMoves.reserve(live.size());
+        iMoves.reserve(live.size());
+        for (Handle h : live) {
+            Range& r = slots_[h].range;
+            const uint32_t v = vertices_.Allocate(r.vertexCount); // fresh: packs from 0
+            const uint32_t i = indices_.Allocate(r.indexCount);
+            vMoves.push_back({ r.firstVertex * stride_, v * stride_, r.vertexCount * stride_ });
+            iMoves.push_back({ r.firstIndex * sizeof(uint32_t), i * sizeof(uint32_t), r.indexCount * sizeof(uint32_t) });
+            r.firstVertex = v;
+            r.firstIndex = i;
+        }
+        respecify_(vbo_, vCap * stride_, vMoves);
+        respecify_(ebo_, iCap * sizeof(uint32_t), iMoves);
+        ++compactions_;
+        return true;
+    }
+
+    MeshArena::Stats MeshArena::GetStats() const {
+        Stats s;
+        s.vertexCapacity = vertices_.Capacity();
+        s.vertexUsed = vertices_.Used();
+        s.indexCapacity = indices_.Capacity();
+        s.indexUsed = indices_.Used();
+        s.ranges = static_cast<uint32_t>(slots_.size() - freeSlots_.size());
+        s.grows = grows_;
+        s.compactions = compactions_;
+        return s;
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,147 @@
+#pragma once
+#include "Core.h"
+#include "Model.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // First-fit allocator over [0, capacity) elements: hands out offsets,
+    // takes them back, and merges neighbouring free blocks so holes left by
+    // unloaded meshes can be reused. Pure bookkeeping, no GL: MeshArena keeps
+    // one for its vertex buffer and one for its index buffer.
+    class ENGINE_API RangeAllocator {
+    public:
+        static constexpr uint32_t kNone = ~0u;
+
+        // Everything free, nothing allocated.
+        void Reset(uint32_t capacity);
+        // Lowest offset with `count` free elements behind it; kNone when no
+        // block is large enough (grow, then ask again). count 0 is kNone.
+        uint32_t Allocate(uint32_t count);
+        // Returns [offset, offset + count), which must have been allocated.
+        void Free(uint32_t offset, uint32_t count);
+        // Adds [Capacity(), capacity) to the free space. Never shrinks.
+        void Grow(uint32_t capacity);
+
+        uint32_t Capacity() const { return capacity_; }
+        uint32_t Used() const { return used_; }
+        // One past the highest allocated element: Used() plus the holes.
+        uint32_t End() const;
+        uint32_t LargestFree() const;
+        std::size_t FreeBlocks() const { return free_.size(); }
+
+    private:
+        std::map<uint32_t, uint32_t> free_; // offset -> count; never adjacent
+        uint32_t capacity_ = 0;
+        uint32_t used_ = 0;
+    };
+
+    // Shared GPU storage for meshes: one vertex buffer, one index buffer and
+    // one VAO per vertex format, with each mesh a range in both. Drawing a
+    // different mesh of the same format is a different offset and base
+    // vertex (glDrawElementsBaseVertex), not a VAO or buffer bind, and the
+    // LOD index lists live in the same index buffer as level 0.
+    //
+    //   MeshArena& arena = MeshArena::For(VertexFormat::Packed);
+    //   Handle h = arena.Add(vertices, vertexCount, indices, indexCount);
+    //   const Range& r = arena.Get(h);    // re-read per draw: Compact moves it
+    //   arena.Remove(h);
+    //
+    // Ranges are allocated first-fit. Growth doubles a buffer in place (the
+    // GL names never change, so neither does the VAO). Compact repacks the
+    // live ranges to the front once holes make up over a quarter of the used
+    // span, and trims the spare capacity; AssetManager::GarbageCollect runs
+    // it for every arena after dropping unloaded models.
+    //
+    // MAIN THREAD ONLY (GL). An arena belongs to the context current when it
+    // first uploaded; if a different context is current on the next Add
+    // (tests re-creating windows), the arena forgets its old GL objects and
+    // starts over, and handles from before are ignored by Remove.
+    class ENGINE_API MeshArena {
+    public:
+        using Handle = uint32_t;
+        static constexpr Handle kNoHandle = ~0u;
+        static constexpr uint32_t kInitialVertices = 1u << 16;
+        static constexpr uint32_t kInitialIndices = 1u << 18;
+
+        // Element offsets into the shared buffers. Indices are mesh-local:
+        // draw with firstVertex as the base vertex.
+        struct Range {
+            uint32_t firstVertex = 0;
+            uint32_t vertexCount = 0;
+            uint32_t firstIndex = 0;
+            uint32_t indexCount = 0;
+        };
+
+        struct Stats {
+            uint32_t vertexCapacity = 0, vertexUsed = 0;
+            uint32_t indexCapacity = 0, indexUsed = 0;
+            uint32_t ranges = 0;      // live meshes
+            uint32_t grows = 0;       // in-place buffer doublings
+            uint32_t compactions = 0; // repacks that moved data
+        };
+
+        // The arena for `format`, created on first use. Never destroyed:
+        // its GL objects go with the context.
+        static MeshArena& For(VertexFormat format);
+        // Compact() on every arena created so far.
+        static void CompactAll();
+
+        // Copies vertexCount vertices of this arena's format and indexCount
+        // indices into the shared buffers.
+        Handle Add(const void* vertices, uint32_t vertexCount,
+                   const uint32_t* indices, uint32_t indexCount);
+        // Frees h's ranges for reuse. No GL; safe without a context.
+        void Remove(Handle h, uint32_t generation);
+        const Range& Get(Handle h) const { return slots_[h].range; }
+        // Bumped when the arena is rebuilt for a new context; Remove only
+        // honours handles from the current generation.
+        uint32_t Generation() const { return generation_; }
+
+        // Repacks when holes are over a quarter of the used span (or always
+        // with force), shrinking capacity toward twice the live data.
+        // Returns true if it repacked.
+        bool Compact(bool force = false);
+
+        VertexFormat Format() const { return format_; }
+        unsigned VAO() const { return vao_; }
+        unsigned VBO() const { return vbo_; }
+        unsigned EBO() const { return ebo_; }
+        std::size_t Stride() const { return stride_; }
+        Stats GetStats() const;
+
+    private:
+        explicit MeshArena(VertexFormat format);
+        void ensureContext_();
+        // Reallocates `buffer` at newBytes, keeping [src, src + bytes) of
+        // each move at dst. Names, and so the VAO, stay valid.
+        struct Move { std::size_t src, dst, bytes; };
+        static void respecify_(unsigned buffer, std::size_t newBytes, const std::vector<Move>& moves);
+
+        struct Slot {
+            Range range;
+            bool live = false;
+        };
+
+        VertexFormat format_;
+        std::size_t stride_ = 0;
+        void* context_ = nullptr;
+        uint32_t generation_ = 0;
+        unsigned vao_ = 0, vbo_ = 0, ebo_ = 0;
+        RangeAllocator vertices_, indices_;
+        std::vector<Slot> slots_;
+        std::vector<Handle> freeSlots_;
+        uint32_t grows_ = 0;
+        uint32_t compactions_ = 0;
+    };
+
+    // Points vertex attributes 0-4 at the bound GL_ARRAY_BUFFER in
+    // `format`'s layout; the bound VAO records them. Shared by the arena and
+    // meshes that own their buffers.
+    ENGINE_API void ApplyVertexLayout(VertexFormat format);
+
+} // namespace MyCoreEngine
@@ -1,14 +1,25 @@
 #include "Model.h"
+#include "MeshArena.h"
+#include "TextureArrays.h"
 #include "Shader.h"
+#include "Profiler.h"
 
 #include <meshoptimizer.h>
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
 
 #include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
 
 #include "stb_image.h"   // declarations only; implementation is in stb_image_impl.cpp
 #include <iostream>
 
 #include <glad/glad.h>
+#include <glm/gtc/packing.hpp>
 
 #include <cstdio>
 #include <GLFW/glfw3.h>
@@ -28,20 +39,100 @@ static std::string normPath(std::string p) {
 
 namespace MyCoreEngine {
 
+    // ---- Vertex packing ----
+    namespace {
+        std::atomic<VertexFormat> sVertexFormat{ VertexFormat::Packed };
+        bool sSharedBuffers = true; // main thread: only the GL constructors read it
+
+        glm::vec3 unitOrZero(const glm::vec3& v) {
+            const float len2 = glm::dot(v, v);
+            return len2 > 0.f ? v / std::sqrt(len2) : glm::vec3(0.f);
+        }
+    } // namespace
+
+    PackedVertex PackVertex(const Vertex& v) {
+        PackedVertex p{};
+        p.Position[0] = v.Position.x;
+        p.Position[1] = v.Position.y;
+        p.Position[2] = v.Position.z;
+        const glm::vec3 n = unitOrZero(v.Normal);
+        const glm::vec3 t = unitOrZero(v.Tangent);
+        // handedness: does the authored bitangent agree with N x T?
+        const float w = glm::dot(glm::cross(n, t), v.Bitangent) < 0.f ? -1.f : 1.f;
+        p.Normal = glm::packSnorm3x10_1x2(glm::vec4(n, 0.f));
+        p.Tangent = glm::packSnorm3x10_1x2(glm::vec4(t, w));
+        p.TexCoords[0] = glm::packHalf1x16(v.TexCoords.x);
+        p.TexCoords[1] = glm::packHalf1x16(v.TexCoords.y);
+        return p;
+    }
+
+    void PackVertices(const std::vector<Vertex>& in, std::vector<PackedVertex>& out) {
+        out.resize(in.size());
+        for (size_t i = 0; i < in.size(); ++i) out[i] = PackVertex(in[i]);
+    }
+
+    void Mesh::SetVertexFormat(VertexFormat f) { sVertexFormat.store(f, std::memory_order_relaxed); }
+    VertexFormat Mesh::GetVertexFormat() { return sVertexFormat.load(std::memory_order_relaxed); }
+    void Mesh::SetSharedBuffers(bool on) { sSharedBuffers = on; }
+    bool Mesh::SharedBuffers() { return sSharedBuffers; }
+
     // ---- Mesh ----
     Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Texture>& textures)
-    : vertices_(vertices), indices_(indices), textures_(textures) {
-        setupBuffers_();
+    : vertices_(vertices), indices_(indices), textures_(textures), format_(GetVertexFormat()) {
+        std::vector<PackedVertex> packed;
+        if (format_ == VertexFormat::Packed) PackVertices(vertices_, packed);
         // synchronous path: compute LODs inline (same total work as before
         // the decode split — meshoptimizer always ran at load)
-        uploadLods_(ComputeLodIndices(vertices_, indices_));
+        upload_(packed, ComputeLodIndices(vertices_, indices_));
     }
 
     Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
-               LodIndexArrays precomputedLods)
-    : vertices_(std::move(vertices)), indices_(std::move(indices)) {
-        setupBuffers_();
-        uploadLods_(precomputedLods); // worker already ran meshoptimizer
+               LodIndexArrays precomputedLods, std::vector<PackedVertex> packed)
+    : vertices_(std::move(vertices)), indices_(std::move(indices)),
+      format_(packed.empty() ? VertexFormat::Full : VertexFormat::Packed) {
+        upload_(packed, precomputedLods); // worker already ran meshoptimizer
+    }
+
+    void Mesh::upload_(const std::vector<PackedVertex>& packed, const LodIndexArrays& lods) {
+        if (sSharedBuffers) {
+            uploadToArena_(packed, lods);
+            return;
+        }
+        setupBuffers_(packed);
+        uploadLods_(lods);
+    }
+
+    void Mesh::uploadToArena_(const std::vector<PackedVertex>& packed, const LodIndexArrays& lods) {
+        // One index range per mesh: level 0, then each accepted LOD list.
+        // Levels are offsets into it, so no level has a buffer of its own.
+        std::vector<unsigned int> all(indices_);
+        lods_[0] = { 0, static_cast<GLsizei>(indices_.size()), 0 };
+        for (int l = 1; l < kLodCount; ++l) {
+            if (!lods[l].empty()) {
+                lods_[l] = { 0, static_cast<GLsizei>(lods[l].size()), static_cast<GLsizei>(all.size()) };
+                all.insert(all.end(), lods[l].begin(), lods[l].end());
+            }
+            else {
+                lods_[l] = lods_[l - 1]; // fall back to the previous level
+            }
+        }
+
+        MeshArena& arena = MeshArena::For(format_);
+        const bool isPacked = format_ == VertexFormat::Packed;
+        const void* data = isPacked ? static_cast<const void*>(packed.data()) : vertices_.data();
+        const uint32_t count = static_cast<uint32_t>(isPacked ? packed.size() : vertices_.size());
+        const MeshArena::Handle h = arena.Add(data, count, all.data(), static_cast<uint32_t>(all.size()));
+        if (h == MeshArena::kNoHandle) { // empty mesh: owned buffers, as before
+            setupBuffers_(packed);
+            uploadLods_(lods);
+            return;
+        }
+        arena_ = &arena;
+        arenaSlot_ = h;
+        arenaGen_ = arena.Generation();
+        vertexBytes_ = std::size_t(count) * arena.Stride();
+        // the shared EBO never changes name (growth is in place)
+        for (LodRange& lr : lods_) lr.ebo = arena.EBO();
     }
 
     static void deleteLodBuffers_(const Mesh::LodRange* lods, unsigned baseEBO) {
@@ -55,8 +146,12 @@ namespace MyCoreEngine {
         }
     }
 
-    Mesh::~Mesh() {
-        // texture ids are shared via the global cache; only buffers are owned here.
+    void Mesh::release_() {
+        if (arena_) {
+            arena_->Remove(arenaSlot_, arenaGen_); // bookkeeping only, no GL
+            arena_ = nullptr;
+            return;
+        }
         // Guard: if the GL context is already gone (late static teardown), skip.
         if (!glfwGetCurrentContext()) return;
         deleteLodBuffers_(lods_, EBO_);
@@ -65,63 +160,65 @@ namespace MyCoreEngine {
         if (VAO_) glDeleteVertexArrays(1, &VAO_);
     }
 
+    Mesh::~Mesh() {
+        // texture ids are shared via the global cache; only buffers are owned here.
+        release_();
+    }
+
     Mesh::Mesh(Mesh&& other) noexcept
         : vertices_(std::move(other.vertices_)),
           indices_(std::move(other.indices_)),
           textures_(std::move(other.textures_)),
           material_(std::move(other.material_)),
           materialIndex_(other.materialIndex_),
-          VAO_(other.VAO_), VBO_(other.VBO_), EBO_(other.EBO_) {
+          legacyMaterial_(std::move(other.legacyMaterial_)),
+          VAO_(other.VAO_), VBO_(other.VBO_), EBO_(other.EBO_),
+          format_(other.format_), vertexBytes_(other.vertexBytes_),
+          arena_(other.arena_), arenaSlot_(other.arenaSlot_), arenaGen_(other.arenaGen_) {
         for (int l = 0; l < kLodCount; ++l) { lods_[l] = other.lods_[l]; other.lods_[l] = {}; }
         other.VAO_ = other.VBO_ = other.EBO_ = 0;
+        other.arena_ = nullptr;
     }
 
     Mesh& Mesh::operator=(Mesh&& other) noexcept {
         if (this != &other) {
-            if (glfwGetCurrentContext()) {
-                deleteLodBuffers_(lods_, EBO_);
-                if (EBO_) glDeleteBuffers(1, &EBO_);
-                if (VBO_) glDeleteBuffers(1, &VBO_);
-                if (VAO_) glDeleteVertexArrays(1, &VAO_);
-            }
+            release_();
             vertices_ = std::move(other.vertices_);
             indices_ = std::move(other.indices_);
             textures_ = std::move(other.textures_);
             material_ = std::move(other.material_);
             materialIndex_ = other.materialIndex_;
+            legacyMaterial_ = std::move(other.legacyMaterial_);
             VAO_ = other.VAO_; VBO_ = other.VBO_; EBO_ = other.EBO_;
+            format_ = other.format_;
+            vertexBytes_ = other.vertexBytes_;
+            arena_ = other.arena_; arenaSlot_ = other.arenaSlot_; arenaGen_ = other.arenaGen_;
             for (int l = 0; l < kLodCount; ++l) { lods_[l] = other.lods_[l]; other.lods_[l] = {}; }
             other.VAO_ = other.VBO_ = other.EBO_ = 0;
+            other.arena_ = nullptr;
         }
         return *this;
     }
-    void Mesh::setupBuffers_() {
+    void Mesh::setupBuffers_(const std::vector<PackedVertex>& packed) {
         glGenVertexArrays(1, &VAO_);
         glGenBuffers(1, &VBO_);
         glGenBuffers(1, &EBO_);
 
         glBindVertexArray(VAO_);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
-        glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), vertices_.data(), GL_STATIC_DRAW);
-
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned int), indices_.data(), GL_STATIC_DRAW);
 
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-
-        glEnableVertexAttribArray(2);
-        glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-
-        glEnableVertexAttribArray(3);
-        glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-
-        glEnableVertexAttribArray(4);
-        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+        if (format_ == VertexFormat::Packed) {
+            vertexBytes_ = packed.size() * sizeof(PackedVertex);
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes_, packed.data(), GL_STATIC_DRAW);
+        }
+        else {
+            vertexBytes_ = vertices_.size() * sizeof(Vertex);
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes_, vertices_.data(), GL_STATIC_DRAW);
+        }
+        ApplyVertexLayout(format_);
 
         glBindVertexArray(0);
     }
@@ -195,9 +292,8 @@ namespace MyCoreEngine {
             glBindTexture(GL_TEXTURE_2D, textures_[i].id);
         }
 
-        glBindVertexArray(VAO_);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_); // LOD draws may have rebound the VAO's element buffer
-        glDrawElements(GL_TRIANGLES, (GLsizei)indices_.size(), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(VAO());
+        IssueDraw(0);
         glBindVertexArray(0);
         glActiveTexture(GL_TEXTURE0);
     }
@@ -212,63 +308,28 @@ namespace MyCoreEngine {
             | ((uint64_t)idAt(3) << 48);
     }
     unsigned int Mesh::IndexCount() const { return static_cast<unsigned int>(indices_.size()); }
-    unsigned int Mesh::VAO() const { return VAO_; } // whatever your VAO member is named
+    unsigned int Mesh::VAO() const { return arena_ ? arena_->VAO() : VAO_; }
+    uint32_t Mesh::BaseVertex() const { return arena_ ? arena_->Get(arenaSlot_).firstVertex : 0; }
+    uint32_t Mesh::FirstIndex() const { return arena_ ? arena_->Get(arenaSlot_).firstIndex : 0; }
     void Mesh::IssueDrawInstanced(GLsizei instanceCount, int lod) const {
+        const LodRange& lr = Lod(lod);
+        if (arena_) {
+            // the arena VAO's element buffer holds every level: just offsets
+            const MeshArena::Range& r = arena_->Get(arenaSlot_);
+            const std::size_t first = std::size_t(r.firstIndex) + lr.firstIndex;
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, lr.indexCount, GL_UNSIGNED_INT,
+                (void*)(first * sizeof(unsigned int)), instanceCount, (GLint)r.firstVertex);
+            return;
+        }
         // Explicitly bind the level's index buffer: LOD draws mutate the
         // shared VAO's element-array binding, so every issue path binds its own.
-        const LodRange& lr = Lod(lod);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lr.ebo);
         glDrawElementsInstanced(GL_TRIANGLES, lr.indexCount, GL_UNSIGNED_INT, 0, instanceCount);
     }
-    void Mesh::BindForDraw(MyCoreEngine::Shader& shader) const {
+    void Mesh::BindForDraw(MyCoreEngine::Shader& shader, const MyCoreEngine::Material& defaults) const {
 
         if (material_) {
-            // Per-material scalar uniforms (override scene defaults)
-            shader.setVec3("uBaseColor", material_->baseColor);
-            shader.setVec3("uEmissive", material_->emissive);
-            shader.setFloat("uMetallic", material_->metallic);
-            shader.setFloat("uRoughness", material_->roughness);
-            shader.setFloat("uAO", material_->ao);
-            // Fixed units: 0 albedo, 1 normal, 2 metal, 3 rough, 4 ao, 5 emissive (optional)
-            // Albedo
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, material_->albedoTex);
-            shader.setInt("diffuseMap", 0); // your shader uses this name
-            // Normal
-            const bool hasNormal = material_->hasNormal();
-            if (hasNormal) {
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, material_->normalTex);
-                shader.setInt("normalMap", 1);
-            }
-            shader.setInt("uHasNormalMap", hasNormal ? 1 : 0);
-
-            // MR/A
-            if (material_->hasMetallic()) {
-                glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, material_->metallicTex);
-                shader.setInt("metallicMap", 2);
-            }
-            if (material_->hasRoughness()) {
-                glActiveTexture(GL_TEXTURE3);
-                glBindTexture(GL_TEXTURE_2D, material_->roughnessTex);
-                shader.setInt("roughnessMap", 3);
-            }
-            if (material_->hasAO()) {
-                glActiveTexture(GL_TEXTURE4);
-                glBindTexture(GL_TEXTURE_2D, material_->aoTex);
-                shader.setInt("aoMap", 4);
-            }
-            shader.setInt("uHasMetallicMap", material_->hasMetallic() ? 1 : 0);
-            shader.setInt("uHasRoughnessMap", material_->hasRoughness() ? 1 : 0);
-            shader.setInt("uHasAOMap", material_->hasAO() ? 1 : 0);
-
-            // Scalars fallback (shader already uses uMetallic/uRoughness/uAO set per-frame;
-            // baseColor/emissive we can set per-draw here if you want)
-            // If you want baseColor as a factor, add a uniform and set it here.
-
-            glActiveTexture(GL_TEXTURE0);
-            glBindVertexArray(VAO_);
+            BindForDrawWith(shader, *material_);
             return;
         }
 
@@ -282,22 +343,7 @@ namespace MyCoreEngine {
             if (diffuseId && normalId) break;
         }
 
-        // --- Bind fixed texture units ---
-        // diffuse -> unit 0
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, diffuseId ? diffuseId : 0);
-        shader.setInt("diffuseMap", 0);
-
-        // normal -> unit 1 (if present)
-        const bool hasNormal = (normalId != 0);
-        if (hasNormal) {
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, normalId);
-            shader.setInt("normalMap", 1);
-        }
-        shader.setInt("uHasNormalMap", hasNormal ? 1 : 0);
-
-        // --- Metallic / Roughness / AO maps: bind to fixed slots if present ---
+        // --- Metallic / Roughness / AO maps ---
         // Common names we may see via Assimp importers:
         static auto isMetal = [](const std::string& t) {
             return t == "texture_metallic" || t == "metallic" || t == "metalness";
@@ -317,92 +363,50 @@ namespace MyCoreEngine {
             if (metalId && roughId && aoId) break;
         }
 
-        // metallic -> unit 2
-        if (metalId) {
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, metalId);
-        }
-        // roughness -> unit 3
-        if (roughId) {
-            glActiveTexture(GL_TEXTURE3);
-            glBindTexture(GL_TEXTURE_2D, roughId);
-        }
-        // ao -> unit 4
-        if (aoId) {
-            glActiveTexture(GL_TEXTURE4);
-            glBindTexture(GL_TEXTURE_2D, aoId);
-        }
-
-        // tell the shader
-        shader.setInt("metallicMap", 2);
-        shader.setInt("roughnessMap", 3);
-        shader.setInt("aoMap", 4);
-        shader.setInt("uHasMetallicMap", metalId ? 1 : 0);
-        shader.setInt("uHasRoughnessMap", roughId ? 1 : 0);
-        shader.setInt("uHasAOMap", aoId ? 1 : 0);
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindVertexArray(VAO_);
+        // The maps found, with the caller's scalars, as this mesh's own
+        // material: bound like any other, and its block cached the same way
+        // (assigning keeps legacyMaterial_'s buffer).
+        legacyMaterial_ = defaults;
+        legacyMaterial_.albedoTex = diffuseId;
+        legacyMaterial_.normalTex = normalId;
+        legacyMaterial_.metallicTex = metalId;
+        legacyMaterial_.roughnessTex = roughId;
+        legacyMaterial_.aoTex = aoId;
+        BindForDrawWith(shader, legacyMaterial_);
     }
-    void Mesh::BindForDrawWith(MyCoreEngine::Shader& shader, const MyCoreEngine::Material& m) const
+    void Mesh::BindForDrawWith(MyCoreEngine::Shader& /*shader*/, const MyCoreEngine::Material& m) const
     {
-        // Per-material scalar uniforms
-        shader.setVec3("uBaseColor", m.baseColor);
-        shader.setVec3("uEmissive", m.emissive);
-        shader.setFloat("uMetallic", m.metallic);
-        shader.setFloat("uRoughness", m.roughness);
-        shader.setFloat("uAO", m.ao);
-
-        // Shading model: 0 PBR, 1 Toon. Set on EVERY bind (unlike the alpha
-        // uniforms below) -- draws are NOT grouped by shading model, so a toon
-        // draw must not leave the flag stale for a following PBR draw.
-        shader.setInt("uShadingModel", static_cast<int>(m.shadingModel));
-        // Toon look, only for toon materials (PBR ignores these uniforms). The
-        // batch key folds these in, so a toon run's params are consistent.
-        if (m.shadingModel == MyCoreEngine::ShadingModel::Toon) {
-            shader.setFloat("uToonBands", static_cast<float>(m.toonBands));
-            shader.setFloat("uToonSpecStrength", m.toonSpecStrength);
-            shader.setFloat("uToonSpecSize", m.toonSpecSize);
-            shader.setFloat("uToonRimStrength", m.toonRimStrength);
-        }
-
-        // Alpha: 1 Mask (discard below cutoff), 2 Blend (output opacity*alpha).
-        // Uploaded ONLY for non-opaque materials, so an opaque bind emits the
-        // exact same uniform traffic it did before transparency existed -- the
-        // opaque hot path must not pay 3 extra glUniform calls per bind. Opaque
-        // relies on the per-frame uAlphaMode=0 default set in
-        // uploadGlobalShadingUniforms_, and opaque runs are always drawn before
-        // any masked run, so uAlphaMode is never left stale at an opaque draw.
-        if (m.alphaMode != MyCoreEngine::AlphaMode::Opaque) {
-            shader.setInt("uAlphaMode", static_cast<int>(m.alphaMode));
-            shader.setFloat("uOpacity", m.opacity);
-            shader.setFloat("uAlphaCutoff", m.alphaCutoff);
-        }
-
-        // Textures: identical layout to your existing BindForDraw(...)
-        // 0: albedo (sRGB), 1: normal (linear), 2: metallic, 3: roughness, 4: AO, 5: emissive (optional)
-        const bool hasNormal = (m.normalTex != 0);
-        const bool hasMetallic = (m.metallicTex != 0);
-        const bool hasRoughness = (m.roughnessTex != 0);
-        const bool hasAO = (m.aoTex != 0);
-
-        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, m.albedoTex);    shader.setInt("diffuseMap", 0);
-        if (hasNormal) { glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, m.normalTex);    shader.setInt("normalMap", 1); }
-        if (hasMetallic) { glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, m.metallicTex);  shader.setInt("metallicMap", 2); }
-        if (hasRoughness) { glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, m.roughnessTex); shader.setInt("roughnessMap", 3); }
-        if (hasAO) { glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, m.aoTex);        shader.setInt("aoMap", 4); }
-
-        shader.setInt("uHasNormalMap", hasNormal ? 1 : 0);
-        shader.setInt("uHasMetallicMap", hasMetallic ? 1 : 0);
-        shader.setInt("uHasRoughnessMap", hasRoughness ? 1 : 0);
-        shader.setInt("uHasAOMap", hasAO ? 1 : 0);
+        // Every scalar goes up as one uniform block (baseColor, emissive,
+        // metallic/roughness/AO, shading model and toon look, alpha, which
+        // maps are present), uploaded only when the material changed since
+        // its last bind. The gating that used to keep the opaque bind free of
+        // the toon and alpha uniforms is in PackMaterialBlock now: those
+        // fields pack as defaults unless the material uses them, matching
+        // the batch key.
+        const MyCoreEngine::MaterialBlockData block = MyCoreEngine::PackMaterialBlock(m);
+        m.block.Bind(MyCoreEngine::MaterialBlockData::kBinding, &block, sizeof(block));
+
+        // Textures on fixed units: 0 albedo (sRGB), 1 normal (linear),
+        // 2 metallic, 3 roughness, 4 AO. The samplers are pointed at them
+        // once per frame (Scene::uploadGlobalShadingUniforms_), not here.
+        glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, m.albedoTex);
+        if (m.hasNormal()) { glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, m.normalTex); }
+        if (m.hasMetallic()) { glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, m.metallicTex); }
+        if (m.hasRoughness()) { glActiveTexture(GL_TEXTURE3); glBindTexture(GL_TEXTURE_2D, m.roughnessTex); }
+        if (m.hasAO()) { glActiveTexture(GL_TEXTURE4); glBindTexture(GL_TEXTURE_2D, m.aoTex); }
 
-        glBindVertexArray(VAO_);
         glActiveTexture(GL_TEXTURE0);
     }
 
     void Mesh::IssueDraw(int lod) const {
         const LodRange& lr = Lod(lod);
+        if (arena_) {
+            const MeshArena::Range& r = arena_->Get(arenaSlot_);
+            const std::size_t first = std::size_t(r.firstIndex) + lr.firstIndex;
+            glDrawElementsBaseVertex(GL_TRIANGLES, lr.indexCount, GL_UNSIGNED_INT,
+                (void*)(first * sizeof(unsigned int)), (GLint)r.firstVertex);
+            return;
+        }
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lr.ebo);
         glDrawElements(GL_TRIANGLES, lr.indexCount, GL_UNSIGNED_INT, 0);
     }
@@ -410,6 +414,81 @@ namespace MyCoreEngine {
     // ---- Model: decode stage (WORKER-SAFE — no GL, no shared state) ----
 
     namespace {
+        // A whole file already in memory, as Assimp's stream interface.
+        // Holds the blob, so the bytes outlive the IOService request.
+        class BlobIOStream final : public Assimp::IOStream {
+        public:
+            explicit BlobIOStream(IOBlobPtr blob) : blob_(std::move(blob)) {}
+
+            size_t Read(void* buffer, size_t size, size_t count) override {
+                if (size == 0) return 0;
+                const size_t n = std::min(count, (blob_->bytes.size() - pos_) / size);
+                if (n) std::memcpy(buffer, blob_->bytes.data() + pos_, n * size);
+                pos_ += n * size;
+                return n;
+            }
+            size_t Write(const void*, size_t, size_t) override { return 0; }
+            aiReturn Seek(size_t offset, aiOrigin origin) override {
+                // aiOrigin_END counts back from the end, as Assimp's own
+                // MemoryIOStream does
+                const size_t len = blob_->bytes.size();
+                size_t to = 0;
+                switch (origin) {
+                case aiOrigin_SET: to = offset; break;
+                case aiOrigin_CUR: to = pos_ + offset; break;
+                case aiOrigin_END: if (offset > len) return aiReturn_FAILURE; to = len - offset; break;
+                default: return aiReturn_FAILURE;
+                }
+                if (to > len) return aiReturn_FAILURE;
+                pos_ = to;
+                return aiReturn_SUCCESS;
+            }
+            size_t Tell() const override { return pos_; }
+            size_t FileSize() const override { return blob_->bytes.size(); }
+            void Flush() override {}
+
+        private:
+            IOBlobPtr blob_;
+            size_t pos_ = 0;
+        };
+
+        // Assimp's file access routed through the IOService: the model
+        // itself from the bytes the caller read, anything it references
+        // (.mtl, external .bin buffers) via io.Read. Read-only — an import
+        // never writes. Owned (and deleted) by the Importer.
+        class ServiceIOSystem final : public Assimp::IOSystem {
+        public:
+            ServiceIOSystem(IOService& io, std::string modelPath, IOBlobPtr modelBytes)
+                : io_(io), modelPath_(std::move(modelPath)), modelBytes_(std::move(modelBytes)) {}
+
+            bool Exists(const char* file) const override {
+                if (modelPath_ == file) return true;
+                std::error_code ec; // a stat, not a read: importers probe for optional files
+                return std::filesystem::is_regular_file(file, ec);
+            }
+            char getOsSeparator() const override {
+    #ifdef _WIN32
+                return '\\';
+    #else
+                return '/';
+    #endif
+            }
+            Assimp::IOStream* Open(const char* file, const char* mode) override {
+                if (std::strchr(mode, 'w') || std::strchr(mode, 'a')) return nullptr;
+                // Importers open the model more than once (format sniffing,
+                // then the real parse): every open of it shares one blob.
+                IOBlobPtr blob = (modelPath_ == file) ? modelBytes_ : io_.ReadNow(file);
+                if (!blob || !blob->ok) return nullptr;
+                return new BlobIOStream(std::move(blob));
+            }
+            void Close(Assimp::IOStream* stream) override { delete stream; }
+
+        private:
+            IOService& io_;
+            std::string modelPath_;
+            IOBlobPtr modelBytes_;
+        };
+
         // same filename resolution the old TextureFromFile used
         std::string resolveTexFilename(const std::string& file, const std::string& directory) {
             if (file.empty() || directory.empty()) return file;
@@ -459,6 +538,7 @@ namespace MyCoreEngine {
                         md.indices.push_back(face.mIndices[j]);
                 }
 
+                if (cpu.vertexFormat == VertexFormat::Packed) PackVertices(md.vertices, md.packed);
                 md.lodIndices = Mesh::ComputeLodIndices(md.vertices, md.indices);
                 md.materialIndex = (mesh->mMaterialIndex < cpu.materials.size())
                                  ? (int)mesh->mMaterialIndex : -1;
@@ -473,7 +553,8 @@ namespace MyCoreEngine {
     int Model::decodeTextureSlot_(ModelCPUData& cpu, ::aiMaterial* mat,
                                   aiTextureType primary, aiTextureType fallback,
                                   bool isSRGB, const std::string& directory,
-                                  const std::unordered_set<std::string>* skipDecodeKeys)
+                                  const std::unordered_set<std::string>* skipDecodeKeys,
+                                  IOService* io)
     {
         const std::string file = texFileFromSlot(mat, primary, fallback);
         if (file.empty()) return -1; // slot absent on the material
@@ -501,7 +582,18 @@ namespace MyCoreEngine {
         // global stbi flag would be a data race
         stbi_set_flip_vertically_on_load_thread(1);
         int w = 0, h = 0, c = 0;
-        unsigned char* data = stbi_load(t.file.c_str(), &w, &h, &c, 4);
+        unsigned char* data = nullptr;
+        if (io) {
+            // usually resident already: the directory was read ahead while
+            // the mesh parsed
+            const IOBlobPtr bytes = io->ReadNow(t.file);
+            if (bytes->ok && bytes->bytes.size() <= (size_t)INT_MAX) {
+                data = stbi_load_from_memory(bytes->bytes.data(), (int)bytes->bytes.size(), &w, &h, &c, 4);
+            }
+        }
+        else {
+            data = stbi_load(t.file.c_str(), &w, &h, &c, 4);
+        }
         if (data) {
             t.width = w;
             t.height = h;
@@ -519,14 +611,39 @@ namespace MyCoreEngine {
         return (int)cpu.textures.size() - 1;
     }
 
-    ModelCPUData Model::Decode(const std::string& path, bool /*gamma*/,
+    ModelCPUData Model::Decode(const std::string& path, bool gamma,
                                const std::unordered_set<std::string>* skipDecodeKeys)
     {
+        return decode_(path, gamma, skipDecodeKeys, nullptr, nullptr);
+    }
+
+    ModelCPUData Model::Decode(const std::string& path, bool gamma,
+                               const std::unordered_set<std::string>* skipDecodeKeys,
+                               IOService& io, IOBlobPtr modelBytes)
+    {
+        return decode_(path, gamma, skipDecodeKeys, &io, std::move(modelBytes));
+    }
+
+    ModelCPUData Model::decode_(const std::string& path, bool /*gamma*/,
+                                const std::unordered_set<std::string>* skipDecodeKeys,
+                                IOService* io, IOBlobPtr modelBytes)
+    {
+        CSE_PROFILE_ZONE("Model::Decode");
         ModelCPUData cpu;
         cpu.sourcePath = normPath(path);
+        cpu.vertexFormat = Mesh::GetVertexFormat();
         MLOG("decode begin: %s", path.c_str());
 
         Assimp::Importer importer; // one importer per call: Assimp is thread-safe this way
+        if (io) {
+            if (!modelBytes) modelBytes = io->ReadNow(path);
+            if (!modelBytes->ok) {
+                std::cerr << "ERROR::MODEL::LOAD_FAILED '" << path << "': "
+                          << modelBytes->error << std::endl;
+                return cpu;
+            }
+            importer.SetIOHandler(new ServiceIOSystem(*io, path, modelBytes)); // importer owns it
+        }
         const ::aiScene* scene = importer.ReadFile(path,
             aiProcess_Triangulate |
             // Merge identical vertices into indexed geometry. Without this the
@@ -589,12 +706,12 @@ namespace MyCoreEngine {
             if (AI_SUCCESS == aim->Get(AI_MATKEY_ROUGHNESS_FACTOR, f)) md.base.roughness = std::clamp(f, 0.f, 1.f);
 
             // linear formats for MR/AO/normal, sRGB for albedo/emissive
-            md.albedo    = decodeTextureSlot_(cpu, aim, aiTextureType_BASE_COLOR, aiTextureType_DIFFUSE, /*srgb=*/true, cpu.directory, skipDecodeKeys);
-            md.normal    = decodeTextureSlot_(cpu, aim, aiTextureType_NORMALS, aiTextureType_HEIGHT,   /*srgb=*/false, cpu.directory, skipDecodeKeys);
-            md.metallic  = decodeTextureSlot_(cpu, aim, aiTextureType_METALNESS, aiTextureType_UNKNOWN,  /*srgb=*/false, cpu.directory, skipDecodeKeys);
-            md.roughness = decodeTextureSlot_(cpu, aim, aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_UNKNOWN, /*srgb=*/false, cpu.directory, skipDecodeKeys);
-            md.ao        = decodeTextureSlot_(cpu, aim, aiTextureType_AMBIENT_OCCLUSION, aiTextureType_AMBIENT, /*srgb=*/false, cpu.directory, skipDecodeKeys);
-            md.emissive  = decodeTextureSlot_(cpu, aim, aiTextureType_EMISSIVE, aiTextureType_EMISSIVE, /*srgb=*/true, cpu.directory, skipDecodeKeys);
+            md.albedo    = decodeTextureSlot_(cpu, aim, aiTextureType_BASE_COLOR, aiTextureType_DIFFUSE, /*srgb=*/true, cpu.directory, skipDecodeKeys, io);
+            md.normal    = decodeTextureSlot_(cpu, aim, aiTextureType_NORMALS, aiTextureType_HEIGHT,   /*srgb=*/false, cpu.directory, skipDecodeKeys, io);
+            md.metallic  = decodeTextureSlot_(cpu, aim, aiTextureType_METALNESS, aiTextureType_UNKNOWN,  /*srgb=*/false, cpu.directory, skipDecodeKeys, io);
+            md.roughness = decodeTextureSlot_(cpu, aim, aiTextureType_DIFFUSE_ROUGHNESS, aiTextureType_UNKNOWN, /*srgb=*/false, cpu.directory, skipDecodeKeys, io);
+            md.ao        = decodeTextureSlot_(cpu, aim, aiTextureType_AMBIENT_OCCLUSION, aiTextureType_AMBIENT, /*srgb=*/false, cpu.directory, skipDecodeKeys, io);
+            md.emissive  = decodeTextureSlot_(cpu, aim, aiTextureType_EMISSIVE, aiTextureType_EMISSIVE, /*srgb=*/true, cpu.directory, skipDecodeKeys, io);
         }
 
         collectMeshes(scene, scene->mRootNode, cpu);
@@ -671,12 +788,16 @@ namespace MyCoreEngine {
             mat->roughnessTex = slot(md.roughness);
             mat->aoTex        = slot(md.ao);
             mat->emissiveTex  = slot(md.emissive);
+            // albedo maps of one size batch through a texture array (a
+            // texture already registered by an earlier model is a no-op)
+            TextureArrays::Get().Add(mat->albedoTex);
             materials_[i] = std::move(mat);
         }
 
         meshes_.reserve(cpu.meshes.size());
         for (auto& md : cpu.meshes) {
-            Mesh mesh(std::move(md.vertices), std::move(md.indices), std::move(md.lodIndices));
+            Mesh mesh(std::move(md.vertices), std::move(md.indices), std::move(md.lodIndices),
+                      std::move(md.packed));
             if (md.materialIndex >= 0 && (size_t)md.materialIndex < materials_.size() &&
                 materials_[md.materialIndex]) {
                 // Pass the SLOT too, not just the shared Material object -- the
@@ -2,12 +2,15 @@
 
 #include "Material.h"
 #include "Core.h"
+#include "IOService.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <unordered_map>
 #include <unordered_set>
 #include <glm/glm.hpp>
@@ -25,6 +28,7 @@ typedef int GLsizei;
 namespace MyCoreEngine {
 
     class Shader;
+    class MeshArena;
 
     // ----- Texture -----
     struct Texture {
@@ -42,6 +46,32 @@ namespace MyCoreEngine {
         glm::vec3 Bitangent{};
     };
 
+    // ----- PackedVertex -----
+    // What a mesh keeps in VRAM by default: 24 bytes against Vertex's 56.
+    // Position stays float (half precision would shear large props). Normal
+    // and tangent are signed 10:10:10:2 normalized (GL_INT_2_10_10_10_REV),
+    // which the vertex fetch expands to the same vec3/vec4 inputs the float
+    // layout feeds, so one shader reads both layouts with no branch. The
+    // tangent's 2-bit w is the bitangent's handedness; the bitangent itself
+    // is rebuilt in the vertex shader. UVs are half floats: tiling UVs run
+    // outside [0,1], which rules out unorm16.
+    struct PackedVertex {
+        float    Position[3];
+        uint32_t Normal;
+        uint32_t Tangent;      // w: +1 right-handed, -1 mirrored UVs
+        uint16_t TexCoords[2];
+    };
+    static_assert(sizeof(PackedVertex) == 24, "PackedVertex is uploaded as-is");
+
+    // The vertex buffer layout a Mesh uploads. Full is the original float
+    // Vertex, kept for comparison and as an escape hatch should the
+    // quantization ever show on an asset.
+    enum class VertexFormat { Full, Packed };
+
+    // WORKER-SAFE (no GL): Vertex -> PackedVertex.
+    ENGINE_API PackedVertex PackVertex(const Vertex& v);
+    ENGINE_API void PackVertices(const std::vector<Vertex>& in, std::vector<PackedVertex>& out);
+
     // ----- Mesh -----
     class ENGINE_API Mesh {
     public:
@@ -49,7 +79,8 @@ namespace MyCoreEngine {
         Mesh(const std::vector<Vertex>& vertices,
             const std::vector<unsigned int>& indices,
             const std::vector<Texture>& textures);
-        // Owns VAO/VBO/EBO (textures are shared via the global cache): move-only
+        // Owns its buffers, or its ranges in the shared MeshArena (textures
+        // are shared via the global cache): move-only
         ~Mesh();
         Mesh(const Mesh&) = delete;
         Mesh& operator=(const Mesh&) = delete;
@@ -59,7 +90,9 @@ namespace MyCoreEngine {
         void Draw(Shader& shader) const;
         const std::vector<Vertex>& Vertices() const { return vertices_; }
         unsigned int IndexCount() const;
-        unsigned int VAO() const;          // returns VAO_ (your VAO handle)
+        // The VAO to bind before IssueDraw: the format's shared arena VAO,
+        // or this mesh's own.
+        unsigned int VAO() const;
         // Pack up to first 4 texture ids into a 64-bit signature for bucketing
         uint64_t TextureSignature() const;
 
@@ -71,6 +104,7 @@ namespace MyCoreEngine {
         struct LodRange {
             unsigned ebo = 0;
             GLsizei  indexCount = 0;
+            GLsizei  firstIndex = 0; // shared buffers: from the mesh's first index
         };
         const LodRange& Lod(int level) const;
 
@@ -84,14 +118,39 @@ namespace MyCoreEngine {
                                                 const std::vector<unsigned int>& indices);
         // MAIN THREAD (GL): build from data a worker already decoded —
         // uploads buffers and the precomputed LOD indices without re-running
-        // meshoptimizer.
+        // meshoptimizer. `packed` is PackVertices(vertices) for the Packed
+        // layout, also made on the worker; empty uploads the Full layout.
         Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices,
-             LodIndexArrays precomputedLods);
+             LodIndexArrays precomputedLods, std::vector<PackedVertex> packed = {});
 
-        // split draw into bind vs issue
-        void BindForDraw(MyCoreEngine::Shader& shader) const; // bind textures + VAO (no draw)
+        // Layout for meshes built from now on (existing meshes keep theirs).
+        // Packed by default. Model::Decode reads it on workers, so it is
+        // atomic; a model takes the value current when its decode started.
+        static void SetVertexFormat(VertexFormat f);
+        static VertexFormat GetVertexFormat();
+        VertexFormat Format() const { return format_; }
+        // This mesh's vertex buffer in VRAM (index buffers not included).
+        std::size_t VertexBytes() const { return vertexBytes_; }
+
+        // Meshes built from now on suballocate the MeshArena of their vertex
+        // format (on by default) or own a VAO/VBO/EBO each, as before. Main
+        // thread, like the constructors that read it.
+        static void SetSharedBuffers(bool on);
+        static bool SharedBuffers();
+        bool InArena() const { return arena_ != nullptr; }
+        // Shared buffers: where this mesh starts in the arena's VBO (the base
+        // vertex) and EBO. Both 0 for owned buffers. Re-read after a
+        // MeshArena::Compact, which moves them.
+        uint32_t BaseVertex() const;
+        uint32_t FirstIndex() const;
+
+        // split draw into bind vs issue. The binds set textures and the
+        // material block only; bind VAO() yourself, once per run of meshes
+        // sharing it. BindForDraw is for a mesh without a material: the maps
+        // come from its textures by type, the scalars from `defaults`.
+        void BindForDraw(MyCoreEngine::Shader& shader, const MyCoreEngine::Material& defaults) const;
         void BindForDrawWith(MyCoreEngine::Shader& shader, const MyCoreEngine::Material& mat) const;
-        void IssueDraw(int lod = 0) const;                    // just glDrawElements
+        void IssueDraw(int lod = 0) const;                    // glDrawElements(BaseVertex)
         void IssueDrawInstanced(GLsizei instanceCount, int lod = 0) const;
         // slot is the material's index in the owning Model's Materials() list.
         // It MUST be passed: MaterialIndex() is the key the editor's per-entity
@@ -113,11 +172,24 @@ namespace MyCoreEngine {
         std::vector<Texture>      textures_;
         MyCoreEngine::MaterialHandle material_; // optional
         size_t materialIndex_ = 0;
+        mutable MyCoreEngine::Material legacyMaterial_; // BindForDraw's, for its block
         unsigned int VAO_ = 0, VBO_ = 0, EBO_ = 0;
         LodRange lods_[kLodCount]{};
+        VertexFormat format_ = VertexFormat::Full;
+        std::size_t vertexBytes_ = 0;
+        MeshArena* arena_ = nullptr; // null: the buffers above are this mesh's
+        uint32_t arenaSlot_ = 0;
+        uint32_t arenaGen_ = 0;
 
-        void setupBuffers_();                       // VAO/VBO/EBO upload (GL)
+        // Both paths: the level-0 and LOD index lists, then the vertices in
+        // format_ (`packed` when Packed), uploaded one way or the other (GL)
+        void upload_(const std::vector<PackedVertex>& packed, const LodIndexArrays& lods);
+        // Shared: one vertex range and one index range (all levels) in the arena
+        void uploadToArena_(const std::vector<PackedVertex>& packed, const LodIndexArrays& lods);
+        // Owned: VAO/VBO/EBO; `packed` is used when format_ is Packed
+        void setupBuffers_(const std::vector<PackedVertex>& packed);
         void uploadLods_(const LodIndexArrays&);    // LOD EBOs / aliasing (GL)
+        void release_();                            // frees either kind (GL for owned)
     };
 
     // ----- ModelCPUData -----
@@ -145,6 +217,7 @@ namespace MyCoreEngine {
         struct MeshData {
             std::vector<Vertex> vertices;
             std::vector<unsigned int> indices;
+            std::vector<PackedVertex> packed; // Packed layout only, else empty
             Mesh::LodIndexArrays lodIndices; // precomputed on the worker
             int materialIndex = -1;          // into `materials`
         };
@@ -153,6 +226,7 @@ namespace MyCoreEngine {
         std::vector<MeshData> meshes;
         std::string sourcePath;            // normalized
         std::string directory;
+        VertexFormat vertexFormat = VertexFormat::Packed; // Mesh's, at decode
         bool valid = false;                // Assimp import succeeded
     };
 
@@ -181,6 +255,16 @@ namespace MyCoreEngine {
         static ModelCPUData Decode(const std::string& path, bool gamma = false,
                                    const std::unordered_set<std::string>* skipDecodeKeys = nullptr);
 
+        // Decode with every file read through `io` instead of by Assimp and
+        // stb themselves: the model from `modelBytes` when the caller already
+        // holds them (AssetManager's async path reads the model first and
+        // only then submits the decode), its .mtl/.bin and textures via
+        // io.Read — which a read-ahead of the model's directory has usually
+        // made resident by the time the import asks. Same result as above.
+        static ModelCPUData Decode(const std::string& path, bool gamma,
+                                   const std::unordered_set<std::string>* skipDecodeKeys,
+                                   IOService& io, IOBlobPtr modelBytes = nullptr);
+
         // MAIN THREAD ONLY: snapshot of every texture-cache key currently
         // uploaded — the input for Decode's skipDecodeKeys.
         static std::unordered_set<std::string> CachedTextureKeys();
@@ -217,6 +301,9 @@ namespace MyCoreEngine {
         std::vector<MyCoreEngine::MaterialHandle> materials_; // size = scene->mNumMaterials
 
         void finalize_(ModelCPUData&& cpu); // the GL half (main thread)
+        static ModelCPUData decode_(const std::string& path, bool gamma,
+                                    const std::unordered_set<std::string>* skipDecodeKeys,
+                                    IOService* io, IOBlobPtr modelBytes);
         static ModelCPUData decodeSyncWithCache_(const std::string& path, bool gamma);
         static std::string makeTexKey_(const std::string & file, const std::string & directory, bool isSRGB);
         // Decode helper: probe primary-then-fallback texture slot, stb-decode
@@ -224,7 +311,8 @@ namespace MyCoreEngine {
         static int decodeTextureSlot_(ModelCPUData& cpu, ::aiMaterial* mat,
                                       aiTextureType primary, aiTextureType fallback,
                                       bool isSRGB, const std::string& directory,
-                                      const std::unordered_set<std::string>* skipDecodeKeys);
+                                      const std::unordered_set<std::string>* skipDecodeKeys,
+                                      IOService* io);
         static unsigned int uploadTextureRGBA_(const ModelCPUData::TextureData& t);
     };
 } // namespace MyCoreEngine
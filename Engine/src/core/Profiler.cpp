@@ -0,0 +1,276 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+namespace MyCoreEngine {
+
+#if CSE_PROFILER
+
+namespace {
+
+    static_assert((Profiler::kRingEvents & (Profiler::kRingEvents - 1)) == 0,
+                  "ring size must be a power of two (the index is masked)");
+
+    constexpr uint64_t kSkipped = ~uint64_t(0); // BeginZone_ while disabled
+
+    // Threads that have exited keep their rings for a while — a JobSystem
+    // torn down a moment before the capture still has the interesting part
+    // of the trace — but only this many: tests and the cooker create and
+    // destroy pools freely, and an always-on recorder must not grow with them.
+    constexpr std::size_t kRetiredRingsKept = 16;
+
+    uint64_t nowNs() {
+        using clock = std::chrono::steady_clock;
+        static const clock::time_point epoch = clock::now();
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            clock::now() - epoch).count();
+    }
+
+    // Single writer (the owning thread), any number of readers, guarded by a
+    // per-slot sequence: `seq` is 0 while the slot is being written and i+1
+    // once it holds event i. A reader that sees the same i+1 before and after
+    // copying the fields got a whole event; anything else is dropped. The
+    // fields are relaxed atomics rather than plain members so that racing
+    // read is defined (and then discarded) instead of UB; on x86 and ARM a
+    // relaxed store is an ordinary store.
+    struct Slot {
+        std::atomic<uint64_t> seq{ 0 };
+        std::atomic<const char*> name{ nullptr };
+        std::atomic<uint64_t> start{ 0 };
+        std::atomic<uint64_t> end{ 0 };
+        std::atomic<uint32_t> depth{ 0 };
+    };
+    static_assert(sizeof(Slot) == 40, "Profiler.h quotes the ring's footprint per thread");
+
+    struct ThreadRing {
+        uint32_t id = 0;
+        std::string name;                   // registry mutex
+        std::atomic<uint64_t> head{ 0 };    // events ever written
+        std::atomic<uint64_t> clearedAt{ 0 };
+        uint32_t depth = 0;                 // owner thread only
+        std::unique_ptr<Slot[]> slots{ new Slot[Profiler::kRingEvents] };
+    };
+
+    struct Registry {
+        std::mutex m;
+        std::vector<std::shared_ptr<ThreadRing>> live;
+        std::deque<std::shared_ptr<ThreadRing>> retired;
+        uint32_t nextId = 1;
+    };
+
+    // Leaked on purpose: worker threads' thread_local holders retire their
+    // rings during shutdown, possibly after static destructors have begun.
+    Registry& registry() {
+        static Registry* r = new Registry;
+        return *r;
+    }
+
+    std::atomic<bool> g_enabled{ true };
+
+    struct RingHolder {
+        std::shared_ptr<ThreadRing> ring;
+        ~RingHolder() {
+            if (!ring) return;
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lk(r.m);
+            r.live.erase(std::remove(r.live.begin(), r.live.end(), ring), r.live.end());
+            r.retired.push_back(std::move(ring));
+            while (r.retired.size() > kRetiredRingsKept) r.retired.pop_front();
+        }
+    };
+
+    ThreadRing& localRing() {
+        thread_local RingHolder holder;
+        if (!holder.ring) {
+            auto ring = std::make_shared<ThreadRing>();
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lk(r.m);
+            ring->id = r.nextId++;
+            r.live.push_back(ring);
+            holder.ring = std::move(ring);
+        }
+        return *holder.ring;
+    }
+
+    void appendEscaped(std::string& out, const char* s) {
+        for (; s && *s; ++s) {
+            const char c = *s;
+            switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", (unsigned)(unsigned char)c);
+                    out += buf;
+                }
+                else {
+                    out += c;
+                }
+            }
+        }
+    }
+
+} // namespace
+
+    void Profiler::SetEnabled(bool on) { g_enabled.store(on, std::memory_order_relaxed); }
+    bool Profiler::Enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+    void Profiler::SetThreadName(const char* name) {
+        ThreadRing& ring = localRing();
+        std::lock_guard<std::mutex> lk(registry().m);
+        ring.name = name ? name : "";
+    }
+
+    uint64_t Profiler::BeginZone_() {
+        if (!g_enabled.load(std::memory_order_relaxed)) return kSkipped;
+        ++localRing().depth;
+        return nowNs();
+    }
+
+    void Profiler::EndZone_(const char* name, uint64_t startNs) {
+        if (startNs == kSkipped) return;
+        const uint64_t end = nowNs();
+        ThreadRing& ring = localRing();
+        const uint32_t depth = ring.depth > 0 ? --ring.depth : 0;
+        const uint64_t i = ring.head.load(std::memory_order_relaxed);
+        Slot& s = ring.slots[i & (kRingEvents - 1)];
+        s.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.name.store(name, std::memory_order_relaxed);
+        s.start.store(startNs, std::memory_order_relaxed);
+        s.end.store(end, std::memory_order_relaxed);
+        s.depth.store(depth, std::memory_order_relaxed);
+        s.seq.store(i + 1, std::memory_order_release);
+        ring.head.store(i + 1, std::memory_order_release);
+    }
+
+    std::vector<ProfileEvent> Profiler::Snapshot() {
+        std::vector<ProfileEvent> out;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.m);
+
+        auto copyRing = [&out](const ThreadRing& ring) {
+            const uint64_t h = ring.head.load(std::memory_order_acquire);
+            uint64_t lo = h > kRingEvents ? h - kRingEvents : 0;
+            lo = std::max(lo, ring.clearedAt.load(std::memory_order_relaxed));
+            const std::size_t first = out.size();
+            for (uint64_t i = lo; i < h; ++i) {
+                const Slot& s = ring.slots[i & (kRingEvents - 1)];
+                if (s.seq.load(std::memory_order_acquire) != i + 1) continue; // already reused
+                ProfileEvent e;
+                e.name = s.name.load(std::memory_order_relaxed);
+                e.startNs = s.start.load(std::memory_order_relaxed);
+                e.endNs = s.end.load(std::memory_order_relaxed);
+                e.depth = s.depth.load(std::memory_order_relaxed);
+                e.threadId = ring.id;
+                // The owner kept writing while we copied: if the slot was
+                // reused meanwhile the fields may mix two zones. Drop it
+                // rather than export one zone with another's timestamps.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) != i + 1) continue;
+                out.push_back(e);
+            }
+            // ring order is END order; the trace wants START order
+            std::sort(out.begin() + first, out.end(),
+                [](const ProfileEvent& a, const ProfileEvent& b) {
+                    return a.startNs != b.startNs ? a.startNs < b.startNs : a.depth < b.depth;
+                });
+        };
+        for (const auto& ring : r.retired) copyRing(*ring);
+        for (const auto& ring : r.live) copyRing(*ring);
+        return out;
+    }
+
+    void Profiler::Clear() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lk(r.m);
+        for (auto& ring : r.live) ring->clearedAt.store(ring->head.load(std::memory_order_acquire));
+        r.retired.clear();
+    }
+
+    std::string Profiler::ChromeTraceJson() {
+        const std::vector<ProfileEvent> events = Snapshot();
+
+        std::vector<std::pair<uint32_t, std::string>> names;
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> lk(r.m);
+            for (const auto& ring : r.retired) names.emplace_back(ring->id, ring->name);
+            for (const auto& ring : r.live) names.emplace_back(ring->id, ring->name);
+        }
+
+        std::string out;
+        out.reserve(events.size() * 96 + 256);
+        out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        bool first = true;
+        char buf[160];
+        for (const auto& [tid, name] : names) {
+            if (!first) out += ',';
+            first = false;
+            std::snprintf(buf, sizeof(buf),
+                "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                tid);
+            out += buf;
+            if (name.empty()) {
+                std::snprintf(buf, sizeof(buf), "thread %u", tid);
+                out += buf;
+            }
+            else {
+                appendEscaped(out, name.c_str());
+            }
+            out += "\"}}";
+        }
+        for (const ProfileEvent& e : events) {
+            if (!first) out += ',';
+            first = false;
+            out += "\n{\"name\":\"";
+            appendEscaped(out, e.name ? e.name : "?");
+            // microseconds with ns precision: Chrome accepts fractional ts/dur
+            std::snprintf(buf, sizeof(buf),
+                "\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0, e.threadId);
+            out += buf;
+        }
+        out += "\n]}\n";
+        return out;
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& path, std::string* error) {
+        const std::string json = ChromeTraceJson();
+        std::ofstream f(path, std::ios::binary | std::ios::trunc);
+        if (f) f.write(json.data(), (std::streamsize)json.size());
+        if (!f) {
+            if (error) *error = "cannot write '" + path + "'";
+            return false;
+        }
+        return true;
+    }
+
+#else // CSE_PROFILER == 0: the API stays linkable, and says it has nothing
+
+    void Profiler::SetEnabled(bool) {}
+    bool Profiler::Enabled() { return false; }
+    void Profiler::SetThreadName(const char*) {}
+    uint64_t Profiler::BeginZone_() { return 0; }
+    void Profiler::EndZone_(const char*, uint64_t) {}
+    std::vector<ProfileEvent> Profiler::Snapshot() { return {}; }
+    void Profiler::Clear() {}
+    std::string Profiler::ChromeTraceJson() { return "{\"traceEvents\":[]}\n"; }
+    bool Profiler::WriteChromeTrace(const std::string&, std::string* error) {
+        if (error) *error = "profiler compiled out (configure with -DCSE_ENABLE_PROFILER=ON)";
+        return false;
+    }
+
+#endif
+
+} // namespace MyCoreEngine
@@ -0,0 +1,122 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The engine's CPU profiler: scoped zones recorded into per-thread ring
+// buffers, exported on demand as a Chrome trace (chrome://tracing, Perfetto,
+// Speedscope all open it).
+//
+//   void Scene::UpdateTransforms() {
+//       CSE_PROFILE_ZONE("Scene::UpdateTransforms");
+//       ...
+//   }
+//
+// Always on: a zone costs two clock reads and a handful of relaxed stores
+// into memory the calling thread owns — no lock, no allocation after the
+// thread's first zone — so the shipped Player records too. The rings are a
+// flight recorder: a hitch can be exported AFTER it happened, with what
+// every worker was doing at the time.
+//
+// COMPILED OUT with -DCSE_ENABLE_PROFILER=OFF (CSE_PROFILER=0). Every macro
+// below becomes `((void)0)`, no zone code exists in the binary, and
+// Profiler::WriteChromeTrace reports that there is nothing to write rather
+// than producing an empty file that looks like an idle engine.
+//
+// Contracts:
+// - Zone names must have STATIC storage (string literals, __func__, a pass's
+//   name()). Only the pointer is recorded; a name built on the stack is
+//   garbage by the time the trace is written.
+// - Zones nest by scope. Chrome's "X" (complete) events carry start+duration,
+//   so the viewer rebuilds the hierarchy from timestamps; depth is recorded
+//   as well so an in-engine consumer (tests, an overlay) can do the same
+//   without sorting.
+// - Each thread keeps the last kRingEvents zones. Older ones are overwritten,
+//   which is what bounds the memory of an always-on recorder; a capture is
+//   "the last N zones per thread", never "everything since boot".
+// - Export may run on any thread while every other thread keeps recording.
+//   A zone overwritten DURING the copy is dropped, never half-read.
+
+#ifndef CSE_PROFILER
+#define CSE_PROFILER 0
+#endif
+
+namespace MyCoreEngine {
+
+    struct ProfileEvent {
+        const char* name = nullptr;
+        uint64_t startNs = 0; // since the profiler's epoch (first use)
+        uint64_t endNs = 0;
+        uint32_t depth = 0;   // 0 = outermost zone on its thread
+        uint32_t threadId = 0;
+    };
+
+    class ENGINE_API Profiler {
+    public:
+        static constexpr bool kCompiledIn = CSE_PROFILER != 0;
+        // 40 bytes an event (Profiler.cpp's Slot): 320 KB per recording thread.
+        static constexpr std::size_t kRingEvents = 8192;
+
+        // Runtime gate on top of the compile-time one. On by default so the
+        // ring already holds the frames before a hitch; turning it off makes a
+        // zone cost one relaxed load.
+        static void SetEnabled(bool on);
+        static bool Enabled();
+
+        // Names the calling thread in the exported trace ("Main",
+        // "JobSystem worker"). Safe to call repeatedly; the last name wins.
+        static void SetThreadName(const char* name);
+
+        // Every recorded zone still in the rings, every thread, ordered by
+        // thread then start time. Thread ids are small and stable for the
+        // process's life.
+        static std::vector<ProfileEvent> Snapshot();
+
+        // Drops every recorded zone (the rings stay allocated).
+        static void Clear();
+
+        // The Chrome trace-event JSON for Snapshot(). Thread names become
+        // "thread_name" metadata so the viewer labels the lanes.
+        static std::string ChromeTraceJson();
+
+        // Writes ChromeTraceJson() to `path`. False, with `error` filled, when
+        // the file cannot be written or the profiler is compiled out.
+        static bool WriteChromeTrace(const std::string& path, std::string* error = nullptr);
+
+        // Called by the zone. Not for direct use: a Begin without its End
+        // leaves the thread's depth wrong for the rest of its life.
+        static uint64_t BeginZone_();
+        static void EndZone_(const char* name, uint64_t startNs);
+    };
+
+    // RAII zone. Use the macro, which disappears when the profiler is
+    // compiled out; the class itself is harmless either way.
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const char* name) : name_(name), start_(Profiler::BeginZone_()) {}
+        ~ProfileZone() { Profiler::EndZone_(name_, start_); }
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+    private:
+        const char* name_;
+        uint64_t start_;
+    };
+
+} // namespace MyCoreEngine
+
+#define CSE_PROFILE_CONCAT2_(a, b) a##b
+#define CSE_PROFILE_CONCAT_(a, b) CSE_PROFILE_CONCAT2_(a, b)
+
+#if CSE_PROFILER
+#define CSE_PROFILE_ZONE(name) \
+    ::MyCoreEngine::ProfileZone CSE_PROFILE_CONCAT_(cseProfileZone_, __LINE__)(name)
+#define CSE_PROFILE_FUNCTION() CSE_PROFILE_ZONE(__func__)
+#define CSE_PROFILE_THREAD(name) ::MyCoreEngine::Profiler::SetThreadName(name)
+#else
+#define CSE_PROFILE_ZONE(name) ((void)0)
+#define CSE_PROFILE_FUNCTION() ((void)0)
+#define CSE_PROFILE_THREAD(name) ((void)0)
+#endif
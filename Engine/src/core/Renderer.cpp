@@ -1,6 +1,7 @@
 ﻿#include <glad/glad.h>
 
 #include "Renderer.h"
+#include "Profiler.h"
 #include "../render/passes/ForwardOpaquePass.h"
 #include "../render/passes/TonemapPass.h"
 
@@ -41,7 +42,6 @@ namespace MyCoreEngine {
         if (hdrDepthTex_) glDeleteTextures(1, &hdrDepthTex_);
         if (hdrColorTex_) glDeleteTextures(1, &hdrColorTex_);
         if (hdrFBO_) glDeleteFramebuffers(1, &hdrFBO_);
-        releaseLDR_();
     }
 
     void Renderer::Setup(int fbWidth, int fbHeight) {
@@ -139,11 +139,11 @@ namespace MyCoreEngine {
     void Renderer::RenderFrame(Scene& scene, Shader& shader, Camera& camera,
                                int fbWidth, int fbHeight, float deltaTime,
                                unsigned targetFBO) {
+        CSE_PROFILE_ZONE("Renderer::RenderFrame");
         // resize the HDR pipeline whenever the output size changes (window
         // resize in the player, viewport-panel resize in the editor)
         if (fbWidth != lastFbW_ || fbHeight != lastFbH_) {
             if (hdrFBO_) recreateHDR_(fbWidth, fbHeight);
-            if (ldrFBO_) recreateLDR_(fbWidth, fbHeight);
             lastFbW_ = fbWidth; lastFbH_ = fbHeight;
             // RenderPipeline::resize() existed but NOTHING had ever called it,
             // so any pass owning a size-dependent resource would silently keep
@@ -162,11 +162,11 @@ namespace MyCoreEngine {
             forwardPass_ = &pipeline_.add<ForwardOpaquePass>(shader);
             pipeline_.setup(passCtx_); // idempotent
         }
-        // ORDER IS LOAD-BEARING and is encoded ONLY by the sequence of these
-        // blocks, because RenderPipeline::add appends. Skybox must sit between
-        // forward and tonemap: it needs the depth buffer forward produced, and
-        // it writes linear HDR that tonemap must still process. Moving either
-        // block past the other silently changes the frame.
+        // The sequence of these blocks is the order the passes declare in, and
+        // so the data flow: each pass reads what the ones before it wrote
+        // (see RenderPipeline). Skybox must sit between forward and tonemap:
+        // it needs the depth buffer forward produced, and it writes linear HDR
+        // that tonemap must still process.
         if (!skyboxPass_) {
             skyboxPass_ = &pipeline_.add<SkyboxPass>();
             pipeline_.setup(passCtx_);
@@ -180,7 +180,7 @@ namespace MyCoreEngine {
         }
         // Bloom is an HDR pass: it composites its glow back into the HDR buffer
         // AFTER the scene is drawn and BEFORE tonemap picks it up. Not part of
-        // the LDR ping-pong chain.
+        // the LDR post chain.
         if (!bloomPass_) {
             bloomPass_ = &pipeline_.add<BloomPass>();
             pipeline_.setup(passCtx_);
@@ -189,9 +189,16 @@ namespace MyCoreEngine {
             tonemapPass_ = &pipeline_.add<TonemapPass>();
             pipeline_.setup(passCtx_);
         }
-        // LDR post-process chain runs after tonemap, in insertion order:
-        // outline -> colour grade -> vignette -> FXAA. Outline stylises first,
-        // grade sets the overall look, vignette frames, AA resolves last.
+        // LDR post-process chain runs after tonemap, each reading the one
+        // before: outline -> colour grade -> vignette -> FXAA. Outline
+        // stylises first, grade sets the overall look, vignette frames, AA
+        // resolves last. Disabled ones are not declared and drop out. With two
+        // or more of the first three on, PostUberPass runs them as one pass,
+        // in the same order, and their own passes drop out too.
+        if (!postUberPass_) {
+            postUberPass_ = &pipeline_.add<PostUberPass>();
+            pipeline_.setup(passCtx_);
+        }
         if (!outlinePass_) {
             outlinePass_ = &pipeline_.add<OutlinePass>();
             pipeline_.setup(passCtx_);
@@ -210,28 +217,14 @@ namespace MyCoreEngine {
             pipeline_.setup(passCtx_);
         }
         // AFTER everything, including FXAA: the 2D/UI overlay paints on top of
-        // the finished frame. It is NOT a chain stage — it never consumes a
-        // ping-pong slot and is deliberately absent from countLdrPostPasses_ —
-        // so UI is never bloomed, graded, vignetted or anti-aliased.
+        // the finished frame. It is NOT a chain stage -- it writes the output
+        // without reading the chain -- so UI is never bloomed, graded,
+        // vignetted or anti-aliased.
         if (!uiPass_) {
             uiPass_ = &pipeline_.add<UIPass>(&renderer2D_, &uiDraw_);
             pipeline_.setup(passCtx_);
         }
 
-        // LDR post-process chain: allocate the ping-pong pair iff at least one
-        // LDR post pass is enabled this frame; release it when the chain empties
-        // so a project using no post pays no memory. postPassesLeft + postSrcTex
-        // drive the ping-pong routing (see PassContext::nextPostTarget).
-        const int  postCount   = countLdrPostPasses_(scene);
-        const bool wantChain   = postCount > 0;
-        if (wantChain && !ldrFBO_) recreateLDR_(fbWidth, fbHeight);
-        else if (!wantChain && ldrFBO_) releaseLDR_();
-        const bool haveBuffers = (ldrFBO_ != 0 && ldrFBO2_ != 0);
-        passCtx_.ldrFBO_A = ldrFBO_;  passCtx_.ldrTex_A = ldrColorTex_;
-        passCtx_.ldrFBO_B = ldrFBO2_; passCtx_.ldrTex_B = ldrColorTex2_;
-        passCtx_.postPassesLeft = (wantChain && haveBuffers) ? postCount : 0;
-        passCtx_.postSrcTex = ldrColorTex_; // tonemap writes buffer A first
-
         // Bake the environment if it changed. Driven from here so BOTH hosts
         // get it without either having to remember, which is what keeps Play
         // and the shipped build lit identically.
@@ -278,7 +271,33 @@ namespace MyCoreEngine {
         passCtx_.ibl.brdfLUT = iblBRDFLUT_;
         passCtx_.ibl.mipCount = iblPrefilterMipCount_;
 
-        // execute the whole pipeline (CSM → forward → tonemap)
+        // The scene's per-frame draw lists are rebuilt by the passes below;
+        // rewinding their arena here is what keeps them from outliving the
+        // frame that needed them. (The editor renders the same scene through
+        // two Renderers, so its scene sees two frames per displayed frame —
+        // harmless, each view consumes its own lists before the next flips.)
+        scene.BeginFrame();
+
+        // Build every view's draw list before any pass draws: the camera's,
+        // and the bucket of each cascade the CSM pass is about to re-render.
+        // The views build side by side on the job system; the passes below
+        // only submit. The frustum is ForwardOpaquePass's, expression for
+        // expression -- RenderScene draws the prebuilt list only for the
+        // view it was built for.
+        frameCascades_.clear();
+        if (csmPass_) csmPass_->plan(passCtx_, scene, camera, fp, frameCascades_);
+        Scene::CameraView view;
+        view.frustum = createFrustumFromCamera(
+            camera, float(fp.viewportW) / float(fp.viewportH), glm::radians(camera.Zoom),
+            camera.NearClip, camera.FarClip);
+        view.position = camera.Position;
+        view.front = camera.Front;
+        view.zoomDeg = camera.Zoom;
+        view.viewportHeightPx = fp.viewportH;
+        scene.BuildDrawLists(&view, frameCascades_, jobs_);
+
+        // declare, compile and execute the frame's graph (CSM → forward →
+        // tonemap → post → UI); the post chain's targets are graph transients
         pipeline_.executeAll(passCtx_, scene, camera, fp);
     }
 
@@ -470,56 +489,6 @@ namespace MyCoreEngine {
         if (skyboxPass_) skyboxPass_->setIntensity(env.skyIntensity);
     }
 
-    int Renderer::countLdrPostPasses_(const Scene& scene) const {
-        // Asked of the passes themselves (IRenderPass::wantsLdrSlot) rather than
-        // restated here. The old version listed only whether each EFFECT was
-        // enabled, while every pass also requires a valid shader and the outline
-        // requires scene depth -- so one failed post-shader compile made the
-        // count too high, nothing ever reached isFinal, and the whole frame was
-        // left in an off-screen buffer: a black window from a typo in GLSL.
-        // A pass added later is counted without touching this function.
-        return pipeline_.countLdrSlots(passCtx_, scene);
-    }
-
-    void Renderer::releaseLDR_() {
-        if (ldrColorTex_)  { glDeleteTextures(1, &ldrColorTex_);  ldrColorTex_ = 0; }
-        if (ldrFBO_)       { glDeleteFramebuffers(1, &ldrFBO_);   ldrFBO_ = 0; }
-        if (ldrColorTex2_) { glDeleteTextures(1, &ldrColorTex2_); ldrColorTex2_ = 0; }
-        if (ldrFBO2_)      { glDeleteFramebuffers(1, &ldrFBO2_);  ldrFBO2_ = 0; }
-    }
-
-    void Renderer::recreateLDR_(int w, int h) {
-        releaseLDR_();
-        const int fw = std::max(1, w), fh = std::max(1, h);
-        // One RGBA8 (post-tonemap, already gamma-encoded -- deliberately NOT
-        // sRGB, or GL would linearise on sample and FXAA would compare linear
-        // values against perceptual thresholds). CLAMP_TO_EDGE matters: post
-        // effects sample past the border and wrapping pulls the far side of the
-        // screen in as a bright fringe.
-        auto makeOne = [&](unsigned& fbo, unsigned& tex) -> bool {
-            glGenFramebuffers(1, &fbo);
-            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-            glGenTextures(1, &tex);
-            glBindTexture(GL_TEXTURE_2D, tex);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, fw, fh, 0, GL_RGBA,
-                         GL_UNSIGNED_BYTE, nullptr);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-                                   GL_TEXTURE_2D, tex, 0);
-            return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
-        };
-        const bool okA = makeOne(ldrFBO_, ldrColorTex_);
-        const bool okB = makeOne(ldrFBO2_, ldrColorTex2_);
-        if (!okA || !okB) {
-            std::cerr << "ERROR::LDR ping-pong FBO incomplete" << std::endl;
-            releaseLDR_();
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    }
-
     void Renderer::makeDepthTex_(int w, int h) {
         // A plain DEPTH_COMPONENT24 texture -- NEAREST (depth must not be
         // interpolated when reconstructed for edge detection), CLAMP so the
@@ -27,6 +27,7 @@
 #include "../render/passes/OutlinePass.h"
 #include "../render/passes/ColorGradePass.h"
 #include "../render/passes/BloomPass.h"
+#include "../render/passes/PostUberPass.h"
 #include "../render/IBLBaker.h"
 
 namespace MyCoreEngine {
@@ -56,6 +57,12 @@ namespace MyCoreEngine {
                          int fbWidth, int fbHeight, float deltaTime,
                          unsigned targetFBO = 0);
 
+        // Where the worker pool comes from. Non-owning; the Application's pool
+        // outlives every Renderer. With one, RenderFrame builds the camera's
+        // and the stale shadow cascades' draw lists in parallel
+        // (Scene::BuildDrawLists); without, it builds them one after another.
+        void SetJobSystem(JobSystem* jobs) { jobs_ = jobs; }
+
         // public API:
         void SetIBLTextures(unsigned int irradianceCube, unsigned int prefilteredCube, unsigned int brdfLUT2D, float prefilteredMipCount);
         // The cube the skybox draws. Separate from SetIBLTextures because a
@@ -86,6 +93,15 @@ namespace MyCoreEngine {
         // the scene so the editor and Player boot to the same tier.
         void ApplyQualityTier(Scene::QualityLevel level, Scene& scene);
 
+        // GPU milliseconds per render pass (UI included), in the order they
+        // ran, from a frame or two ago: timer queries read back late so the
+        // CPU never waits on them (GpuTimers). Empty where the driver has no
+        // timer queries, or with timing off.
+        const std::vector<GpuPassTime>& GpuPassTimes() const { return pipeline_.gpuTimers().Last(); }
+        float GpuFrameMs() const { return pipeline_.gpuTimers().LastTotalMs(); }
+        void  SetGpuTimingEnabled(bool on) { pipeline_.gpuTimers().SetEnabled(on); }
+        bool  GpuTimingEnabled() const { return pipeline_.gpuTimers().Enabled(); }
+
         // Light exposure
         float exposure() const { return exposure_; }
         void setExposure(float e) { exposure_ = std::max(0.01f, e); }
@@ -198,6 +214,8 @@ namespace MyCoreEngine {
         CSMSnapshot nullSnap_{};             // fallback for getCSMSnapshot()
 
         uint64_t frameIndex_ = 0;
+        JobSystem* jobs_ = nullptr;                      // non-owning
+        std::vector<Scene::CascadeParam> frameCascades_; // this frame's CSM plan
         int lastFbW_ = 0, lastFbH_ = 0; // HDR pipeline size tracking
 
         SkyboxPass* skyboxPass_ = nullptr;
@@ -212,15 +230,7 @@ namespace MyCoreEngine {
         OutlinePass*    outlinePass_ = nullptr;
         ColorGradePass* colorGradePass_ = nullptr;
         BloomPass*      bloomPass_ = nullptr;
-        // LDR ping-pong pair for the post-process chain (tonemap -> effects ->
-        // FXAA), allocated only while at least one LDR post pass is enabled.
-        unsigned int ldrFBO_ = 0, ldrColorTex_ = 0;    // buffer A
-        unsigned int ldrFBO2_ = 0, ldrColorTex2_ = 0;  // buffer B
-        void recreateLDR_(int w, int h);
-        void releaseLDR_();
-        // How many LDR post passes are enabled this frame (vignette, FXAA, ...).
-        // The chain buffers are needed iff this is > 0.
-        int  countLdrPostPasses_(const Scene& scene) const;
+        PostUberPass*   postUberPass_ = nullptr;
         IBLBaker    ibl_;
         // Bake-free half of ApplyEnvironment: which cube the skybox draws and
         // how bright. Safe to call every frame; costs nothing.
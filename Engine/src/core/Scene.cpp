@@ -4,12 +4,18 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
-#include <cstring>   // memcpy: exact float hashing in texKeyFromMaterial_
+#include <cstring>   // memcpy: exact float hashing in texKeyFromMaterial_; memchr
 #include <GLFW/glfw3.h>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp> // extractEulerAngleYXZ (matches localMatrix's Y*X*Z)
 #include "Scene.h"
 #include "CameraDirector.h" // FindActiveCamera delegates to its selection
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#ifndef GL_DRAW_INDIRECT_BUFFER // GL 4.0; the loader is 3.3 core
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
 
 
 // --- game camera helpers ---------------------------------------------------
@@ -135,7 +141,7 @@ static uint64_t fnv1aF_(uint64_t h, float f) {
     return fnv1a64_(h, bits);
 }
 // The batch key must cover EVERY value Mesh::BindForDrawWith uploads, because an
-// instanced run is drawn with a SINGLE bind of items_[r.first]'s material: any
+// instanced run is drawn with a SINGLE bind of its first item's material: any
 // uploaded value missing from this key makes every instance in the run render
 // with whichever item happened to sort first. Worse, the sort tiebreaker is
 // camera depth, so the whole batch visibly flips as the camera moves past the
@@ -145,9 +151,14 @@ static uint64_t fnv1aF_(uint64_t h, float f) {
 // only for Toon, alpha params only for non-Opaque) so the two stay easy to keep
 // in sync. Note emissiveTex is deliberately absent: BindForDrawWith never binds
 // it, so it cannot affect the draw.
-uint64_t Scene::texKeyFromMaterial_(const Material & m) {
+//
+// An albedo map in a texture array hashes as the array: its layer is per
+// instance, so materials that differ only in which map of one size they use
+// share a key. Arrays and textures share GL's name space, so the two cannot
+// collide.
+uint64_t Scene::texKeyFromMaterial_(const Material & m, unsigned albedoArray) {
     uint64_t h = 1469598103934665603ull;
-    h = fnv1a64_(h, m.albedoTex);
+    h = fnv1a64_(h, albedoArray ? albedoArray : m.albedoTex);
     h = fnv1a64_(h, m.normalTex);
     h = fnv1a64_(h, m.metallicTex);
     h = fnv1a64_(h, m.roughnessTex);
@@ -178,14 +189,78 @@ uint64_t Scene::texKeyFromMaterial_(const Material & m) {
     return h;
 }
 
+namespace {
+    // Every signal of T, for the draw-list epoch
+    template <typename T, auto Handler, typename Self>
+    void connectAll(entt::registry& reg, Self& self) {
+        reg.on_construct<T>().template connect<Handler>(self);
+        reg.on_update<T>().template connect<Handler>(self);
+        reg.on_destroy<T>().template connect<Handler>(self);
+    }
+    template <typename T, typename Self>
+    void disconnectAll(entt::registry& reg, Self& self) {
+        reg.on_construct<T>().disconnect(self);
+        reg.on_update<T>().disconnect(self);
+        reg.on_destroy<T>().disconnect(self);
+    }
+} // namespace
+
+Scene::Scene() {
+    registry.storage<RenderProxy>(); // its pool exists before any worker reads it
+    registry.on_construct<ModelComponent>().connect<&Scene::onModelAdded_>(*this);
+    registry.on_destroy<ModelComponent>().connect<&Scene::onModelRemoved_>(*this);
+    registry.on_construct<NoShadow>().connect<&Scene::onNoShadowAdded_>(*this);
+    registry.on_destroy<NoShadow>().connect<&Scene::onNoShadowRemoved_>(*this);
+    registry.on_construct<MaterialOverrides>().connect<&Scene::onOverridesAdded_>(*this);
+    registry.on_destroy<MaterialOverrides>().connect<&Scene::onOverridesRemoved_>(*this);
+    connectAll<Transform, &Scene::onDrawableEdited_>(registry, *this);
+    connectAll<AABB, &Scene::onDrawableEdited_>(registry, *this);
+    connectAll<ModelComponent, &Scene::onDrawableEdited_>(registry, *this);
+    connectAll<MaterialOverrides, &Scene::onDrawableEdited_>(registry, *this);
+}
+
 Scene::~Scene() {
-    if (instanceVBO_ && glfwGetCurrentContext()) {
-        glDeleteBuffers(1, &instanceVBO_);
+    disconnectAll<NoShadow>(registry, *this);
+    disconnectAll<Transform>(registry, *this);
+    disconnectAll<AABB>(registry, *this);
+    disconnectAll<ModelComponent>(registry, *this);
+    disconnectAll<MaterialOverrides>(registry, *this);
+    if (glfwGetCurrentContext()) {
+        if (clusterUBO_[0]) glDeleteBuffers(3, clusterUBO_);
     }
 }
 
-const Material * Scene::chooseMaterial_(entt::entity e, const Mesh & mesh) const {
-    if (registry.any_of<MaterialOverrides>(e)) {
+void Scene::onModelAdded_(entt::registry& reg, entt::entity e) {
+    RenderProxy proxy;
+    if (reg.any_of<NoShadow>(e)) proxy.flags &= ~RenderProxy::kCastsShadow;
+    if (reg.any_of<MaterialOverrides>(e)) proxy.flags |= RenderProxy::kHasOverrides;
+    reg.emplace_or_replace<RenderProxy>(e, proxy);
+}
+
+void Scene::onModelRemoved_(entt::registry& reg, entt::entity e) {
+    reg.remove<RenderProxy>(e);
+}
+
+void Scene::onNoShadowAdded_(entt::registry& reg, entt::entity e) {
+    ++casterFlagsEpoch_;
+    if (auto* proxy = reg.try_get<RenderProxy>(e)) proxy->flags &= ~RenderProxy::kCastsShadow;
+}
+
+void Scene::onNoShadowRemoved_(entt::registry& reg, entt::entity e) {
+    ++casterFlagsEpoch_;
+    if (auto* proxy = reg.try_get<RenderProxy>(e)) proxy->flags |= RenderProxy::kCastsShadow;
+}
+
+void Scene::onOverridesAdded_(entt::registry& reg, entt::entity e) {
+    if (auto* proxy = reg.try_get<RenderProxy>(e)) proxy->flags |= RenderProxy::kHasOverrides;
+}
+
+void Scene::onOverridesRemoved_(entt::registry& reg, entt::entity e) {
+    if (auto* proxy = reg.try_get<RenderProxy>(e)) proxy->flags &= ~RenderProxy::kHasOverrides;
+}
+
+const Material * Scene::chooseMaterial_(entt::entity e, const Mesh & mesh, bool hasOverrides) const {
+    if (hasOverrides) {
         const auto & ov = registry.get<MaterialOverrides>(e);
         const size_t idx = mesh.MaterialIndex();
         if (auto it = ov.byIndex.find(idx); it != ov.byIndex.end() && it->second) {
@@ -196,13 +271,36 @@ const Material * Scene::chooseMaterial_(entt::entity e, const Mesh & mesh) const
 }
 
 void Scene::bindMaterialForItem_(const DrawItem & di, Shader & shader) const {
-    const Material * mat = chooseMaterial_(di.entity, *di.mesh);
+    const Material * mat = chooseMaterial_(di.entity, *di.mesh, di.hasOverrides);
     if (mat) {
         di.mesh->BindForDrawWith(shader, *mat);
     }
     else {
-        di.mesh->BindForDraw(shader); // legacy path (no material)
+        di.mesh->BindForDraw(shader, fallbackMaterial_); // legacy path (no material)
     }
+    // Albedo from its texture array: the layer is this item's for a single
+    // draw; instanced draws read it per instance instead.
+    const TextureArrays::Slot albedo = mat ? TextureArrays::Get().Find(mat->albedoTex)
+                                           : TextureArrays::Slot{};
+    const DrawUniforms& u = colorUniforms_.For(shader);
+    glUniform1i(u.albedoArray, albedo.array ? 1 : 0);
+    if (albedo.array) {
+        glActiveTexture(GL_TEXTURE0 + kAlbedoArrayUnit);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, albedo.array);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform1f(u.albedoLayer, static_cast<float>(di.albedoLayer));
+    }
+}
+
+const Scene::DrawUniforms& Scene::DrawUniforms::For(const Shader& shader) {
+    if (program != shader.ID) {
+        program = shader.ID;
+        model = shader.location("model");
+        useInstancing = shader.location("uUseInstancing");
+        albedoArray = shader.location("uAlbedoArray");
+        albedoLayer = shader.location("uAlbedoLayer");
+    }
+    return *this;
 }
 
 Entity Scene::createEntity() {
@@ -214,15 +312,18 @@ void Scene::ResetToDefaults() {
     registry.clear();
     dirtyCasters_.clear();
     lastStats_ = RenderStats{};
+    ++epoch_; // the settings below bypass their setters
 
     // scene-level settings: mirror the in-class initializers in Scene.h
     // (keep the two in sync when adding settings)
     instancingEnabled_ = true;
+    multiDrawEnabled_ = true;
     lodEnabled_ = true;
     lodDistanceScale_ = 1.0f;
     smallCullEnabled_ = false;
     smallCullPixels_ = 3.0f;
     depthPrepassEnabled_ = false;
+    clusteredLightsEnabled_ = true;
     normalMapEnabled_ = true;
     pbrEnabled_ = true;
     metallic_ = 0.0f;
@@ -248,8 +349,16 @@ void Scene::ResetToDefaults() {
     qualityLevel_ = QualityLevel::Custom;
 }
 
-void Scene::UpdateTransforms()
+// Parallel transform pass: below this many nodes the fork/join costs more
+// than it saves; a chunk is this many nodes (a few hundred matrix products,
+// enough to amortise claiming it).
+static constexpr std::size_t kParallelTransformMinNodes = 4096;
+static constexpr std::size_t kTransformChunk = 1024;
+
+void Scene::UpdateTransforms(JobSystem* jobs)
 {
+    CSE_PROFILE_ZONE("Scene::UpdateTransforms");
+    dropPrebuilt_(); // their poses are about to change
     auto worldSphere = [](const glm::mat4& m, const AABB& b) -> DirtyCaster {
         const glm::vec3 localC = (b.min + b.max) * 0.5f;
         const glm::vec3 worldC = glm::vec3(m * glm::vec4(localC, 1.f));
@@ -263,68 +372,123 @@ void Scene::UpdateTransforms()
     dirtyCasters_.clear();
 
     // Hierarchy pass (P2-8): world = parentWorld * localTRS, resolved
-    // root-down. A node recomputes when its own local TRS is dirty OR any
-    // ancestor recomputed, so children follow a moving parent. Entities in
-    // a Parent cycle are unreachable from any root and simply freeze (the
-    // editor refuses to create cycles; this guards corrupt data).
+    // root-down. A node recomputes when its own local TRS is dirty OR its
+    // parent recomputed, so children follow a moving parent. The order is
+    // the persistent parent-before-child array TransformHierarchy keeps in
+    // step with Parent/Transform changes, so this is one forward sweep: a
+    // clean subtree costs a flag test per node and nothing else. Entities
+    // in a Parent cycle are not in the order and simply freeze (the editor
+    // refuses to create cycles; this guards corrupt data).
+    const auto& order = hierarchy_.Order();
     auto view = registry.view<Transform>();
-
-    // derived children adjacency; rebuilt per call (scene sizes are small)
-    std::unordered_map<entt::entity, std::vector<entt::entity>> children;
-    std::vector<entt::entity> roots;
-    for (auto e : view) {
-        const auto* p = registry.try_get<Parent>(e);
-        if (p && p->value != entt::null && registry.valid(p->value) &&
-            registry.all_of<Transform>(p->value)) {
-            children[p->value].push_back(e);
+    movedScratch_.assign(order.size(), 0);
+    // Lookups go through the CONST registry: on a mutable one, asking for a
+    // component type nobody has used yet creates its pool, which is a
+    // structural change — and this step also runs on job workers.
+    const entt::registry& creg = registry;
+
+    // One node. Writes only its own Transform and moved flag, reads its
+    // parent's (an earlier slot), so nodes whose parents are done can run
+    // on any thread.
+    auto propagate = [&](std::size_t i, std::vector<DirtyCaster>& casters) {
+        const TransformHierarchy::Node& n = order[i];
+        if (n.e == entt::null) return; // dead slot: reads as "not moved"
+        auto& t = view.get<Transform>(n.e);
+        // a dead parent slot is a dangling Parent: the node acts as a root
+        const bool hasParent = n.parent != TransformHierarchy::kRoot &&
+                               order[n.parent].e != entt::null;
+        const bool needs = t.dirty || (hasParent && movedScratch_[n.parent]);
+        if (!needs) return;
+        movedScratch_[i] = 1;
+
+        // Remember moved/rotated shadow casters so the CSM pass can
+        // refresh cascades whose region their shadow can touch. BOTH the
+        // departure and arrival positions matter: recording only the new
+        // sphere leaves a baked "ghost" shadow behind teleports and fast
+        // per-frame moves. The model must actually be LOADED — an empty
+        // ModelComponent renders and casts nothing (every render path
+        // null-checks it; this predicate must too).
+        const auto* mcPtr = creg.try_get<ModelComponent>(n.e);
+        const auto* aabb = creg.try_get<AABB>(n.e);
+        const bool casts = mcPtr && mcPtr->model && aabb &&
+            (creg.get<RenderProxy>(n.e).flags & RenderProxy::kCastsShadow);
+        if (casts) {
+            casters.push_back(worldSphere(t.modelMatrix, *aabb));
+        }
+        if (hasParent) {
+            // parent is earlier in the order: its modelMatrix is current
+            t.modelMatrix = view.get<Transform>(order[n.parent].e).modelMatrix * t.localMatrix();
+            t.dirty = false;
         }
         else {
-            roots.push_back(e);
+            t.updateMatrix();
         }
-    }
+        if (casts) {
+            casters.push_back(worldSphere(t.modelMatrix, *aabb));
+        }
+        // the cull's world bounds follow the matrix (own slot only, so
+        // this is as thread-safe as the rest of the node)
+        if (aabb) bounds_.Update(n.e, t.modelMatrix, *aabb);
+    };
 
-    struct Item { entt::entity e; entt::entity parent; bool parentMoved; };
-    std::vector<Item> stack;
-    stack.reserve(roots.size());
-    for (auto r : roots) stack.push_back({ r, entt::null, false });
-
-    while (!stack.empty()) {
-        const Item it = stack.back();
-        stack.pop_back();
-        auto& t = view.get<Transform>(it.e);
-
-        const bool needs = t.dirty || it.parentMoved;
-        if (needs) {
-            // Remember moved/rotated shadow casters so the CSM pass can
-            // refresh cascades whose region their shadow can touch. BOTH the
-            // departure and arrival positions matter: recording only the new
-            // sphere leaves a baked "ghost" shadow behind teleports and fast
-            // per-frame moves. The model must actually be LOADED — an empty
-            // ModelComponent renders and casts nothing (every render path
-            // null-checks it; this predicate must too).
-            const auto* mcPtr = registry.try_get<ModelComponent>(it.e);
-            const bool casts = !registry.any_of<NoShadow>(it.e) &&
-                mcPtr && mcPtr->model && registry.all_of<AABB>(it.e);
-            if (casts) {
-                dirtyCasters_.push_back(worldSphere(t.modelMatrix, registry.get<AABB>(it.e)));
-            }
-            if (it.parent != entt::null) {
-                // parent processed first: its modelMatrix is current
-                t.modelMatrix = view.get<Transform>(it.parent).modelMatrix * t.localMatrix();
-                t.dirty = false;
-            }
-            else {
-                t.updateMatrix();
-            }
-            if (casts) {
-                dirtyCasters_.push_back(worldSphere(t.modelMatrix, registry.get<AABB>(it.e)));
-            }
+    // Anything that moved invalidates the recorded camera draws.
+    auto noteMoved = [&] {
+        if (!movedScratch_.empty() &&
+            std::memchr(movedScratch_.data(), 1, movedScratch_.size())) {
+            ++epoch_;
         }
+    };
 
-        if (auto itc = children.find(it.e); itc != children.end()) {
-            for (auto c : itc->second) stack.push_back({ c, it.e, needs });
+    if (!jobs || jobs->workerCount() == 0 || order.size() < kParallelTransformMinNodes) {
+        for (std::size_t i = 0; i < order.size(); ++i) propagate(i, dirtyCasters_);
+        noteMoved();
+        return;
+    }
+
+    // Parallel: wave by wave (no node shares a wave with its parent; after
+    // a rebuild a wave is a depth level), each wave split into fixed
+    // chunks. Chunk c of a wave files its casters under c and the lists are
+    // appended in chunk order, waves in order — so dirtyCasters_ comes out
+    // in slot order, identical to the serial pass. It must: the CSM update
+    // policy reads it through HasDynamicCasterInViewRange, and a different
+    // order run to run would make shadow refreshes depend on scheduling.
+    const auto& waves = hierarchy_.Waves();
+    for (std::size_t w = 0; w + 1 < waves.size(); ++w) {
+        const std::size_t begin = waves[w];
+        const std::size_t count = waves[w + 1] - begin;
+        if (count < 2 * kTransformChunk) { // not worth a fork
+            for (std::size_t i = begin; i < begin + count; ++i) propagate(i, dirtyCasters_);
+            continue;
+        }
+        const std::size_t chunks = JobSystem::chunkCount(count, kTransformChunk);
+        if (chunkCasters_.size() < chunks) chunkCasters_.resize(chunks);
+        for (std::size_t c = 0; c < chunks; ++c) chunkCasters_[c].clear();
+        jobs->parallelFor(count, kTransformChunk,
+            [&](std::size_t b, std::size_t e, std::size_t c) {
+                CSE_PROFILE_ZONE("UpdateTransforms chunk");
+                for (std::size_t i = b; i < e; ++i) propagate(begin + i, chunkCasters_[c]);
+            });
+        for (std::size_t c = 0; c < chunks; ++c) {
+            dirtyCasters_.insert(dirtyCasters_.end(),
+                                 chunkCasters_[c].begin(), chunkCasters_[c].end());
         }
     }
+    noteMoved();
+}
+
+entt::entity Scene::RaycastBounds(const glm::vec3& origin, const glm::vec3& dir,
+                                  float maxT, float* tOut)
+{
+    bounds_.Sync();
+    rayHits_.clear(); // kept: a ray per frame for picking would allocate every frame
+    bounds_.Raycast(origin, dir, maxT, rayHits_);
+    entt::entity best = entt::null;
+    float bestT = FLT_MAX;
+    for (const auto& h : rayHits_) {
+        if (h.t < bestT) { bestT = h.t; best = h.entity; }
+    }
+    if (tOut) *tOut = bestT;
+    return best;
 }
 
 bool Scene::HasDynamicCasterInViewRange(const glm::vec3& camPos, const glm::vec3& camFwd,
@@ -428,77 +592,157 @@ void Scene::SelectPunctualLights(entt::registry& reg, const glm::vec3& camPos,
     if (culledOut) *culledOut = culled;
 }
 
-// Renderer calls this; we keep signature identical.
-// Now builds a draw list with frustum culling, sorts, then batches by texture key.
-void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camera,
-                        int viewportHeightPx)
+bool Scene::ViewKey::operator==(const ViewKey& o) const {
+    // bitwise: the same view recomputed from the same inputs is the same bits
+    return std::memcmp(&planes, &o.planes, sizeof(planes)) == 0 &&
+           position == o.position && front == o.front && zoomDeg == o.zoomDeg &&
+           viewportHeightPx == o.viewportHeightPx && cascadeIndex == o.cascadeIndex;
+}
+
+Scene::ViewKey Scene::cameraKey_(const CameraView& v) {
+    ViewKey k;
+    k.planes = BoundsCache::PlanesFrom(v.frustum);
+    k.position = v.position;
+    k.front = v.front;
+    k.zoomDeg = v.zoomDeg;
+    k.viewportHeightPx = v.viewportHeightPx;
+    return k;
+}
+
+Scene::ViewKey Scene::cascadeKey_(const CascadeParam& p) {
+    ViewKey k;
+    k.planes = BoundsCache::PlanesFromClip(p.lightVP);
+    k.cascadeIndex = p.cascadeIndex;
+    return k;
+}
+
+void Scene::BuildDrawLists(const CameraView* camera, const std::vector<CascadeParam>& cascades,
+                           JobSystem* jobs)
 {
-    shader.setVec3("uCamPos", camera.Position);
-    RenderStats stats{}; // local accumulator for this frame
-    items_.clear();
-    items_.reserve(1024);
-    transparentItems_.clear(); // rebuilt below; consumed by RenderTransparent
+    CSE_PROFILE_ZONE("Scene::BuildDrawLists");
+    const std::size_t numCascades = std::min<std::size_t>(cascades.size(), 4);
+    for (bool& b : cascadePrebuilt_) b = false;
+    // a camera whose recording still holds is replayed, not built; one that
+    // is built gets its slot here, on the main thread
+    DrawRecording* cameraRec = nullptr;
+    if (camera) {
+        const ViewKey key = cameraKey_(*camera);
+        if (DrawRecording* held = currentRecording_(key)) {
+            held->lastUsed = ++recordingTick_;
+            camera = nullptr;
+        }
+        else {
+            cameraRec = &recordingSlot_(key);
+        }
+    }
+
+    // Everything the views share is brought up to date HERE, on the main
+    // thread: the tasks below only read it.
+    bounds_.Sync();
+
+    // View 0 is the camera (when there is one), then one per cascade. The
+    // camera is usually the biggest list, so it is handed out first rather
+    // than started last.
+    const std::size_t first = camera ? 0 : 1;
+    int cache[4];
+    cacheSlots_(cascades, numCascades, cache);
+    auto buildView = [&](std::size_t view) {
+        if (view == 0) buildCameraList_(*camera, *cameraRec);
+        else buildCascadeList_(view - 1, cascades[view - 1], cache[view - 1]);
+    };
+    const std::size_t views = numCascades + 1 - first;
+    if (jobs && views > 1) {
+        jobs->parallelFor(views, 1, [&](std::size_t b, std::size_t e, std::size_t) {
+            for (std::size_t v = b; v < e; ++v) buildView(first + v);
+        });
+    }
+    else {
+        for (std::size_t v = 0; v < views; ++v) buildView(first + v);
+    }
+
+    for (std::size_t c = 0; c < numCascades; ++c) {
+        cascadePrebuilt_[c] = true;
+        cascadePrebuiltKey_[c] = cascadeKey_(cascades[c]);
+    }
+}
+
+// The camera's lists: frustum/size cull, opaque and transparent items, both
+// sorted, then recorded. May run on a JobSystem worker (see BuildDrawLists),
+// so it reads the registry through a const reference -- the non-const
+// accessors may create a component pool, which is a structural change -- and
+// writes only the camera's lists, its sorters, the recording slot `rec` and
+// bounds_' camera cull results.
+void Scene::buildCameraList_(const CameraView& v, DrawRecording& rec)
+{
+    CSE_PROFILE_ZONE("Scene::BuildCameraList");
+    const entt::registry& reg = registry;
+    RenderStats stats{};
+    // Sized from last frame's lists, so the arena carves each one once
+    // instead of growing it by doubling (every abandoned block stays
+    // allocated until the frame is rewound).
+    frameMem_.Refresh(items_, items_.size());
+    frameMem_.Refresh(itemMats_, itemMats_.size());
+    frameMem_.Refresh(transparentItems_, transparentItems_.size()); // consumed by RenderTransparent
+    frameMem_.Refresh(transparentMats_, transparentMats_.size());
 
     // Projected-size cull needs the vertical-FOV factor and a pixel height.
     // Object pixel height ~= viewportH * (2*radius) / (2*dist*tan(fovY/2))
     //                      = viewportH * radius / (dist * tanHalfFov).
     // Zoom is vertical FOV in DEGREES (mirror ForwardOpaquePass's frustum).
-    const float tanHalfFov = std::tan(glm::radians(camera.Zoom) * 0.5f);
-    const bool  screenCull = smallCullEnabled_ && viewportHeightPx > 0 &&
+    const float tanHalfFov = std::tan(glm::radians(v.zoomDeg) * 0.5f);
+    const bool  screenCull = smallCullEnabled_ && v.viewportHeightPx > 0 &&
                              tanHalfFov > 1e-4f && smallCullPixels_ > 0.f;
 
-    // 1) Build draw list with frustum test
-    auto view = registry.view<ModelComponent, Transform, AABB>();
-    for (auto entity : view) {
-        auto& mc = view.get<ModelComponent>(entity);
-        auto& t = view.get<Transform>(entity);
-        auto& bounds = view.get<AABB>(entity);
-        stats.entitiesTotal++;
-
+    // 1) Cull, then build the draw list from the survivors. The frustum
+    // test, the size cull and the LOD pick run in one SIMD pass over the
+    // cached world bounds (BoundsCache / CullKernel); only what survives
+    // touches the registry.
+    //
+    // Screen-space size cull: skip objects whose projected sphere is
+    // smaller than the threshold in pixels. Adaptive — flying high/wide
+    // shrinks distant objects below the floor and bounds the frame, which
+    // is the only lever that helps a vertex/instance-bound wide view
+    // (shadows/PCF/fill were measured free). The object is dropped from
+    // the FORWARD pass only; its (equally sub-pixel) shadow is left to the
+    // shadow pass, so no caster-set change and no CSM ghosting.
+    //
+    // LOD by camera distance relative to the object's world-space size.
+    CullParams cp;
+    cp.camX = v.position.x; cp.camY = v.position.y; cp.camZ = v.position.z;
+    cp.screenCull = screenCull;
+    cp.viewportHeightPx = (float)v.viewportHeightPx;
+    cp.tanHalfFov = tanHalfFov;
+    cp.minPixels = smallCullPixels_;
+    cp.lodEnabled = lodEnabled_;
+    cp.lodDistanceScale = lodDistanceScale_;
+    bounds_.Cull(BoundsCache::PlanesFrom(v.frustum), cp);
+
+    // Settled entities the frustum rejected are never visited, so an
+    // unloaded (null) model out of view counts as culled here.
+    stats.entitiesTotal = static_cast<unsigned>(bounds_.Size());
+    stats.culled = static_cast<unsigned>(bounds_.Size() - bounds_.Hits().size());
+    for (const BoundsCache::Hit& hit : bounds_.Hits()) {
+        const entt::entity entity = hit.entity;
+        const auto& mc = reg.get<ModelComponent>(entity);
         if (!mc.model) continue;
-        if (!bounds.isOnFrustum(camFrustum, t)) { stats.culled++; continue; }
-
-        // World-space bounding sphere (center + radius) — needed by BOTH the
-        // LOD level and the screen-size cull, so it's computed unconditionally
-        // (was inside the lodEnabled_ block).
-        const glm::vec3 localC = (bounds.min + bounds.max) * 0.5f;
-        const glm::vec3 worldC = glm::vec3(t.modelMatrix * glm::vec4(localC, 1.f));
-        const float maxScale = std::max({ glm::length(glm::vec3(t.modelMatrix[0])),
-                                          glm::length(glm::vec3(t.modelMatrix[1])),
-                                          glm::length(glm::vec3(t.modelMatrix[2])) });
-        const float radius = std::max(0.01f, glm::length(bounds.max - bounds.min) * 0.5f * maxScale);
-        const float dist = glm::length(worldC - camera.Position);
-
-        // Screen-space size cull: skip objects whose projected sphere is
-        // smaller than the threshold in pixels. Adaptive — flying high/wide
-        // shrinks distant objects below the floor and bounds the frame, which
-        // is the only lever that helps a vertex/instance-bound wide view
-        // (shadows/PCF/fill were measured free). The object is dropped from
-        // the FORWARD pass only; its (equally sub-pixel) shadow is left to the
-        // shadow pass, so no caster-set change and no CSM ghosting.
-        if (screenCull && dist > 1e-3f) {
-            const float pixelH = (float)viewportHeightPx * radius / (dist * tanHalfFov);
-            if (pixelH < smallCullPixels_) { stats.culledSmall++; continue; }
-        }
-
-        // LOD by camera distance relative to the object's world-space size
-        int lod = 0;
-        if (lodEnabled_) {
-            const float ratio = dist / (radius * lodDistanceScale_);
-            lod = (ratio > 60.f) ? 2 : (ratio > 25.f) ? 1 : 0;
-        }
+        if (hit.result == kCullSmall) { stats.culledSmall++; continue; }
+        const int lod = hit.lod;
+        const auto& t = reg.get<Transform>(entity);
+        const bool hasOverrides = reg.get<RenderProxy>(entity).flags & RenderProxy::kHasOverrides;
 
         // Push one DrawItem per mesh in the model
         for (const auto& mesh : mc.model->Meshes()) {
             DrawItem di;
             di.entity = entity;
             di.mesh = &mesh;
-            di.model = t.modelMatrix;
             di.lod = lod;
-            di.depth = glm::dot(glm::vec3(di.model[3]) - camera.Position, camera.Front);
+            di.depth = glm::dot(glm::vec3(t.modelMatrix[3]) - v.position, v.front);
+            di.hasOverrides = hasOverrides;
             // Batch key is derived from the material actually used by this entity
-            if (const Material* m = chooseMaterial_(entity, mesh)) {
-                di.texKey = texKeyFromMaterial_(*m);
+            if (const Material* m = chooseMaterial_(entity, mesh, hasOverrides)) {
+                const TextureArrays::Slot albedo = TextureArrays::Get().Find(m->albedoTex);
+                di.texKey = texKeyFromMaterial_(*m, albedo.array);
+                di.albedoLayer = albedo.layer;
                 di.alphaMode = static_cast<int>(m->alphaMode);
                 di.doubleSided = m->doubleSided;
                 di.shadingModel = static_cast<int>(m->shadingModel);
@@ -511,10 +755,14 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
             // write); everything else joins the opaque list. When no material
             // is transparent -- the overwhelmingly common case -- this is a
             // straight push to items_ exactly as before.
-            if (di.alphaMode == static_cast<int>(AlphaMode::Blend))
+            if (di.alphaMode == static_cast<int>(AlphaMode::Blend)) {
                 transparentItems_.push_back(di);
-            else
+                transparentMats_.push_back(t.modelMatrix);
+            }
+            else {
                 items_.push_back(di);
+                itemMats_.push_back(t.modelMatrix);
+            }
         }
     }
     stats.itemsBuilt = static_cast<unsigned>(items_.size());
@@ -525,53 +773,155 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
     // the usual case -- alphaMode is 0 for all and this reduces EXACTLY to the
     // previous {texKey, mesh, lod, depth} order, so opaque scenes are byte-for-
     // byte unchanged.
-    std::sort(items_.begin(), items_.end(),
-        [](const DrawItem& a, const DrawItem& b) {
-            if (a.alphaMode != b.alphaMode) return a.alphaMode < b.alphaMode;  // opaque prefix, masked suffix
-            // Single-sided before double-sided so the prepass-covered runs
-            // (opaque + single-sided) form a contiguous prefix. All-false for a
-            // conventional opaque scene, so the order is unchanged there.
-            if (a.doubleSided != b.doubleSided) return !a.doubleSided;         // false (0) sorts first
-            if (a.shadingModel != b.shadingModel) return a.shadingModel < b.shadingModel; // PBR/Toon split into separate runs
-            if (a.texKey != b.texKey) return a.texKey < b.texKey;              // bucket by textures
-            if (a.mesh != b.mesh)   return (uintptr_t)a.mesh < (uintptr_t)b.mesh; // group identical VAOs
-            if (a.lod != b.lod)     return a.lod < b.lod;                       // instanced runs share a LOD
-            return a.depth < b.depth;                                           // front-to-back within a mesh
-        });
-    ensureInstanceBuffer_();
-
-    // Discover instanced runs once and upload EVERY instance matrix in one
-    // buffer update; draws then point the instanced attribs at per-run byte
-    // offsets. (The old per-run glBufferData+glMapBuffer cycle was a driver
-    // sync per run — the top frame cost at high instance counts.)
-    runs_.clear();
-    instanceMats_.clear();
-    for (std::size_t i = 0; i < items_.size(); ) {
-        const auto key = items_[i].texKey;
-        const Mesh* mesh = items_[i].mesh;
-        const int lod = items_[i].lod;
-        const int amode = items_[i].alphaMode;
-        const bool ds = items_[i].doubleSided;
-        const int sm = items_[i].shadingModel;
+    //  - Single-sided before double-sided so the prepass-covered runs (opaque
+    //    + single-sided) form a contiguous prefix. All-false for a
+    //    conventional opaque scene, so the order is unchanged there.
+    //  - PBR/Toon split into separate runs; identical VAOs group; instanced
+    //    runs share a LOD; front-to-back within a mesh.
+    // All of it is one packed 64-bit key per item (DrawSort.h), radix-sorted
+    // with the item index; items_ itself is never moved.
+    drawSorter_.Clear();
+    for (const DrawItem& di : items_) {
+        drawSorter_.Add({ di.alphaMode, di.doubleSided, di.shadingModel,
+                          di.texKey, di.mesh, di.lod, di.depth });
+    }
+    drawSorter_.Sort();
+
+    // Transparents back-to-front by view-space depth: depth is
+    // dot(centre - camPos, camFront), so larger = farther, and the sorter
+    // is ascending, so it is handed the negated depth.
+    transparentSorter_.Clear();
+    for (const DrawItem& di : transparentItems_) {
+        DrawKeyFields f;
+        f.depth = -di.depth;
+        transparentSorter_.Add(f);
+    }
+    transparentSorter_.Sort();
+
+    record_(rec, cameraKey_(v), stats);
+}
+
+Scene::DrawRecording* Scene::currentRecording_(const ViewKey& view)
+{
+    for (DrawRecording& rec : recordings_) {
+        if (rec.valid && rec.epoch == epoch_ && rec.view == view) return &rec;
+    }
+    return nullptr;
+}
+
+// The slot a build for `view` writes: the view's own (stale) recording if it
+// has one, else the least recently used -- an unused slot has lastUsed 0.
+Scene::DrawRecording& Scene::recordingSlot_(const ViewKey& view)
+{
+    DrawRecording* slot = &recordings_[0];
+    for (DrawRecording& rec : recordings_) {
+        if (rec.valid && rec.view == view) { slot = &rec; break; }
+        if (rec.lastUsed < slot->lastUsed) slot = &rec;
+    }
+    slot->lastUsed = ++recordingTick_;
+    return *slot;
+}
+
+const Scene::DrawRecording& Scene::latestRecording_() const
+{
+    const DrawRecording* latest = &recordings_[0];
+    for (const DrawRecording& rec : recordings_) {
+        if (rec.lastUsed > latest->lastUsed) latest = &rec;
+    }
+    return *latest;
+}
+
+// Lays the sorted lists out the way RenderScene submits them: items and
+// matrices in draw order, the instanced runs, and every instanced matrix
+// gathered into one array (the only place they are gathered). With
+// multi-draw on, single-item runs are gathered too, so any run can be a
+// command in an indirect batch.
+void Scene::record_(DrawRecording& rec, const ViewKey& view, const RenderStats& buildStats)
+{
+    const std::vector<uint32_t>& order = drawSorter_.Order();
+    rec.items.clear();
+    rec.mats.clear();
+    rec.runs.clear();
+    rec.instanceMats.clear();
+    rec.instanceLayers.clear();
+    for (uint32_t i : order) {
+        rec.items.push_back(items_[i]);
+        rec.mats.push_back(itemMats_[i]);
+    }
+    for (std::size_t i = 0; i < rec.items.size(); ) {
+        const DrawItem& head = rec.items[i];
         std::size_t runEnd = i + 1;
-        while (runEnd < items_.size() &&
-            items_[runEnd].texKey == key &&
-            items_[runEnd].mesh == mesh &&
-            items_[runEnd].lod == lod &&
-            items_[runEnd].alphaMode == amode &&
-            items_[runEnd].doubleSided == ds &&
-            items_[runEnd].shadingModel == sm) { // homogeneous in mode, cull state AND shading
+        while (runEnd < rec.items.size() &&
+            rec.items[runEnd].texKey == head.texKey &&
+            rec.items[runEnd].mesh == head.mesh &&
+            rec.items[runEnd].lod == head.lod &&
+            rec.items[runEnd].alphaMode == head.alphaMode &&
+            rec.items[runEnd].doubleSided == head.doubleSided &&
+            rec.items[runEnd].shadingModel == head.shadingModel) { // homogeneous in mode, cull state AND shading
             ++runEnd;
         }
         const std::size_t count = runEnd - i;
-        runs_.push_back({ key, mesh, lod, i, count, instanceMats_.size(), amode });
-        if (instancingEnabled_ && count >= 2) {
-            for (std::size_t k = 0; k < count; ++k)
-                instanceMats_.push_back(items_[i + k].model);
+        rec.runs.push_back({ head.texKey, head.mesh, head.lod, i, count, rec.instanceMats.size(), head.alphaMode });
+        if (instancingEnabled_ && (count >= 2 || multiDrawEnabled_)) {
+            rec.instanceMats.insert(rec.instanceMats.end(), rec.mats.begin() + i, rec.mats.begin() + runEnd);
+            for (std::size_t k = i; k < runEnd; ++k) {
+                rec.instanceLayers.push_back(static_cast<float>(rec.items[k].albedoLayer));
+            }
         }
         i = runEnd;
     }
-    uploadInstanceMats_();
+
+    rec.transparentItems.clear();
+    rec.transparentMats.clear();
+    for (uint32_t i : transparentSorter_.Order()) {
+        rec.transparentItems.push_back(transparentItems_[i]);
+        rec.transparentMats.push_back(transparentMats_[i]);
+    }
+
+    rec.view = view;
+    rec.epoch = epoch_;
+    rec.buildStats = buildStats;
+    rec.valid = true;
+}
+
+// Renderer calls this; we keep signature identical.
+// Submits the camera's recorded draws, batched by texture key. The recording
+// is rebuilt here (or by BuildDrawLists) only when the view or the scene
+// epoch changed since it was made; otherwise the frame is a pure replay.
+void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camera,
+                        int viewportHeightPx)
+{
+    TextureArrays::Get().EnsureContext(); // BeginFrame may have been skipped
+
+    CameraView view;
+    view.frustum = camFrustum;
+    view.position = camera.Position;
+    view.front = camera.Front;
+    view.zoomDeg = camera.Zoom;
+    view.viewportHeightPx = viewportHeightPx;
+    const ViewKey key = cameraKey_(view);
+    DrawRecording* held = currentRecording_(key);
+    const bool replayed = held != nullptr;
+    if (replayed) {
+        held->lastUsed = ++recordingTick_;
+    }
+    else {
+        bounds_.Sync();
+        held = &recordingSlot_(key);
+        buildCameraList_(view, *held);
+    }
+    drawn_ = held;
+    const DrawRecording& rec = *held;
+    RenderStats stats = rec.buildStats; // local accumulator for this frame
+    stats.replayed = replayed;
+
+    // Every instanced matrix goes up in one write to the instance ring;
+    // draws then point the instanced attribs at per-run byte offsets.
+    // Re-uploaded on a replay too: a span lasts one frame of the ring.
+    uploadInstanceMats_(rec.instanceMats.data(), rec.instanceMats.size());
+    uploadInstanceLayers_(rec.instanceLayers.data(), rec.instanceLayers.size());
+    buildBatches_();
+    const std::size_t cmdBytes = sizeof(DrawElementsIndirectCommand);
 
     // --- depth prepass: same runs/LODs/matrices as the color pass with a
     // no-op fragment shader, so the expensive PBR/PCF shading below runs at
@@ -584,10 +934,12 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
 
         Shader& d = *depthPrepassShader_;
         d.use();
-        d.setInt("uUseInstancing", 0);
+        const DrawUniforms& du = prepassUniforms_.For(d);
+        glUniform1i(du.useInstancing, 0);
 
-        const Mesh* prevMesh = nullptr;
-        for (const auto& r : runs_) {
+        unsigned boundVao = 0;
+        for (const DrawBatch& b : batches_) {
+            const DrawRun& r = rec.runs[b.firstRun];
             // Only opaque, single-sided runs belong in the prepass:
             //  - Masked runs would write depth for fragments the color pass
             //    discards (the prepass shader has no alpha test), punching
@@ -597,21 +949,28 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
             //    color pass's back faces would fail GL_EQUAL and vanish.
             // Both depth-test and write normally in the color pass instead.
             const bool inPrepass = (r.alphaMode == static_cast<int>(AlphaMode::Opaque))
-                                   && !items_[r.first].doubleSided;
+                                   && !rec.items[r.first].doubleSided;
             if (!inPrepass) continue;
-            if (r.mesh != prevMesh) {
-                glBindVertexArray(r.mesh->VAO());
-                prevMesh = r.mesh;
+            if (r.mesh->VAO() != boundVao) {
+                boundVao = r.mesh->VAO();
+                glBindVertexArray(boundVao);
+            }
+            if (b.runCount >= 2) {
+                bindInstanceAttribs_(0); // each command's baseInstance offsets it
+                glUniform1i(du.useInstancing, 1);
+                MultiDrawElementsIndirect(indirectSpan_.offset + b.firstCommand * cmdBytes,
+                                          static_cast<int>(b.runCount));
+                glUniform1i(du.useInstancing, 0);
             }
-            if (instancingEnabled_ && r.count >= 2) {
+            else if (instancingEnabled_ && r.count >= 2) {
                 bindInstanceAttribs_(r.matOffset * sizeof(glm::mat4));
-                d.setInt("uUseInstancing", 1);
+                glUniform1i(du.useInstancing, 1);
                 r.mesh->IssueDrawInstanced(static_cast<GLsizei>(r.count), r.lod);
-                d.setInt("uUseInstancing", 0);
+                glUniform1i(du.useInstancing, 0);
             }
             else {
                 for (std::size_t k = 0; k < r.count; ++k) {
-                    d.setMat4("model", items_[r.first + k].model);
+                    glUniformMatrix4fv(du.model, 1, GL_FALSE, &rec.mats[r.first + k][0][0]);
                     r.mesh->IssueDraw(r.lod);
                 }
             }
@@ -624,17 +983,21 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
     }
 
     shader.use();
-    shader.setInt("uUseInstancing", 0);
+    const DrawUniforms& u = colorUniforms_.For(shader);
+    glUniform1i(u.useInstancing, 0);
     uploadGlobalShadingUniforms_(shader, camera, stats);
+    lightsView_ = lightsViewFor_(camera);
 
     uint64_t currentKey = ~0ull;
-    const Mesh* currentMesh = nullptr;
+    unsigned boundVao = 0;
     int  boundAlphaMode = -1;      // alpha mode of the last-bound material
     int  boundShadingModel = -1;   // shading model of the last-bound material
     bool cullOff = false;
     bool depthSwitchedToNormal = false;
 
-    for (const auto& r : runs_) {
+    for (const DrawBatch& b : batches_) {
+        // every run in a batch binds the same state: the head's decides
+        const DrawRun& r = rec.runs[b.firstRun];
         // The prepass covered only opaque + single-sided runs and left the
         // color pass in GL_EQUAL + depthMask FALSE. Everything else (masked,
         // or double-sided opaque) skipped the prepass and must depth-test and
@@ -642,7 +1005,7 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
         // prefix, so this one-way switch fires at most once. No-op when the
         // prepass is off (that state is already active).
         const bool inPrepass = (r.alphaMode == static_cast<int>(AlphaMode::Opaque))
-                               && !items_[r.first].doubleSided;
+                               && !rec.items[r.first].doubleSided;
         if (prepass && !inPrepass && !depthSwitchedToNormal) {
             glDepthFunc(GL_LESS);
             glDepthMask(GL_TRUE);
@@ -652,7 +1015,7 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
         // Double-sided materials draw their back faces too (foliage seen edge
         // on, glass interiors). Toggled per run; single-sided is the norm, so
         // this rarely fires on the opaque hot path.
-        const bool wantCullOff = items_[r.first].doubleSided;
+        const bool wantCullOff = rec.items[r.first].doubleSided;
         if (wantCullOff != cullOff) {
             if (wantCullOff) glDisable(GL_CULL_FACE); else glEnable(GL_CULL_FACE);
             cullOff = wantCullOff;
@@ -668,26 +1031,44 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
         // the same textures + alpha mode (same texKey), so without this the
         // second would skip the bind and inherit the first's uShadingModel.
         if (r.texKey != currentKey || r.alphaMode != boundAlphaMode ||
-            items_[r.first].shadingModel != boundShadingModel) {
-            bindMaterialForItem_(items_[r.first], shader);
+            rec.items[r.first].shadingModel != boundShadingModel) {
+            bindMaterialForItem_(rec.items[r.first], shader);
             currentKey = r.texKey;
             boundAlphaMode = r.alphaMode;
-            boundShadingModel = items_[r.first].shadingModel;
-            currentMesh = r.mesh;
+            boundShadingModel = rec.items[r.first].shadingModel;
             stats.textureBinds++;
-            stats.vaoBinds++; // BindForDraw set VAO
         }
-        else if (r.mesh != currentMesh) {
-            glBindVertexArray(r.mesh->VAO());
-            currentMesh = r.mesh;
+        // Meshes in the shared arena all use their format's VAO: a mesh
+        // change is an offset in the draw, not a bind.
+        if (r.mesh->VAO() != boundVao) {
+            boundVao = r.mesh->VAO();
+            glBindVertexArray(boundVao);
             stats.vaoBinds++;
         }
 
-        if (instancingEnabled_ && r.count >= 2) {
+        if (b.runCount >= 2) {
+            bindInstanceAttribs_(0);
+            bindInstanceLayers_(0);
+            glUniform1i(u.useInstancing, 1);
+            MultiDrawElementsIndirect(indirectSpan_.offset + b.firstCommand * cmdBytes,
+                                      static_cast<int>(b.runCount));
+            glUniform1i(u.useInstancing, 0);
+
+            stats.multiDraws++;
+            stats.drawsSaved += static_cast<unsigned>(b.runCount - 1);
+            for (std::size_t k = b.firstRun; k < b.firstRun + b.runCount; ++k) {
+                const DrawRun& m = rec.runs[k];
+                stats.instances += static_cast<unsigned>(m.count);
+                stats.submitted += static_cast<unsigned>(m.count);
+                stats.lodInstances[glm::clamp(m.lod, 0, 2)] += static_cast<unsigned>(m.count);
+            }
+        }
+        else if (instancingEnabled_ && r.count >= 2) {
             bindInstanceAttribs_(r.matOffset * sizeof(glm::mat4));
-            shader.setInt("uUseInstancing", 1);
+            bindInstanceLayers_(r.matOffset);
+            glUniform1i(u.useInstancing, 1);
             r.mesh->IssueDrawInstanced(static_cast<GLsizei>(r.count), r.lod);
-            shader.setInt("uUseInstancing", 0);
+            glUniform1i(u.useInstancing, 0);
 
             stats.instancedDraws++;
             stats.instances += static_cast<unsigned>(r.count);
@@ -699,8 +1080,8 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
                 // per-item material bind: entities in the same texKey bucket can
                 // still carry different override instances (same textures,
                 // different scalars)
-                bindMaterialForItem_(items_[r.first + k], shader);
-                shader.setMat4("model", items_[r.first + k].model);
+                bindMaterialForItem_(rec.items[r.first + k], shader);
+                glUniformMatrix4fv(u.model, 1, GL_FALSE, &rec.mats[r.first + k][0][0]);
                 r.mesh->IssueDraw(r.lod);
                 stats.draws++;
                 stats.submitted++;
@@ -715,56 +1096,176 @@ void Scene::RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camer
         glDepthMask(GL_TRUE);
     }
     if (cullOff) glEnable(GL_CULL_FACE); // a double-sided run left culling off
+    if (!indirectCmds_.empty()) glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
     glBindVertexArray(0);
     glActiveTexture(GL_TEXTURE0);
 
+    const FrameAllocator::Stats mem = frameMem_.stats();
+    stats.frameArenaKB = static_cast<unsigned>(mem.lastFrameBytes / 1024);
+    stats.frameArenaPeakKB = static_cast<unsigned>(mem.peakFrameBytes / 1024);
+
     lastStats_ = stats; // publish render stats for the last frame
 }
 
-// Uploads the per-frame lighting/material-fallback uniforms shared by the
+// Uploads the per-frame lighting/material-fallback state shared by the
 // opaque and transparent passes. Extracted so a transparent draw shades with
 // EXACTLY the same sun, punctual lights, and IBL as the opaque geometry --
 // otherwise glass would be lit by a different (or empty) light set and read as
-// obviously wrong.
-void Scene::uploadGlobalShadingUniforms_(Shader& shader, Camera& camera, RenderStats& stats) {
-    shader.setInt("uUsePBR", pbrEnabled_ ? 1 : 0);
-    shader.setFloat("uMetallic", metallic_);
-    shader.setFloat("uRoughness", roughness_);
-    shader.setFloat("uAO", ao_);
-    shader.setVec3("uLightDir", lightDir_);
-    shader.setVec3("uLightColor", lightColor_);
-    shader.setFloat("uLightIntensity", lightIntensity_);
+// obviously wrong. Most of it is the FrameGlobals block: the passes filled its
+// cascades, this fills the rest and uploads it, which the transparent pass's
+// call finds unchanged and skips. The transparent pass also reuses the
+// opaque pass's light selection and clusters (`reuseLights`).
+void Scene::uploadGlobalShadingUniforms_(Shader& shader, Camera& camera, RenderStats& stats,
+                                         bool reuseLights) {
+    bindUniformBlocks_(shader);
+
+    FrameGlobalsBlock& g = frameGlobals_;
+    g.camPos = camera.Position;
+    g.lightDir = lightDir_;
+    g.lightColor = lightColor_;
+    g.lightIntensity = lightIntensity_;
+    g.usePBR = pbrEnabled_ ? 1 : 0;
+    g.useMetallicMap = metallicMapEnabled_ ? 1 : 0;
+    g.useRoughnessMap = roughnessMapEnabled_ ? 1 : 0;
+    g.useAOMap = aoMapEnabled_ ? 1 : 0;
+    g.useIBL = (iblEnabled_ && iblAvailable_) ? 1 : 0;
+    g.iblIntensity = iblIntensity_;
+    g.normalMapEnabled = normalMapEnabled_ ? 1 : 0;
 
     // Punctual lights: selection is a pure function (testable headlessly),
     // this is just the upload. The array is bounded, so a scene with 500
-    // lamps uploads the 16 that matter most to this camera.
-    SelectPunctualLights(registry, camera.Position, punctualScratch_,
-                         kMaxPunctualLights, &stats.lightsCulled);
+    // lamps uploads the 16 that matter most to this camera. Clustered, it
+    // uploads up to 256 and each fragment reads only the ones that reach it.
+    g.useClusters = clusteredLightsEnabled_ ? 1 : 0;
+    if (!reuseLights) {
+        uploadPunctualLights_(camera, stats);
+        if (clusteredLightsEnabled_) uploadLightClusters_(camera, stats);
+    }
+    g.numLights = clusteredLightsEnabled_ ? 0 : static_cast<int>(punctualScratch_.size());
+    frameGlobalsUBO_.Bind(kFrameGlobalsBinding, &g, sizeof(g));
+
+    // The scalars a mesh without a material draws with. Bound now as well,
+    // so the material block is backed (and opaque) before the first bind.
+    fallbackMaterial_.metallic = metallic_;
+    fallbackMaterial_.roughness = roughness_;
+    fallbackMaterial_.ao = ao_;
+    const MaterialBlockData fallback = PackMaterialBlock(fallbackMaterial_);
+    fallbackMaterial_.block.Bind(kMaterialBinding, &fallback, sizeof(fallback));
+
+    // Fixed texture units, the same for every material. Set even when no
+    // material uses an array: left at its default of 0, the array sampler
+    // would share unit 0 with the 2D albedo sampler.
+    shader.setInt("diffuseMap", 0);
+    shader.setInt("normalMap", 1);
+    shader.setInt("metallicMap", 2);
+    shader.setInt("roughnessMap", 3);
+    shader.setInt("aoMap", 4);
+    shader.setInt("diffuseArray", kAlbedoArrayUnit);
+}
+
+// The selected punctual lights as the PunctualLights block: four vec4s each,
+// world space. Both paths read it; the array path only its first 16.
+void Scene::uploadPunctualLights_(Camera& camera, RenderStats& stats) {
+    const size_t maxLights = clusteredLightsEnabled_ ? LightClusters::kMaxLights
+                                                     : kMaxPunctualLights;
+    SelectPunctualLights(registry, camera.Position, punctualScratch_, maxLights,
+                         &stats.lightsCulled);
     stats.lightsActive = static_cast<unsigned>(punctualScratch_.size());
-    shader.setInt("uNumLights", static_cast<int>(punctualScratch_.size()));
+
+    clusterLightData_.assign(std::size_t(LightClusters::kMaxLights) * 4, glm::vec4(0.f));
+    for (size_t i = 0; i < punctualScratch_.size(); ++i) {
+        const PunctualLight& L = punctualScratch_[i];
+        clusterLightData_[i * 4 + 0] = glm::vec4(L.position, L.range);
+        clusterLightData_[i * 4 + 1] = glm::vec4(L.color, L.intensity);
+        clusterLightData_[i * 4 + 2] = glm::vec4(L.spotDir, L.cosOuter);
+        clusterLightData_[i * 4 + 3] = glm::vec4(L.cosInner, float(L.type), 0.f, 0.f);
+    }
+    if (!clusterUBO_[0]) glGenBuffers(3, clusterUBO_);
+    // whole-block respecify each frame: the driver orphans the old store
+    // (no GPU sync), and the block is its full declared size
+    glBindBuffer(GL_UNIFORM_BUFFER, clusterUBO_[0]);
+    glBufferData(GL_UNIFORM_BUFFER, clusterLightData_.size() * sizeof(glm::vec4),
+                 clusterLightData_.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kPunctualLightsBinding, clusterUBO_[0]);
+}
+
+// Clustered punctual lights: the lights uploadPunctualLights_ selected,
+// binned into the camera's froxels and uploaded as two more uniform blocks.
+// The lights go up in world space (the shader lights worldPos); only the
+// binning is in view space.
+void Scene::uploadLightClusters_(Camera& camera, RenderStats& stats) {
+    GLint vp[4] = { 0, 0, 1, 1 };
+    glGetIntegerv(GL_VIEWPORT, vp);
+    ClusterGridDesc grid;
+    grid.nearZ = camera.NearClip;
+    grid.farZ = camera.FarClip;
+    grid.tanHalfFovY = std::tan(glm::radians(camera.Zoom) * 0.5f);
+    grid.viewportW = float(std::max(vp[2], 1));
+    grid.viewportH = float(std::max(vp[3], 1));
+    grid.aspect = grid.viewportW / grid.viewportH;
+
+    // selection order is influence order, so overflow drops the weakest
+    const glm::mat4 viewM = camera.GetViewMatrix();
+    clusterSpheres_.resize(punctualScratch_.size());
     for (size_t i = 0; i < punctualScratch_.size(); ++i) {
         const PunctualLight& L = punctualScratch_[i];
-        char name[40];
-        std::snprintf(name, sizeof(name), "uLightPosRange[%zu]", i);
-        shader.setVec4(name, glm::vec4(L.position, L.range));
-        std::snprintf(name, sizeof(name), "uLightColorInt[%zu]", i);
-        shader.setVec4(name, glm::vec4(L.color, L.intensity));
-        std::snprintf(name, sizeof(name), "uLightSpotDir[%zu]", i);
-        shader.setVec4(name, glm::vec4(L.spotDir, L.cosOuter));
-        std::snprintf(name, sizeof(name), "uLightSpotMisc[%zu]", i);
-        shader.setVec4(name, glm::vec4(L.cosInner, float(L.type), 0.f, 0.f));
+        const glm::vec3 v = glm::vec3(viewM * glm::vec4(L.position, 1.f));
+        clusterSpheres_[i] = { v.x, v.y, v.z, L.range };
     }
-    shader.setInt("uUseMetallicMap", metallicMapEnabled_ ? 1 : 0);
-    shader.setInt("uUseRoughnessMap", roughnessMapEnabled_ ? 1 : 0);
-    shader.setInt("uUseAOMap", aoMapEnabled_ ? 1 : 0);
-    shader.setInt("uUseIBL", (iblEnabled_ && iblAvailable_) ? 1 : 0);
-    shader.setFloat("uIBLIntensity", iblIntensity_);
-    shader.setInt("uNormalMapEnabled", normalMapEnabled_ ? 1 : 0);
-    // Default alpha mode = Opaque. Per-material binds override it; this covers
-    // the no-material (legacy BindForDraw) item, which would otherwise inherit
-    // a stale uAlphaMode (e.g. Blend from the previous frame's transparent
-    // pass) and wrongly discard or blend.
-    shader.setInt("uAlphaMode", 0);
+    lightClusters_.Build(grid, clusterSpheres_.data(), clusterSpheres_.size());
+    stats.lightClusterRefs = static_cast<unsigned>(lightClusters_.Indices().size());
+    stats.lightClusterDropped = lightClusters_.Dropped();
+
+    lightClusters_.PackGrid(clusterWords_);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusterUBO_[1]);
+    glBufferData(GL_UNIFORM_BUFFER, clusterWords_.size() * sizeof(uint32_t),
+                 clusterWords_.data(), GL_STREAM_DRAW);
+    lightClusters_.PackIndices(clusterWords_);
+    glBindBuffer(GL_UNIFORM_BUFFER, clusterUBO_[2]);
+    glBufferData(GL_UNIFORM_BUFFER, clusterWords_.size() * sizeof(uint32_t),
+                 clusterWords_.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kClusterGridBinding, clusterUBO_[1]);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kClusterIndicesBinding, clusterUBO_[2]);
+}
+
+bool Scene::LightsView::operator==(const LightsView& o) const {
+    return valid == o.valid && clustered == o.clustered && position == o.position &&
+           view == o.view && zoomDeg == o.zoomDeg && nearZ == o.nearZ && farZ == o.farZ &&
+           std::memcmp(viewport, o.viewport, sizeof(viewport)) == 0;
+}
+
+// Everything the light selection (camera position) and the cluster grid
+// (view, projection, viewport) depend on.
+Scene::LightsView Scene::lightsViewFor_(Camera& camera) const {
+    LightsView v;
+    v.valid = true;
+    v.clustered = clusteredLightsEnabled_;
+    v.position = camera.Position;
+    v.view = camera.GetViewMatrix();
+    v.zoomDeg = camera.Zoom;
+    v.nearZ = camera.NearClip;
+    v.farZ = camera.FarClip;
+    glGetIntegerv(GL_VIEWPORT, v.viewport);
+    return v;
+}
+
+// Block bindings are per program, so they are set again only when a
+// different program comes through.
+void Scene::bindUniformBlocks_(const Shader& shader) {
+    if (blocksProgram_ == shader.ID) return;
+    const struct { const char* name; unsigned binding; } blocks[] = {
+        { "PunctualLights", kPunctualLightsBinding },
+        { "ClusterGrid", kClusterGridBinding },
+        { "ClusterIndices", kClusterIndicesBinding },
+        { "FrameGlobals", kFrameGlobalsBinding },
+        { "MaterialBlock", kMaterialBinding } };
+    for (const auto& b : blocks) {
+        const GLuint idx = glGetUniformBlockIndex(shader.ID, b.name);
+        if (idx != GL_INVALID_INDEX) glUniformBlockBinding(shader.ID, idx, b.binding);
+    }
+    blocksProgram_ = shader.ID;
 }
 
 // Blend-mode geometry, drawn after the skybox so it composites over the whole
@@ -773,18 +1274,20 @@ void Scene::uploadGlobalShadingUniforms_(Shader& shader, Camera& camera, RenderS
 // depth-writing (so two transparent surfaces do not occlude each other by
 // depth), and never instanced (the sort order is per-item, not per-batch).
 void Scene::RenderTransparent(Shader& shader, Camera& camera) {
-    if (transparentItems_.empty()) return;
-
-    // Back-to-front by view-space depth. depth was computed in RenderScene as
-    // dot(centre - camPos, camFront), so larger = farther; draw farthest first.
-    std::sort(transparentItems_.begin(), transparentItems_.end(),
-        [](const DrawItem& a, const DrawItem& b) { return a.depth > b.depth; });
+    if (!HasTransparent()) return;
+    const DrawRecording& rec = *drawn_;
 
     shader.use();
-    shader.setVec3("uCamPos", camera.Position);
-    shader.setInt("uUseInstancing", 0);
+    const DrawUniforms& u = colorUniforms_.For(shader);
+    glUniform1i(u.useInstancing, 0);
+    // The opaque pass of this view already selected, binned and uploaded the
+    // punctual lights, and they are still bound: only a transparent pass for
+    // another view (or with no opaque pass this frame) selects them again.
+    const LightsView lights = lightsViewFor_(camera);
+    const bool reuseLights = lights == lightsView_;
     RenderStats scratch{}; // transparent lights fold into the opaque stats; not published
-    uploadGlobalShadingUniforms_(shader, camera, scratch);
+    uploadGlobalShadingUniforms_(shader, camera, scratch, reuseLights);
+    lightsView_ = lights;
 
     // Establish a KNOWN cull state rather than trusting the incoming one.
     // (Belt-and-braces with SkyboxPass restoring it -- this pass must not
@@ -807,16 +1310,23 @@ void Scene::RenderTransparent(Shader& shader, Camera& camera) {
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
     glDepthMask(GL_TRUE);
     glDepthFunc(GL_LESS);
+    unsigned boundVao = 0;
     {
         bool cullOff = false;
-        for (const auto& di : transparentItems_) {
+        // Back-to-front by view-space depth, farthest first: recorded in
+        // that order when the camera's list was built.
+        for (std::size_t i = 0; i < rec.transparentItems.size(); ++i) {
+            const DrawItem& di = rec.transparentItems[i];
             const bool wantCullOff = di.doubleSided;
             if (wantCullOff != cullOff) {
                 if (wantCullOff) glDisable(GL_CULL_FACE); else glEnable(GL_CULL_FACE);
                 cullOff = wantCullOff;
             }
-            glBindVertexArray(di.mesh->VAO());
-            shader.setMat4("model", di.model);
+            if (di.mesh->VAO() != boundVao) {
+                boundVao = di.mesh->VAO();
+                glBindVertexArray(boundVao);
+            }
+            glUniformMatrix4fv(u.model, 1, GL_FALSE, &rec.transparentMats[i][0][0]);
             di.mesh->IssueDraw(di.lod);
         }
         if (cullOff) glEnable(GL_CULL_FACE);
@@ -832,16 +1342,19 @@ void Scene::RenderTransparent(Shader& shader, Camera& camera) {
     glDepthFunc(GL_LEQUAL); // == the frontmost surface primed above
 
     bool cullOff = false;
-    const Mesh* currentMesh = nullptr;
-    for (const auto& di : transparentItems_) {
+    for (std::size_t i = 0; i < rec.transparentItems.size(); ++i) {
+        const DrawItem& di = rec.transparentItems[i];
         const bool wantCullOff = di.doubleSided;
         if (wantCullOff != cullOff) {
             if (wantCullOff) glDisable(GL_CULL_FACE); else glEnable(GL_CULL_FACE);
             cullOff = wantCullOff;
         }
-        bindMaterialForItem_(di, shader); // sets uAlphaMode=Blend, uOpacity, VAO
-        if (di.mesh != currentMesh) currentMesh = di.mesh; // BindForDraw set the VAO
-        shader.setMat4("model", di.model);
+        bindMaterialForItem_(di, shader); // its block carries Blend and the opacity
+        if (di.mesh->VAO() != boundVao) {
+            boundVao = di.mesh->VAO();
+            glBindVertexArray(boundVao);
+        }
+        glUniformMatrix4fv(u.model, 1, GL_FALSE, &rec.transparentMats[i][0][0]);
         di.mesh->IssueDraw(di.lod);
     }
 
@@ -854,25 +1367,69 @@ void Scene::RenderTransparent(Shader& shader, Camera& camera) {
     glActiveTexture(GL_TEXTURE0);
 }
 
-void Scene::ensureInstanceBuffer_() {
-    if (!instanceVBO_) {
-        glGenBuffers(1, &instanceVBO_);
+// Groups the recorded runs for submission. With multi-draw available, a
+// batch is a stretch of consecutive runs that bind the same material, cull
+// state and arena VAO, so one indirect call draws them all; otherwise every
+// run is a batch of one. The commands of the 2+ batches go up in one write
+// to the instance ring and stay bound for both passes.
+void Scene::buildBatches_()
+{
+    const DrawRecording& rec = *drawn_;
+    batches_.clear();
+    indirectCmds_.clear();
+    const bool multiDraw = multiDrawEnabled_ && instancingEnabled_ && GetGLCaps().multiDrawIndirect;
+    for (std::size_t i = 0; i < rec.runs.size(); ) {
+        const DrawRun& head = rec.runs[i];
+        const DrawItem& headItem = rec.items[head.first];
+        std::size_t end = i + 1;
+        if (multiDraw && head.mesh->InArena()) {
+            while (end < rec.runs.size()) {
+                const DrawRun& r = rec.runs[end];
+                const DrawItem& item = rec.items[r.first];
+                if (!r.mesh->InArena() || r.mesh->VAO() != head.mesh->VAO() ||
+                    r.texKey != head.texKey || r.alphaMode != head.alphaMode ||
+                    item.shadingModel != headItem.shadingModel ||
+                    item.doubleSided != headItem.doubleSided) {
+                    break;
+                }
+                ++end;
+            }
+        }
+        batches_.push_back({ i, end - i, indirectCmds_.size() });
+        if (end - i >= 2) {
+            for (std::size_t k = i; k < end; ++k) {
+                const DrawRun& r = rec.runs[k];
+                const Mesh::LodRange& lr = r.mesh->Lod(r.lod);
+                DrawElementsIndirectCommand cmd;
+                cmd.count = static_cast<uint32_t>(lr.indexCount);
+                cmd.instanceCount = static_cast<uint32_t>(r.count);
+                cmd.firstIndex = r.mesh->FirstIndex() + static_cast<uint32_t>(lr.firstIndex);
+                cmd.baseVertex = static_cast<int32_t>(r.mesh->BaseVertex());
+                cmd.baseInstance = static_cast<uint32_t>(r.matOffset);
+                indirectCmds_.push_back(cmd);
+            }
+        }
+        i = end;
     }
+    if (indirectCmds_.empty()) return;
+
+    // into the instance ring beside the matrices: fresh space every frame,
+    // so nothing orphans; the draws add indirectSpan_.offset
+    indirectSpan_ = instanceStream_.Write(indirectCmds_.data(),
+                                          indirectCmds_.size() * sizeof(DrawElementsIndirectCommand),
+                                          sizeof(uint32_t));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectSpan_.buffer);
 }
 
-void Scene::uploadInstanceMats_() {
-    const std::size_t bytes = instanceMats_.size() * sizeof(glm::mat4);
-    if (bytes == 0) return;
-    if (bytes > instanceVBOCapacity_) instanceVBOCapacity_ = bytes;
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
-    // orphan at the high-water capacity (no GPU sync), then fill
-    glBufferData(GL_ARRAY_BUFFER, instanceVBOCapacity_, nullptr, GL_STREAM_DRAW);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instanceMats_.data());
+void Scene::uploadInstanceMats_(const glm::mat4* mats, std::size_t count) {
+    if (count == 0) return;
+    instanceSpan_ = instanceStream_.Write(mats, count * sizeof(glm::mat4), sizeof(glm::vec4));
 }
 
 void Scene::bindInstanceAttribs_(std::size_t byteOffset) const {
     // current mesh VAO must already be bound
-    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceSpan_.buffer);
+    byteOffset += instanceSpan_.offset;
     const GLsizei stride = sizeof(glm::mat4);
     const std::size_t vec4sz = sizeof(glm::vec4);
 
@@ -885,6 +1442,20 @@ void Scene::bindInstanceAttribs_(std::size_t byteOffset) const {
     }
 }
 
+void Scene::uploadInstanceLayers_(const float* layers, std::size_t count) {
+    if (count == 0) return;
+    layerSpan_ = instanceStream_.Write(layers, count * sizeof(float), sizeof(float));
+}
+
+void Scene::bindInstanceLayers_(std::size_t first) const {
+    // current mesh VAO must already be bound
+    glBindBuffer(GL_ARRAY_BUFFER, layerSpan_.buffer);
+    glEnableVertexAttribArray(12);
+    glVertexAttribPointer(12, 1, GL_FLOAT, GL_FALSE, sizeof(float),
+        reinterpret_cast<void*>(layerSpan_.offset + first * sizeof(float)));
+    glVertexAttribDivisor(12, 1);
+}
+
 // Depth-only traversal for directional shadow map
 void Scene::RenderShadowDepth(Shader & shadowShader, const glm::mat4 & lightVP)
 {
@@ -893,73 +1464,162 @@ void Scene::RenderShadowDepth(Shader & shadowShader, const glm::mat4 & lightVP)
     shadowShader.use();
     shadowShader.setMat4("uLightVP", lightVP);
     
-    auto view = registry.view<ModelComponent, Transform, AABB>();
-    for (auto entity : view) {
-        auto& mc = view.get<ModelComponent>(entity);
-        auto& t = view.get<Transform>(entity);
+    // only what the light frustum can reach (BoundsCache skips the rest)
+    bounds_.Sync();
+    shadowCandidates_.clear();
+    bounds_.Query(BoundsCache::PlanesFromClip(lightVP), shadowCandidates_, shadowQueryScratch_);
+    unsigned boundVao = 0;
+    for (auto entity : shadowCandidates_) {
+        const auto& mc = registry.get<ModelComponent>(entity);
+        const auto& t = registry.get<Transform>(entity);
         if (!mc.model) continue;
-        if (registry.any_of<NoShadow>(entity)) continue;
+        if (!(registry.get<RenderProxy>(entity).flags & RenderProxy::kCastsShadow)) continue;
             for (const auto& mesh : mc.model->Meshes()) {
                 shadowShader.setMat4("model", t.modelMatrix);
                 // No material/texture binds; just draw geometry
+                if (mesh.VAO() != boundVao) {
+                    boundVao = mesh.VAO();
+                    glBindVertexArray(boundVao);
+                }
                 mesh.IssueDraw();
             }
     }
+    glBindVertexArray(0);
 }
 
-void Scene::RenderShadowsCombined(Shader& shadowShader, const std::vector<CascadeParam>& cascades, std::function<void(int)> preDrawCallback)
+bool Scene::staticCurrent_(int cacheSlot, const ViewKey& view) const
 {
-    size_t numCascades = cascades.size();
-    if (numCascades > 4) numCascades = 4;
-    
-    // 1. Clear buckets
-    for (size_t i = 0; i < numCascades; ++i) {
-        shadowCascadeItems_[i].clear();
-        // pre-allocate reasonable size if empty
-        if (shadowCascadeItems_[i].capacity() < 512) shadowCascadeItems_[i].reserve(1024);
-    }
-
-    // 2. Iterate entities once
-    auto view = registry.view<ModelComponent, Transform, AABB>();
-    for (auto e : view) {
-        const auto& mc = view.get<ModelComponent>(e);
-        if (!mc.model) continue;
-        if (registry.any_of<NoShadow>(e)) continue;
+    const StaticCasters& sc = staticCasters_[cacheSlot];
+    return sc.valid && sc.view == view && sc.settledEpoch == bounds_.SettledEpoch() &&
+           sc.flagsEpoch == casterFlagsEpoch_;
+}
 
-        const auto& t = view.get<Transform>(e);
-        const auto& b = view.get<AABB>(e);
+void Scene::cacheSlots_(const std::vector<CascadeParam>& cascades, std::size_t count, int out[4])
+{
+    bool distinct = true;
+    for (std::size_t c = 0; c < count && distinct; ++c) {
+        const int idx = cascades[c].cascadeIndex;
+        distinct = idx >= 0 && idx < 4;
+        for (std::size_t o = 0; o < c && distinct; ++o) distinct = cascades[o].cascadeIndex != idx;
+    }
+    for (std::size_t c = 0; c < count; ++c) out[c] = distinct ? cascades[c].cascadeIndex : int(c);
+}
 
-        // Test against each cascade.
-        // NOTE: casters are culled against the LIGHT frustum only. Culling by
-        // the camera's Z-slice is wrong for casters — an object outside the
-        // slice (behind the camera, off to the side) can still cast a shadow
-        // INTO the slice, and dropping it makes shadows pop as the camera
-        // moves. Receiver-side slice selection happens in the shader.
-        for (size_t c = 0; c < numCascades; ++c) {
-            const auto& p = cascades[c];
+// One cascade's caster bucket: the cached settled casters (rebuilt only when
+// stale) and this frame's dynamic ones, each sorted by mesh for instancing.
+// Like buildCameraList_, may run on a JobSystem worker: const registry reads,
+// and only slot `slot`'s bucket, matrices, candidates and sorter, and cache
+// entry `cacheSlot`, are written.
+void Scene::buildCascadeList_(std::size_t slot, const CascadeParam& p, int cacheSlot)
+{
+    CSE_PROFILE_ZONE("Scene::BuildCascadeList");
+    const entt::registry& reg = registry;
+    auto& bucket = shadowCascadeItems_[slot];
+    auto& bucketMats = shadowCascadeMats_[slot];
+    frameMem_.Refresh(bucket, bucket.size()); // sized from its last build
+    frameMem_.Refresh(bucketMats, bucketMats.size());
+    auto& candidates = cascadeCandidates_[slot];
+    auto& queryScratch = cascadeQueryScratch_[slot];
+    DrawSorter& sorter = shadowSorters_[slot];
+
+    // Fill the bucket from the entities the light frustum reaches.
+    // NOTE: casters are culled against the LIGHT frustum only. Culling by
+    // the camera's Z-slice is wrong for casters — an object outside the
+    // slice (behind the camera, off to the side) can still cast a shadow
+    // INTO the slice, and dropping it makes shadows pop as the camera
+    // moves. Receiver-side slice selection happens in the shader.
+    //
+    // The BoundsCache query is conservative (world AABB vs the clip
+    // planes, settled entities through the octree); the exact corner test
+    // below then decides, so the bucket holds the same casters as a full
+    // registry walk would.
+    auto gather = [&](BoundsCache::Members which) {
+        candidates.clear();
+        bounds_.Query(BoundsCache::PlanesFromClip(p.lightVP), candidates, queryScratch, which);
+        for (auto e : candidates) {
+            const auto& mc = reg.get<ModelComponent>(e);
+            if (!mc.model) continue;
+            if (!(reg.get<RenderProxy>(e).flags & RenderProxy::kCastsShadow)) continue;
+
+            const auto& t = reg.get<Transform>(e);
+            const auto& b = reg.get<AABB>(e);
 
             // Frustum cull (Light Space)
             if (!aabbIntersectsLightFrustum(p.lightVP, b, t.modelMatrix)) continue;
 
-            // 2c. Add to bucket
             for (const auto& m : mc.model->Meshes()) {
-                DrawItem di; 
-                di.mesh = &m; 
-                di.model = t.modelMatrix;
-                shadowCascadeItems_[c].push_back(di);
+                DrawItem di;
+                di.mesh = &m;
+                bucket.push_back(di);
+                bucketMats.push_back(t.modelMatrix);
             }
         }
+        // Sort by mesh for instancing (only the mesh field of the key is set)
+        sorter.Clear();
+        for (const DrawItem& di : bucket) {
+            DrawKeyFields f;
+            f.mesh = di.mesh;
+            sorter.Add(f);
+        }
+        sorter.Sort();
+    };
+
+    // The settled casters only when the cached ones no longer hold: built
+    // through the bucket, then stored in draw order.
+    const ViewKey view = cascadeKey_(p);
+    bucketCache_[slot] = cacheSlot;
+    bucketCacheHit_[slot] = staticCurrent_(cacheSlot, view);
+    if (!bucketCacheHit_[slot]) {
+        gather(BoundsCache::Members::Settled);
+        StaticCasters& sc = staticCasters_[cacheSlot];
+        sc.items.clear();
+        sc.mats.clear();
+        for (uint32_t i : sorter.Order()) {
+            sc.items.push_back(bucket[i]);
+            sc.mats.push_back(bucketMats[i]);
+        }
+        sc.view = view;
+        sc.settledEpoch = bounds_.SettledEpoch();
+        sc.flagsEpoch = casterFlagsEpoch_;
+        sc.valid = true;
+        bucket.clear();
+        bucketMats.clear();
+    }
+    gather(BoundsCache::Members::Dynamic);
+}
+
+void Scene::RenderShadowsCombined(Shader& shadowShader, const std::vector<CascadeParam>& cascades, std::function<void(int)> preDrawCallback)
+{
+    size_t numCascades = cascades.size();
+    if (numCascades > 4) numCascades = 4;
+
+    // 1. The bucket of every cascade BuildDrawLists did not already build
+    // for this exact light view (with its cached part still current).
+    int cache[4];
+    cacheSlots_(cascades, numCascades, cache);
+    bool synced = false;
+    for (size_t c = 0; c < numCascades; ++c) {
+        const ViewKey view = cascadeKey_(cascades[c]);
+        if (cascadePrebuilt_[c] && cascadePrebuiltKey_[c] == view &&
+            bucketCache_[c] == cache[c] && staticCurrent_(cache[c], view)) {
+            cascadePrebuilt_[c] = false; // drawn once
+            continue;
+        }
+        if (!synced) { bounds_.Sync(); synced = true; }
+        cascadePrebuilt_[c] = false;
+        buildCascadeList_(c, cascades[c], cache[c]);
     }
 
-    // 3. Draw each bucket
-    ensureInstanceBuffer_();
+    // 2. Draw each bucket
     shadowShader.use();
     shadowShader.setInt("uUseInstancing", 0);
 
     // Save/Restore state if needed? (We assume caller sets global render states)
 
     for (size_t c = 0; c < numCascades; ++c) {
-        auto& bucket = shadowCascadeItems_[c];
+        const auto& bucket = shadowCascadeItems_[c];
+        const auto& bucketMats = shadowCascadeMats_[c];
+        const StaticCasters& sc = staticCasters_[bucketCache_[c]];
 
         // Bind + CLEAR this cascade before testing the bucket. The callback is
         // the only thing that attaches depth_[c] to the FBO and clears it, so
@@ -970,7 +1630,7 @@ void Scene::RenderShadowsCombined(Shader& shadowShader, const std::vector<Cascad
         if (preDrawCallback) {
             preDrawCallback((int)c);
         }
-        if (bucket.empty()) continue; // cleared above; nothing to draw into it
+        if (bucket.empty() && sc.items.empty()) continue; // cleared above; nothing to draw into it
 
         // Shadow maps tolerate coarse geometry: near cascades use LOD 1,
         // far cascades LOD 2 (the cascade index is already a distance proxy).
@@ -986,33 +1646,49 @@ void Scene::RenderShadowsCombined(Shader& shadowShader, const std::vector<Cascad
         // Set cascade-specific uniform
         shadowShader.setMat4("uLightVP", cascades[c].lightVP);
 
-        // Sort by mesh for instancing
-        std::sort(bucket.begin(), bucket.end(),
-            [](const DrawItem& a, const DrawItem& b) { return a.mesh < b.mesh; });
+        // The static list and the dynamic bucket are each in ascending mesh
+        // order (the sorter's mesh ranks keep pointer order), so one merge
+        // walk yields every mesh's run across both: static items [s0, s1)
+        // and dynamic entries [d0, d1) of the order, one mesh each.
+        const std::vector<uint32_t>& order = shadowSorters_[c].Order();
+        const size_t statics = sc.items.size();
+        struct Run { const Mesh* mesh; size_t s0, s1, d0, d1; };
+        auto nextRun = [&](size_t& si, size_t& di) {
+            const Mesh* ms = si < statics ? sc.items[si].mesh : nullptr;
+            const Mesh* md = di < bucket.size() ? bucket[order[di]].mesh : nullptr;
+            Run r{ (!ms || (md && reinterpret_cast<uintptr_t>(md) < reinterpret_cast<uintptr_t>(ms))) ? md : ms,
+                   si, si, di, di };
+            while (r.s1 < statics && sc.items[r.s1].mesh == r.mesh) ++r.s1;
+            while (r.d1 < bucket.size() && bucket[order[r.d1]].mesh == r.mesh) ++r.d1;
+            si = r.s1;
+            di = r.d1;
+            return r;
+        };
+        const size_t total = statics + bucket.size();
 
         // Gather every instanced matrix in this bucket and upload once
         // (per-run map/unmap cycles were a driver sync each).
-        instanceMats_.clear();
-        for (size_t i = 0; i < bucket.size();) {
-            const Mesh* mesh = bucket[i].mesh;
-            size_t j = i + 1;
-            while (j < bucket.size() && bucket[j].mesh == mesh) ++j;
-            if (j - i >= 2) {
-                for (size_t k = i; k < j; ++k) instanceMats_.push_back(bucket[k].model);
-            }
-            i = j;
+        frameMem_.Refresh(instanceMats_, total);
+        for (size_t si = 0, di = 0; si + di < total;) {
+            const Run r = nextRun(si, di);
+            if ((r.s1 - r.s0) + (r.d1 - r.d0) < 2) continue;
+            for (size_t k = r.s0; k < r.s1; ++k) instanceMats_.push_back(sc.mats[k]);
+            for (size_t k = r.d0; k < r.d1; ++k) instanceMats_.push_back(bucketMats[order[k]]);
         }
-        uploadInstanceMats_();
+        uploadInstanceMats_(instanceMats_.data(), instanceMats_.size());
 
         // Instanced draw loop
         size_t matOffset = 0;
-        for (size_t i = 0; i < bucket.size();) {
-            const Mesh* mesh = bucket[i].mesh;
-            size_t j = i + 1;
-            while (j < bucket.size() && bucket[j].mesh == mesh) ++j;
-            const size_t run = j - i;
-
-            glBindVertexArray(mesh->VAO());
+        unsigned boundVao = 0;
+        for (size_t si = 0, di = 0; si + di < total;) {
+            const Run r = nextRun(si, di);
+            const Mesh* mesh = r.mesh;
+            const size_t run = (r.s1 - r.s0) + (r.d1 - r.d0);
+
+            if (mesh->VAO() != boundVao) {
+                boundVao = mesh->VAO();
+                glBindVertexArray(boundVao);
+            }
 
             if (run >= 2) {
                 bindInstanceAttribs_(matOffset * sizeof(glm::mat4));
@@ -1022,58 +1698,80 @@ void Scene::RenderShadowsCombined(Shader& shadowShader, const std::vector<Cascad
                 shadowShader.setInt("uUseInstancing", 0);
             }
             else {
-                shadowShader.setMat4("model", bucket[i].model);
+                shadowShader.setMat4("model", r.s1 > r.s0 ? sc.mats[r.s0] : bucketMats[order[r.d0]]);
                 mesh->IssueDraw(shadowLod);
             }
-            i = j;
         }
     }
     glBindVertexArray(0);
 }
 
-void Scene::RenderDepth(Shader& prog, const glm::mat4& lightVP)
+Scene::ShadowBucketSnapshot Scene::shadowBucketForTest_(int cascade) const
 {
-    items_.clear();
-    items_.reserve(1024);
+    ShadowBucketSnapshot snap;
+    const StaticCasters& sc = staticCasters_[bucketCache_[cascade]];
+    snap.items = sc.items;
+    snap.staticCount = sc.items.size();
+    snap.staticReused = bucketCacheHit_[cascade];
+    for (uint32_t i : shadowSorters_[cascade].Order()) snap.items.push_back(shadowCascadeItems_[cascade][i]);
+    return snap;
+}
 
-    // use AABB view and cull per-cascade
-    auto view = registry.view<ModelComponent, Transform, AABB>();
-    for (auto e : view) {
-        const auto& mc = view.get<ModelComponent>(e);
-        const auto& t = view.get<Transform>(e);
-        const auto& b = view.get<AABB>(e);
+void Scene::RenderDepth(Shader& prog, const glm::mat4& lightVP)
+{
+    frameMem_.Refresh(items_, items_.size());
+    frameMem_.Refresh(itemMats_, itemMats_.size());
+
+    // light-frustum candidates from the bounds cache, then the exact test
+    bounds_.Sync();
+    shadowCandidates_.clear();
+    bounds_.Query(BoundsCache::PlanesFromClip(lightVP), shadowCandidates_, shadowQueryScratch_);
+    for (auto e : shadowCandidates_) {
+        const auto& mc = registry.get<ModelComponent>(e);
+        const auto& t = registry.get<Transform>(e);
+        const auto& b = registry.get<AABB>(e);
         if (!mc.model) continue;
-        if (registry.any_of<NoShadow>(e)) continue;
+        if (!(registry.get<RenderProxy>(e).flags & RenderProxy::kCastsShadow)) continue;
         if (!aabbIntersectsLightFrustum(lightVP, b, t.modelMatrix)) continue;
 
         for (const auto& m : mc.model->Meshes()) {
-            DrawItem di; di.mesh = &m; di.model = t.modelMatrix;
+            DrawItem di; di.mesh = &m;
             items_.push_back(di);
+            itemMats_.push_back(t.modelMatrix);
         }
     }
     // sort by mesh so we can instance consecutive items
-    std::sort(items_.begin(), items_.end(),
-        [](const DrawItem& a, const DrawItem& b) { return a.mesh < b.mesh; });
+    drawSorter_.Clear();
+    for (const DrawItem& di : items_) {
+        DrawKeyFields f;
+        f.mesh = di.mesh;
+        drawSorter_.Add(f);
+    }
+    drawSorter_.Sort();
+    const std::vector<uint32_t>& order = drawSorter_.Order();
 
-    ensureInstanceBuffer_();
     prog.setInt("uUseInstancing", 0);
 
+    unsigned boundVao = 0;
     for (size_t i = 0; i < items_.size();) {
-        const Mesh* mesh = items_[i].mesh;
+        const Mesh* mesh = items_[order[i]].mesh;
         size_t j = i + 1;
-        while (j < items_.size() && items_[j].mesh == mesh) ++j;
+        while (j < items_.size() && items_[order[j]].mesh == mesh) ++j;
         const size_t run = j - i;
 
-        glBindVertexArray(mesh->VAO());
+        if (mesh->VAO() != boundVao) {
+            boundVao = mesh->VAO();
+            glBindVertexArray(boundVao);
+        }
 
         if (run >= 2) {
-            glBindBuffer(GL_ARRAY_BUFFER, instanceVBO_);
-            glBufferData(GL_ARRAY_BUFFER, run * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
-            if (void* p = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY)) {
-                auto* mats = static_cast<glm::mat4*>(p);
-                for (size_t k = 0; k < run; ++k) mats[k] = items_[i + k].model;
-                glUnmapBuffer(GL_ARRAY_BUFFER);
+            // written straight into the ring: no copy, no sync
+            const StreamBuffer::Span span = instanceStream_.Map(run * sizeof(glm::mat4), sizeof(glm::vec4));
+            if (auto* mats = static_cast<glm::mat4*>(span.data)) {
+                for (size_t k = 0; k < run; ++k) mats[k] = itemMats_[order[i + k]];
             }
+            instanceStream_.Unmap();
+            instanceSpan_ = span;
             bindInstanceAttribs_(0);
             prog.setInt("uUseInstancing", 1);
             prog.setMat4("uLightVP", lightVP);
@@ -1082,7 +1780,7 @@ void Scene::RenderDepth(Shader& prog, const glm::mat4& lightVP)
         }
         else {
             prog.setMat4("uLightVP", lightVP);
-            prog.setMat4("model", items_[i].model);
+            prog.setMat4("model", itemMats_[order[i]]);
             mesh->IssueDraw();
         }
 
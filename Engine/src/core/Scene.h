@@ -4,22 +4,34 @@
 #include <entt/entt.hpp>
 #include <vector>
 #include <algorithm>
+#include <cfloat>
 #include <cstdint>
 
 #include "Entity.h"
 #include "Components.h"
 #include "Shader.h"
 #include "Model.h"
+#include "FrameAllocator.h"
+#include "TransformHierarchy.h"
+#include "BoundsCache.h"
+#include "DrawSort.h"
+#include "LightClusters.h"
+#include "GLInit.h"
+#include "TextureArrays.h"
+#include "StreamBuffer.h"
+#include "UniformBlocks.h"
 #include "Scene.h"
 
 //forward declaration of glad unit
 typedef unsigned int GLuint;
 
-// Batched draw item
+// Batched draw item. The model matrix is NOT in here: each list keeps its
+// matrices in a parallel array (same index), so sorting moves 4-byte
+// indices and the matrices are only read when a draw or the instance
+// buffer needs them.
 struct DrawItem {
     uint64_t texKey = 0;
     const Mesh* mesh = nullptr;
-    glm::mat4 model{ 1.0f };
     float     depth = 0.0f;
     int       lod = 0;                 // mesh LOD level chosen for this item
     entt::entity entity = entt::null;  // producer entity (for material overrides)
@@ -29,19 +41,41 @@ struct DrawItem {
     // items_ at all (they go to a separately sorted transparent list).
     int       alphaMode = 0;
     bool      doubleSided = false;
+    // The entity's RenderProxy::kHasOverrides, so the material bind skips
+    // the MaterialOverrides lookup for the (usual) entity without any.
+    bool      hasOverrides = false;
     // 0 PBR, 1 Toon. MUST be part of the batch key: a run is drawn with ONE
-    // material bind (items_[first]), so instances with different shading models
+    // material bind (its first item), so instances with different shading models
     // that share textures would otherwise merge into one run and all render as
     // whichever item happened to be first after culling -- a whole batch of
     // objects flipping PBR<->Toon as the camera moved.
     int       shadingModel = 0;
+    // The albedo map's layer when it lives in a texture array (the batch key
+    // then names the array, not the map): per instance in an instanced run.
+    int       albedoLayer = 0;
 };
 
 // Tag component: add to an entity to skip it from shadow maps.
 struct NoShadow {};
 
+// What the draw-list loops need to know about an entity beyond its mesh
+// and matrix, as bits. Scene adds one alongside every ModelComponent and
+// keeps it current from the NoShadow / MaterialOverrides signals, so the
+// loops test a bit of a component they already touch instead of probing
+// two more pools per entity (and the overrides pool per mesh). Engine-owned:
+// never add, edit or serialize it.
+struct RenderProxy {
+    enum : uint8_t {
+        kCastsShadow  = 1 << 0, // no NoShadow
+        kHasOverrides = 1 << 1, // has MaterialOverrides
+    };
+    uint8_t flags = kCastsShadow;
+};
+
 namespace MyCoreEngine {
 
+    class JobSystem;
+
     // Environment lighting for a scene. PURE DATA — the renderer bakes GL
     // resources from it; nothing here is a texture id, so it serializes and
     // survives undo/restore like any other scene setting.
@@ -109,6 +143,8 @@ namespace MyCoreEngine {
         unsigned draws = 0;           // non-instanced draw calls
         unsigned instancedDraws = 0;  // instanced draw calls
         unsigned instances = 0;       // total instances drawn via instancing
+        unsigned multiDraws = 0;      // glMultiDrawElementsIndirect calls
+        unsigned drawsSaved = 0;      // runs folded into them, less the calls
         unsigned vaoBinds = 0;
         unsigned textureBinds = 0;    // when a new texture bucket is bound
         unsigned culled = 0;          // entities rejected by frustum
@@ -119,6 +155,11 @@ namespace MyCoreEngine {
         unsigned lodInstances[3] = { 0, 0, 0 }; // submitted instances per LOD level
         unsigned lightsActive = 0;    // punctual lights uploaded this frame
         unsigned lightsCulled = 0;    // in the scene but out of range / disabled
+        unsigned lightClusterRefs = 0;    // light-froxel pairs binned (clustered lights)
+        unsigned lightClusterDropped = 0; // pairs that did not fit the index block
+        unsigned frameArenaKB = 0;    // per-frame draw lists, the last rewound frame (all threads)
+        unsigned frameArenaPeakKB = 0; // high-water mark of frameArenaKB
+        bool     replayed = false;    // camera draws replayed from the recording (no cull/sort)
     };
 
     // One punctual light resolved to world space and ready to upload. Kept
@@ -174,7 +215,8 @@ namespace MyCoreEngine {
     public:
         entt::registry registry;
 
-        virtual ~Scene(); // frees instanceVBO_
+        Scene();          // listens to the components the draw lists read
+        virtual ~Scene(); // frees the cluster buffers (the instance ring frees itself)
 
         // Create a new entity and return the wrapper.
         Entity createEntity();
@@ -186,30 +228,90 @@ namespace MyCoreEngine {
         // shadow rebuild (wholesale caster removal bypasses dirty tracking).
         void ResetToDefaults();
 
-        void UpdateTransforms();
+        // Resolves world matrices parent-first; see TransformHierarchy for how
+        // the walk order is kept without re-deriving it every call. With a
+        // JobSystem, large hierarchies are propagated on its workers too (the
+        // caller joins in and blocks until done); the result, dirty-caster
+        // list included, is identical to the serial pass.
+        void UpdateTransforms(JobSystem* jobs = nullptr);
+        TransformHierarchy::Stats HierarchyStats() const { return hierarchy_.stats(); }
+        // World bounds of every Transform+AABB+ModelComponent entity, as the
+        // last UpdateTransforms/RenderScene left them (see BoundsCache).
+        const BoundsCache& Bounds() const { return bounds_; }
+        // Nearest renderable whose world AABB the ray enters (dir need not be
+        // unit length), or entt::null. Goes through the bounds cache's
+        // octree, so it does not walk the registry. For editor picking and
+        // gameplay queries; bounds only, no mesh triangles. Main thread
+        // only: the candidates go through a scratch list the scene keeps.
+        entt::entity RaycastBounds(const glm::vec3& origin, const glm::vec3& dir,
+                                   float maxT = FLT_MAX, float* tOut = nullptr);
+        // Bumped by every change that can alter what RenderScene draws for a
+        // fixed camera: an entity gaining, replacing or losing a Transform,
+        // AABB, ModelComponent or MaterialOverrides, UpdateTransforms moving
+        // anything, a list-building setting (instancing, LOD, size cull), and
+        // MarkChanged(). While it and the camera stay put, RenderScene replays
+        // its recorded draws instead of culling and sorting again.
+        uint64_t Epoch() const { return epoch_; }
+        // For edits the registry signals cannot see: a Material changed in
+        // place (the inspector's material fields), a texture swapped under a
+        // live model.
+        void MarkChanged() { ++epoch_; }
+        // Frame boundary for the per-frame draw lists (items, instance
+        // matrices, shadow buckets): they live in a double-buffered frame
+        // arena, so a list built this frame stays valid through the next one
+        // and the memory follows the recent peak instead of the all-time one.
+        // Renderer::RenderFrame calls it; a caller driving RenderScene by hand
+        // may skip it (the lists are then simply reused in place). Also
+        // drops albedo texture arrays left from another GL context before
+        // any builder looks a layer up.
+        void BeginFrame() {
+            frameMem_.BeginFrame();
+            dropPrebuilt_();
+            lightsView_.valid = false;
+            instanceStream_.NextFrame();
+            TextureArrays::Get().EnsureContext();
+        }
+        const FrameAllocator& FrameMemory() const { return frameMem_; }
         // Renderer calls this; builds a draw list with frustum culling +
         // optional projected-size culling, sorts, then batches by texture key.
         // viewportHeightPx (pixels) drives the screen-size cull; 0 disables it
         // (e.g. callers with no framebuffer size handy).
+        //
+        // Every build is RECORDED: the runs in draw order, their matrices,
+        // the instance matrices and the material each bind uses. A call for
+        // the same view with Epoch() unchanged replays the recording — one
+        // instance upload, the global uniforms and the draws, nothing else
+        // (a static menu camera, an idle editor viewport, a locked fighting-
+        // game stage). GetRenderStats().replayed says which it was. The last
+        // few views each keep their own recording, so cameras that take turns
+        // (an editor's scene and game viewports) replay too.
         virtual void RenderScene(const Frustum& camFrustum, Shader& shader, Camera& camera,
                                  int viewportHeightPx = 0);
 
-        // Draws the Blend-mode geometry collected by the most recent
-        // RenderScene, back-to-front and alpha-composited. MUST run after the
+        // Draws the Blend-mode geometry of the view the most recent
+        // RenderScene drew, back-to-front and alpha-composited. MUST run after the
         // skybox and with the SAME forward shader, so transparents blend over
         // the opaque scene and the sky. Global lighting uniforms are re-uploaded
         // here (RenderScene set them, but this keeps the pass self-contained).
         // No-op when the last frame collected no transparent geometry.
         void RenderTransparent(Shader& shader, Camera& camera);
-        bool HasTransparent() const { return !transparentItems_.empty(); }
+        bool HasTransparent() const { return drawn_ && !drawn_->transparentItems.empty(); }
 
         // Depth-only shadow pass (directional)
         void RenderShadowDepth(Shader & shadowShader, const glm::mat4 & lightVP);
 
         // Toggle instancing at runtime
-        void SetInstancingEnabled(bool enabled) { instancingEnabled_ = enabled; }
+        void SetInstancingEnabled(bool enabled) { setListSetting_(instancingEnabled_, enabled); }
         bool GetInstancingEnabled() const { return instancingEnabled_; }
 
+        // Multi-draw indirect: consecutive runs that share a material bind
+        // and the arena VAO go out as one glMultiDrawElementsIndirect, each
+        // run a command whose baseInstance picks its matrices from the
+        // instance buffer. Needs instancing on and GetGLCaps().multiDrawIndirect;
+        // otherwise (plain 3.3) the runs draw one call each, as before.
+        void SetMultiDrawEnabled(bool enabled) { setListSetting_(multiDrawEnabled_, enabled); }
+        bool GetMultiDrawEnabled() const { return multiDrawEnabled_; }
+
         // Punctual lights are a BOUNDED set: the shader carries a fixed array,
         // so when a scene has more lights than this the strongest ones win
         // rather than an arbitrary prefix. Must match MAX_PUNCTUAL_LIGHTS in
@@ -231,11 +333,26 @@ namespace MyCoreEngine {
                                          size_t maxLights = kMaxPunctualLights,
                                          unsigned* culledOut = nullptr);
 
+        // Clustered lights: instead of the 16-light array every fragment
+        // loops over, select up to LightClusters::kMaxLights, bin them into
+        // view-space froxels each frame, and let each fragment shade only
+        // its froxel's list (two more uniform blocks, see LightClusters.h).
+        // On by default; off falls back to the bounded array.
+        void  SetClusteredLightsEnabled(bool v) { clusteredLightsEnabled_ = v; }
+        bool  GetClusteredLightsEnabled() const { return clusteredLightsEnabled_; }
+        // Uniform-block binding points of the forward shader's blocks. The
+        // light records serve both the array and the clusters.
+        static constexpr unsigned kPunctualLightsBinding = 1;
+        static constexpr unsigned kClusterGridBinding = 2;
+        static constexpr unsigned kClusterIndicesBinding = 3;
+        static constexpr unsigned kFrameGlobalsBinding = FrameGlobalsBlock::kBinding;
+        static constexpr unsigned kMaterialBinding = MaterialBlockData::kBinding;
+
         // Mesh LOD: level picked per entity from camera distance vs object size
-        void  SetLODEnabled(bool v) { lodEnabled_ = v; }
+        void  SetLODEnabled(bool v) { setListSetting_(lodEnabled_, v); }
         bool  GetLODEnabled() const { return lodEnabled_; }
         // >1 keeps high detail farther out; <1 switches down sooner (cheaper)
-        void  SetLODDistanceScale(float s) { lodDistanceScale_ = std::clamp(s, 0.1f, 8.f); }
+        void  SetLODDistanceScale(float s) { setListSetting_(lodDistanceScale_, std::clamp(s, 0.1f, 8.f)); }
         float GetLODDistanceScale() const { return lodDistanceScale_; }
 
         // Projected-size cull: drop objects whose bounding sphere projects
@@ -243,10 +360,10 @@ namespace MyCoreEngine {
         // camera distance/altitude — the lever that actually helps a
         // vertex/instance-bound wide view (shadows/PCF/fill measured free).
         // Needs the viewport pixel height passed to RenderScene.
-        void  SetSmallCullEnabled(bool v) { smallCullEnabled_ = v; }
+        void  SetSmallCullEnabled(bool v) { setListSetting_(smallCullEnabled_, v); }
         bool  GetSmallCullEnabled() const { return smallCullEnabled_; }
         // pixel-height floor; higher culls more (and pops sooner). 0 disables.
-        void  SetSmallCullPixels(float px) { smallCullPixels_ = std::clamp(px, 0.f, 64.f); }
+        void  SetSmallCullPixels(float px) { setListSetting_(smallCullPixels_, std::clamp(px, 0.f, 64.f)); }
         float GetSmallCullPixels() const { return smallCullPixels_; }
 
         // Depth prepass: lay depth down first (cheap shader), then shade color
@@ -266,9 +383,18 @@ namespace MyCoreEngine {
         bool HasDynamicCasterInViewRange(const glm::vec3& camPos, const glm::vec3& camFwd,
                                          float zNear, float zFar,
                                          const glm::vec3& sunDir) const;
+        // The caster spheres behind it: departure + arrival per caster the
+        // last UpdateTransforms moved, in hierarchy order (xyz centre, w
+        // radius). Debug/test aid.
+        std::size_t DirtyCasterCount() const { return dirtyCasters_.size(); }
+        glm::vec4 DirtyCasterSphere(std::size_t i) const {
+            return glm::vec4(dirtyCasters_[i].center, dirtyCasters_[i].radius);
+        }
         
         // Read-only stats for the last frame
         const RenderStats &GetRenderStats() const { return lastStats_; }
+        // The instance ring: its size, fence waits and growth so far
+        StreamBuffer::Stats GetInstanceStreamStats() const { return instanceStream_.GetStats(); }
 
         // Environment lighting. Scene-level (like the sun) rather than a
         // component: there is exactly one environment, and it is what the
@@ -343,6 +469,10 @@ namespace MyCoreEngine {
                 float lift        = 0.0f; // black-point offset, -0.5..0.5
                 float gain        = 1.0f; // white-point scale, 0.5..2
             } colorGrade;
+
+            // Run outline, grade and vignette as one pass when two or more
+            // are on (PostUberPass): the same image, less fill and bandwidth.
+            bool fused = true;
         };
         PostFXSettings&       PostFX()       { return postFX_; }
         const PostFXSettings& PostFX() const { return postFX_; }
@@ -365,6 +495,12 @@ namespace MyCoreEngine {
         bool  GetIBLAvailable() const { return iblAvailable_; }
         float GetIBLIntensity() const { return iblIntensity_; }
         void  SetIBLIntensity(float v) { iblIntensity_ = std::max(0.0f, v); }
+
+        // The forward shader's FrameGlobals block. The forward passes fill
+        // the cascade fields and the IBL mip count before RenderScene and
+        // RenderTransparent; those fill the rest (camera, sun, switches) and
+        // upload it, skipping the upload when nothing changed.
+        FrameGlobalsBlock& FrameGlobals() { return frameGlobals_; }
         // add a forward-only method (public)
         virtual void RenderDepth(class Shader& depthProg, const glm::mat4& lightVP);
         virtual void RenderDepthCascade(Shader& prog, const glm::mat4& lightVP, float splitNear, float splitFar, const glm::mat4& camView);
@@ -389,6 +525,16 @@ namespace MyCoreEngine {
             int cascadeIndex = 0;
         };
         // Culls and buckets entities for all cascades in one go.
+        //
+        // Each bucket is two parts. The SETTLED casters (see BoundsCache) are
+        // culled, sorted by mesh and kept per cascade across frames; a
+        // re-render of the same light view reuses them as long as nothing
+        // settled changed (a static caster's transform, model or NoShadow).
+        // A new lightVP — sun direction, splits, or the cascade refitting
+        // around a moved camera — rebuilds them. The DYNAMIC casters are
+        // culled again every time. Both are sorted by mesh, so the draw merges
+        // them into one instanced run per mesh.
+        //
         // preDrawCallback(index) is invoked for EVERY cascade before its bucket
         // is drawn -- including cascades whose bucket is empty, because the
         // callback is what binds and CLEARS the cascade's depth target. Skipping
@@ -397,13 +543,41 @@ namespace MyCoreEngine {
         // therefore not treat "callback fired" as "geometry was drawn".
         virtual void RenderShadowsCombined(Shader& shadowShader, const std::vector<CascadeParam>& cascades, std::function<void(int)> preDrawCallback = nullptr);
 
+        // What the camera's list is built from; RenderScene derives the same
+        // thing from its own arguments.
+        struct CameraView {
+            Frustum   frustum;
+            glm::vec3 position{ 0.f };
+            glm::vec3 front{ 0.f, 0.f, -1.f };
+            float     zoomDeg = 45.f;        // vertical FOV, as Camera::Zoom
+            int       viewportHeightPx = 0;  // 0 disables the size cull
+        };
+        // Builds this frame's draw lists for every view up front: the
+        // camera's opaque and transparent lists (null camera = none) and the
+        // caster bucket of each entry in `cascades`, one JobSystem task per
+        // view with the caller taking one too (serially without a
+        // JobSystem). The tasks only read the registry and the bounds cache
+        // and each writes its own lists, so the result is the serial build's.
+        // The next RenderScene / RenderShadowsCombined for the SAME view
+        // submits the prebuilt list; a call for any other view builds its own
+        // as before. Main thread, after BeginFrame.
+        void BuildDrawLists(const CameraView* camera, const std::vector<CascadeParam>& cascades,
+                            JobSystem* jobs = nullptr);
+
      protected:
-        // Test seam: the per-cascade caster buckets built by the last
-        // RenderShadowsCombined call, so culling can be asserted directly
-        // instead of inferred from callback invocations.
-        const std::vector<DrawItem>& shadowBucketForTest_(int cascade) const {
-            return shadowCascadeItems_[cascade];
-        }
+        // Test seam: what the last RenderShadowsCombined call drew into
+        // bucket `cascade` (its position in the call), so culling can be
+        // asserted directly instead of inferred from callback invocations.
+        // Static casters first, then dynamic ones, each in mesh order.
+        struct ShadowBucketSnapshot {
+            std::vector<DrawItem> items;
+            std::size_t staticCount = 0;   // items[0, staticCount) were settled
+            bool staticReused = false;     // ...and came from the cache
+        };
+        ShadowBucketSnapshot shadowBucketForTest_(int cascade) const;
+        // Test seam: the camera's opaque list in draw order, as recorded for
+        // the view the last BuildDrawLists or RenderScene asked for.
+        const std::vector<DrawItem>& cameraDrawsForTest_() const { return latestRecording_().items; }
         // Test seam: the instanced batch key. Two materials that upload any
         // different value MUST hash differently, or their draws merge into one
         // run that binds only the first item's material.
@@ -412,37 +586,147 @@ namespace MyCoreEngine {
         }
 
      private:
-         std::vector<DrawItem> items_;
+         // Per-frame lists below are FrameVectors on frameMem_, re-seated each
+         // frame with FrameAllocator::Refresh. Declared first so it outlives
+         // every list that points into it.
+         FrameAllocator frameMem_;
+         FrameVector<DrawItem> items_;
+         FrameVector<glm::mat4> itemMats_;        // items_[i]'s model matrix
          // Blend-mode items, built by RenderScene and consumed by
          // RenderTransparent later in the same frame (after the skybox, so they
          // composite over it). Kept OUT of items_ because they sort back-to-
          // front, do not write depth, and cannot batch like opaque geometry.
-         std::vector<DrawItem> transparentItems_;
-         // Reusable storage for shadow items per cascade (up to 4)
-         std::vector<DrawItem> shadowCascadeItems_[4];
+         FrameVector<DrawItem> transparentItems_;
+         FrameVector<glm::mat4> transparentMats_;
+         // Dynamic shadow casters per bucket (up to 4); the settled ones are
+         // in staticCasters_
+         FrameVector<DrawItem> shadowCascadeItems_[4];
+         FrameVector<glm::mat4> shadowCascadeMats_[4];
+         // Order each list above by packed 64-bit key (radix sort); the lists
+         // themselves stay in build order. One sorter per list, so the views
+         // of a BuildDrawLists can sort at the same time.
+         DrawSorter drawSorter_;             // items_ (and RenderDepth's list)
+         DrawSorter transparentSorter_;      // transparentItems_, back to front
+         DrawSorter shadowSorters_[4];       // shadowCascadeItems_[c], by mesh
+
+         // Identifies the view a list was built for: a render call for a
+         // different view must not draw it.
+         struct ViewKey {
+             CullPlanes planes{};
+             glm::vec3  position{ 0.f };
+             glm::vec3  front{ 0.f };
+             float      zoomDeg = 0.f;
+             int        viewportHeightPx = 0;
+             int        cascadeIndex = -1;   // -1 = the camera
+             bool operator==(const ViewKey& o) const;
+         };
+         static ViewKey cameraKey_(const CameraView& v);
+         static ViewKey cascadeKey_(const CascadeParam& p);
+         // Cascades BuildDrawLists built and nothing has submitted yet. Each
+         // is consumed by the first matching render call.
+         // BeginFrame and UpdateTransforms drop them: a list is only good for
+         // the frame and the poses it was built from. (The camera needs no
+         // such flag: its build is recorded, see recordings_.)
+         bool cascadePrebuilt_[4] = { false, false, false, false };
+         ViewKey cascadePrebuiltKey_[4];
+         void dropPrebuilt_() {
+             for (bool& b : cascadePrebuilt_) b = false;
+         }
+         // see Epoch()
+         uint64_t epoch_ = 0;
+         void onDrawableEdited_(entt::registry&, entt::entity) { ++epoch_; }
+         template <typename T>
+         void setListSetting_(T& field, T v) {
+             if (field == v) return; // hosts re-apply settings every frame
+             field = v;
+             ++epoch_;
+         }
+         // The per-view builders. Pure CPU, safe to run at the same time as
+         // each other (one camera, distinct cascade slots) once bounds_ is
+         // synced: registry and bounds cache reads only, own lists and
+         // sorter each. The camera records into the slot it is handed.
+         struct DrawRecording;
+         void buildCameraList_(const CameraView& v, DrawRecording& rec);
+         void buildCascadeList_(std::size_t slot, const CascadeParam& p, int cacheSlot);
+
+         // A cascade's settled casters: light-frustum culled, NoShadow
+         // skipped, and stored in mesh order (so instanced runs fall out of a
+         // walk), for the view and settled set they were built from.
+         // Persistent, unlike the per-frame lists: they outlive the frame.
+         struct StaticCasters {
+             bool valid = false;
+             ViewKey view;
+             uint64_t settledEpoch = 0;
+             uint64_t flagsEpoch = 0;
+             std::vector<DrawItem> items;
+             std::vector<glm::mat4> mats;   // items[i]'s model matrix
+         };
+         StaticCasters staticCasters_[4];
+         bool staticCurrent_(int cacheSlot, const ViewKey& view) const;
+         // The cache entry each bucket of a call uses: its cascadeIndex, so a
+         // cascade finds its casters whichever bucket it arrives in, or the
+         // bucket position when the call's indices are not distinct in [0, 4).
+         static void cacheSlots_(const std::vector<CascadeParam>& cascades, std::size_t count, int out[4]);
+         int bucketCache_[4] = { 0, 1, 2, 3 };     // entry the bucket drew
+         bool bucketCacheHit_[4] = { false, false, false, false };
+         // Bumped when any entity gains or loses NoShadow
+         uint64_t casterFlagsEpoch_ = 0;
+         // RenderProxy upkeep (each also bumps the epochs that depend on it).
+         // A destroy signal fires while the component is still there, so
+         // every flag change names the value it becomes.
+         void onModelAdded_(entt::registry& reg, entt::entity e);
+         void onModelRemoved_(entt::registry& reg, entt::entity e);
+         void onNoShadowAdded_(entt::registry& reg, entt::entity e);
+         void onNoShadowRemoved_(entt::registry& reg, entt::entity e);
+         void onOverridesAdded_(entt::registry& reg, entt::entity e);
+         void onOverridesRemoved_(entt::registry& reg, entt::entity e);
          // private:
-         GLuint instanceVBO_ = 0;
-         std::size_t instanceVBOCapacity_ = 0; // high-water mark, never shrinks
-         void ensureInstanceBuffer_();
-         // Orphan at capacity + subdata: the store must NEVER shrink, because
-         // mesh VAOs keep instanced-attrib pointers baked at large offsets and
-         // a smaller store would make later fetches out-of-bounds (GL UB).
-         void uploadInstanceMats_();
-         // sets attribs 8..11 + divisors on the current VAO, reading from
-         // instanceVBO_ starting at byteOffset
+         // Instance matrices, the albedo layer of each instance parallel to
+         // them (only the camera passes bind those) and the multi-draw
+         // commands, streamed through one fenced ring: every upload lands in
+         // fresh space, so nothing waits on or orphans a buffer the GPU is
+         // still reading. BeginFrame moves it to the next segment.
+         StreamBuffer instanceStream_;
+         StreamBuffer::Span instanceSpan_; // the last matrices uploaded
+         StreamBuffer::Span layerSpan_;    // the last layers uploaded
+         void uploadInstanceMats_(const glm::mat4* mats, std::size_t count);
+         // sets attribs 8..11 + divisors on the current VAO, reading the last
+         // uploaded matrices from byteOffset into them
          void bindInstanceAttribs_(std::size_t byteOffset) const;
+         void uploadInstanceLayers_(const float* layers, std::size_t count);
+         // attrib 12 + divisor on the current VAO, from instance `first`
+         void bindInstanceLayers_(std::size_t first) const;
+         // albedo arrays sample at this unit (0-4 material, 5-7 IBL, 8-11 CSM)
+         static constexpr int kAlbedoArrayUnit = 12;
 
          // Choose material (override -> shared) for an item and bind it for drawing
          static bool aabbIntersectsLightFrustum(const glm::mat4& lightVP, const AABB& aabb, const glm::mat4& model);
          
-         const Material * chooseMaterial_(entt::entity e, const Mesh & mesh) const;
+         const Material * chooseMaterial_(entt::entity e, const Mesh & mesh, bool hasOverrides) const;
          void bindMaterialForItem_(const DrawItem & di, Shader & shader) const;
-         static uint64_t texKeyFromMaterial_(const Material & m);
+         static uint64_t texKeyFromMaterial_(const Material & m, unsigned albedoArray = 0);
          // Per-frame sun/punctual-light/IBL uniform upload shared by the
-         // opaque and transparent passes so both shade identically.
-         void uploadGlobalShadingUniforms_(Shader& shader, Camera& camera, RenderStats& stats);
+         // opaque and transparent passes so both shade identically. With
+         // `reuseLights` the punctual lights and clusters already bound are
+         // kept: no selection, no binning, no block upload.
+         void uploadGlobalShadingUniforms_(Shader& shader, Camera& camera, RenderStats& stats,
+                                           bool reuseLights = false);
+         FrameGlobalsBlock frameGlobals_;
+         UniformBuffer frameGlobalsUBO_;
+         // the scene's fallback scalars, for meshes without a material
+         Material fallbackMaterial_;
+
+         // Locations of the uniforms set on every draw, looked up once per
+         // program instead of by name each call.
+         struct DrawUniforms {
+             GLuint program = 0;
+             GLint model = -1, useInstancing = -1, albedoArray = -1, albedoLayer = -1;
+             const DrawUniforms& For(const Shader& shader);
+         };
+         mutable DrawUniforms colorUniforms_, prepassUniforms_;
 
          bool instancingEnabled_ = true;
+         bool multiDrawEnabled_ = true;
          bool lodEnabled_ = true;
          float lodDistanceScale_ = 1.0f;
          // Off by default: it changes what's visible (distant objects pop out),
@@ -457,28 +741,118 @@ namespace MyCoreEngine {
          bool depthPrepassEnabled_ = false;
          Shader* depthPrepassShader_ = nullptr; // non-owning (forward pass owns it)
 
-         // Per-frame scratch: instanced-run table + gathered instance matrices
-         // (single buffer upload per frame; per-run map/unmap cycles were the
-         // top frame cost at high instance counts)
+         // Instanced-run table + gathered instance matrices (single buffer
+         // upload per pass; per-run map/unmap cycles were the top frame cost
+         // at high instance counts)
          struct DrawRun {
              uint64_t texKey;
              const Mesh* mesh;
              int lod;
-             std::size_t first;     // index into items_
+             std::size_t first;     // position in DrawRecording::items
              std::size_t count;
-             std::size_t matOffset; // index into instanceMats_
+             std::size_t matOffset; // index into DrawRecording::instanceMats
              int alphaMode = 0;     // homogeneous within a run (0 Opaque, 1 Mask)
          };
-         std::vector<DrawRun> runs_;
-         std::vector<glm::mat4> instanceMats_;
+         // RenderScene's draws for one camera view, as submitted: the opaque
+         // items in draw order with their matrices, the runs over them, the
+         // gathered instance matrices, and the transparent list back to
+         // front. Written by every camera build (buildCameraList_, so possibly
+         // on a worker) and replayed as-is while the view and epoch_ match.
+         // Persistent, not frame memory: it outlives the frame it was built in.
+         struct DrawRecording {
+             bool valid = false;
+             ViewKey view;
+             uint64_t epoch = 0;
+             uint64_t lastUsed = 0;                  // recordingTick_ when last built or drawn
+             std::vector<DrawItem> items;
+             std::vector<glm::mat4> mats;            // items[i]'s model matrix
+             std::vector<DrawRun> runs;              // DrawRun::first indexes items
+             std::vector<glm::mat4> instanceMats;
+             std::vector<float> instanceLayers;      // albedo layer, per instanceMats entry
+             std::vector<DrawItem> transparentItems; // farthest first
+             std::vector<glm::mat4> transparentMats;
+             RenderStats buildStats;                 // the build's cull counters
+         };
+         // One recording per view for the last kRecordingSlots views asked
+         // for, least recently used evicted first: a single slot made two
+         // cameras that alternate every frame rebuild each other's draws.
+         // Slots are picked on the main thread (BuildDrawLists, RenderScene);
+         // a worker only fills the slot it was handed.
+         static constexpr std::size_t kRecordingSlots = 4;
+         DrawRecording recordings_[kRecordingSlots];
+         uint64_t recordingTick_ = 0;
+         const DrawRecording* drawn_ = nullptr; // what the last RenderScene drew
+         DrawRecording* currentRecording_(const ViewKey& view); // null: build it
+         DrawRecording& recordingSlot_(const ViewKey& view);
+         const DrawRecording& latestRecording_() const;
+         void record_(DrawRecording& rec, const ViewKey& view, const RenderStats& buildStats);
+         FrameVector<glm::mat4> instanceMats_;       // shadow passes' gather
+
+         // Multi-draw batches over drawn_->runs, rebuilt every RenderScene:
+         // the commands hold arena offsets, which MeshArena::Compact can move
+         // between frames, so they are never part of the recording.
+         struct DrawBatch {
+             std::size_t firstRun;
+             std::size_t runCount;
+             std::size_t firstCommand; // into indirectCmds_; unused for 1 run
+         };
+         std::vector<DrawBatch> batches_;
+         std::vector<DrawElementsIndirectCommand> indirectCmds_;
+         StreamBuffer::Span indirectSpan_; // indirectCmds_ in instanceStream_
+         void buildBatches_();
          // per-frame scratch for the selected punctual lights (reused so the
          // light upload does not allocate every frame)
          std::vector<PunctualLight> punctualScratch_;
 
+         // Punctual lights and their clusters: the binning, its scratch, and
+         // the three uniform buffers (lights, grid, indices) bound at
+         // kPunctualLightsBinding and kCluster*Binding. The lights buffer
+         // serves the array path too.
+         bool clusteredLightsEnabled_ = true;
+         LightClusters lightClusters_;
+         std::vector<LightSphere> clusterSpheres_;
+         std::vector<glm::vec4> clusterLightData_; // 4 per light, world space
+         std::vector<uint32_t> clusterWords_;
+         GLuint clusterUBO_[3] = { 0, 0, 0 };
+         GLuint blocksProgram_ = 0; // last program whose block bindings were set
+         // The view the bound lights and clusters were selected and binned
+         // for. RenderScene sets it; RenderTransparent reuses the upload when
+         // it draws the same view in the same frame, BeginFrame forgets it.
+         struct LightsView {
+             bool valid = false;
+             bool clustered = false;
+             glm::vec3 position{ 0.f };
+             glm::mat4 view{ 1.f };
+             float zoomDeg = 0.f, nearZ = 0.f, farZ = 0.f;
+             GLint viewport[4] = { 0, 0, 0, 0 };
+             bool operator==(const LightsView& o) const;
+         };
+         LightsView lightsView_;
+         LightsView lightsViewFor_(Camera& camera) const; // reads GL_VIEWPORT
+         void uploadPunctualLights_(Camera& camera, RenderStats& stats);
+         void uploadLightClusters_(Camera& camera, RenderStats& stats);
+         void bindUniformBlocks_(const Shader& shader);
+
          // world-space bounding spheres of casters whose transforms changed
          // this frame
          struct DirtyCaster { glm::vec3 center; float radius; };
          std::vector<DirtyCaster> dirtyCasters_;
+         // parent-before-child walk order for UpdateTransforms, maintained
+         // from registry signals (declared after `registry`, which it
+         // listens to)
+         TransformHierarchy hierarchy_{ registry };
+         std::vector<uint8_t> movedScratch_; // per order slot, this pass
+         // world bounds of every renderable, SIMD-culled by RenderScene;
+         // UpdateTransforms refreshes the entities it moves
+         BoundsCache bounds_{ registry };
+         std::vector<entt::entity> shadowCandidates_; // light-frustum query scratch
+         BoundsCache::QueryScratch shadowQueryScratch_;
+         // the same, per cascade build (each may run on its own worker)
+         std::vector<entt::entity> cascadeCandidates_[4];
+         BoundsCache::QueryScratch cascadeQueryScratch_[4];
+         std::vector<BoundsCache::RayHit> rayHits_;   // RaycastBounds scratch
+         // parallel pass: casters per chunk of a wave, merged in chunk order
+         std::vector<std::vector<DirtyCaster>> chunkCasters_;
 
          RenderStats lastStats_;
          EnvironmentSettings environment_{};
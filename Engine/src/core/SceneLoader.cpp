@@ -2,6 +2,7 @@
 
 #include "AssetManager.h"
 #include "Scene.h"
+#include "Profiler.h"
 
 #include <algorithm>
 #include <iostream>
@@ -151,6 +152,7 @@ bool SceneLoader::DrainPendingSwap() {
     // host draws its loading screen and calls this again next frame.
     if (swapPrewarming()) return false;
 
+    CSE_PROFILE_ZONE("SceneLoader::Swap");
     swapping_ = true;
     struct Guard {
         bool* f;
@@ -3,6 +3,7 @@
 #include "Components.h"
 #include "AssetManager.h"
 #include "Model.h"
+#include "IOService.h"
 #include "PathSandbox.h"
 #include "../physics/PhysicsComponents.h"
 #include "../script/ScriptComponent.h"
@@ -16,6 +17,8 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <sstream>
 
 using json = nlohmann::json;
 
@@ -46,6 +49,7 @@ namespace MyCoreEngine {
         settings["pbrEnabled"] = scene_.GetPBREnabled();
         settings["normalMapEnabled"] = scene_.GetNormalMapEnabled();
         settings["instancingEnabled"] = scene_.GetInstancingEnabled();
+        settings["multiDraw"] = scene_.GetMultiDrawEnabled();
         settings["metallic"] = scene_.GetMetallic();
         settings["roughness"] = scene_.GetRoughness();
         settings["ao"] = scene_.GetAO();
@@ -63,6 +67,7 @@ namespace MyCoreEngine {
         settings["smallCullEnabled"] = scene_.GetSmallCullEnabled();
         settings["smallCullPixels"] = scene_.GetSmallCullPixels();
         settings["depthPrepass"] = scene_.GetDepthPrepassEnabled();
+        settings["clusteredLights"] = scene_.GetClusteredLightsEnabled();
         settings["aaEnabled"] = scene_.GetAAEnabled();
 
         // --- post-process stack ---
@@ -88,6 +93,7 @@ namespace MyCoreEngine {
             post["bloomEnabled"]   = p.bloom.enabled;
             post["bloomThreshold"] = p.bloom.threshold;
             post["bloomIntensity"] = p.bloom.intensity;
+            post["fused"]          = p.fused;
             settings["postFX"] = post;
         }
         settings["qualityLevel"] = static_cast<int>(scene_.GetQualityLevel());
@@ -325,6 +331,19 @@ namespace MyCoreEngine {
         return false;
     }
 
+    bool SceneSerializer::readText_(const std::string& path, std::string& out) const {
+        if (IOService* io = assets_.ioService()) {
+            const IOBlobPtr blob = io->ReadNow(path);
+            if (!blob->ok) return false;
+            out.assign(blob->bytes.begin(), blob->bytes.end());
+            return true;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return !in.bad();
+    }
+
     bool SceneSerializer::Load(const std::string& path, SceneLoadReport* report) {
         // Honour the documented guarantee that a bad file leaves the current
         // scene intact. Only a JSON *syntax* error and a bad version were
@@ -340,19 +359,37 @@ namespace MyCoreEngine {
         // a JSON walk, not model I/O.
         report_ = dryRun_ ? nullptr : report;
         if (report_) *report_ = SceneLoadReport{};
+
+        // The file is read ONCE, here, and the probe parses the same bytes
+        // (it used to open the file a second time).
+        std::string owned;
+        if (!text_ && !readText_(path, owned)) {
+            std::cerr << "ERROR::SCENE::LOAD_FAILED cannot open '" << path << "'" << std::endl;
+            return false;
+        }
+        const std::string& text = text_ ? *text_ : owned;
+
         if (!dryRun_) {
             Scene scratch;
             SceneSerializer probe(scratch, assets_);
             probe.dryRun_ = true;
+            probe.text_ = &text;
+            IOService* io = assets_.ioService();
+            std::vector<std::string> models;
+            if (io) probe.collect_ = &models;
             if (!probe.Load(path)) return false; // scene_ untouched
-        }
 
-        std::ifstream in(path);
-        if (!in) {
-            std::cerr << "ERROR::SCENE::LOAD_FAILED cannot open '" << path << "'" << std::endl;
-            return false;
+            // The real pass imports these one after another on this thread.
+            // Hinting them all now lets the I/O thread read model N+1 (and
+            // its textures) while model N decodes, instead of every import
+            // starting from a cold disk.
+            for (const std::string& m : models) {
+                io->ReadAhead(m);
+                io->ReadAheadSiblings(m);
+            }
         }
 
+        std::istringstream in(text);
         json root;
         try {
             in >> root;
@@ -399,6 +436,7 @@ namespace MyCoreEngine {
             scene_.SetPBREnabled(s.value("pbrEnabled", scene_.GetPBREnabled()));
             scene_.SetNormalMapEnabled(s.value("normalMapEnabled", scene_.GetNormalMapEnabled()));
             scene_.SetInstancingEnabled(s.value("instancingEnabled", scene_.GetInstancingEnabled()));
+            scene_.SetMultiDrawEnabled(s.value("multiDraw", scene_.GetMultiDrawEnabled()));
             scene_.SetMetallic(s.value("metallic", scene_.GetMetallic()));
             scene_.SetRoughness(s.value("roughness", scene_.GetRoughness()));
             scene_.SetAO(s.value("ao", scene_.GetAO()));
@@ -412,6 +450,7 @@ namespace MyCoreEngine {
             scene_.SetSmallCullEnabled(s.value("smallCullEnabled", scene_.GetSmallCullEnabled()));
             scene_.SetSmallCullPixels(s.value("smallCullPixels", scene_.GetSmallCullPixels()));
             scene_.SetDepthPrepassEnabled(s.value("depthPrepass", scene_.GetDepthPrepassEnabled()));
+            scene_.SetClusteredLightsEnabled(s.value("clusteredLights", scene_.GetClusteredLightsEnabled()));
             scene_.SetAAEnabled(s.value("aaEnabled", scene_.GetAAEnabled()));
 
             // --- post-process stack (see the save side). Absent => defaults
@@ -442,6 +481,7 @@ namespace MyCoreEngine {
                 p.bloom.enabled   = jp.value("bloomEnabled",   p.bloom.enabled);
                 p.bloom.threshold = jp.value("bloomThreshold", p.bloom.threshold);
                 p.bloom.intensity = jp.value("bloomIntensity", p.bloom.intensity);
+                p.fused           = jp.value("fused",          p.fused);
             }
 
             const int ql = s.value("qualityLevel",
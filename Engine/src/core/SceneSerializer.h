@@ -81,9 +81,17 @@ namespace MyCoreEngine {
         bool dryRun_ = false;
         // Filled during a non-probe load; null when the caller did not ask.
         SceneLoadReport* report_ = nullptr;
-        // Set only on a CollectModelPaths probe. Null on every other pass,
-        // including the probe a real Load runs against itself.
+        // Set on a CollectModelPaths probe, and on the probe a real Load runs
+        // when its AssetManager has an IOService (to read the models ahead).
+        // Null on every other pass.
         std::vector<std::string>* collect_ = nullptr;
+        // The file's bytes, when an outer Load already read them. Set only on
+        // that Load's probe; every other pass reads the file itself.
+        const std::string* text_ = nullptr;
+
+        // Whole file into `out`, through the AssetManager's IOService if it
+        // has one. False when it cannot be read.
+        bool readText_(const std::string& path, std::string& out) const;
     };
 
 } // namespace MyCoreEngine
@@ -1,6 +1,7 @@
 #include <glad/glad.h>
 #include "Shader.h"
 #include "Core.h"
+#include "ShaderCache.h"
 
 #include <string>
 #include <fstream>
@@ -10,7 +11,26 @@
 
 namespace MyCoreEngine
 {
+    namespace {
+        // #version has to stay the first line, so the defines go after it
+        void insertDefines(std::string& code, std::string_view defines)
+        {
+            if (defines.empty()) return;
+            size_t at = 0;
+            if (code.compare(0, 8, "#version") == 0) {
+                const size_t eol = code.find('\n');
+                at = eol == std::string::npos ? code.size() : eol + 1;
+            }
+            code.insert(at, defines);
+        }
+    } // namespace
+
     Shader::Shader(const char* vertexPath, const char* fragmentPath)
+        : Shader(vertexPath, fragmentPath, std::string_view{})
+    {
+    }
+
+    Shader::Shader(const char* vertexPath, const char* fragmentPath, std::string_view defines)
     {
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
@@ -44,6 +64,12 @@ namespace MyCoreEngine
             valid_ = false;
             return; // nothing to compile; ID stays 0
         }
+        insertDefines(vertexCode, defines);
+        insertDefines(fragmentCode, defines);
+        // a program linked before from these exact sources loads as a binary
+        const uint64_t key = ShaderCache::Key(vertexCode, fragmentCode);
+        ID = glCreateProgram();
+        if (ShaderCache::Load(ID, key)) return;
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
         // 2. compile shaders
@@ -59,11 +85,12 @@ namespace MyCoreEngine
         glCompileShader(fragment);
         checkCompileErrors(fragment, "FRAGMENT");
         // shader Program
-        ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
+        ShaderCache::PrepareToLink(ID);
         glLinkProgram(ID);
         checkCompileErrors(ID, "PROGRAM");
+        if (valid_) ShaderCache::Store(ID, key);
         // delete the shaders as they're linked into our program now and no longer necessary
         glDeleteShader(vertex);
         glDeleteShader(fragment);
@@ -76,6 +103,7 @@ namespace MyCoreEngine
 
     Shader::Shader(Shader&& other) noexcept
         : ID(std::exchange(other.ID, 0u)),
+          names_(std::move(other.names_)),
           locations_(std::move(other.locations_)),
           valid_(other.valid_)
     {
@@ -86,6 +114,7 @@ namespace MyCoreEngine
         if (this != &other) {
             if (ID) glDeleteProgram(ID);
             ID = std::exchange(other.ID, 0u);
+            names_ = std::move(other.names_);
             locations_ = std::move(other.locations_);
             valid_ = other.valid_;
         }
@@ -97,72 +126,73 @@ namespace MyCoreEngine
         glUseProgram(ID);
     }
 
-    int Shader::loc_(const std::string& name) const
+    int Shader::location(std::string_view name) const
     {
         auto it = locations_.find(name);
         if (it != locations_.end()) return it->second;
-        const int location = glGetUniformLocation(ID, name.c_str());
-        locations_.emplace(name, location);
+        const std::string& owned = names_.emplace_back(name); // GL wants it terminated
+        const int location = glGetUniformLocation(ID, owned.c_str());
+        locations_.emplace(owned, location);
         return location;
     }
 
     // utility uniform functions
     // ------------------------------------------------------------------------
-    void Shader::setBool(const std::string& name, bool value) const
+    void Shader::setBool(std::string_view name, bool value) const
     {
-        glUniform1i(loc_(name), (int)value);
+        glUniform1i(location(name), (int)value);
     }
     // ------------------------------------------------------------------------
-    void Shader::setInt(const std::string& name, int value) const
+    void Shader::setInt(std::string_view name, int value) const
     {
-        glUniform1i(loc_(name), value);
+        glUniform1i(location(name), value);
     }
     // ------------------------------------------------------------------------
-    void Shader::setFloat(const std::string& name, float value) const
+    void Shader::setFloat(std::string_view name, float value) const
     {
-        glUniform1f(loc_(name), value);
+        glUniform1f(location(name), value);
     }
     // ------------------------------------------------------------------------
-    void Shader::setVec2(const std::string& name, const glm::vec2& value) const
+    void Shader::setVec2(std::string_view name, const glm::vec2& value) const
     {
-        glUniform2fv(loc_(name), 1, &value[0]);
+        glUniform2fv(location(name), 1, &value[0]);
     }
-    void Shader::setVec2(const std::string& name, float x, float y) const
+    void Shader::setVec2(std::string_view name, float x, float y) const
     {
-        glUniform2f(loc_(name), x, y);
+        glUniform2f(location(name), x, y);
     }
     // ------------------------------------------------------------------------
-    void Shader::setVec3(const std::string& name, const glm::vec3& value) const
+    void Shader::setVec3(std::string_view name, const glm::vec3& value) const
     {
-        glUniform3fv(loc_(name), 1, &value[0]);
+        glUniform3fv(location(name), 1, &value[0]);
     }
-    void Shader::setVec3(const std::string& name, float x, float y, float z) const
+    void Shader::setVec3(std::string_view name, float x, float y, float z) const
     {
-        glUniform3f(loc_(name), x, y, z);
+        glUniform3f(location(name), x, y, z);
     }
     // ------------------------------------------------------------------------
-    void Shader::setVec4(const std::string& name, const glm::vec4& value) const
+    void Shader::setVec4(std::string_view name, const glm::vec4& value) const
     {
-        glUniform4fv(loc_(name), 1, &value[0]);
+        glUniform4fv(location(name), 1, &value[0]);
     }
-    void Shader::setVec4(const std::string& name, float x, float y, float z, float w) const
+    void Shader::setVec4(std::string_view name, float x, float y, float z, float w) const
     {
-        glUniform4f(loc_(name), x, y, z, w);
+        glUniform4f(location(name), x, y, z, w);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat2(const std::string& name, const glm::mat2& mat) const
+    void Shader::setMat2(std::string_view name, const glm::mat2& mat) const
     {
-        glUniformMatrix2fv(loc_(name), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix2fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat3(const std::string& name, const glm::mat3& mat) const
+    void Shader::setMat3(std::string_view name, const glm::mat3& mat) const
     {
-        glUniformMatrix3fv(loc_(name), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix3fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
     // ------------------------------------------------------------------------
-    void Shader::setMat4(const std::string& name, const glm::mat4& mat) const
+    void Shader::setMat4(std::string_view name, const glm::mat4& mat) const
     {
-        glUniformMatrix4fv(loc_(name), 1, GL_FALSE, &mat[0][0]);
+        glUniformMatrix4fv(location(name), 1, GL_FALSE, &mat[0][0]);
     }
 
     // utility function for checking shader compilation/linking errors.
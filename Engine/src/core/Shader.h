@@ -2,7 +2,9 @@
 #include "Core.h"
 #include <glm/glm.hpp>
 
+#include <deque>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -14,6 +16,11 @@ namespace MyCoreEngine
     public:
         // constructor generates the shader on the fly
         Shader(const char* vertexPath, const char* fragmentPath);
+        // Same, with `defines` ("#define A\n#define B\n") inserted after each
+        // stage's #version line: one source file, several permutations.
+        // Either loads the program from ShaderCache when these exact sources
+        // were linked before, and compiles it otherwise.
+        Shader(const char* vertexPath, const char* fragmentPath, std::string_view defines);
         ~Shader();
 
         // GL program handles can't be shared; allow moves, forbid copies
@@ -28,37 +35,43 @@ namespace MyCoreEngine
         bool isValid() const { return valid_; }
 
         void use() const;
-        // utility uniform functions (locations cached per name)
+        // utility uniform functions (locations cached per name; looking a
+        // name up again hashes it but never allocates)
         // ------------------------------------------------------------------------
-        void setBool(const std::string& name, bool value) const;
+        void setBool(std::string_view name, bool value) const;
         // ------------------------------------------------------------------------
-        void setInt(const std::string& name, int value) const;
+        void setInt(std::string_view name, int value) const;
         // ------------------------------------------------------------------------
-        void setFloat(const std::string& name, float value) const;
+        void setFloat(std::string_view name, float value) const;
         // ------------------------------------------------------------------------
-        void setVec2(const std::string& name, const glm::vec2& value) const;
-        void setVec2(const std::string& name, float x, float y) const;
+        void setVec2(std::string_view name, const glm::vec2& value) const;
+        void setVec2(std::string_view name, float x, float y) const;
         // ------------------------------------------------------------------------
-        void setVec3(const std::string& name, const glm::vec3& value) const;
-        void setVec3(const std::string& name, float x, float y, float z) const;
+        void setVec3(std::string_view name, const glm::vec3& value) const;
+        void setVec3(std::string_view name, float x, float y, float z) const;
         // ------------------------------------------------------------------------
-        void setVec4(const std::string& name, const glm::vec4& value) const;
-        void setVec4(const std::string& name, float x, float y, float z, float w) const;
+        void setVec4(std::string_view name, const glm::vec4& value) const;
+        void setVec4(std::string_view name, float x, float y, float z, float w) const;
         // ------------------------------------------------------------------------
-        void setMat2(const std::string& name, const glm::mat2& mat) const;
+        void setMat2(std::string_view name, const glm::mat2& mat) const;
         // ------------------------------------------------------------------------
-        void setMat3(const std::string& name, const glm::mat3& mat) const;
+        void setMat3(std::string_view name, const glm::mat3& mat) const;
         // ------------------------------------------------------------------------
-        void setMat4(const std::string& name, const glm::mat4& mat) const;
+        void setMat4(std::string_view name, const glm::mat4& mat) const;
+
+        // cached glGetUniformLocation (driver lookups are expensive per frame).
+        // Code setting a uniform on every draw keeps the result instead and
+        // calls glUniform* itself.
+        int location(std::string_view name) const;
     private:
-        // cached glGetUniformLocation (driver lookups are expensive per frame)
-        int loc_(const std::string& name) const;
 
         // utility function for checking shader compilation/linking errors.
         // ------------------------------------------------------------------------
         void checkCompileErrors(unsigned int shader, std::string type);
 
-        mutable std::unordered_map<std::string, int> locations_;
+        // keys view into names_, whose strings never move
+        mutable std::deque<std::string> names_;
+        mutable std::unordered_map<std::string_view, int> locations_;
         bool valid_ = true;
     };
 }
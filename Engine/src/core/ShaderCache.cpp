@@ -0,0 +1,208 @@
+#include <glad/glad.h>
+#include "ShaderCache.h"
+
+#include <GLFW/glfw3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+#include "GLInit.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        constexpr char kMagic[4] = { 'C', 'S', 'P', 'B' };
+        constexpr uint32_t kLayout = 1;
+        constexpr std::size_t kHeaderBytes = 4 + 4 + 8 + 4 + 4;
+
+        struct Entry {
+            uint64_t driver = 0;
+            uint32_t format = 0;
+            std::vector<uint8_t> binary;
+        };
+
+        // main thread only, like every GL call here
+        std::unordered_map<uint64_t, Entry> sEntries;
+        std::string sDirectory;
+        bool sEnabled = true;
+        ShaderCache::Stats sStats;
+        void* sDriverContext = nullptr;
+        uint64_t sDriver = 0;
+
+        uint64_t fnv1a(uint64_t h, std::string_view s) {
+            for (unsigned char c : s) { h ^= c; h *= 1099511628211ull; }
+            return h;
+        }
+
+        template <typename T>
+        void put(std::vector<uint8_t>& out, T v) {
+            const auto* p = reinterpret_cast<const uint8_t*>(&v);
+            out.insert(out.end(), p, p + sizeof(T));
+        }
+        template <typename T>
+        T get(const uint8_t* p) {
+            T v;
+            std::memcpy(&v, p, sizeof(T));
+            return v;
+        }
+
+        std::string glString(GLenum name) {
+            const auto* s = reinterpret_cast<const char*>(glGetString(name));
+            return s ? s : "";
+        }
+
+        // The current context's driver, asked once per context.
+        uint64_t currentDriver() {
+            void* context = glfwGetCurrentContext();
+            if (context != sDriverContext) {
+                sDriverContext = context;
+                sDriver = ShaderCache::DriverKey(glString(GL_VENDOR), glString(GL_RENDERER),
+                                                 glString(GL_VERSION));
+            }
+            return sDriver;
+        }
+
+        std::filesystem::path pathFor(uint64_t key) {
+            return std::filesystem::path(sDirectory) / ShaderCache::FileName(key);
+        }
+
+        bool readFile(const std::filesystem::path& path, std::vector<uint8_t>& out) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) return false;
+            out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            return true;
+        }
+
+        // Written aside and renamed into place, so a run killed mid-write
+        // never leaves half a binary under the real name.
+        void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            std::filesystem::path tmp = path;
+            tmp += ".tmp";
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                if (!out) return;
+                out.write(reinterpret_cast<const char*>(bytes.data()),
+                          static_cast<std::streamsize>(bytes.size()));
+                if (!out) return;
+            }
+            std::filesystem::rename(tmp, path, ec);
+            if (ec) std::filesystem::remove(tmp, ec);
+        }
+    } // namespace
+
+    void ShaderCache::SetDirectory(const std::string& dir) { sDirectory = dir; }
+    const std::string& ShaderCache::Directory() { return sDirectory; }
+    void ShaderCache::SetEnabled(bool enabled) { sEnabled = enabled; }
+    bool ShaderCache::Enabled() { return sEnabled; }
+    ShaderCache::Stats ShaderCache::GetStats() { return sStats; }
+    void ShaderCache::ResetStats() { sStats = Stats{}; }
+    void ShaderCache::Clear() { sEntries.clear(); }
+
+    bool ShaderCache::Load(unsigned program, uint64_t key) {
+        if (!sEnabled || !GetGLCaps().programBinary) {
+            ++sStats.misses;
+            return false;
+        }
+        const uint64_t driver = currentDriver();
+        auto it = sEntries.find(key);
+        if (it == sEntries.end() && !sDirectory.empty()) {
+            std::vector<uint8_t> file;
+            Entry e;
+            if (readFile(pathFor(key), file) && Decode(file, driver, e.format, e.binary)) {
+                e.driver = driver;
+                it = sEntries.emplace(key, std::move(e)).first;
+            }
+        }
+        if (it == sEntries.end() || it->second.driver != driver) {
+            ++sStats.misses;
+            return false;
+        }
+        if (!ProgramBinary(program, it->second.format, it->second.binary.data(),
+                           it->second.binary.size())) {
+            // the driver changed under the same strings, or the file is bad
+            sEntries.erase(it);
+            if (!sDirectory.empty()) {
+                std::error_code ec;
+                std::filesystem::remove(pathFor(key), ec);
+            }
+            ++sStats.rejected;
+            ++sStats.misses;
+            return false;
+        }
+        ++sStats.hits;
+        return true;
+    }
+
+    void ShaderCache::PrepareToLink(unsigned program) {
+        if (sEnabled && GetGLCaps().programBinary) ProgramBinaryRetrievable(program);
+    }
+
+    void ShaderCache::Store(unsigned program, uint64_t key) {
+        if (!sEnabled || !GetGLCaps().programBinary) return;
+        Entry e;
+        e.driver = currentDriver();
+        unsigned format = 0;
+        if (!GetProgramBinary(program, e.binary, format)) return;
+        e.format = format;
+        if (!sDirectory.empty()) writeFile(pathFor(key), Encode(e.driver, e.format, e.binary));
+        sEntries[key] = std::move(e);
+        ++sStats.stored;
+    }
+
+    uint64_t ShaderCache::Key(std::string_view vertexSource, std::string_view fragmentSource) {
+        uint64_t h = 1469598103934665603ull;
+        h = fnv1a(h, vertexSource);
+        h = fnv1a(h, std::string_view("\0", 1)); // "ab"+"c" is not "a"+"bc"
+        return fnv1a(h, fragmentSource);
+    }
+
+    uint64_t ShaderCache::DriverKey(std::string_view vendor, std::string_view renderer,
+                                    std::string_view version) {
+        uint64_t h = 1469598103934665603ull;
+        for (std::string_view s : { vendor, renderer, version }) {
+            h = fnv1a(h, s);
+            h = fnv1a(h, std::string_view("\0", 1));
+        }
+        return h;
+    }
+
+    std::string ShaderCache::FileName(uint64_t key) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return name;
+    }
+
+    std::vector<uint8_t> ShaderCache::Encode(uint64_t driver, uint32_t format,
+                                             const std::vector<uint8_t>& binary) {
+        std::vector<uint8_t> out;
+        out.reserve(kHeaderBytes + binary.size());
+        out.insert(out.end(), std::begin(kMagic), std::end(kMagic));
+        put(out, kLayout);
+        put(out, driver);
+        put(out, format);
+        put(out, static_cast<uint32_t>(binary.size()));
+        out.insert(out.end(), binary.begin(), binary.end());
+        return out;
+    }
+
+    bool ShaderCache::Decode(const std::vector<uint8_t>& file, uint64_t driver,
+                             uint32_t& format, std::vector<uint8_t>& binary) {
+        if (file.size() < kHeaderBytes) return false;
+        const uint8_t* p = file.data();
+        if (std::memcmp(p, kMagic, sizeof(kMagic)) != 0) return false;
+        if (get<uint32_t>(p + 4) != kLayout) return false;
+        if (get<uint64_t>(p + 8) != driver) return false;
+        const uint32_t length = get<uint32_t>(p + 20);
+        if (length == 0 || file.size() - kHeaderBytes != length) return false;
+        format = get<uint32_t>(p + 16);
+        binary.assign(file.begin() + kHeaderBytes, file.end());
+        return true;
+    }
+
+} // namespace MyCoreEngine
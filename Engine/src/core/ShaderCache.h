@@ -0,0 +1,73 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Linked programs kept as driver binaries (glGetProgramBinary), so a
+    // program built once is loaded instead of compiled again: from memory for
+    // the rest of the run (the editor's second renderer, a pass rebuilt on a
+    // quality-tier switch) and, with a directory set, from disk on the next.
+    //
+    // A program is keyed by a hash of both stages' final source, defines
+    // included, so each permutation is its own entry and an edited shader
+    // misses rather than loading stale code. A file also records the driver
+    // it came from (vendor, renderer and version strings) and is never handed
+    // to another one. A binary the driver still refuses is dropped, and the
+    // program compiles from source as it would without the cache.
+    //
+    // Shader goes through it by itself. Without GetGLCaps().programBinary
+    // every program compiles from source. MAIN THREAD ONLY (GL).
+    class ENGINE_API ShaderCache {
+    public:
+        struct Stats {
+            unsigned hits = 0;      // programs linked from a binary
+            unsigned misses = 0;    // programs compiled from source
+            unsigned rejected = 0;  // binaries the driver refused
+            unsigned stored = 0;    // binaries kept after a compile
+        };
+
+        // Where binaries persist between runs. Empty (the default) keeps
+        // them in memory only.
+        static void SetDirectory(const std::string& dir);
+        static const std::string& Directory();
+        // Off: every program compiles from source, for comparisons.
+        static void SetEnabled(bool enabled);
+        static bool Enabled();
+
+        static Stats GetStats();
+        static void ResetStats();
+        // Forgets the binaries held in memory; the files stay.
+        static void Clear();
+
+        // --- called by Shader ---
+        // Links `program` from a kept binary. False on a miss or a refusal:
+        // the caller compiles it.
+        static bool Load(unsigned program, uint64_t key);
+        // Before linking, so the driver keeps the binary to hand back.
+        static void PrepareToLink(unsigned program);
+        // After a successful link: keeps the program's binary.
+        static void Store(unsigned program, uint64_t key);
+
+        // --- pure ---
+        static uint64_t Key(std::string_view vertexSource, std::string_view fragmentSource);
+        static uint64_t DriverKey(std::string_view vendor, std::string_view renderer,
+                                  std::string_view version);
+        // The file a key persists to, inside Directory().
+        static std::string FileName(uint64_t key);
+        // A file: magic, layout version, driver key, binary format, length,
+        // then the binary.
+        static std::vector<uint8_t> Encode(uint64_t driver, uint32_t format,
+                                           const std::vector<uint8_t>& binary);
+        // False when the bytes are not such a file, are cut short, or came
+        // from another driver.
+        static bool Decode(const std::vector<uint8_t>& file, uint64_t driver,
+                           uint32_t& format, std::vector<uint8_t>& binary);
+    };
+
+} // namespace MyCoreEngine
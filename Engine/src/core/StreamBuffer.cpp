@@ -0,0 +1,227 @@
+#include <glad/glad.h>
+#include "StreamBuffer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+
+#include "GLInit.h"
+#include "Profiler.h"
+
+// ARB_buffer_storage / GL 4.4; the loader is 3.3 core
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace MyCoreEngine {
+
+    namespace {
+        bool sPersistent = true; // main thread: read when a buffer is created
+
+        std::size_t alignUp(std::size_t v, std::size_t align) {
+            return (v + align - 1) / align * align;
+        }
+    } // namespace
+
+    // ---- StreamRing ----
+
+    void StreamRing::Reset(std::size_t segmentBytes) {
+        segmentBytes_ = segmentBytes;
+        head_ = 0;
+        segment_ = 0;
+    }
+
+    std::size_t StreamRing::Allocate(std::size_t bytes, std::size_t align) {
+        if (bytes == 0) return kNone;
+        align = std::max<std::size_t>(align, 1);
+        const std::size_t offset = alignUp(head_, align);
+        const std::size_t end = std::size_t(segment_ + 1) * segmentBytes_;
+        if (offset > end || bytes > end - offset) return kNone;
+        head_ = offset + bytes;
+        return offset;
+    }
+
+    int StreamRing::Advance() {
+        if (Used() == 0) return -1;
+        const int closed = segment_;
+        segment_ = (segment_ + 1) % kSegments;
+        head_ = std::size_t(segment_) * segmentBytes_;
+        return closed;
+    }
+
+    std::size_t StreamRing::GrowTo(std::size_t bytes, std::size_t align) const {
+        const std::size_t need = Used() + bytes + std::max<std::size_t>(align, 1);
+        std::size_t size = std::max<std::size_t>(segmentBytes_ * 2, 1);
+        while (size < need) size *= 2;
+        return size;
+    }
+
+    // ---- StreamBuffer ----
+
+    void StreamBuffer::SetPersistentEnabled(bool enabled) { sPersistent = enabled; }
+    bool StreamBuffer::PersistentEnabled() { return sPersistent; }
+
+    StreamBuffer::StreamBuffer(std::size_t segmentBytes)
+        : initialSegmentBytes_(segmentBytes) {}
+
+    StreamBuffer::~StreamBuffer() {
+        if (context_ && glfwGetCurrentContext() == context_) Release();
+    }
+
+    void StreamBuffer::create_(std::size_t segmentBytes) {
+        const std::size_t bytes = segmentBytes * StreamRing::kSegments;
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        if (sPersistent && GetGLCaps().bufferStorage) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            BufferStorage(GL_COPY_WRITE_BUFFER, bytes, flags);
+            mapped_ = static_cast<unsigned char*>(
+                glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(bytes), flags));
+        }
+        else {
+            glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        ring_.Reset(segmentBytes);
+        stats_.capacity = bytes;
+        stats_.persistent = mapped_ != nullptr;
+    }
+
+    void StreamBuffer::dropFences_() {
+        for (void*& f : fences_) {
+            if (f) glDeleteSync(static_cast<GLsync>(f));
+            f = nullptr;
+        }
+        for (bool& p : pending_) p = false;
+    }
+
+    StreamBuffer::Span StreamBuffer::Map(std::size_t bytes, std::size_t align) {
+        if (bytes == 0) return {};
+        void* context = glfwGetCurrentContext();
+        if (context != context_) {
+            // our objects went with another context
+            context_ = context;
+            buffer_ = 0;
+            mapped_ = nullptr;
+            mapOpen_ = false;
+            for (void*& f : fences_) f = nullptr;
+            for (bool& p : pending_) p = false;
+            retired_.clear();
+            stats_ = Stats{};
+        }
+        if (!buffer_) create_(initialSegmentBytes_);
+
+        std::size_t offset = ring_.Allocate(bytes, align);
+        if (offset == StreamRing::kNone) {
+            // Spilled past this frame's segment. Move on when the GPU is
+            // already done with the next one; otherwise grow rather than wait.
+            // A segment this frame already spilled out of is not free: the
+            // frame's draws from it may not even be issued yet.
+            const int next = (ring_.Segment() + 1) % StreamRing::kSegments;
+            GLsync fence = static_cast<GLsync>(fences_[next]);
+            const bool nextFree = !pending_[next] &&
+                                  (!fence || glClientWaitSync(fence, 0, 0) != GL_TIMEOUT_EXPIRED);
+            const bool fitsOne = bytes + align <= ring_.SegmentBytes();
+            if (nextFree && fitsOne) {
+                // fenced at NextFrame, once every draw reading it is issued
+                pending_[ring_.Advance()] = true;
+                if (fence) glDeleteSync(fence);
+                fences_[next] = nullptr;
+                ++stats_.wraps;
+            }
+            else {
+                CSE_PROFILE_ZONE("StreamBuffer::grow");
+                const std::size_t segmentBytes = ring_.GrowTo(bytes, align);
+                retired_.push_back(buffer_);
+                buffer_ = 0;
+                mapped_ = nullptr; // deleting the buffer unmaps it
+                dropFences_();     // and forgets what was pending in it
+                create_(segmentBytes);
+                ++stats_.grows;
+            }
+            offset = ring_.Allocate(bytes, align);
+        }
+
+        Span s{ buffer_, offset, nullptr };
+        if (mapped_) {
+            s.data = mapped_ + offset;
+        }
+        else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+            s.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(offset),
+                                      static_cast<GLsizeiptr>(bytes),
+                                      GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                      GL_MAP_UNSYNCHRONIZED_BIT);
+            mapOpen_ = true;
+        }
+        return s;
+    }
+
+    void StreamBuffer::Unmap() {
+        if (!mapOpen_) return; // persistent: nothing to end
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        mapOpen_ = false;
+    }
+
+    StreamBuffer::Span StreamBuffer::Write(const void* data, std::size_t bytes, std::size_t align) {
+        Span s = Map(bytes, align);
+        if (s.data) std::copy_n(static_cast<const unsigned char*>(data), bytes, static_cast<unsigned char*>(s.data));
+        Unmap();
+        s.data = nullptr;
+        return s;
+    }
+
+    void StreamBuffer::NextFrame() {
+        if (!buffer_ || glfwGetCurrentContext() != context_) return;
+        // their draws were issued last frame; GL frees them once those finish
+        if (!retired_.empty()) {
+            glDeleteBuffers(static_cast<GLsizei>(retired_.size()), retired_.data());
+            retired_.clear();
+        }
+        // Everything this frame wrote -- the segments it spilled out of and
+        // the one it ends in -- is fenced here, after all of its draws.
+        const int closed = ring_.Advance();
+        if (closed >= 0) pending_[closed] = true;
+        bool wrote = false;
+        for (int s = 0; s < StreamRing::kSegments; ++s) {
+            if (!pending_[s]) continue;
+            if (fences_[s]) glDeleteSync(static_cast<GLsync>(fences_[s]));
+            fences_[s] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            pending_[s] = false;
+            wrote = true;
+        }
+        if (!wrote) return; // idle frame: nothing to fence
+
+        void*& next = fences_[ring_.Segment()];
+        if (!next) return;
+        GLsync fence = static_cast<GLsync>(next);
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            // the GPU is a whole ring behind
+            CSE_PROFILE_ZONE("StreamBuffer::wait");
+            ++stats_.waits;
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        }
+        glDeleteSync(fence);
+        next = nullptr;
+    }
+
+    void StreamBuffer::Release() {
+        if (buffer_) glDeleteBuffers(1, &buffer_);
+        if (!retired_.empty()) glDeleteBuffers(static_cast<GLsizei>(retired_.size()), retired_.data());
+        dropFences_();
+        retired_.clear();
+        buffer_ = 0;
+        mapped_ = nullptr;
+        mapOpen_ = false;
+        context_ = nullptr;
+        stats_ = Stats{};
+    }
+
+    StreamBuffer::Stats StreamBuffer::GetStats() const { return stats_; }
+
+} // namespace MyCoreEngine
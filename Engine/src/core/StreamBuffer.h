@@ -0,0 +1,133 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Offsets in a ring of kSegments equal segments. Allocations bump
+    // through the current segment; Advance moves to the next one, which the
+    // GPU may still be reading until its fence says otherwise. Pure
+    // bookkeeping, no GL: StreamBuffer keeps one and owns the fences.
+    class ENGINE_API StreamRing {
+    public:
+        static constexpr int kSegments = 3;
+        static constexpr std::size_t kNone = ~std::size_t(0);
+
+        // Everything free, segment 0 current.
+        void Reset(std::size_t segmentBytes);
+        // Offset of `bytes` at a multiple of `align` (any positive value, so
+        // a vertex stride works) inside the current segment; kNone when they
+        // do not fit in what is left of it. bytes 0 is kNone.
+        std::size_t Allocate(std::size_t bytes, std::size_t align);
+        // Closes the current segment and makes the next one current, empty.
+        // Returns the closed segment, or -1 without moving when nothing was
+        // allocated in it (an idle frame fences nothing).
+        int Advance();
+
+        int Segment() const { return segment_; }
+        std::size_t SegmentBytes() const { return segmentBytes_; }
+        std::size_t Capacity() const { return segmentBytes_ * kSegments; }
+        // Bytes taken in the current segment, alignment padding included.
+        std::size_t Used() const { return head_ - std::size_t(segment_) * segmentBytes_; }
+        // The segment size to grow to when `bytes` at `align` did not fit:
+        // at least double, and enough for the current segment's use plus them.
+        std::size_t GrowTo(std::size_t bytes, std::size_t align) const;
+
+    private:
+        std::size_t segmentBytes_ = 0;
+        std::size_t head_ = 0;
+        int segment_ = 0;
+    };
+
+    // A buffer for data written once per frame and read once by the GPU:
+    // instance matrices, 2D vertices. Triple-buffered: a frame writes one
+    // segment of a ring while the GPU reads the previous ones, and a fence
+    // per segment says when it may be written again, so writes never wait on
+    // a draw in flight and the driver never copies or orphans.
+    //
+    //   StreamBuffer::Span s = stream.Write(mats, bytes, 16);
+    //   glBindBuffer(GL_ARRAY_BUFFER, s.buffer);   // then offsets from s.offset
+    //   ...
+    //   stream.NextFrame();                        // at the top of the next frame
+    //
+    // With GL 4.4 or ARB_buffer_storage the ring is mapped once, persistent
+    // and coherent, and Map hands out pointers into it. Otherwise each Map is
+    // a glMapBufferRange with GL_MAP_UNSYNCHRONIZED_BIT (the fences do the
+    // synchronising) and Unmap ends it.
+    //
+    // A frame that outgrows its segment moves on to the next one if the GPU
+    // is done with it (and this frame did not write it already), and
+    // otherwise grows the ring into a new buffer, so an
+    // allocation never waits mid-frame. Spans already handed out stay valid:
+    // the old buffer is deleted at the next NextFrame, after its draws were
+    // issued. Only NextFrame waits, and only when the GPU is a full ring
+    // behind.
+    //
+    // MAIN THREAD ONLY (GL). Created on the first Map, in the context
+    // current then; if a different context is current later (tests
+    // re-creating windows), the old objects are forgotten and it starts over.
+    class ENGINE_API StreamBuffer {
+    public:
+        static constexpr std::size_t kInitialSegmentBytes = 64 * 1024;
+
+        struct Span {
+            unsigned buffer = 0;     // the GL buffer to bind
+            std::size_t offset = 0;  // byte offset of the data in it
+            void* data = nullptr;    // where to write; valid until Unmap
+        };
+
+        struct Stats {
+            std::size_t capacity = 0; // bytes, all segments
+            uint32_t waits = 0;       // NextFrame blocked on a fence
+            uint32_t wraps = 0;       // frames that spilled into the next segment
+            uint32_t grows = 0;       // moves to a larger buffer
+            bool persistent = false;  // mapped once (buffer storage)
+        };
+
+        explicit StreamBuffer(std::size_t segmentBytes = kInitialSegmentBytes);
+        ~StreamBuffer(); // deletes the GL objects only while a context is current
+        StreamBuffer(const StreamBuffer&) = delete;
+        StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+        // Room for `bytes` at a multiple of `align`. Write through data, then
+        // Unmap before drawing from it. bytes 0 is an empty span.
+        Span Map(std::size_t bytes, std::size_t align);
+        void Unmap();
+        // Map, copy, Unmap.
+        Span Write(const void* data, std::size_t bytes, std::size_t align);
+
+        // Fences the segments this frame wrote and waits, if it must, until
+        // the GPU is done with the next one.
+        void NextFrame();
+        // Deletes the GL objects (context current). The next Map starts over.
+        void Release();
+
+        Stats GetStats() const;
+
+        // Off: new buffers use the unsynchronised-map path even where
+        // persistent mapping exists. Default on. For comparisons and tests.
+        static void SetPersistentEnabled(bool enabled);
+        static bool PersistentEnabled();
+
+    private:
+        void create_(std::size_t segmentBytes);
+        void dropFences_();
+
+        StreamRing ring_;
+        std::size_t initialSegmentBytes_;
+        unsigned buffer_ = 0;
+        unsigned char* mapped_ = nullptr; // persistent mapping, or null
+        bool mapOpen_ = false;            // a fallback Map awaits its Unmap
+        void* fences_[StreamRing::kSegments] = {};
+        // Segments this frame spilled out of. Fenced by NextFrame, after the
+        // frame's draws that read them, and never reused before that.
+        bool pending_[StreamRing::kSegments] = {};
+        std::vector<unsigned> retired_;   // outgrown; deleted at NextFrame
+        void* context_ = nullptr;
+        Stats stats_;
+    };
+
+} // namespace MyCoreEngine
@@ -0,0 +1,264 @@
+#include <glad/glad.h>
+#include "TextureArrays.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        bool sEnabled = true; // main thread: only Add reads it
+
+        int mipLevels(int width, int height) {
+            int levels = 1;
+            for (int size = std::max(width, height); size > 1; size >>= 1) ++levels;
+            return levels;
+        }
+
+        // Every level of a width x height array, `layers` deep. Storage only.
+        void specify(unsigned array, int width, int height, bool srgb, int layers) {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+            const int levels = mipLevels(width, height);
+            for (int level = 0; level < levels; ++level) {
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, level, srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                             std::max(1, width >> level), std::max(1, height >> level), layers,
+                             0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+    } // namespace
+
+    // ---- TextureLayerTable ----
+
+    TextureLayerTable::Placement TextureLayerTable::Add(unsigned texture, int width, int height, bool srgb) {
+        Placement p;
+        if (auto it = slots_.find(texture); it != slots_.end()) {
+            p.slot = it->second;
+            if (p.slot.cls >= 0) p.capacity = classes_[p.slot.cls].capacity;
+            return p;
+        }
+
+        const auto key = std::make_tuple(width, height, srgb);
+        auto [it, inserted] = classOf_.emplace(key, static_cast<int>(classes_.size()));
+        const int cls = it->second;
+        if (inserted) {
+            Class c;
+            c.width = width;
+            c.height = height;
+            c.srgb = srgb;
+            classes_.push_back(c);
+        }
+        Class& c = classes_[cls];
+
+        if (c.capacity == 0) {
+            if (c.waiting == 0) { // first of its class: nothing to batch with yet
+                c.waiting = texture;
+                slots_.emplace(texture, Slot{});
+                return p;
+            }
+            p.created = true;
+            p.promoted = c.waiting;
+            c.capacity = std::min(kInitialLayers, maxLayers_);
+            c.layers = 1;
+            slots_[c.waiting] = Slot{ cls, 0 };
+            c.waiting = 0;
+        }
+        if (!c.freeLayers.empty()) { // a removed texture's layer
+            p.slot = Slot{ cls, c.freeLayers.back() };
+            c.freeLayers.pop_back();
+            ++c.layers;
+            p.copy = true;
+            p.capacity = c.capacity;
+            slots_.emplace(texture, p.slot);
+            return p;
+        }
+        if (c.layers == c.capacity) {
+            if (c.capacity >= maxLayers_) { // full for good: stays on its own
+                slots_.emplace(texture, Slot{});
+                p.capacity = c.capacity;
+                return p;
+            }
+            c.capacity = std::min(c.capacity * 2, maxLayers_);
+            p.grew = !p.created;
+        }
+        p.slot = Slot{ cls, c.layers++ };
+        p.copy = true;
+        p.capacity = c.capacity;
+        slots_.emplace(texture, p.slot);
+        return p;
+    }
+
+    TextureLayerTable::Slot TextureLayerTable::Find(unsigned texture) const {
+        const auto it = slots_.find(texture);
+        return it != slots_.end() ? it->second : Slot{};
+    }
+
+    void TextureLayerTable::Remove(unsigned texture) {
+        const auto it = slots_.find(texture);
+        if (it == slots_.end()) return;
+        const Slot s = it->second;
+        slots_.erase(it);
+        if (s.cls >= 0) {
+            Class& c = classes_[s.cls];
+            --c.layers;
+            c.freeLayers.push_back(s.layer);
+            return;
+        }
+        for (Class& c : classes_) {
+            if (c.waiting == texture) c.waiting = 0;
+        }
+    }
+
+    void TextureLayerTable::Clear() {
+        classes_.clear();
+        classOf_.clear();
+        slots_.clear();
+    }
+
+    // ---- TextureArrays ----
+
+    TextureArrays& TextureArrays::Get() {
+        // Leaked on purpose, like the mesh arenas: the GL objects go with
+        // the context.
+        static TextureArrays* sArrays = new TextureArrays();
+        return *sArrays;
+    }
+
+    void TextureArrays::SetEnabled(bool enabled) { sEnabled = enabled; }
+    bool TextureArrays::Enabled() { return sEnabled; }
+
+    void TextureArrays::EnsureContext() {
+        void* context = glfwGetCurrentContext();
+        if (context == context_) return;
+        // our objects went with another context
+        context_ = context;
+        table_.Clear();
+        arrays_.clear();
+        scratch_ = 0;
+        grows_ = 0;
+    }
+
+    void TextureArrays::Add(unsigned texture) {
+        if (!sEnabled || texture == 0) return;
+        EnsureContext();
+        if (!context_) return;
+
+        // size and format from the texture itself, so a cache hit that never
+        // decoded its pixels registers the same way
+        GLint width = 0, height = 0, format = 0;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+        // the copy reads every level: the chain must be complete
+        GLint lastWidth = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, mipLevels(width, height) - 1, GL_TEXTURE_WIDTH, &lastWidth);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        if (width <= 0 || height <= 0 || lastWidth != 1 ||
+            (format != GL_RGBA8 && format != GL_SRGB8_ALPHA8)) {
+            return;
+        }
+
+        const TextureLayerTable::Placement p = table_.Add(texture, width, height, format == GL_SRGB8_ALPHA8);
+        if (!p.copy) return;
+
+        CSE_PROFILE_ZONE("TextureArrays::Add");
+        const int cls = p.slot.cls;
+        if (arrays_.size() <= static_cast<std::size_t>(cls)) arrays_.resize(cls + 1, 0);
+        const TextureLayerTable::Class& c = table_.Classes()[cls];
+        if (!scratch_) glGenBuffers(1, &scratch_);
+        if (p.created) {
+            glGenTextures(1, &arrays_[cls]);
+            specify(arrays_[cls], c.width, c.height, c.srgb, p.capacity);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            copyLayer_(p.promoted, arrays_[cls], 0, c.width, c.height);
+        }
+        else if (p.grew) {
+            grow_(cls, p.capacity / 2, p.capacity);
+        }
+        copyLayer_(texture, arrays_[cls], p.slot.layer, c.width, c.height);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+
+    void TextureArrays::Remove(unsigned texture) {
+        if (texture == 0) return;
+        EnsureContext(); // a table from another context is cleared, not edited
+        table_.Remove(texture);
+    }
+
+    TextureArrays::Slot TextureArrays::Find(unsigned texture) const {
+        const TextureLayerTable::Slot s = table_.Find(texture);
+        if (s.cls < 0) return {};
+        return { arrays_[s.cls], s.layer };
+    }
+
+    // Every level of `src` into `layer`, through the scratch buffer: the
+    // pixels never leave the GPU.
+    void TextureArrays::copyLayer_(unsigned src, unsigned array, int layer, int width, int height) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, scratch_);
+        glBufferData(GL_PIXEL_PACK_BUFFER, std::size_t(width) * height * 4, nullptr, GL_STREAM_COPY);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        const int levels = mipLevels(width, height);
+        for (int level = 0; level < levels; ++level) {
+            const int w = std::max(1, width >> level), h = std::max(1, height >> level);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, scratch_);
+            glBindTexture(GL_TEXTURE_2D, src);
+            glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, scratch_);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, w, h, 1, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Re-specifies the array deeper one level at a time, keeping the old
+    // layers: read the level out, allocate it at the new depth, write it
+    // back. The name, and so every slot handed out, stays valid.
+    void TextureArrays::grow_(int cls, int oldCapacity, int newCapacity) {
+        const TextureLayerTable::Class& c = table_.Classes()[cls];
+        const unsigned array = arrays_[cls];
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, scratch_);
+        glBufferData(GL_PIXEL_PACK_BUFFER, std::size_t(c.width) * c.height * 4 * oldCapacity,
+                     nullptr, GL_STREAM_COPY);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+        const int levels = mipLevels(c.width, c.height);
+        for (int level = 0; level < levels; ++level) {
+            const int w = std::max(1, c.width >> level), h = std::max(1, c.height >> level);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, scratch_);
+            glGetTexImage(GL_TEXTURE_2D_ARRAY, level, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, c.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                         w, h, newCapacity, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, scratch_);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, w, h, oldCapacity,
+                            GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        ++grows_;
+    }
+
+    TextureArrays::Stats TextureArrays::GetStats() const {
+        Stats s;
+        for (const TextureLayerTable::Class& c : table_.Classes()) {
+            if (c.capacity) {
+                ++s.arrays;
+                s.layers += static_cast<uint32_t>(c.layers);
+            }
+            if (c.waiting) ++s.waiting;
+        }
+        s.grows = grows_;
+        return s;
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,135 @@
+#pragma once
+#include "Core.h"
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // Which array layer each texture gets. Textures are grouped into classes
+    // by size and colour space; a class's first texture only waits, and the
+    // array is created when a second one arrives (a lone texture gains
+    // nothing from an array and would just be stored twice). Pure
+    // bookkeeping, no GL: TextureArrays does the copies it asks for.
+    class ENGINE_API TextureLayerTable {
+    public:
+        static constexpr int kInitialLayers = 4;
+
+        struct Slot {
+            int cls = -1;   // -1: not in an array
+            int layer = -1;
+        };
+
+        // What Add needs done, in order: create or grow the class's array
+        // (keeping layers [0, previous capacity)), copy `promoted` into
+        // layer 0, then the added texture into its slot.
+        struct Placement {
+            Slot slot;             // cls -1: the texture stays on its own
+            bool copy = false;     // false for a texture added before
+            unsigned promoted = 0; // the class's waiting texture, now layer 0
+            bool created = false;
+            bool grew = false;
+            int capacity = 0;      // the class's layer capacity after the add
+        };
+
+        struct Class {
+            int width = 0, height = 0;
+            bool srgb = false;
+            int layers = 0;        // in use
+            int capacity = 0;      // allocated; 0 until the array exists
+            unsigned waiting = 0;  // the first texture, until a second arrives
+            std::vector<int> freeLayers; // given back by Remove, reused first
+        };
+
+        explicit TextureLayerTable(int maxLayers = 256) : maxLayers_(maxLayers) {}
+
+        Placement Add(unsigned texture, int width, int height, bool srgb);
+        Slot Find(unsigned texture) const;
+        // Forgets `texture`: its layer goes back to its class for the next
+        // Add, and a waiting texture stops waiting.
+        void Remove(unsigned texture);
+        void Clear();
+
+        const std::vector<Class>& Classes() const { return classes_; }
+        int MaxLayers() const { return maxLayers_; }
+
+    private:
+        int maxLayers_;
+        std::vector<Class> classes_;
+        std::map<std::tuple<int, int, bool>, int> classOf_;
+        std::unordered_map<unsigned, Slot> slots_; // every texture seen, placed or not
+    };
+
+    // Albedo maps in GL_TEXTURE_2D_ARRAYs, one array per size and colour
+    // space, so materials that differ only in their albedo map (recoloured
+    // props) can share a batch key and an instanced draw, each instance
+    // picking its layer.
+    //
+    //   TextureArrays& arrays = TextureArrays::Get();
+    //   arrays.Add(albedoTex);                 // Model::finalize_ does this
+    //   TextureArrays::Slot s = arrays.Find(albedoTex);
+    //   if (s.array) { /* sample s.array at layer s.layer */ }
+    //
+    // A texture is copied into its layer on the GPU (through a pixel buffer,
+    // every mip level), so the original 2D texture stays valid and is what
+    // everything else keeps using. Arrays grow by doubling in place: the GL
+    // name never changes. Only a texture that shares its class with another
+    // is copied; a texture alone in its class costs nothing.
+    //
+    // Add, EnsureContext and the GL work are MAIN THREAD ONLY. Find is also
+    // called by the draw-list builders on workers; it only reads, and Add
+    // never runs during a frame's build.
+    class ENGINE_API TextureArrays {
+    public:
+        struct Slot {
+            unsigned array = 0; // 0: not in an array, sample the 2D texture
+            int layer = 0;
+        };
+
+        struct Stats {
+            uint32_t arrays = 0;  // arrays created
+            uint32_t layers = 0;  // textures copied into them
+            uint32_t waiting = 0; // textures alone in their class
+            uint32_t grows = 0;   // in-place capacity doublings
+        };
+
+        static TextureArrays& Get();
+
+        // Off: Add does nothing, so textures finalized afterwards batch by
+        // their own id again. Default on. For comparisons and tests.
+        static void SetEnabled(bool enabled);
+        static bool Enabled();
+
+        // Registers a mip-mapped RGBA8 / SRGB8_ALPHA8 GL_TEXTURE_2D; size and
+        // format are read back from it. Other formats are ignored.
+        void Add(unsigned texture);
+        Slot Find(unsigned texture) const;
+        // Call BEFORE deleting a registered texture: GL reuses the name, and
+        // a new texture under it would otherwise be found in the old one's
+        // layer (and never copied). The layer is reused by a later Add.
+        void Remove(unsigned texture);
+
+        // Forgets every array when a different context is current than the
+        // one they were made in (tests re-creating windows). Called by Add,
+        // and by Scene::BeginFrame and RenderScene before anything looks a
+        // slot up.
+        void EnsureContext();
+
+        Stats GetStats() const;
+
+    private:
+        TextureArrays() = default;
+        void copyLayer_(unsigned src, unsigned array, int layer, int width, int height);
+        void grow_(int cls, int oldCapacity, int newCapacity);
+
+        TextureLayerTable table_;
+        std::vector<unsigned> arrays_; // per table class; 0 until created
+        void* context_ = nullptr;
+        unsigned scratch_ = 0;         // pixel buffer for the copies
+        uint32_t grows_ = 0;
+    };
+
+} // namespace MyCoreEngine
@@ -0,0 +1,217 @@
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "Components.h"
+#include "Profiler.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        // Dead slots cost a branch each in the per-frame pass; compact once
+        // they are at least half the array (and not just a handful).
+        constexpr std::size_t kCompactMinDead = 64;
+    }
+
+    TransformHierarchy::TransformHierarchy(entt::registry& reg) : reg_(reg) {
+        reg_.on_construct<Transform>().connect<&TransformHierarchy::onTransformAdded_>(*this);
+        reg_.on_destroy<Transform>().connect<&TransformHierarchy::onTransformRemoved_>(*this);
+        reg_.on_construct<Parent>().connect<&TransformHierarchy::onParentSet_>(*this);
+        reg_.on_update<Parent>().connect<&TransformHierarchy::onParentSet_>(*this);
+        reg_.on_destroy<Parent>().connect<&TransformHierarchy::onParentRemoved_>(*this);
+    }
+
+    TransformHierarchy::~TransformHierarchy() {
+        reg_.on_construct<Transform>().disconnect(*this);
+        reg_.on_destroy<Transform>().disconnect(*this);
+        reg_.on_construct<Parent>().disconnect(*this);
+        reg_.on_update<Parent>().disconnect(*this);
+        reg_.on_destroy<Parent>().disconnect(*this);
+    }
+
+    const std::vector<TransformHierarchy::Node>& TransformHierarchy::Order() {
+        if (!stale_ && dead_ >= kCompactMinDead && dead_ * 2 >= nodes_.size()) stale_ = true;
+        if (stale_) rebuild_();
+        return nodes_;
+    }
+
+    const std::vector<uint32_t>& TransformHierarchy::Waves() {
+        if (wavesValid_) return waves_;
+        waves_.clear();
+        waves_.push_back(0);
+        uint32_t start = 0;
+        for (uint32_t i = 0; i < nodes_.size(); ++i) {
+            const Node& n = nodes_[i];
+            // a dead parent slot is no dependency: the node acts as a root
+            if (n.e != entt::null && n.parent != kRoot &&
+                nodes_[n.parent].e != entt::null && uint32_t(n.parent) >= start) {
+                waves_.push_back(i);
+                start = i;
+            }
+        }
+        waves_.push_back(static_cast<uint32_t>(nodes_.size()));
+        wavesValid_ = true;
+        return waves_;
+    }
+
+    TransformHierarchy::Stats TransformHierarchy::stats() const {
+        Stats s = stats_;
+        s.nodes = nodes_.size();
+        s.deadSlots = dead_;
+        return s;
+    }
+
+    int32_t TransformHierarchy::slotOf_(entt::entity e) const {
+        const auto idx = static_cast<std::size_t>(entt::to_entity(e));
+        if (idx >= slotByIndex_.size()) return kRoot;
+        const int32_t s = slotByIndex_[idx];
+        // the index may belong to an older version of the entity
+        return (s != kRoot && nodes_[s].e == e) ? s : kRoot;
+    }
+
+    void TransformHierarchy::setSlot_(entt::entity e, int32_t slot) {
+        const auto idx = static_cast<std::size_t>(entt::to_entity(e));
+        if (idx >= slotByIndex_.size()) slotByIndex_.resize(idx + 1, kRoot);
+        slotByIndex_[idx] = slot;
+    }
+
+    int32_t TransformHierarchy::resolveParent_(entt::entity e) {
+        const auto* p = reg_.try_get<Parent>(e);
+        if (!p || p->value == entt::null) return kRoot;
+        if (!reg_.valid(p->value) || !reg_.all_of<Transform>(p->value)) {
+            awaited_.insert(p->value);
+            return kRoot;
+        }
+        // A parent with a Transform but no slot is stuck in a cycle; only a
+        // rebuild knows what that makes of e.
+        const int32_t s = slotOf_(p->value);
+        if (s == kRoot) stale_ = true;
+        return s;
+    }
+
+    void TransformHierarchy::link_(int32_t slot, int32_t parent) {
+        wavesValid_ = false;
+        nodes_[slot].parent = parent;
+        if (parent != kRoot) ++childCount_[parent];
+    }
+
+    void TransformHierarchy::unlink_(int32_t slot) {
+        const int32_t parent = nodes_[slot].parent;
+        if (parent != kRoot) --childCount_[parent];
+        nodes_[slot].parent = kRoot;
+    }
+
+    // --- signals ----------------------------------------------------------------
+
+    void TransformHierarchy::onTransformAdded_(entt::registry&, entt::entity e) {
+        if (awaited_.erase(e) > 0) stale_ = true; // someone's Parent was waiting for it
+        if (stale_) return;
+        const int32_t parent = resolveParent_(e); // any resolvable parent is already earlier
+        if (stale_) return;
+        const int32_t slot = static_cast<int32_t>(nodes_.size());
+        nodes_.push_back({ e, kRoot });
+        childCount_.push_back(0);
+        setSlot_(e, slot);
+        link_(slot, parent);
+        ++stats_.inPlaceEdits;
+    }
+
+    void TransformHierarchy::onTransformRemoved_(entt::registry&, entt::entity e) {
+        if (stale_) return;
+        const int32_t slot = slotOf_(e);
+        if (slot == kRoot) {
+            // In (or under) a cycle, so never in the order — but removing it
+            // may break the cycle and free entities below it.
+            stale_ = true;
+            return;
+        }
+        // its children fall back to roots; if this entity comes back (undo
+        // resurrects by handle), they have to re-attach
+        if (childCount_[slot] > 0) awaited_.insert(e);
+        unlink_(slot);
+        nodes_[slot].e = entt::null;
+        setSlot_(e, kRoot);
+        wavesValid_ = false;
+        ++dead_;
+        ++stats_.inPlaceEdits;
+    }
+
+    void TransformHierarchy::onParentSet_(entt::registry&, entt::entity e) {
+        if (stale_) return;
+        const int32_t slot = slotOf_(e);
+        if (slot == kRoot) {
+            // No Transform yet (onTransformAdded_ picks the link up), or a
+            // cycle member being re-pointed: only a rebuild can place it.
+            if (reg_.all_of<Transform>(e)) stale_ = true;
+            return;
+        }
+        const int32_t parent = resolveParent_(e);
+        // a later parent would break parent-before-child; itself is a cycle
+        if (parent >= slot) stale_ = true;
+        if (stale_) return;
+        unlink_(slot);
+        link_(slot, parent);
+        ++stats_.inPlaceEdits;
+    }
+
+    void TransformHierarchy::onParentRemoved_(entt::registry&, entt::entity e) {
+        if (stale_) return;
+        const int32_t slot = slotOf_(e);
+        if (slot == kRoot) {
+            if (reg_.all_of<Transform>(e)) stale_ = true; // a cycle member broke free
+            return;
+        }
+        unlink_(slot); // becoming a root never breaks parent-before-child
+        ++stats_.inPlaceEdits;
+    }
+
+    // --- rebuild ----------------------------------------------------------------
+
+    void TransformHierarchy::rebuild_() {
+        CSE_PROFILE_ZONE("TransformHierarchy::rebuild");
+        nodes_.clear();
+        childCount_.clear();
+        awaited_.clear();
+        std::fill(slotByIndex_.begin(), slotByIndex_.end(), kRoot);
+        dead_ = 0;
+
+        // Roots first, children grouped by parent; view order within each,
+        // so the result is deterministic for a given registry.
+        auto view = reg_.view<Transform>();
+        std::unordered_map<entt::entity, std::vector<entt::entity>> children;
+        for (auto e : view) {
+            const auto* p = reg_.try_get<Parent>(e);
+            if (p && p->value != entt::null &&
+                reg_.valid(p->value) && reg_.all_of<Transform>(p->value)) {
+                children[p->value].push_back(e);
+            }
+            else {
+                if (p && p->value != entt::null) awaited_.insert(p->value);
+                const int32_t slot = static_cast<int32_t>(nodes_.size());
+                nodes_.push_back({ e, kRoot });
+                setSlot_(e, slot);
+            }
+        }
+
+        // Breadth-first from the roots: depth-sorted, parents before children.
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            auto it = children.find(nodes_[i].e);
+            if (it == children.end()) continue;
+            for (auto c : it->second) {
+                const int32_t slot = static_cast<int32_t>(nodes_.size());
+                nodes_.push_back({ c, static_cast<int32_t>(i) });
+                setSlot_(c, slot);
+            }
+        }
+        childCount_.assign(nodes_.size(), 0);
+        for (const Node& n : nodes_) {
+            if (n.parent != kRoot) ++childCount_[n.parent];
+        }
+
+        stale_ = false;
+        wavesValid_ = false;
+        ++stats_.rebuilds;
+    }
+
+} // namespace MyCoreEngine
@@ -0,0 +1,122 @@
+#pragma once
+#include "Core.h"
+
+#include <entt/entt.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace MyCoreEngine {
+
+    // The order Scene::UpdateTransforms walks: every entity with a Transform,
+    // parents before their children, kept up to date from registry signals
+    // instead of being re-derived every frame.
+    //
+    //   for (const auto& n : hierarchy_.Order()) {
+    //       if (n.parent == TransformHierarchy::kRoot) ...  // local == world
+    //       else ...  // Order()[n.parent] was visited earlier this pass
+    //   }
+    //
+    // The structure only changes when a Parent link or a Transform comes or
+    // goes, so that is when the work is done; the per-frame pass is one
+    // linear sweep over this array, with no map or stack to build.
+    //
+    // INVARIANT: a node's parent slot is always LOWER than its own slot, so a
+    // single forward pass sees every parent before its children. A rebuild
+    // lays the array out breadth-first (roots, then depth 1, ...). After that
+    // the common edits happen in place, in O(1):
+    // - a new Transform is appended (its parent, if any, is already earlier);
+    // - a Parent removed, or re-pointed at an entity with a LOWER slot, keeps
+    //   the invariant and just rewrites the link;
+    // - a Transform removed (entity destroyed) leaves a dead slot behind. Its
+    //   children keep pointing at it and are treated as roots, exactly like
+    //   any other dangling Parent.
+    // Anything else — re-pointing a Parent at a LATER slot, which is what
+    // moving a subtree under a newer entity looks like — marks the order
+    // stale and the next Order() rebuilds it. So does piling up dead slots.
+    //
+    // A Parent whose target has no Transform (yet) makes the entity a root;
+    // the target is remembered, and if it gains a Transform later (load
+    // order, undo resurrecting entities) the order is rebuilt so the link
+    // takes effect. Entities in a Parent cycle are unreachable from every
+    // root, never enter the order, and freeze.
+    //
+    // Writes that bypass entt's signals (get<Parent>(e).value = x) are not
+    // seen. Go through emplace/replace/patch/remove, as every engine and
+    // editor path does.
+    //
+    // Main thread only, like the registry it listens to. Scene owns one for
+    // its own registry; it must not outlive that registry.
+    class ENGINE_API TransformHierarchy {
+    public:
+        static constexpr int32_t kRoot = -1;
+
+        struct Node {
+            entt::entity e = entt::null; // null: dead slot, skip it
+            int32_t parent = kRoot;      // slot in Order(), always < own slot
+        };
+
+        struct Stats {
+            uint64_t    rebuilds = 0;     // full breadth-first re-sorts
+            uint64_t    inPlaceEdits = 0; // structural changes absorbed without one
+            std::size_t nodes = 0;        // slots, dead ones included
+            std::size_t deadSlots = 0;
+        };
+
+        explicit TransformHierarchy(entt::registry& reg);
+        ~TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+        // Parent-before-child order, rebuilt first if an edit invalidated it.
+        const std::vector<Node>& Order();
+
+        // Order() cut into waves for a parallel pass: wave k is the slot
+        // range [Waves()[k], Waves()[k+1]), and no node in a wave has its
+        // parent in the same wave, so a wave's nodes are independent once
+        // every earlier wave is done. Right after a rebuild the waves are
+        // exactly the depth levels; in-place edits can split a level
+        // further, never merge two. Recomputed only after an edit. Call
+        // Order() first.
+        const std::vector<uint32_t>& Waves();
+
+        // Forces the next Order() to rebuild. For code that has to write
+        // Parent links behind the signals' back.
+        void Invalidate() { stale_ = true; }
+
+        Stats stats() const;
+
+    private:
+        void onTransformAdded_(entt::registry& reg, entt::entity e);
+        void onTransformRemoved_(entt::registry& reg, entt::entity e);
+        void onParentSet_(entt::registry& reg, entt::entity e);
+        void onParentRemoved_(entt::registry& reg, entt::entity e);
+
+        void rebuild_();
+        int32_t slotOf_(entt::entity e) const;
+        void setSlot_(entt::entity e, int32_t slot);
+        // Slot of e's resolvable parent, or kRoot. A link to an entity with
+        // no Transform is remembered in awaited_; one into a cycle marks the
+        // order stale.
+        int32_t resolveParent_(entt::entity e);
+        void link_(int32_t slot, int32_t parent);
+        void unlink_(int32_t slot);
+
+        entt::registry& reg_;
+        std::vector<Node> nodes_;
+        std::vector<uint32_t> childCount_; // live links per slot
+        std::vector<int32_t> slotByIndex_; // by entt::to_entity(e); -1 = absent
+        // Parent targets that have no Transform right now; gaining one
+        // requires a rebuild so their children attach.
+        std::unordered_set<entt::entity> awaited_;
+        std::vector<uint32_t> waves_;
+        std::size_t dead_ = 0;
+        bool stale_ = true;
+        bool wavesValid_ = false;
+        Stats stats_;
+    };
+
+} // namespace MyCoreEngine
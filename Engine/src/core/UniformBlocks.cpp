@@ -0,0 +1,112 @@
+#include <glad/glad.h>
+#include "UniformBlocks.h"
+
+#include <GLFW/glfw3.h>
+
+#include <cstring>
+#include <utility>
+
+#include "Material.h"
+
+namespace MyCoreEngine {
+
+    namespace {
+        // main thread only, like every UniformBuffer
+        UniformBuffer::Stats sStats;
+        bool sSkipUnchanged = true;
+    } // namespace
+
+    MaterialBlockData PackMaterialBlock(const Material& m) {
+        MaterialBlockData b;
+        b.baseColor = m.baseColor;
+        b.metallic = m.metallic;
+        b.emissive = m.emissive;
+        b.roughness = m.roughness;
+        b.ao = m.ao;
+        b.shadingModel = static_cast<int>(m.shadingModel);
+        if (m.shadingModel == ShadingModel::Toon) {
+            b.toonBands = static_cast<float>(m.toonBands);
+            b.toonSpecStrength = m.toonSpecStrength;
+            b.toonSpecSize = m.toonSpecSize;
+            b.toonRimStrength = m.toonRimStrength;
+        }
+        if (m.alphaMode != AlphaMode::Opaque) {
+            b.alphaMode = static_cast<int>(m.alphaMode);
+            b.opacity = m.opacity;
+            b.alphaCutoff = m.alphaCutoff;
+        }
+        b.hasNormalMap = m.hasNormal() ? 1 : 0;
+        b.hasMetallicMap = m.hasMetallic() ? 1 : 0;
+        b.hasRoughnessMap = m.hasRoughness() ? 1 : 0;
+        b.hasAOMap = m.hasAO() ? 1 : 0;
+        return b;
+    }
+
+    UniformBuffer::~UniformBuffer() {
+        if (buffer_ && glfwGetCurrentContext() == context_) glDeleteBuffers(1, &buffer_);
+    }
+
+    UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, 0u)),
+          context_(std::exchange(other.context_, nullptr)),
+          contents_(std::move(other.contents_)) {}
+
+    UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+        if (this != &other) {
+            if (buffer_ && glfwGetCurrentContext() == context_) glDeleteBuffers(1, &buffer_);
+            buffer_ = std::exchange(other.buffer_, 0u);
+            context_ = std::exchange(other.context_, nullptr);
+            contents_ = std::move(other.contents_);
+        }
+        return *this;
+    }
+
+    bool UniformBuffer::Bind(unsigned binding, const void* data, std::size_t bytes) {
+        void* context = glfwGetCurrentContext();
+        if (context != context_) {
+            // our buffer went with another context
+            context_ = context;
+            buffer_ = 0;
+        }
+        ++sStats.binds;
+        bool upload = false;
+        if (!buffer_) {
+            glGenBuffers(1, &buffer_);
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+            glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_DYNAMIC_DRAW);
+            upload = true;
+        }
+        else if (!sSkipUnchanged || contents_.size() != bytes ||
+                 std::memcmp(contents_.data(), data, bytes) != 0) {
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer_);
+            if (contents_.size() == bytes) {
+                glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(bytes), data);
+            }
+            else {
+                glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_DYNAMIC_DRAW);
+            }
+            upload = true;
+        }
+        if (upload) {
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+            const auto* p = static_cast<const unsigned char*>(data);
+            contents_.assign(p, p + bytes);
+            ++sStats.uploads;
+        }
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer_);
+        return upload;
+    }
+
+    void UniformBuffer::Release() {
+        if (buffer_) glDeleteBuffers(1, &buffer_);
+        buffer_ = 0;
+        context_ = nullptr;
+        contents_.clear();
+    }
+
+    UniformBuffer::Stats UniformBuffer::GetStats() { return sStats; }
+    void UniformBuffer::ResetStats() { sStats = Stats{}; }
+    void UniformBuffer::SetSkipUnchanged(bool enabled) { sSkipUnchanged = enabled; }
+    bool UniformBuffer::SkipUnchanged() { return sSkipUnchanged; }
+
+} // namespace MyCoreEngine
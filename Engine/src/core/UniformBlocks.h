@@ -0,0 +1,119 @@
+#pragma once
+#include "Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace MyCoreEngine {
+
+    struct Material;
+
+    // The forward shader's state that changes per frame, as its FrameGlobals
+    // uniform block (frag.glsl), member for member in std140 layout: a vec3
+    // shares its 16 bytes with the float after it, and the per-cascade
+    // scalars are vec4s the shader indexes. The forward passes fill the
+    // cascade fields and the IBL mip count; Scene fills the camera, the sun
+    // and the switches, and uploads it once per frame.
+    struct FrameGlobalsBlock {
+        static constexpr unsigned kBinding = 4;
+
+        glm::mat4  lightVP[4]{};          // uLightVP
+        glm::vec4  csmSplits{ 0.f };      // uCSMSplits: view-space far of each cascade
+        glm::vec4  cascadeTexel{ 0.f };   // uCascadeTexel: 1 / cascade resolution
+        glm::ivec4 cascadeKernel{ 0 };    // uCascadeKernel: PCF radius per cascade
+        glm::vec3  camPos{ 0.f };         float lightIntensity = 0.f;
+        glm::vec3  lightDir{ 0.f };       float iblIntensity = 0.f;
+        glm::vec3  lightColor{ 0.f };     float prefilterMipCount = 0.f;
+        float splitBlend = 0.f;
+        float shadowBiasConst = 0.f;
+        float shadowBiasSlope = 0.f;
+        int   cascadeCount = 0;
+        int   shadowsOn = 0;
+        int   csmDebug = 0;
+        int   usePBR = 0;
+        int   useIBL = 0;
+        int   normalMapEnabled = 0;
+        int   useMetallicMap = 0;
+        int   useRoughnessMap = 0;
+        int   useAOMap = 0;
+        int   useClusters = 0;
+        int   numLights = 0;               // the array path's live lights
+        int   pad_[2] = {};
+    };
+    static_assert(sizeof(FrameGlobalsBlock) == 416, "FrameGlobals is 416 bytes in std140");
+
+    // A material's scalars as the shader's MaterialBlock. Packed with the
+    // same gating as the batch key (Scene::texKeyFromMaterial_): toon
+    // parameters only for Toon, alpha parameters only for non-opaque, so
+    // materials sharing a key pack to the same bytes.
+    struct MaterialBlockData {
+        static constexpr unsigned kBinding = 5;
+
+        glm::vec3 baseColor{ 1.f };       float metallic = 0.f;
+        glm::vec3 emissive{ 0.f };        float roughness = 0.f;
+        float ao = 1.f;
+        float opacity = 1.f;
+        float alphaCutoff = 0.f;
+        float toonBands = 0.f;
+        float toonSpecStrength = 0.f;
+        float toonSpecSize = 0.f;
+        float toonRimStrength = 0.f;
+        int   shadingModel = 0;
+        int   alphaMode = 0;
+        int   hasNormalMap = 0;
+        int   hasMetallicMap = 0;
+        int   hasRoughnessMap = 0;
+        int   hasAOMap = 0;
+        int   pad_[3] = {};
+    };
+    static_assert(sizeof(MaterialBlockData) == 96, "MaterialBlock is 96 bytes in std140");
+
+    ENGINE_API MaterialBlockData PackMaterialBlock(const Material& m);
+
+    // One uniform buffer holding one block. Bind uploads only when the bytes
+    // differ from the last upload, so a material or a frame that did not
+    // change costs a glBindBufferBase and a compare.
+    //
+    // A copy starts without a buffer (materials are copied to make them
+    // unique; the copy must not write into the original's). Created on the
+    // first Bind, in the context current then; forgotten if a different
+    // context is current later, like StreamBuffer.
+    //
+    // MAIN THREAD ONLY (GL).
+    class ENGINE_API UniformBuffer {
+    public:
+        struct Stats {
+            uint64_t uploads = 0; // Binds that changed the contents
+            uint64_t binds = 0;
+        };
+
+        UniformBuffer() = default;
+        ~UniformBuffer(); // deletes the buffer only while its context is current
+        UniformBuffer(const UniformBuffer&) {}
+        UniformBuffer& operator=(const UniformBuffer&) { return *this; }
+        UniformBuffer(UniformBuffer&& other) noexcept;
+        UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+        // Uploads `bytes` if they changed, then binds the buffer at `binding`
+        // of GL_UNIFORM_BUFFER. Returns whether it uploaded.
+        bool Bind(unsigned binding, const void* data, std::size_t bytes);
+        // Deletes the buffer (context current). The next Bind starts over.
+        void Release();
+
+        // Every UniformBuffer together, since the last reset.
+        static Stats GetStats();
+        static void ResetStats();
+        // Off: every Bind uploads, changed or not. Default on. For
+        // comparisons and tests.
+        static void SetSkipUnchanged(bool enabled);
+        static bool SkipUnchanged();
+
+    private:
+        unsigned buffer_ = 0;
+        void* context_ = nullptr;
+        std::vector<unsigned char> contents_; // what the buffer holds
+    };
+
+} // namespace MyCoreEngine
@@ -0,0 +1,105 @@
+// Engine/src/render/GpuTimers.cpp
+#include <glad/glad.h>
+#include "GpuTimers.h"
+
+#include "../core/GLInit.h"
+
+namespace {
+    // Weight of the newest frame in avgMs: settles in a few dozen frames, and
+    // holds still enough to read in an overlay.
+    constexpr float kSmoothing = 0.1f;
+}
+
+GpuTimers::~GpuTimers() {
+    for (Frame& f : frames_) {
+        if (!f.queries.empty()) glDeleteQueries(GLsizei(f.queries.size()), f.queries.data());
+    }
+}
+
+bool GpuTimers::Supported() {
+    return MyCoreEngine::GetGLCaps().timerQuery;
+}
+
+void GpuTimers::SetEnabled(bool on) {
+    enabled_ = on;
+    if (!on) {
+        for (Frame& f : frames_) f.pending = false; // stale by the time it is back on
+        last_.clear();
+        averages_.clear();
+    }
+}
+
+bool GpuTimers::ready_(const Frame& f) const {
+    if (f.used == 0) return true;
+    // queries finish in order: the last one in means they all are
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv(f.queries[size_t(f.used - 1)], GL_QUERY_RESULT_AVAILABLE, &available);
+    return available == GL_TRUE;
+}
+
+void GpuTimers::publish_(Frame& f) {
+    last_.clear();
+    for (int i = 0; i < f.used; ++i) {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(f.queries[size_t(i)], GL_QUERY_RESULT, &ns);
+        GpuPassTime t;
+        t.name = f.names[size_t(i)];
+        t.ms = float(double(ns) * 1e-6);
+        GpuPassTime* avg = nullptr;
+        for (GpuPassTime& a : averages_) if (a.name == t.name) { avg = &a; break; }
+        if (avg) avg->avgMs += (t.ms - avg->avgMs) * kSmoothing;
+        else averages_.push_back({ t.name, t.ms, t.ms });
+        t.avgMs = avg ? avg->avgMs : t.ms;
+        last_.push_back(t);
+    }
+    f.pending = false;
+}
+
+void GpuTimers::BeginFrame() {
+    recording_ = false;
+    if (!enabled_ || !Supported()) return;
+
+    // Oldest first, so the newest frame read back is the one left in last_.
+    // The oldest is the frame whose slot this one reuses: in, or dropped.
+    for (uint64_t back = kFrames; back >= 1; --back) {
+        if (frame_ < back) continue;
+        Frame& f = frames_[size_t((frame_ - back) % kFrames)];
+        if (!f.pending) continue;
+        if (ready_(f)) publish_(f);
+        else if (back == kFrames) { f.pending = false; ++dropped_; }
+        else break; // the newer ones are further behind still
+    }
+
+    Frame& cur = frames_[size_t(frame_ % kFrames)];
+    cur.used = 0;
+    cur.names.clear();
+    cur.pending = true;
+    recording_ = true;
+    ++frame_;
+}
+
+void GpuTimers::Begin(const char* name) {
+    if (!recording_ || open_) return;
+    Frame& f = frames_[size_t((frame_ - 1) % kFrames)];
+    if (size_t(f.used) == f.queries.size()) {
+        GLuint q = 0;
+        glGenQueries(1, &q);
+        f.queries.push_back(q);
+    }
+    f.names.push_back(name);
+    glBeginQuery(GL_TIME_ELAPSED, f.queries[size_t(f.used)]);
+    open_ = true;
+}
+
+void GpuTimers::End() {
+    if (!open_) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    ++frames_[size_t((frame_ - 1) % kFrames)].used;
+    open_ = false;
+}
+
+float GpuTimers::LastTotalMs() const {
+    float total = 0.0f;
+    for (const GpuPassTime& t : last_) total += t.ms;
+    return total;
+}
@@ -0,0 +1,74 @@
+// Engine/src/render/GpuTimers.h
+#pragma once
+#include "../core/Core.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What one pass cost the GPU.
+struct GpuPassTime {
+    const char* name = nullptr; // the pass's name(): static storage
+    float ms = 0.0f;            // in the frame read back
+    float avgMs = 0.0f;         // smoothed over the frames it ran in
+};
+
+// GPU time per render pass, from GL_TIME_ELAPSED queries around each pass's
+// execute. A query's result is ready only once the GPU has got that far, so
+// asking for it in the same frame would stall the CPU until the GPU caught
+// up. Each frame's queries are kept instead and read kFrames - 1 frames
+// later at the most, when they are ready: Last() describes a frame or two
+// ago, never this one. A frame whose results are still not in when its
+// queries come round again is dropped rather than waited for (Dropped()).
+//
+// Without timer queries (GetGLCaps().timerQuery) every call does nothing and
+// Last() stays empty. Queries of this kind cannot nest, so a pass must not
+// start its own. MAIN THREAD ONLY (GL).
+class ENGINE_API GpuTimers {
+public:
+    static constexpr int kFrames = 3;
+
+    GpuTimers() = default;
+    ~GpuTimers(); // frees the queries: needs the context still current
+    GpuTimers(const GpuTimers&) = delete;
+    GpuTimers& operator=(const GpuTimers&) = delete;
+
+    // On by default. Off costs nothing per pass and empties Last().
+    void SetEnabled(bool on);
+    bool Enabled() const { return enabled_; }
+    // Whether the context has timer queries at all.
+    static bool Supported();
+
+    // Starts a frame: publishes the oldest frames whose results are in.
+    void BeginFrame();
+    // Around one pass. `name` must have static storage, as a profiler zone's.
+    void Begin(const char* name);
+    void End();
+
+    // The newest frame read back, passes in the order they ran.
+    const std::vector<GpuPassTime>& Last() const { return last_; }
+    // Last()'s passes summed.
+    float LastTotalMs() const;
+    // Frames dropped because their results were late.
+    unsigned Dropped() const { return dropped_; }
+
+private:
+    struct Frame {
+        std::vector<unsigned> queries;   // grown on demand, reused
+        std::vector<const char*> names;  // per query used this frame
+        int used = 0;
+        bool pending = false;            // recorded and not read back yet
+    };
+    bool ready_(const Frame& f) const;
+    void publish_(Frame& f);
+
+    std::array<Frame, kFrames> frames_;
+    uint64_t frame_ = 0;     // BeginFrame calls so far
+    bool enabled_ = true;
+    bool recording_ = false; // this frame's queries are being issued
+    bool open_ = false;      // between Begin and End
+    std::vector<GpuPassTime> last_;
+    std::vector<GpuPassTime> averages_; // by name, across frames
+    unsigned dropped_ = 0;
+};
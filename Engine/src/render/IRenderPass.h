@@ -7,6 +7,7 @@
 #include "../src/core/Shader.h"
 #include "../src/core/Camera.h"  // for ENGINE_API
 #include "../src/core/Scene.h"
+#include "RenderGraph.h"
 
 // Forward decls to avoid heavy includes
 
@@ -40,6 +41,13 @@ struct IBLSnapshot {
     float mipCount = 0.0f;
 };
 
+// The per-pixel LDR effects PostUberPass can run as one pass, as bits.
+enum PostEffect : unsigned {
+    kPostOutline    = 1u << 0,
+    kPostColorGrade = 1u << 1,
+    kPostVignette   = 1u << 2,
+};
+
 // Things the renderer already owns & sets up each frame.
 struct PassContext {
     // GL targets
@@ -48,42 +56,30 @@ struct PassContext {
     unsigned hdrColorTex{ 0 };
     unsigned hdrDepthTex{ 0 };  // sampleable scene depth (DEPTH_COMPONENT24)
 
-    // --- LDR post-process chain (ping-pong) ---
-    // After tonemapping, an arbitrary number of full-screen LDR (gamma-space)
-    // effects can run -- vignette, colour grade, depth outline, FXAA, ... They
-    // bounce colour between two buffers A and B via nextPostTarget(); the LAST
-    // enabled one resolves to defaultFBO. When none are enabled, tonemap writes
-    // straight to defaultFBO and neither buffer is touched (nor allocated), so
-    // a project using no post pays nothing. The Renderer sets postPassesLeft to
-    // the count of enabled LDR passes each frame and seeds postSrcTex = ldrTex_A
-    // (tonemap's first target); each pass decrements as it consumes a slot.
-    unsigned ldrFBO_A{ 0 }, ldrTex_A{ 0 };
-    unsigned ldrFBO_B{ 0 }, ldrTex_B{ 0 };
-    int      postPassesLeft{ 0 };
-    unsigned postSrcTex{ 0 };
-
-    // Where TonemapPass writes: buffer A if any LDR post pass follows this
-    // frame, else the final output.
-    unsigned tonemapTarget() const { return postPassesLeft > 0 ? ldrFBO_A : defaultFBO; }
-
-    struct PostTarget { unsigned srcTex{ 0 }; unsigned dstFBO{ 0 }; bool isFinal{ false }; };
-    // Called by each enabled LDR post pass: returns the texture to sample and
-    // the FBO to draw into, advancing the ping-pong. The final pass (nothing
-    // left after it) resolves to defaultFBO.
-    PostTarget nextPostTarget() {
-        PostTarget t;
-        t.srcTex = postSrcTex;
-        --postPassesLeft;
-        t.isFinal = (postPassesLeft <= 0);
-        if (t.isFinal) {
-            t.dstFBO = defaultFBO;
-        } else {
-            const bool srcIsA = (postSrcTex == ldrTex_A);
-            t.dstFBO   = srcIsA ? ldrFBO_B : ldrFBO_A;
-            postSrcTex = srcIsA ? ldrTex_B : ldrTex_A;
-        }
-        return t;
-    }
+    // --- The frame's render graph ---
+    // The pipeline imports the output, the HDR target and the shadow maps
+    // into `graph` each frame, then each enabled pass declares what it reads
+    // and writes (IRenderPass::declare). `res` is where a pass finds what the
+    // passes before it produced: after tonemapping `ldr` is the LDR
+    // (gamma-space) colour, and each post pass -- outline, grade, vignette,
+    // FXAA, ... -- reads it and replaces it with a target of its own. The
+    // pipeline presents the last one as the output, so the last enabled pass
+    // draws into defaultFBO, and with no post pass tonemap does.
+    RenderGraph* graph{ nullptr };
+    struct FrameResources {
+        RenderGraph::Resource output = RenderGraph::kNone;
+        RenderGraph::Resource hdr = RenderGraph::kNone;
+        RenderGraph::Resource shadows = RenderGraph::kNone;
+        RenderGraph::Resource ldr = RenderGraph::kNone;
+        // PostEffect bits a fused pass (PostUberPass) already applied this
+        // frame; their own passes are then not enabled.
+        unsigned fusedPost = 0;
+    } res;
+
+    // What a declared resource is this frame. Without a graph (a pass driven
+    // by hand) every output is defaultFBO.
+    unsigned fbo(RenderGraph::Resource r) const { return graph ? graph->Fbo(r) : defaultFBO; }
+    unsigned texture(RenderGraph::Resource r) const { return graph ? graph->Texture(r) : 0u; }
 
     // Fullscreen quad for post
     unsigned fsQuadVAO{ 0 };
@@ -123,21 +119,21 @@ struct IRenderPass {
     // Do the pass's work; return true if you drew something
     virtual bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) = 0;
 
-    // Does this pass consume an LDR ping-pong slot this frame?
-    //
-    // The Renderer counts these into postPassesLeft BEFORE the chain runs, and
-    // nextPostTarget() gives the final slot to whoever takes the last one. So a
-    // pass that runs without being counted, or is counted and then declines,
-    // desyncs the routing -- and if the count is too HIGH nothing ever reaches
-    // isFinal, so the finished frame is left in an off-screen buffer and the
-    // window shows the clear colour. A post shader that failed to compile used
-    // to do exactly that: the count asked only whether the effect was enabled.
-    //
-    // Overriding this instead of restating the predicate in the Renderer is
-    // what makes the two impossible to disagree. It must NOT consult ldrTex_A:
-    // the count runs before the buffers are (re)allocated, and the empty-chain
-    // case is handled once, globally, by postPassesLeft = 0.
-    virtual bool wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene&) const {
-        return false;
-    }
+    // Will this pass run this frame? A disabled pass is not declared at all,
+    // so the chain routes around it: the next post pass reads what the one
+    // before it wrote. Asked of the pass rather than restated by the
+    // Renderer, so it covers everything execute() needs -- a post shader
+    // that failed to compile, the outline's scene depth -- and a pass that
+    // declines is never handed the output.
+    virtual bool enabled(const PassContext&, const MyCoreEngine::Scene&) const { return true; }
+
+    // Declares what execute() reads and writes, through `b` and ctx.res.
+    // Runs each frame the pass is enabled, before any pass executes. A pass
+    // that writes nothing imported, and nothing a later pass reads, is culled.
+    virtual void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) = 0;
 };
+
+// The size of the frame's full-resolution post targets.
+inline TargetDesc ldrTargetDesc(const FrameParams& fp) {
+    return TargetDesc{ fp.viewportW, fp.viewportH, TargetDesc::Format::RGBA8 };
+}
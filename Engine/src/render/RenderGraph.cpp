@@ -0,0 +1,225 @@
+// Engine/src/render/RenderGraph.cpp
+#include <glad/glad.h>
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+RenderGraph::Resource RenderGraph::PassBuilder::Create(const char* name, const TargetDesc& desc) {
+    Res r;
+    r.name = name;
+    r.desc = desc;
+    graph_->resources_.push_back(r);
+    const Resource id = Resource(graph_->resources_.size() - 1);
+    Write(id);
+    return id;
+}
+
+void RenderGraph::PassBuilder::Read(Resource r) {
+    if (r != kNone) graph_->passes_[size_t(pass_)].reads.push_back(r);
+}
+
+void RenderGraph::PassBuilder::Write(Resource r) {
+    if (r != kNone) graph_->passes_[size_t(pass_)].writes.push_back(r);
+}
+
+void RenderGraph::Reset() {
+    resources_.clear();
+    passes_.clear();
+    order_.clear();
+    slotDescs_.clear();
+}
+
+RenderGraph::Resource RenderGraph::Import(const char* name, unsigned fbo, unsigned texture) {
+    Res r;
+    r.name = name;
+    r.imported = true;
+    r.fbo = fbo;
+    r.texture = texture;
+    resources_.push_back(r);
+    return Resource(resources_.size() - 1);
+}
+
+RenderGraph::PassBuilder RenderGraph::AddPass(const char* name) {
+    Pass p;
+    p.name = name;
+    passes_.push_back(std::move(p));
+    return PassBuilder(*this, int(passes_.size() - 1));
+}
+
+void RenderGraph::Present(Resource transient, Resource imported) {
+    if (transient == kNone || imported == kNone || transient == imported) return;
+    if (resources_[size_t(transient)].imported) return; // nothing drew a transient
+    resources_[size_t(transient)].presentAs = imported;
+}
+
+RenderGraph::Resource RenderGraph::root_(Resource r) const {
+    while (r != kNone && resources_[size_t(r)].presentAs != kNone) r = resources_[size_t(r)].presentAs;
+    return r;
+}
+
+void RenderGraph::Compile() {
+    order_.clear();
+    slotDescs_.clear();
+    for (Res& r : resources_) { r.slot = -1; r.first = r.last = -1; }
+
+    // Liveness, walking back from the passes with an effect outside the
+    // graph. A transient is wanted once a live pass reads it; its writers
+    // are then live too. Every dependency points back in declaration order,
+    // so one backward walk reaches the fixpoint.
+    std::vector<bool> wanted(resources_.size(), false);
+    for (size_t i = passes_.size(); i-- > 0;) {
+        Pass& p = passes_[i];
+        p.live = false;
+        for (Resource w : p.writes) {
+            const Resource r = root_(w);
+            if (resources_[size_t(r)].imported || wanted[size_t(r)]) { p.live = true; break; }
+        }
+        if (!p.live) continue;
+        for (Resource rd : p.reads) wanted[size_t(root_(rd))] = true;
+    }
+
+    // Declaration order already satisfies every hazard (a pass can only name
+    // what was declared before it), so the live passes in that order are a
+    // topological order of the graph.
+    for (size_t i = 0; i < passes_.size(); ++i) {
+        if (passes_[i].live) order_.push_back(int(i));
+    }
+
+    // Lifetimes of the transients, as positions in the order.
+    for (int pos = 0; pos < int(order_.size()); ++pos) {
+        const Pass& p = passes_[size_t(order_[size_t(pos)])];
+        auto touch = [&](Resource r) {
+            Res& res = resources_[size_t(root_(r))];
+            if (res.imported) return;
+            if (res.first < 0) res.first = pos;
+            res.last = pos;
+        };
+        for (Resource r : p.reads) touch(r);
+        for (Resource r : p.writes) touch(r);
+    }
+
+    // Slots: first come, first served, each transient taking the lowest
+    // slot of its desc whose last user ran before its first. A pass reading
+    // one transient and writing another never gets them in one slot.
+    std::vector<Resource> live;
+    for (Resource r = 0; r < Resource(resources_.size()); ++r) {
+        const Res& res = resources_[size_t(r)];
+        if (!res.imported && res.presentAs == kNone && res.first >= 0) live.push_back(r);
+    }
+    std::stable_sort(live.begin(), live.end(), [&](Resource a, Resource b) {
+        return resources_[size_t(a)].first < resources_[size_t(b)].first;
+    });
+    std::vector<int> slotLast;
+    for (Resource r : live) {
+        Res& res = resources_[size_t(r)];
+        for (int s = 0; s < int(slotDescs_.size()); ++s) {
+            if (slotDescs_[size_t(s)] == res.desc && slotLast[size_t(s)] < res.first) {
+                res.slot = s;
+                break;
+            }
+        }
+        if (res.slot < 0) {
+            res.slot = int(slotDescs_.size());
+            slotDescs_.push_back(res.desc);
+            slotLast.push_back(-1);
+        }
+        slotLast[size_t(res.slot)] = res.last;
+    }
+    slots_.assign(slotDescs_.size(), Slot{});
+}
+
+int RenderGraph::SlotOf(Resource r) const {
+    if (r == kNone) return -1;
+    return resources_[size_t(root_(r))].slot;
+}
+
+void RenderGraph::BindSlot(int slot, unsigned fbo, unsigned texture) {
+    if (slot < 0 || slot >= int(slots_.size())) return;
+    slots_[size_t(slot)] = Slot{ fbo, texture };
+}
+
+unsigned RenderGraph::Fbo(Resource r) const {
+    if (r == kNone) return 0;
+    const Res& res = resources_[size_t(root_(r))];
+    if (res.imported) return res.fbo;
+    return res.slot >= 0 ? slots_[size_t(res.slot)].fbo : 0u;
+}
+
+unsigned RenderGraph::Texture(Resource r) const {
+    if (r == kNone) return 0;
+    const Res& res = resources_[size_t(root_(r))];
+    if (res.imported) return res.texture;
+    return res.slot >= 0 ? slots_[size_t(res.slot)].texture : 0u;
+}
+
+// ---------------------------------------------------------------------------
+
+TransientTargets::~TransientTargets() { Release(); }
+
+void TransientTargets::Release() {
+    for (Target& t : targets_) {
+        if (t.texture) glDeleteTextures(1, &t.texture);
+        if (t.fbo) glDeleteFramebuffers(1, &t.fbo);
+    }
+    targets_.clear();
+}
+
+void TransientTargets::Realize(RenderGraph& graph) {
+    const std::vector<TargetDesc>& slots = graph.Slots();
+    std::vector<Target> next;
+    next.reserve(slots.size());
+    std::vector<bool> taken(targets_.size(), false);
+    for (const TargetDesc& desc : slots) {
+        Target t;
+        for (size_t i = 0; i < targets_.size(); ++i) {
+            if (!taken[i] && targets_[i].desc == desc) {
+                taken[i] = true;
+                t = targets_[i];
+                break;
+            }
+        }
+        if (!t.fbo) {
+            // RGBA8 for the post chain: gamma-encoded already, and deliberately
+            // NOT sRGB, or sampling would linearise it and FXAA would compare
+            // linear values against perceptual thresholds. RGBA16F for HDR
+            // intermediates. CLAMP_TO_EDGE because post effects sample past
+            // the border, and wrapping pulls the far edge in as a fringe.
+            t.desc = desc;
+            const bool hdr = desc.format == TargetDesc::Format::RGBA16F;
+            glGenFramebuffers(1, &t.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, t.fbo);
+            glGenTextures(1, &t.texture);
+            glBindTexture(GL_TEXTURE_2D, t.texture);
+            glTexImage2D(GL_TEXTURE_2D, 0, hdr ? GL_RGBA16F : GL_RGBA8,
+                         std::max(1, desc.width), std::max(1, desc.height), 0, GL_RGBA,
+                         hdr ? GL_FLOAT : GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.texture, 0);
+            if (const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER); status != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "ERROR::transient target incomplete, status 0x" << std::hex << status << std::dec << std::endl;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+        graph.BindSlot(int(next.size()), t.fbo, t.texture);
+        next.push_back(t);
+    }
+    for (size_t i = 0; i < targets_.size(); ++i) {
+        if (taken[i]) continue;
+        glDeleteTextures(1, &targets_[i].texture);
+        glDeleteFramebuffers(1, &targets_[i].fbo);
+    }
+    targets_ = std::move(next);
+}
+
+std::size_t TransientTargets::Bytes() const {
+    std::size_t bytes = 0;
+    for (const Target& t : targets_) {
+        const std::size_t texel = t.desc.format == TargetDesc::Format::RGBA16F ? 8 : 4;
+        bytes += std::size_t(std::max(1, t.desc.width)) * std::size_t(std::max(1, t.desc.height)) * texel;
+    }
+    return bytes;
+}
@@ -0,0 +1,144 @@
+// Engine/src/render/RenderGraph.h
+#pragma once
+#include "../core/Core.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// What a transient target is: two of the same desc can share one texture.
+struct TargetDesc {
+    enum class Format : uint8_t { RGBA8, RGBA16F };
+    int width = 0, height = 0;
+    Format format = Format::RGBA8;
+
+    bool operator==(const TargetDesc& o) const {
+        return width == o.width && height == o.height && format == o.format;
+    }
+    bool operator!=(const TargetDesc& o) const { return !(*this == o); }
+};
+
+// One frame's passes as a graph over the targets they read and write.
+// Rebuilt every frame: the pipeline declares each enabled pass in turn, then
+// Compile works out which passes matter, what order they run in and which
+// transient targets can share a texture. Pure bookkeeping, no GL:
+// TransientTargets makes the textures, and Fbo/Texture hand them to the
+// passes while they execute.
+//
+// Resources are imported (the output, the HDR target, the shadow maps: owned
+// elsewhere, live all frame) or transient (created by a pass, made by the
+// graph for the span of passes that use them). Hazards are taken in
+// declaration order, as a pass's declarations can only name what earlier
+// passes produced: a read follows the last write, a write follows the last
+// write and every read since. Each pass runs after the passes it depends on.
+//
+// A pass survives Compile when it writes an imported resource, or a
+// transient a surviving pass reads; the rest are culled. Transients of the
+// same desc whose lifetimes do not overlap share a slot: the post chain's
+// stage outputs fold into two textures, or one when a single stage feeds
+// the last.
+class ENGINE_API RenderGraph {
+public:
+    using Resource = int;
+    static constexpr Resource kNone = -1;
+
+    // Declares one pass's accesses. Handed out by AddPass.
+    class PassBuilder {
+    public:
+        // A new transient, written by this pass.
+        Resource Create(const char* name, const TargetDesc& desc);
+        void Read(Resource r);
+        void Write(Resource r);
+    private:
+        friend class RenderGraph;
+        PassBuilder(RenderGraph& g, int pass) : graph_(&g), pass_(pass) {}
+        RenderGraph* graph_;
+        int pass_;
+    };
+
+    // Drops every pass and resource; the physical slots are kept.
+    void Reset();
+    // `name` must outlive the frame (a literal).
+    Resource Import(const char* name, unsigned fbo, unsigned texture);
+    PassBuilder AddPass(const char* name);
+    // From here on `transient` is `imported`: its writers write the imported
+    // target instead. The post chain's last stage writes the output this way.
+    // Called once all passes are declared; resolved by Compile. An imported
+    // `transient` is left as it is.
+    void Present(Resource transient, Resource imported);
+
+    // Culls, orders, and assigns each live transient a slot.
+    void Compile();
+
+    // After Compile: the live passes, in execution order, as AddPass indices.
+    const std::vector<int>& Order() const { return order_; }
+    bool Culled(int pass) const { return !passes_[size_t(pass)].live; }
+    int  PassCount() const { return int(passes_.size()); }
+    const char* PassName(int pass) const { return passes_[size_t(pass)].name; }
+    const char* ResourceName(Resource r) const { return resources_[size_t(r)].name; }
+
+    // After Compile: one desc per slot the frame needs.
+    const std::vector<TargetDesc>& Slots() const { return slotDescs_; }
+    // The slot a transient was given (-1 if imported, presented or unused).
+    int SlotOf(Resource r) const;
+    // [first, last] positions in Order() the transient is used at.
+    int FirstUse(Resource r) const { return resources_[size_t(r)].first; }
+    int LastUse(Resource r) const { return resources_[size_t(r)].last; }
+
+    // Set by TransientTargets once the slots exist.
+    void BindSlot(int slot, unsigned fbo, unsigned texture);
+    // What a pass renders into / samples for a resource. 0 for kNone.
+    unsigned Fbo(Resource r) const;
+    unsigned Texture(Resource r) const;
+
+private:
+    struct Res {
+        const char* name = "";
+        bool imported = false;
+        TargetDesc desc{};
+        unsigned fbo = 0, texture = 0; // imported only
+        Resource presentAs = kNone;
+        int slot = -1;
+        int first = -1, last = -1;
+    };
+    struct Pass {
+        const char* name = "";
+        std::vector<Resource> reads, writes;
+        bool live = false;
+    };
+    struct Slot { unsigned fbo = 0, texture = 0; };
+
+    Resource root_(Resource r) const;
+
+    std::vector<Res> resources_;
+    std::vector<Pass> passes_;
+    std::vector<int> order_;
+    std::vector<TargetDesc> slotDescs_;
+    std::vector<Slot> slots_;
+};
+
+// The textures behind a RenderGraph's slots: one RGBA8 or RGBA16F colour
+// target each, linear and clamped, matched to the slots by desc every frame.
+// A target no slot asked for this frame is deleted, so a post chain switched
+// off or a resize frees its memory at once.
+//
+// MAIN THREAD ONLY (GL), context current.
+class ENGINE_API TransientTargets {
+public:
+    TransientTargets() = default;
+    ~TransientTargets();
+    TransientTargets(const TransientTargets&) = delete;
+    TransientTargets& operator=(const TransientTargets&) = delete;
+
+    // Makes or reuses a target per slot and binds it into the graph.
+    void Realize(RenderGraph& graph);
+    void Release();
+
+    // Bytes the targets hold now.
+    std::size_t Bytes() const;
+    int Count() const { return int(targets_.size()); }
+
+private:
+    struct Target { TargetDesc desc; unsigned fbo = 0, texture = 0; };
+    std::vector<Target> targets_;
+};
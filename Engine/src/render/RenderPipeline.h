@@ -1,10 +1,19 @@
 // Engine/src/render/RenderPipeline.h
 #pragma once
 #include "IRenderPass.h"
+#include "RenderGraph.h"
+#include "GpuTimers.h"
+#include "../core/Profiler.h"
 #include <vector>
 #include <memory>
 #include <utility>          // <-- needed for std::forward
 
+// Owns the passes and runs each frame through a RenderGraph: the enabled
+// passes declare their reads and writes, the graph culls and orders them and
+// places the transient targets, and the live ones execute. Passes are
+// declared in the order they were added; that order is the data flow (a pass
+// can only read what an earlier one declared), while which passes run, and
+// where each one draws, come from the graph.
 class RenderPipeline {
 public:
     template<class T, class...Args>
@@ -29,19 +38,51 @@ public:
         setupCount_ = passes_.size();
     }
     void resize(PassContext& ctx, int w, int h) { for (auto& p : passes_) p->resize(ctx, w, h); }
+
+    // Builds and runs this frame's graph. ctx's targets (defaultFBO, hdrFBO,
+    // hdrColorTex) are imported as they are now. Each pass is its own
+    // profiler zone and GPU timer, named by name() -- which returns a
+    // literal, the static storage both need.
     void executeAll(PassContext& ctx, MyCoreEngine::Scene& scene, Camera& cam, const FrameParams& fp) {
-        for (auto& p : passes_) p->execute(ctx, scene, cam, fp);
-    }
+        graph_.Reset();
+        ctx.graph = &graph_;
+        ctx.res = PassContext::FrameResources{};
+        ctx.res.output = graph_.Import("Output", ctx.defaultFBO, 0);
+        ctx.res.hdr = graph_.Import("HDR", ctx.hdrFBO, ctx.hdrColorTex);
+        ctx.res.shadows = graph_.Import("ShadowMaps", 0, 0);
 
-    // How many LDR post passes will consume a ping-pong slot this frame. Asked
-    // of the passes themselves so the count cannot drift from what they do --
-    // see IRenderPass::wantsLdrSlot. A pass added later is counted for free.
-    int countLdrSlots(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
-        int n = 0;
-        for (const auto& p : passes_) if (p->wantsLdrSlot(ctx, scene)) ++n;
-        return n;
+        declared_.clear();
+        for (auto& p : passes_) {
+            if (!p->enabled(ctx, scene)) continue;
+            RenderGraph::PassBuilder b = graph_.AddPass(p->name());
+            p->declare(b, ctx, fp);
+            declared_.push_back(p.get());
+        }
+        // the post chain's last stage -- or tonemap, with none -- is the frame
+        graph_.Present(ctx.res.ldr, ctx.res.output);
+        graph_.Compile();
+        targets_.Realize(graph_);
+
+        timers_.BeginFrame();
+        for (int i : graph_.Order()) {
+            IRenderPass* p = declared_[size_t(i)];
+            CSE_PROFILE_ZONE(p->name());
+            timers_.Begin(p->name());
+            p->execute(ctx, scene, cam, fp);
+            timers_.End();
+        }
     }
+
+    // The last frame's graph, for tests.
+    const RenderGraph& graph() const { return graph_; }
+    const TransientTargets& transientTargets() const { return targets_; }
+    GpuTimers& gpuTimers() { return timers_; }
+    const GpuTimers& gpuTimers() const { return timers_; }
 private:
     std::vector<std::unique_ptr<IRenderPass>> passes_;
     size_t setupCount_ = 0; // high-water mark: passes [0, setupCount_) are set up
+    RenderGraph graph_;
+    TransientTargets targets_;
+    GpuTimers timers_;
+    std::vector<IRenderPass*> declared_; // by AddPass index, this frame
 };
@@ -8,7 +8,7 @@
 #include <algorithm>
 
 BloomPass::BloomPass() = default;
-BloomPass::~BloomPass() { release_(); }
+BloomPass::~BloomPass() = default;
 
 void BloomPass::setup(PassContext&) {
     brightShader_ = std::make_unique<MyCoreEngine::Shader>(
@@ -19,55 +19,36 @@ void BloomPass::setup(PassContext&) {
         "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/bloom_composite_frag.glsl");
 }
 
-void BloomPass::release_() {
-    if (texA_) glDeleteTextures(1, &texA_);
-    if (fboA_) glDeleteFramebuffers(1, &fboA_);
-    if (texB_) glDeleteTextures(1, &texB_);
-    if (fboB_) glDeleteFramebuffers(1, &fboB_);
-    texA_ = fboA_ = texB_ = fboB_ = 0;
-    halfW_ = halfH_ = 0;
+bool BloomPass::enabled(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
+    return scene.PostFX().bloom.enabled && ctx.hdrColorTex && ctx.hdrFBO &&
+           brightShader_ && brightShader_->isValid();
 }
 
-void BloomPass::ensureTargets_(int fullW, int fullH) {
-    const int hw = std::max(1, fullW / 2);
-    const int hh = std::max(1, fullH / 2);
-    if (hw == halfW_ && hh == halfH_ && fboA_ && fboB_) return; // already sized
-    release_();
-    halfW_ = hw; halfH_ = hh;
-
-    auto make = [&](unsigned& fbo, unsigned& tex) {
-        glGenFramebuffers(1, &fbo);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-        glGenTextures(1, &tex);
-        glBindTexture(GL_TEXTURE_2D, tex);
-        // RGBA16F: bloom carries HDR energy through the blur/composite.
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, hw, hh, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
-    };
-    make(fboA_, texA_);
-    make(fboB_, texB_);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+// The half-res pair is scratch: written and read here only, so the graph
+// gives it back after this pass and makes nothing while bloom is off.
+void BloomPass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    halfW_ = std::max(1, fp.viewportW / 2);
+    halfH_ = std::max(1, fp.viewportH / 2);
+    // RGBA16F: bloom carries HDR energy through the blur/composite.
+    const TargetDesc half{ halfW_, halfH_, TargetDesc::Format::RGBA16F };
+    b.Read(ctx.res.hdr);
+    a_ = b.Create("Bloom.A", half);
+    b_ = b.Create("Bloom.B", half);
+    b.Write(ctx.res.hdr);
 }
 
 bool BloomPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                         const FrameParams& fp) {
     const auto& b = scene.PostFX().bloom;
-    if (!b.enabled || !ctx.hdrColorTex || !ctx.hdrFBO ||
-        !brightShader_ || !brightShader_->isValid()) {
-        return false;
-    }
-    ensureTargets_(fp.viewportW, fp.viewportH);
-    if (!fboA_ || !fboB_) return false;
+    const unsigned fboA = ctx.fbo(a_), texA = ctx.texture(a_);
+    const unsigned fboB = ctx.fbo(b_), texB = ctx.texture(b_);
+    if (!enabled(ctx, scene) || !texA || !texB) return false;
 
     glDisable(GL_DEPTH_TEST);
     glBindVertexArray(ctx.fsQuadVAO);
 
     // 1) Bright-pass: scene HDR -> half-res buffer A.
-    glBindFramebuffer(GL_FRAMEBUFFER, fboA_);
+    glBindFramebuffer(GL_FRAMEBUFFER, fboA);
     glViewport(0, 0, halfW_, halfH_);
     brightShader_->use();
     brightShader_->setInt("uScene", 0);
@@ -86,14 +67,14 @@ bool BloomPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
     const int kIterations = 5;
     for (int i = 0; i < kIterations; ++i) {
         // horizontal: A -> B
-        glBindFramebuffer(GL_FRAMEBUFFER, fboB_);
+        glBindFramebuffer(GL_FRAMEBUFFER, fboB);
         blurShader_->setVec2("uDirection", du, 0.0f);
-        glBindTexture(GL_TEXTURE_2D, texA_);
+        glBindTexture(GL_TEXTURE_2D, texA);
         glDrawArrays(GL_TRIANGLES, 0, 6);
         // vertical: B -> A
-        glBindFramebuffer(GL_FRAMEBUFFER, fboA_);
+        glBindFramebuffer(GL_FRAMEBUFFER, fboA);
         blurShader_->setVec2("uDirection", 0.0f, dv);
-        glBindTexture(GL_TEXTURE_2D, texB_);
+        glBindTexture(GL_TEXTURE_2D, texB);
         glDrawArrays(GL_TRIANGLES, 0, 6);
     }
 
@@ -106,7 +87,7 @@ bool BloomPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
     compositeShader_->use();
     compositeShader_->setInt("uBloom", 0);
     compositeShader_->setFloat("uIntensity", b.intensity);
-    glBindTexture(GL_TEXTURE_2D, texA_);
+    glBindTexture(GL_TEXTURE_2D, texA);
     glDrawArrays(GL_TRIANGLES, 0, 6);
     glDisable(GL_BLEND);
 
@@ -6,10 +6,11 @@
 namespace MyCoreEngine { class Shader; }
 
 // Bloom: a bright-pass + separable-Gaussian glow composited additively back into
-// the HDR buffer BEFORE tonemap (an HDR pass, NOT part of the LDR ping-pong
-// chain). Works at half resolution through a pair of RGBA16F buffers, so the
-// blur is cheap; the glow width comes from repeating the separable blur. Owns
-// its own buffers (rebuilt when the viewport size changes). Pure GL 3.3.
+// the HDR buffer BEFORE tonemap (an HDR pass, NOT part of the LDR post chain).
+// Works at half resolution through a pair of RGBA16F buffers, so the blur is
+// cheap; the glow width comes from repeating the separable blur. The buffers
+// are graph transients, alive only for this pass, so they cost nothing while
+// bloom is off. Pure GL 3.3.
 // ENGINE_API: see VignettePass — exported so the chain is testable outside the DLL.
 class ENGINE_API BloomPass : public IRenderPass {
 public:
@@ -18,16 +19,14 @@ public:
     const char* name() const override { return "Bloom"; }
     void setup(PassContext&) override;
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
 
 private:
-    void ensureTargets_(int fullW, int fullH); // (re)allocate the half-res A/B pair
-    void release_();
-
     std::unique_ptr<MyCoreEngine::Shader> brightShader_;
     std::unique_ptr<MyCoreEngine::Shader> blurShader_;
     std::unique_ptr<MyCoreEngine::Shader> compositeShader_;
 
-    unsigned fboA_ = 0, texA_ = 0;
-    unsigned fboB_ = 0, texB_ = 0;
+    RenderGraph::Resource a_ = RenderGraph::kNone, b_ = RenderGraph::kNone; // half-res pair
     int halfW_ = 0, halfH_ = 0;
 };
@@ -9,22 +9,31 @@
 ColorGradePass::ColorGradePass() = default;
 ColorGradePass::~ColorGradePass() = default;
 
+// The post-FX uber shader with only its grade stage (see PostUberPass).
 void ColorGradePass::setup(PassContext&) {
     shader_ = std::make_unique<MyCoreEngine::Shader>(
-        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/colorgrade_frag.glsl");
+        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/postfx_uber_frag.glsl",
+        "#define POST_GRADE\n");
 }
 
-bool ColorGradePass::wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene& scene) const {
-    return scene.PostFX().colorGrade.enabled && shader_ && shader_->isValid();
+bool ColorGradePass::enabled(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
+    return scene.PostFX().colorGrade.enabled && !(ctx.res.fusedPost & kPostColorGrade) &&
+           shader_ && shader_->isValid();
+}
+
+void ColorGradePass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    in_ = ctx.res.ldr;
+    b.Read(in_);
+    out_ = ctx.res.ldr = b.Create("ColorGrade", ldrTargetDesc(fp));
 }
 
 bool ColorGradePass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                              const FrameParams& fp) {
     const auto& g = scene.PostFX().colorGrade;
-    if (!ctx.ldrTex_A || !wantsLdrSlot(ctx, scene)) return false;
-    const PassContext::PostTarget t = ctx.nextPostTarget();
+    const unsigned src = ctx.texture(in_);
+    if (!src || !enabled(ctx, scene)) return false;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, t.dstFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
     glViewport(0, 0, fp.viewportW, fp.viewportH);
     glDisable(GL_DEPTH_TEST);
 
@@ -38,7 +47,7 @@ bool ColorGradePass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camer
     shader_->setFloat("uGain", g.gain);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, t.srcTex);
+    glBindTexture(GL_TEXTURE_2D, src);
 
     glBindVertexArray(ctx.fsQuadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -7,7 +7,7 @@ namespace MyCoreEngine { class Shader; }
 
 // Procedural colour grade (white balance / lift-gain / contrast / saturation)
 // on the tonemapped image -- a self-contained stand-in for a LUT workflow, no
-// external asset. An LDR post pass on the ping-pong chain. Cheap fullscreen
+// external asset. An LDR post pass on the post chain. Cheap fullscreen
 // pass; parameters from the scene's PostFXSettings.
 // ENGINE_API: see VignettePass — exported so the chain is testable outside the DLL.
 class ENGINE_API ColorGradePass : public IRenderPass {
@@ -16,9 +16,11 @@ public:
     ~ColorGradePass() override;
     const char* name() const override { return "ColorGrade"; }
     void setup(PassContext&) override;
-    bool wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene&) const override;
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
 
 private:
     std::unique_ptr<MyCoreEngine::Shader> shader_;
+    RenderGraph::Resource in_ = RenderGraph::kNone, out_ = RenderGraph::kNone;
 };
@@ -13,19 +13,24 @@ void FXAAPass::setup(PassContext&) {
 }
 
 // Runs last in the LDR chain when AA is on. A broken shader means no pass,
-// which the count has to see too -- hence this, and not a copy in the Renderer.
-bool FXAAPass::wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene& scene) const {
+// which the graph has to see too -- hence this, and not a copy in the Renderer.
+bool FXAAPass::enabled(const PassContext&, const MyCoreEngine::Scene& scene) const {
     return scene.GetAAEnabled() && shader_ && shader_->isValid();
 }
 
+void FXAAPass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    in_ = ctx.res.ldr;
+    b.Read(in_);
+    out_ = ctx.res.ldr = b.Create("FXAA", ldrTargetDesc(fp));
+}
+
 bool FXAAPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                        const FrameParams& fp) {
-    // ldrTex_A additionally guards the (rare) FBO-alloc-failed case, where the
-    // Renderer zeroes postPassesLeft and the whole chain stands down together.
-    if (!ctx.ldrTex_A || !wantsLdrSlot(ctx, scene)) return false;
-    const PassContext::PostTarget t = ctx.nextPostTarget();
+    // no source: not declared this frame (or run without a graph)
+    const unsigned src = ctx.texture(in_);
+    if (!src || !enabled(ctx, scene)) return false;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, t.dstFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
     glViewport(0, 0, fp.viewportW, fp.viewportH);
     glDisable(GL_DEPTH_TEST);
 
@@ -42,7 +47,7 @@ bool FXAAPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
     shader_->setFloat("uSubpixel", subpixel_);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, t.srcTex);
+    glBindTexture(GL_TEXTURE_2D, src);
 
     glBindVertexArray(ctx.fsQuadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
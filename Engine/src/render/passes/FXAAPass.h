@@ -8,8 +8,8 @@
 // luma, so it must see gamma-space LDR; run on linear HDR the same constants
 // mean something entirely different and it smears highlights while ignoring
 // dark detail. That is why TonemapPass renders into an intermediate LDR
-// target (ctx.ldrFBO) whenever this pass is active, instead of writing
-// straight to the output as it does otherwise.
+// target whenever this pass is active, instead of writing straight to the
+// output as it does otherwise.
 //
 // Chosen over MSAA deliberately: MSAA costs rasterization, and this renderer
 // is rasterization-bound at ~40k instances, while measurement showed fill
@@ -29,7 +29,8 @@ public:
 
     const char* name() const override { return "FXAA"; }
     void setup(PassContext&) override;
-    bool wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene&) const override;
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
     bool execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera& camera,
                  const FrameParams& fp) override;
 
@@ -47,6 +48,7 @@ public:
 
 private:
     std::unique_ptr<MyCoreEngine::Shader> shader_;
+    RenderGraph::Resource in_ = RenderGraph::kNone, out_ = RenderGraph::kNone;
     float edgeThreshold_ = 0.125f;
     float edgeThresholdMin_ = 0.0312f;
     float subpixel_ = 0.75f;
@@ -1,5 +1,6 @@
 // Engine/src/render/passes/ForwardOpaquePass.cpp
 #include "ForwardOpaquePass.h"
+#include "ForwardShading.h"
 #include <glad/glad.h>
 
 void ForwardOpaquePass::setup(PassContext&) {
@@ -29,62 +30,17 @@ bool ForwardOpaquePass::execute(PassContext& ctx, Scene& scene, Camera& cam, con
 		scene.SetDepthPrepassShader(nullptr);
 	}
 
-	// main shader
+	// main shader: camera, cascades and IBL exactly as the transparent pass
+	// binds them
 	shader_->use();
-	shader_->setMat4("projection", fp.proj);
-	shader_->setMat4("view", fp.view);
-	
-	// CSM block
-	shader_->setInt("uShadowsOn", ctx.csm.enabled ? 1 : 0);
-	shader_->setInt("uCascadeCount", ctx.csm.cascades);
-	shader_->setFloat("uSplitBlend", ctx.splitBlend);
-	shader_->setInt("uCSMDebug", ctx.csmDebug);
-	shader_->setFloat("uShadowBiasConst", ctx.shadowBiasConst);
-	shader_->setFloat("uShadowBiasSlope", ctx.shadowBiasSlope);
-
-	for (int i = 0; i < ctx.csm.cascades; ++i) {
-		char name[32];
-		snprintf(name, sizeof(name), "uLightVP[%d]", i);
-		shader_->setMat4(name, ctx.csm.lightVP[i]);
-		snprintf(name, sizeof(name), "uCSMSplits[%d]", i);
-		shader_->setFloat(name, ctx.csm.splitFar[i]);
-		snprintf(name, sizeof(name), "uCascadeTexel[%d]", i);
-		shader_->setFloat(name, (ctx.csm.resPer[i] > 0) ? (1.0f / float(ctx.csm.resPer[i])) : 1.0f);
-		snprintf(name, sizeof(name), "uCascadeKernel[%d]", i);
-		shader_->setInt(name, ctx.cascadeKernel[i]);
-	}
-	for (int i = 0; i < ctx.csm.cascades; ++i) {
-		const int unit = kBaseUnit + i;
-		glActiveTexture(GL_TEXTURE0 + unit);
-		glBindTexture(GL_TEXTURE_2D, ctx.csm.depthTex[i]);
-		char name[32];
-		snprintf(name, sizeof(name), "uShadowCascade[%d]", i);
-		shader_->setInt(name, unit);
-	}
-	// IBL (optional)
-	if (ctx.ibl.irradiance && ctx.ibl.prefiltered && ctx.ibl.brdfLUT) {
-		glActiveTexture(GL_TEXTURE5);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, ctx.ibl.irradiance);
-		shader_->setInt("irradianceMap", 5);
-		glActiveTexture(GL_TEXTURE6);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, ctx.ibl.prefiltered);
-		shader_->setInt("prefilteredMap", 6);
-		glActiveTexture(GL_TEXTURE7);
-		glBindTexture(GL_TEXTURE_2D, ctx.ibl.brdfLUT);
-		shader_->setInt("brdfLUT", 7);
-		shader_->setFloat("uPrefilterMipCount", ctx.ibl.mipCount);
-		scene.SetIBLAvailable(true);
-	}
-	else {
-		shader_->setFloat("uPrefilterMipCount", 0.0f);
-		// Tell the scene the maps are NOT there. Scene::RenderScene sets
-		// uUseIBL from its own iblEnabled_ flag, which defaults to true and
-		// runs AFTER this block -- so before this, the shader took the IBL
-		// branch and sampled unbound cubemaps. Those read as black, making
-		// ambient exactly ZERO rather than the intended 0.03 fallback, which
-		// is why unlit surfaces were pure black instead of merely dim.
-		scene.SetIBLAvailable(false);
-	}
+	ApplyForwardShadingState(*shader_, scene, ctx, fp);
+	// Tell the scene whether the maps are there. Scene::RenderScene sets
+	// uUseIBL from its own iblEnabled_ flag, which defaults to true -- without
+	// this the shader took the IBL branch and sampled unbound cubemaps. Those
+	// read as black, making ambient exactly ZERO rather than the intended 0.03
+	// fallback, which is why unlit surfaces were pure black instead of merely
+	// dim.
+	scene.SetIBLAvailable(ctx.ibl.irradiance && ctx.ibl.prefiltered && ctx.ibl.brdfLUT);
 	
 	// draw scene — culling frustum must use the same clip planes as the
 	// projection in fp.proj (both read the camera's NearClip/FarClip)
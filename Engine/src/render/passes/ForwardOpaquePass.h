@@ -13,11 +13,14 @@ public:
     void setup(PassContext&) override;
     void resize(PassContext&, int, int) override {};
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams&) override {
+        b.Read(ctx.res.shadows);
+        b.Write(ctx.res.hdr);
+    }
 
 private:
     Shader* shader_; // not owned
     // Depth-prepass program: the SAME vertex shader as the color pass with a
     // no-op fragment stage (bit-identical gl_Position -> GL_EQUAL is exact).
     std::unique_ptr<Shader> prepassShader_;
-    static constexpr int kBaseUnit = 8; // uShadowCascade[] start at texture unit 8
 };
@@ -1,11 +1,14 @@
 #pragma once
 // Binds the forward shader's per-frame SHADING state — camera matrices, the
-// CSM cascades and their uniforms, and the IBL textures — from a PassContext.
+// CSM cascades, and the IBL textures — from a PassContext. The cascade
+// values and the IBL mip count go into the scene's FrameGlobals block
+// (Scene uploads it with the rest of the frame's state); the matrices and
+// the samplers stay plain uniforms.
 //
 // Exists so the transparent pass lights and shadows its geometry with EXACTLY
 // the same inputs as the opaque forward pass. If the two drifted, glass would
 // be lit differently from the wall behind it and read as obviously wrong. It
-// deliberately does NOT touch scene material/light-list uniforms (Scene
+// deliberately does NOT touch scene material/light-list state (Scene
 // uploads those) nor Scene::SetIBLAvailable (that is the opaque pass's call,
 // made once per frame before this runs).
 
@@ -14,29 +17,26 @@
 #include <glad/glad.h>
 #include <cstdio>
 
-inline void ApplyForwardShadingState(Shader& shader, const PassContext& ctx,
-                                     const FrameParams& fp) {
+inline void ApplyForwardShadingState(Shader& shader, MyCoreEngine::Scene& scene,
+                                     const PassContext& ctx, const FrameParams& fp) {
     shader.setMat4("projection", fp.proj);
     shader.setMat4("view", fp.view);
 
-    shader.setInt("uShadowsOn", ctx.csm.enabled ? 1 : 0);
-    shader.setInt("uCascadeCount", ctx.csm.cascades);
-    shader.setFloat("uSplitBlend", ctx.splitBlend);
-    shader.setInt("uCSMDebug", ctx.csmDebug);
-    shader.setFloat("uShadowBiasConst", ctx.shadowBiasConst);
-    shader.setFloat("uShadowBiasSlope", ctx.shadowBiasSlope);
-
-    for (int i = 0; i < ctx.csm.cascades; ++i) {
-        char name[32];
-        std::snprintf(name, sizeof(name), "uLightVP[%d]", i);
-        shader.setMat4(name, ctx.csm.lightVP[i]);
-        std::snprintf(name, sizeof(name), "uCSMSplits[%d]", i);
-        shader.setFloat(name, ctx.csm.splitFar[i]);
-        std::snprintf(name, sizeof(name), "uCascadeTexel[%d]", i);
-        shader.setFloat(name, (ctx.csm.resPer[i] > 0) ? (1.0f / float(ctx.csm.resPer[i])) : 1.0f);
-        std::snprintf(name, sizeof(name), "uCascadeKernel[%d]", i);
-        shader.setInt(name, ctx.cascadeKernel[i]);
+    MyCoreEngine::FrameGlobalsBlock& g = scene.FrameGlobals();
+    g.shadowsOn = ctx.csm.enabled ? 1 : 0;
+    g.cascadeCount = ctx.csm.cascades;
+    g.splitBlend = ctx.splitBlend;
+    g.csmDebug = ctx.csmDebug;
+    g.shadowBiasConst = ctx.shadowBiasConst;
+    g.shadowBiasSlope = ctx.shadowBiasSlope;
+    for (int i = 0; i < 4; ++i) {
+        const bool live = i < ctx.csm.cascades;
+        g.lightVP[i] = live ? ctx.csm.lightVP[i] : glm::mat4(1.f);
+        g.csmSplits[i] = live ? ctx.csm.splitFar[i] : 0.f;
+        g.cascadeTexel[i] = (live && ctx.csm.resPer[i] > 0) ? (1.0f / float(ctx.csm.resPer[i])) : 1.0f;
+        g.cascadeKernel[i] = live ? ctx.cascadeKernel[i] : 0;
     }
+
     constexpr int kBaseUnit = 8; // uShadowCascade[] start at texture unit 8
     for (int i = 0; i < ctx.csm.cascades; ++i) {
         const int unit = kBaseUnit + i;
@@ -57,9 +57,9 @@ inline void ApplyForwardShadingState(Shader& shader, const PassContext& ctx,
         glActiveTexture(GL_TEXTURE7);
         glBindTexture(GL_TEXTURE_2D, ctx.ibl.brdfLUT);
         shader.setInt("brdfLUT", 7);
-        shader.setFloat("uPrefilterMipCount", ctx.ibl.mipCount);
+        g.prefilterMipCount = ctx.ibl.mipCount;
     }
     else {
-        shader.setFloat("uPrefilterMipCount", 0.0f);
+        g.prefilterMipCount = 0.0f;
     }
 }
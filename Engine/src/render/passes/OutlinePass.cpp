@@ -10,26 +10,37 @@
 OutlinePass::OutlinePass() = default;
 OutlinePass::~OutlinePass() = default;
 
+// The post-FX uber shader with only its outline stage (see PostUberPass).
 void OutlinePass::setup(PassContext&) {
     shader_ = std::make_unique<MyCoreEngine::Shader>(
-        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/outline_frag.glsl");
+        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/postfx_uber_frag.glsl",
+        "#define POST_OUTLINE\n");
 }
 
 // Needs the scene depth texture as well as the effect being on. hdrDepthTex is
-// published into the context before the Renderer counts, so it is safe to ask
-// here -- and it has to be asked, or a depth-less frame would be miscounted.
-bool OutlinePass::wantsLdrSlot(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
+// published into the context before the pipeline declares, so it is safe to
+// ask here -- and it has to be asked, or a depth-less frame would route the
+// chain through a pass that then declines. Not when PostUberPass already
+// drew the outline this frame.
+bool OutlinePass::enabled(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
     return scene.PostFX().outline.enabled && ctx.hdrDepthTex &&
-           shader_ && shader_->isValid();
+           !(ctx.res.fusedPost & kPostOutline) && shader_ && shader_->isValid();
+}
+
+void OutlinePass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    in_ = ctx.res.ldr;
+    b.Read(in_);
+    b.Read(ctx.res.hdr); // the scene depth
+    out_ = ctx.res.ldr = b.Create("Outline", ldrTargetDesc(fp));
 }
 
 bool OutlinePass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera& cam,
                           const FrameParams& fp) {
     const auto& o = scene.PostFX().outline;
-    if (!ctx.ldrTex_A || !wantsLdrSlot(ctx, scene)) return false;
-    const PassContext::PostTarget t = ctx.nextPostTarget();
+    const unsigned src = ctx.texture(in_);
+    if (!src || !enabled(ctx, scene)) return false;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, t.dstFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
     glViewport(0, 0, fp.viewportW, fp.viewportH);
     glDisable(GL_DEPTH_TEST);
 
@@ -39,15 +50,15 @@ bool OutlinePass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&
     shader_->setVec2("uTexel",
                      1.0f / float(fp.viewportW > 0 ? fp.viewportW : 1),
                      1.0f / float(fp.viewportH > 0 ? fp.viewportH : 1));
-    shader_->setFloat("uThickness", o.thickness);
-    shader_->setFloat("uThreshold", o.threshold);
-    shader_->setFloat("uStrength", o.strength);
-    shader_->setVec3("uColor", o.color);
+    shader_->setFloat("uOutlineThickness", o.thickness);
+    shader_->setFloat("uOutlineThreshold", o.threshold);
+    shader_->setFloat("uOutlineStrength", o.strength);
+    shader_->setVec3("uOutlineColor", o.color);
     shader_->setFloat("uNear", cam.NearClip);
     shader_->setFloat("uFar", cam.FarClip);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, t.srcTex);
+    glBindTexture(GL_TEXTURE_2D, src);
     glActiveTexture(GL_TEXTURE1);
     glBindTexture(GL_TEXTURE_2D, ctx.hdrDepthTex);
 
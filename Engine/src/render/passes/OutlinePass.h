@@ -5,8 +5,8 @@
 
 namespace MyCoreEngine { class Shader; }
 
-// Ink outline from scene-depth discontinuities. An LDR post pass on the
-// ping-pong chain that ALSO samples the scene depth texture (PassContext::
+// Ink outline from scene-depth discontinuities. An LDR post pass on the post
+// chain that ALSO samples the scene depth texture (PassContext::
 // hdrDepthTex). Depth-only (a forward renderer has no normal buffer), so it
 // draws silhouettes and depth steps -- the contour line that pairs with cel
 // shading. Cheap fullscreen pass; parameters from the scene's PostFXSettings.
@@ -17,9 +17,11 @@ public:
     ~OutlinePass() override;
     const char* name() const override { return "Outline"; }
     void setup(PassContext&) override;
-    bool wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene&) const override;
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
 
 private:
     std::unique_ptr<MyCoreEngine::Shader> shader_;
+    RenderGraph::Resource in_ = RenderGraph::kNone, out_ = RenderGraph::kNone;
 };
@@ -0,0 +1,124 @@
+// Engine/src/render/passes/PostUberPass.cpp
+#include "PostUberPass.h"
+
+#include "../../core/Shader.h"
+#include "../../core/Scene.h"
+#include "../../core/Camera.h"
+
+#include <glad/glad.h>
+
+#include <string>
+
+PostUberPass::PostUberPass() = default;
+PostUberPass::~PostUberPass() = default;
+
+unsigned PostUberPass::FusedEffects(const PassContext& ctx, const MyCoreEngine::Scene& scene) {
+    const auto& p = scene.PostFX();
+    if (!p.fused) return 0;
+    unsigned mask = 0;
+    if (p.outline.enabled && ctx.hdrDepthTex) mask |= kPostOutline;
+    if (p.colorGrade.enabled) mask |= kPostColorGrade;
+    if (p.vignette.enabled) mask |= kPostVignette;
+    // one effect: nothing to fuse
+    return (mask & (mask - 1)) ? mask : 0u;
+}
+
+MyCoreEngine::Shader* PostUberPass::program_(unsigned mask) const {
+    if (mask == 0 || mask >= programs_.size()) return nullptr;
+    auto& slot = programs_[mask];
+    if (!slot) {
+        std::string defines;
+        if (mask & kPostOutline) defines += "#define POST_OUTLINE\n";
+        if (mask & kPostColorGrade) defines += "#define POST_GRADE\n";
+        if (mask & kPostVignette) defines += "#define POST_VIGNETTE\n";
+        slot = std::make_unique<MyCoreEngine::Shader>(
+            "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/postfx_uber_frag.glsl", defines);
+    }
+    return slot.get();
+}
+
+int PostUberPass::CompiledPermutations() const {
+    int n = 0;
+    for (const auto& p : programs_) if (p) ++n;
+    return n;
+}
+
+// A permutation that failed to compile leaves the effects to their own
+// passes, which is the same image. The pipeline asks right before declare,
+// which has no scene to work the mask out from, so the answer is kept.
+bool PostUberPass::enabled(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
+    const unsigned mask = FusedEffects(ctx, scene);
+    const MyCoreEngine::Shader* s = program_(mask);
+    mask_ = (s && s->isValid()) ? mask : 0u;
+    return mask_ != 0;
+}
+
+void PostUberPass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    in_ = ctx.res.ldr;
+    b.Read(in_);
+    if (mask_ & kPostOutline) b.Read(ctx.res.hdr); // the scene depth
+    out_ = ctx.res.ldr = b.Create("PostUber", ldrTargetDesc(fp));
+    ctx.res.fusedPost |= mask_;
+}
+
+bool PostUberPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera& cam,
+                           const FrameParams& fp) {
+    const unsigned src = ctx.texture(in_);
+    if (!src || FusedEffects(ctx, scene) != mask_) return false;
+    MyCoreEngine::Shader* s = program_(mask_);
+    if (!s || !s->isValid()) return false;
+    const auto& p = scene.PostFX();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
+    glViewport(0, 0, fp.viewportW, fp.viewportH);
+    glDisable(GL_DEPTH_TEST);
+
+    s->use();
+    s->setInt("uScene", 0);
+    if (mask_ & kPostOutline) {
+        const auto& o = p.outline;
+        s->setInt("uDepth", 1);
+        s->setVec2("uTexel",
+                   1.0f / float(fp.viewportW > 0 ? fp.viewportW : 1),
+                   1.0f / float(fp.viewportH > 0 ? fp.viewportH : 1));
+        s->setFloat("uOutlineThickness", o.thickness);
+        s->setFloat("uOutlineThreshold", o.threshold);
+        s->setFloat("uOutlineStrength", o.strength);
+        s->setVec3("uOutlineColor", o.color);
+        s->setFloat("uNear", cam.NearClip);
+        s->setFloat("uFar", cam.FarClip);
+    }
+    if (mask_ & kPostColorGrade) {
+        const auto& g = p.colorGrade;
+        s->setFloat("uContrast", g.contrast);
+        s->setFloat("uSaturation", g.saturation);
+        s->setFloat("uTemperature", g.temperature);
+        s->setFloat("uTint", g.tint);
+        s->setFloat("uLift", g.lift);
+        s->setFloat("uGain", g.gain);
+    }
+    if (mask_ & kPostVignette) {
+        const auto& v = p.vignette;
+        s->setFloat("uVignetteIntensity", v.intensity);
+        s->setFloat("uVignetteRoundness", v.roundness);
+        s->setFloat("uVignetteSmoothness", v.smoothness);
+        s->setFloat("uAspect", fp.viewportH > 0
+                                   ? float(fp.viewportW) / float(fp.viewportH)
+                                   : 1.0f);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, src);
+    if (mask_ & kPostOutline) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, ctx.hdrDepthTex);
+    }
+
+    glBindVertexArray(ctx.fsQuadVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    glBindVertexArray(0);
+
+    glActiveTexture(GL_TEXTURE0); // leave unit 0 active for the next pass
+    glEnable(GL_DEPTH_TEST);
+    return true;
+}
@@ -0,0 +1,46 @@
+// Engine/src/render/passes/PostUberPass.h
+#pragma once
+#include "../IRenderPass.h"
+#include <array>
+#include <memory>
+
+namespace MyCoreEngine { class Shader; }
+
+// Outline, colour grade and vignette fused into one fullscreen pass. Each of
+// the three reads only its own texel of the colour it is handed, so run back
+// to back in one shader they need one full-resolution read and write instead
+// of one per effect -- fill rate and bandwidth being what a laptop runs out
+// of first. FXAA reads its neighbours, so it cannot join in and stays its own
+// pass after this one.
+//
+// Declared right after tonemap when the scene's PostFXSettings::fused is on
+// and at least two of the three effects are: it applies them and records so
+// in ctx.res.fusedPost, and their own passes then are not enabled. With one
+// effect there is nothing to save, and the effect's own pass runs as before.
+//
+// The program is postfx_uber_frag.glsl compiled once per combination of
+// effects (POST_OUTLINE / POST_GRADE / POST_VIGNETTE), on first use, and kept.
+// The effects' own passes compile it with their single define.
+// ENGINE_API: see VignettePass.
+class ENGINE_API PostUberPass : public IRenderPass {
+public:
+    PostUberPass();
+    ~PostUberPass() override;
+    const char* name() const override { return "PostUber"; }
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
+    bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+
+    // The PostEffect bits this pass would fuse this frame (0 below two).
+    static unsigned FusedEffects(const PassContext&, const MyCoreEngine::Scene&);
+    // How many permutations have been compiled so far.
+    int CompiledPermutations() const;
+
+private:
+    // Compiled on first ask. Null for a mask the pass never fuses.
+    MyCoreEngine::Shader* program_(unsigned mask) const;
+
+    mutable std::array<std::unique_ptr<MyCoreEngine::Shader>, 8> programs_;
+    mutable unsigned mask_ = 0; // from the last enabled(): what declare fuses
+    RenderGraph::Resource in_ = RenderGraph::kNone, out_ = RenderGraph::kNone;
+};
@@ -170,11 +170,20 @@ void ShadowCSMPass::publish_(PassContext& ctx, bool on) {
     ctx.csm = snap_;
 }
 
-bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const FrameParams& fp) {
-    if (!enabled_) {
-        publish_(ctx, false); // publish "off"
-        return false;
-    }
+void ShadowCSMPass::plan(PassContext& ctx, Scene& scene, Camera& cam, const FrameParams& fp,
+                         std::vector<Scene::CascadeParam>& out) {
+    planned_ = false;
+    if (!enabled_) return;
+    plan_(ctx, scene, cam, fp);
+    planned_ = true;
+    out.insert(out.end(), planParams_.begin(), planParams_.end());
+}
+
+// Everything execute decides before it touches a depth target: which
+// cascades are stale, and the light matrix of each. Leaves the cascades to
+// render, in update order, in planParams_.
+void ShadowCSMPass::plan_(PassContext& ctx, Scene& scene, Camera& cam, const FrameParams& fp) {
+    planParams_.clear();
     ensureTargets_();
     ++frameIndex_;
 
@@ -264,11 +273,9 @@ bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const F
         cascadeValid_[needIdx[k]] = false;
     }
 
-    // Nothing stale: publish the still-valid snapshot and skip all GPU work.
-    if (toUpdate == 0) {
-        publish_(ctx, true);
-        return false;
-    }
+    // Nothing stale: execute publishes the still-valid snapshot and skips
+    // all GPU work.
+    if (toUpdate == 0) return;
 
     const glm::vec3 sunDir = sun;
     const glm::mat4 V = cam.GetViewMatrix();
@@ -342,6 +349,48 @@ bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const F
         pendingDynamic_[i] = false;
     }
 
+    // Cascade parameters, in update order.
+    // Note: RenderShadowsCombined receives sequential buckets 0..N, so if we
+    // pass "Cascade 3" alone it arrives as bucket 0.
+    //
+    // The callback in execute remaps bucket -> actual cascade for the depth
+    // ATTACHMENT, and for a long time that was assumed to be enough. It is
+    // not: anything the callee derives from the bucket counter is then wrong
+    // for a partial update. Shadow LOD did exactly that, giving a lone far
+    // cascade the near cascade's geometry. CascadeParam::cascadeIndex
+    // carries the real one, and any new per-cascade decision must key off
+    // IT, not off the loop counter.
+    for (int k = 0; k < toUpdate; ++k) {
+        const int i = needIdx[k];
+        Scene::CascadeParam p;
+        p.lightVP = lightVP_[i];
+        p.splitNear = splitZ_[i];
+        p.splitFar = splitZ_[i + 1]; // splitZ is [0..cascades]
+        p.viewMatrix = V;
+        // The only record of which cascade this bucket is: the depth
+        // attachment is picked by it too, so the two cannot disagree.
+        p.cascadeIndex = i;
+        planParams_.push_back(p);
+    }
+}
+
+bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const FrameParams& fp) {
+    if (!enabled_) {
+        planned_ = false;
+        publish_(ctx, false); // publish "off"
+        return false;
+    }
+    // Renderer plans ahead (so the scene can build every view's list at
+    // once); anyone driving the pass directly gets the same plan here.
+    if (!planned_) plan_(ctx, scene, cam, fp);
+    planned_ = false;
+
+    // Nothing stale: publish the still-valid snapshot and skip all GPU work.
+    if (planParams_.empty()) {
+        publish_(ctx, true);
+        return false;
+    }
+
     // render depth per cascade (your renderCSM_ body)
     glBindFramebuffer(GL_FRAMEBUFFER, shadowFBO_);
     glEnable(GL_DEPTH_TEST);
@@ -361,49 +410,12 @@ bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const F
     depthProg_->use();
     depthProg_->setInt("uUseInstancing", 0);
 
-    // Prepare cascade parameters
-    // Note: We need to map from our "updated" list back to the actual cascades.
-    // BUT RenderShadowsCombined processes ALL provided cascades.
-    // If we only want to update SOME, we pass only those.
-    // HOWEVER, RenderShadowsCombined receives sequential buckets 0..N, so if we
-    // pass "Cascade 3" alone it arrives as bucket 0.
-    //
-    // The callback remaps bucket -> actual cascade for the depth ATTACHMENT,
-    // and for a long time that was assumed to be enough. It is not: anything
-    // the callee derives from the bucket counter is then wrong for a partial
-    // update. Shadow LOD did exactly that, giving a lone far cascade the near
-    // cascade's geometry. CascadeParam::cascadeIndex carries the real one, and
-    // any new per-cascade decision must key off IT, not off the loop counter.
-    
-    struct BatchEntry {
-        int actualIndex;
-        Scene::CascadeParam param;
-    };
-    std::vector<BatchEntry> batch;
-    batch.reserve(toUpdate);
-    std::vector<Scene::CascadeParam> params;
-    params.reserve(toUpdate);
-
-    for (int k = 0; k < toUpdate; ++k) {
-        const int i = needIdx[k];
-        Scene::CascadeParam p;
-        p.lightVP = lightVP_[i];
-        p.splitNear = splitZ_[i];
-        p.splitFar = splitZ_[i + 1]; // splitZ is [0..cascades]
-        p.viewMatrix = V;
-        // Set beside actualIndex deliberately: they are the same number, and
-        // the two must never disagree about which cascade this bucket is.
-        p.cascadeIndex = i;
-
-        BatchEntry be; be.actualIndex = i; be.param = p;
-        batch.push_back(be);
-        params.push_back(p);
-    }
+    const std::vector<Scene::CascadeParam>& params = planParams_;
 
     // Callback to bind target
     auto preDraw = [&](int bucketIndex) {
-        if (bucketIndex < 0 || bucketIndex >= (int)batch.size()) return;
-        int i = batch[bucketIndex].actualIndex;
+        if (bucketIndex < 0 || bucketIndex >= (int)params.size()) return;
+        const int i = params[bucketIndex].cascadeIndex;
         
         glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth_[i], 0);
         glViewport(0, 0, resPer_[i], resPer_[i]);
@@ -440,7 +452,7 @@ bool ShadowCSMPass::execute(PassContext& ctx, Scene& scene, Camera& cam, const F
     // publish snapshot for forward
     publish_(ctx, true);
     
-    return (toUpdate > 0);
+    return true;
 }
 
 void ShadowCSMPass::setLambda(float v) {
@@ -2,6 +2,7 @@
 #pragma once
 #include "../IRenderPass.h"
 #include <memory>
+#include <vector>
 
 class ENGINE_API ShadowCSMPass final : public IRenderPass {
 
@@ -13,6 +14,20 @@ public:
     void setup(PassContext&) override;                     // create FBO, depth tex, shader
     void resize(PassContext&, int, int) override {};        // NOP (shadow size is independent)
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+    // Writes the shadow maps (imported: the pass owns them). Always declared;
+    // a disabled or up-to-date CSM decides for itself in execute.
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams&) override {
+        b.Write(ctx.res.shadows);
+    }
+
+    // The CPU half of execute, run ahead of the pipeline: decides which
+    // cascades go stale this frame, fits their light matrices and appends
+    // them to `out` (nothing when disabled or nothing is stale). Renderer
+    // calls it so Scene::BuildDrawLists can build the cascade buckets beside
+    // the camera's list; the next execute then draws this plan instead of
+    // making its own. Without it, execute plans for itself as before.
+    void plan(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&,
+              std::vector<MyCoreEngine::Scene::CascadeParam>& out);
 
     // Read-only access for validation/inspection
     const CSMSnapshot& snapshot() const { return snap_; }
@@ -157,8 +172,13 @@ private:
 
     std::unique_ptr<MyCoreEngine::Shader> depthProg_; // "shadow_depth_*.glsl"
 
+    // this frame's plan: the cascades to render, in update order
+    std::vector<MyCoreEngine::Scene::CascadeParam> planParams_;
+    bool planned_{ false }; // plan() ran and execute has not consumed it yet
+
     // helpers
     void ensureTargets_();
+    void plan_(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&);
     bool rebuild_(const Camera& cam, float aspect);
     void markDirty_() { shadowParamsDirty_ = true; forceFullUpdateOnce_ = true; }
 
@@ -36,9 +36,13 @@ void SkyboxPass::setup(PassContext&) {
     glBindVertexArray(0);
 }
 
-bool SkyboxPass::execute(PassContext& ctx, MyCoreEngine::Scene&, Camera&,
+bool SkyboxPass::enabled(const PassContext& ctx, const MyCoreEngine::Scene&) const {
+    return ctx.ibl.environment && shader_ && shader_->isValid() && cubeVAO_;
+}
+
+bool SkyboxPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                          const FrameParams& fp) {
-    if (!ctx.ibl.environment || !shader_ || !shader_->isValid() || !cubeVAO_) {
+    if (!enabled(ctx, scene)) {
         return false; // no environment baked: leave the cleared background
     }
 
@@ -24,6 +24,12 @@ public:
     void setup(PassContext&) override;
     bool execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera& camera,
                  const FrameParams& fp) override;
+    // Off without an environment (the cleared background stays).
+    bool enabled(const PassContext& ctx, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams&) override {
+        b.Read(ctx.res.hdr); // depth-tested against what forward drew
+        b.Write(ctx.res.hdr);
+    }
 
     // Multiplies the sampled environment. Lets the sky be dimmed independently
     // of how strongly it lights the scene.
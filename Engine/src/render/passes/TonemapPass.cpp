@@ -2,11 +2,17 @@
 #include "TonemapPass.h"
 #include <glad/glad.h>
 
+void TonemapPass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+	b.Read(ctx.res.hdr);
+	out_ = ctx.res.ldr = b.Create("Tonemap", ldrTargetDesc(fp));
+}
+
 bool TonemapPass::execute(PassContext& ctx, Scene& scene, Camera& camera, const FrameParams& fp) {
 	// With any LDR post pass active this is no longer the last step: tonemap
-	// lands in ping-pong buffer A and the chain (vignette/outline/FXAA/...)
-	// resolves to the output. With none, it writes straight to defaultFBO.
-	glBindFramebuffer(GL_FRAMEBUFFER, ctx.tonemapTarget());
+	// lands in a transient target and the chain (vignette/outline/FXAA/...)
+	// resolves to the output. With none, the graph presents tonemap's target
+	// as the output, so it writes straight to defaultFBO.
+	glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
 	glViewport(0, 0, fp.viewportW, fp.viewportH);
 	glDisable(GL_DEPTH_TEST);
 	
@@ -8,4 +8,10 @@ public:
     void setup(PassContext&) override {}
     void resize(PassContext&, int, int) override {}
     bool execute(PassContext& ctx, Scene& scene, Camera& camera, const FrameParams & fp) override;
+    // Reads the HDR target and starts the LDR chain with a target of its own,
+    // which is the output when no post pass follows.
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) override;
+
+private:
+    RenderGraph::Resource out_ = RenderGraph::kNone;
 };
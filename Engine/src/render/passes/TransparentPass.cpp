@@ -16,7 +16,7 @@ bool TransparentPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Came
     shader_->use();
     // Re-bind shadows + IBL + camera so translucent geometry shades identically
     // to the opaque pass (the skybox pass ran in between on its own program).
-    ApplyForwardShadingState(*shader_, ctx, fp);
+    ApplyForwardShadingState(*shader_, scene, ctx, fp);
 
     // Scene owns the sort + blend state + draw + state restore.
     scene.RenderTransparent(*shader_, cam);
@@ -2,7 +2,8 @@
 // Draws Blend-mode geometry, alpha-composited over the opaque scene and the
 // sky.
 //
-// ORDERING: after ForwardOpaquePass AND SkyboxPass, before TonemapPass.
+// ORDERING: after ForwardOpaquePass AND SkyboxPass, before TonemapPass (all
+// four write the HDR target, so the graph keeps them in this order).
 // - After opaque + sky, because a transparent surface blends over whatever is
 //   already in the HDR target behind it.
 // - Before tonemap, because the blend must happen in linear HDR (a 50%-opacity
@@ -21,6 +22,14 @@ public:
     const char* name() const override { return "Transparent"; }
     void setup(PassContext&) override {}
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+    // Only on frames that collected blend geometry.
+    bool enabled(const PassContext&, const MyCoreEngine::Scene& scene) const override {
+        return scene.HasTransparent();
+    }
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams&) override {
+        b.Read(ctx.res.shadows);
+        b.Write(ctx.res.hdr);
+    }
 
 private:
     Shader* shader_; // not owned; the same forward shader ForwardOpaquePass uses
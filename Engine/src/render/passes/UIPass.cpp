@@ -17,14 +17,18 @@ void UIPass::setup(PassContext&) {
     }
 }
 
-bool UIPass::execute(PassContext& ctx, MyCoreEngine::Scene&, Camera&,
+bool UIPass::enabled(const PassContext&, const MyCoreEngine::Scene&) const {
+    return r2d_ && draw_ && *draw_ && r2d_->IsReady();
+}
+
+bool UIPass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                      const FrameParams& fp) {
-    if (!r2d_ || !draw_ || !*draw_ || !r2d_->IsReady()) return false;
+    if (!enabled(ctx, scene)) return false;
     if (fp.viewportW <= 0 || fp.viewportH <= 0) return false;
 
-    // Paint onto the FINISHED frame. Deliberately NOT ctx.nextPostTarget():
-    // this is an overlay, not a chain stage, so consuming a ping-pong slot
-    // would desync the routing and send the real final image off-screen.
+    // Paint onto the FINISHED frame. Deliberately not a chain stage: this is an
+    // overlay, so it neither reads nor replaces ctx.res.ldr, and the image it
+    // paints over is the one the graph presented to defaultFBO.
     glBindFramebuffer(GL_FRAMEBUFFER, ctx.defaultFBO);
     glViewport(0, 0, fp.viewportW, fp.viewportH);
 
@@ -8,10 +8,10 @@
 // UI is composited at final resolution in gamma space, which is where a 2D
 // renderer belongs.
 //
-// This pass is NOT part of the LDR ping-pong chain and must never call
-// nextPostTarget(): it does not transform the image, it paints ON TOP of the
-// finished frame in ctx.defaultFBO. It is deliberately absent from
-// Renderer::countLdrPostPasses_ for the same reason.
+// This pass is NOT part of the LDR post chain and never touches ctx.res.ldr:
+// it does not transform the image, it paints ON TOP of the finished frame in
+// ctx.defaultFBO. It declares a write of the output, which orders it after
+// whichever pass the graph presented there.
 //
 // The pass owns no UI itself. It hands a Renderer2D, already set up in
 // screen space for the current viewport, to a host-supplied callback — so the
@@ -40,6 +40,11 @@ public:
     const char* name() const override { return "UI"; }
     void setup(PassContext&) override;
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
+    // Only with a callback set and a working Renderer2D.
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams&) override {
+        b.Write(ctx.res.output);
+    }
 
 private:
     MyCoreEngine::Renderer2D* r2d_ = nullptr;
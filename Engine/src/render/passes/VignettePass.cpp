@@ -9,37 +9,46 @@
 VignettePass::VignettePass() = default;
 VignettePass::~VignettePass() = default;
 
+// The post-FX uber shader with only its vignette stage (see PostUberPass).
 void VignettePass::setup(PassContext&) {
     shader_ = std::make_unique<MyCoreEngine::Shader>(
-        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/vignette_frag.glsl");
+        "Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/postfx_uber_frag.glsl",
+        "#define POST_VIGNETTE\n");
 }
 
-bool VignettePass::wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene& scene) const {
-    return scene.PostFX().vignette.enabled && shader_ && shader_->isValid();
+bool VignettePass::enabled(const PassContext& ctx, const MyCoreEngine::Scene& scene) const {
+    return scene.PostFX().vignette.enabled && !(ctx.res.fusedPost & kPostVignette) &&
+           shader_ && shader_->isValid();
+}
+
+void VignettePass::declare(RenderGraph::PassBuilder& b, PassContext& ctx, const FrameParams& fp) {
+    in_ = ctx.res.ldr;
+    b.Read(in_);
+    out_ = ctx.res.ldr = b.Create("Vignette", ldrTargetDesc(fp));
 }
 
 bool VignettePass::execute(PassContext& ctx, MyCoreEngine::Scene& scene, Camera&,
                            const FrameParams& fp) {
     const auto& v = scene.PostFX().vignette;
-    // ldrTex_A guards the rare FBO-alloc-failed case (then no chain runs).
-    if (!ctx.ldrTex_A || !wantsLdrSlot(ctx, scene)) return false;
-    const PassContext::PostTarget t = ctx.nextPostTarget();
+    // no source: not declared this frame (or run without a graph)
+    const unsigned src = ctx.texture(in_);
+    if (!src || !enabled(ctx, scene)) return false;
 
-    glBindFramebuffer(GL_FRAMEBUFFER, t.dstFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, ctx.fbo(out_));
     glViewport(0, 0, fp.viewportW, fp.viewportH);
     glDisable(GL_DEPTH_TEST);
 
     shader_->use();
     shader_->setInt("uScene", 0);
-    shader_->setFloat("uIntensity", v.intensity);
-    shader_->setFloat("uRoundness", v.roundness);
-    shader_->setFloat("uSmoothness", v.smoothness);
+    shader_->setFloat("uVignetteIntensity", v.intensity);
+    shader_->setFloat("uVignetteRoundness", v.roundness);
+    shader_->setFloat("uVignetteSmoothness", v.smoothness);
     shader_->setFloat("uAspect", fp.viewportH > 0
                                      ? float(fp.viewportW) / float(fp.viewportH)
                                      : 1.0f);
 
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, t.srcTex);
+    glBindTexture(GL_TEXTURE_2D, src);
 
     glBindVertexArray(ctx.fsQuadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6);
@@ -6,22 +6,24 @@
 namespace MyCoreEngine { class Shader; }
 
 // Radial edge darkening -- a cinematic framing effect. An LDR post pass: it
-// runs after tonemapping on the ping-pong chain (see PassContext), reading the
-// current chain texture and writing the next. Cheap (one fullscreen pass, a
+// runs after tonemapping on the post chain (see PassContext), reading the
+// current chain target and writing its own. Cheap (one fullscreen pass, a
 // handful of ALU), so it is allowed at every quality tier. Parameters come from
 // the scene's PostFXSettings each frame.
 // ENGINE_API so hosts and tests outside the DLL can construct it, matching
 // FXAAPass. Without it the LDR chain could only be exercised through
-// Renderer::RenderFrame, which is why its ping-pong routing went untested.
+// Renderer::RenderFrame, which is why its chain routing went untested.
 class ENGINE_API VignettePass : public IRenderPass {
 public:
     VignettePass();
     ~VignettePass() override;
     const char* name() const override { return "Vignette"; }
     void setup(PassContext&) override;
-    bool wantsLdrSlot(const PassContext&, const MyCoreEngine::Scene&) const override;
+    bool enabled(const PassContext&, const MyCoreEngine::Scene&) const override;
+    void declare(RenderGraph::PassBuilder&, PassContext&, const FrameParams&) override;
     bool execute(PassContext&, MyCoreEngine::Scene&, Camera&, const FrameParams&) override;
 
 private:
     std::unique_ptr<MyCoreEngine::Shader> shader_;
+    RenderGraph::Resource in_ = RenderGraph::kNone, out_ = RenderGraph::kNone;
 };
@@ -9,19 +9,17 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <iterator>
 
 namespace MyCoreEngine {
 
 namespace {
-    // One flush's worth of quads. 4 verts each; the index buffer is built once
-    // for this maximum and reused, so a flush never touches index memory.
+    // One flush's worth of quads, of either stream. 4 verts each; the index
+    // buffer is built once for this maximum and reused, so a flush never
+    // touches index memory. The vertices go to the stream ring, which has no
+    // per-flush size of its own.
     constexpr int kMaxQuadsPerFlush = 4096;
 
-    // Box quads are tens per frame, not thousands, so this buffer is sized for
-    // a realistic worst case rather than for the plain stream's ceiling: 4096
-    // box quads would be 1.1 MB of VBO to serve a few dozen panels.
-    constexpr int kMaxBoxQuadsPerFlush = 512;
-
     constexpr const char* kVertPath = "Exported/Shaders/sprite2d_vert.glsl";
     constexpr const char* kFragPath = "Exported/Shaders/sprite2d_frag.glsl";
     constexpr const char* kBoxVertPath = "Exported/Shaders/sprite2d_box_vert.glsl";
@@ -40,24 +38,12 @@ bool Renderer2D::Init() {
         return false;
     }
 
+    // The vertices themselves stream through stream_; flush_ points the
+    // attributes at its buffer.
     glGenVertexArrays(1, &vao_);
-    glGenBuffers(1, &vbo_);
     glGenBuffers(1, &ibo_);
 
     glBindVertexArray(vao_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER,
-                 sizeof(Vertex) * 4 * kMaxQuadsPerFlush, nullptr, GL_DYNAMIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          (void*)offsetof(Vertex, uv));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-                          (void*)offsetof(Vertex, color));
 
     // Static index buffer: 0,1,2, 2,3,0 per quad, for every quad up front.
     {
@@ -99,49 +85,24 @@ bool Renderer2D::Init() {
                      "background-image will paint as plain squares\n";
     } else {
         glGenVertexArrays(1, &boxVao_);
-        glGenBuffers(1, &boxVbo_);
         glBindVertexArray(boxVao_);
-        glBindBuffer(GL_ARRAY_BUFFER, boxVbo_);
-        glBufferData(GL_ARRAY_BUFFER,
-                     sizeof(BoxVertex) * 4 * kMaxBoxQuadsPerFlush, nullptr,
-                     GL_DYNAMIC_DRAW);
-        // Seven attributes. GL 3.3 guarantees GL_MAX_VERTEX_ATTRIBS >= 16.
-        struct Attr { int loc; int n; std::size_t off; };
-        const Attr kAttrs[] = {
-            { 0, 2, offsetof(BoxVertex, pos)    },
-            { 1, 2, offsetof(BoxVertex, uv)     },
-            { 2, 4, offsetof(BoxVertex, color)  },
-            { 3, 2, offsetof(BoxVertex, local)  },
-            { 4, 2, offsetof(BoxVertex, half)   },
-            { 5, 4, offsetof(BoxVertex, border) },
-            { 6, 2, offsetof(BoxVertex, shape)  },
-        };
-        for (const Attr& a : kAttrs) {
-            glEnableVertexAttribArray(GLuint(a.loc));
-            glVertexAttribPointer(GLuint(a.loc), a.n, GL_FLOAT, GL_FALSE,
-                                  sizeof(BoxVertex), (void*)a.off);
-        }
         // The same 0,1,2, 2,3,0 pattern, so the index buffer is shared.
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
         glBindVertexArray(0);
-        boxVerts_.reserve(4 * 64);
-        boxScratch_.reserve(4 * kMaxBoxQuadsPerFlush);
         roundedReady_ = true;
     }
 
-    cmds_.reserve(1024);
-    verts_.reserve(4 * kMaxQuadsPerFlush);
     ready_ = true;
     return true;
 }
 
 void Renderer2D::Shutdown() {
-    if (vbo_)      { glDeleteBuffers(1, &vbo_);            vbo_ = 0; }
     if (ibo_)      { glDeleteBuffers(1, &ibo_);            ibo_ = 0; }
     if (vao_)      { glDeleteVertexArrays(1, &vao_);       vao_ = 0; }
     if (whiteTex_) { glDeleteTextures(1, &whiteTex_);      whiteTex_ = 0; }
-    if (boxVbo_)   { glDeleteBuffers(1, &boxVbo_);         boxVbo_ = 0; }
     if (boxVao_)   { glDeleteVertexArrays(1, &boxVao_);    boxVao_ = 0; }
+    stream_.Release();
+    vaoBuffer_ = boxVaoBuffer_ = 0;
     shader_.reset();
     boxShader_.reset();
     roundedReady_ = false;
@@ -151,14 +112,22 @@ void Renderer2D::Shutdown() {
 void Renderer2D::beginCommon_(const glm::mat4& viewProj, int vpW, int vpH) {
     viewProj_ = viewProj;
     vpW_ = vpW; vpH_ = vpH;
-    cmds_.clear();
-    boxVerts_.clear();
+    // Sized from the previous frame's quad count (stats_ is reset below), so
+    // a steady UI carves its command list once per frame instead of growing
+    // it by doubling through the arena.
+    frameMem_.BeginFrame();
+    stream_.NextFrame();
+    frameMem_.Refresh(cmds_, std::size_t(stats_.quads));
+    frameMem_.Refresh(boxVerts_, boxVerts_.size());
     clipStack_.clear();
     clipHistory_.clear();
     clipStackIdx_.clear();
     curClip_ = -1;
     seq_ = 0;
     stats_ = Stats{};
+    const FrameAllocator::Stats mem = frameMem_.stats();
+    stats_.frameArenaBytes = mem.lastFrameBytes;
+    stats_.frameArenaPeakBytes = mem.peakFrameBytes;
     inFrame_ = true;
 
     // Snapshot every bit of state we are about to change. The 3D pipeline has
@@ -434,10 +403,12 @@ void Renderer2D::DrawText(const Font& font, const std::string& utf8,
 void Renderer2D::flush_() {
     if (cmds_.empty() || !shader_) return;
 
-    // Stable by (layer, submission order): callers may emit in any order and
-    // still get correct painter's-algorithm output, and equal layers keep the
-    // order they were submitted in.
-    std::stable_sort(cmds_.begin(), cmds_.end(),
+    // By (layer, submission order): callers may emit in any order and still
+    // get correct painter's-algorithm output, and equal layers keep the order
+    // they were submitted in. `seq` is unique, so the key is total and a plain
+    // sort IS the stable sort — without stable_sort's temporary buffer, which
+    // was a heap allocation the size of the whole command list every frame.
+    std::sort(cmds_.begin(), cmds_.end(),
                      [](const Cmd& a, const Cmd& b) {
                          if (a.layer != b.layer) return a.layer < b.layer;
                          return a.seq < b.seq;
@@ -459,37 +430,43 @@ void Renderer2D::flush_() {
         // change already breaks in every real UI, so a panel with a label is
         // still two draw calls, exactly as it was before boxes existed.
         const QuadKind kind = cmds_[i].kind;
-        const size_t runCap = (kind == QuadKind::Box) ? size_t(kMaxBoxQuadsPerFlush)
-                                                      : size_t(kMaxQuadsPerFlush);
         size_t n = 0;
-        verts_.clear();
-        boxScratch_.clear();
-        while (i + n < cmds_.size() && n < runCap &&
+        while (i + n < cmds_.size() && n < size_t(kMaxQuadsPerFlush) &&
                cmds_[i + n].texture == tex && cmds_[i + n].clip == clip &&
                cmds_[i + n].kind == kind) {
-            const Cmd& c = cmds_[i + n];
-            if (kind == QuadKind::Box) {
-                boxScratch_.insert(boxScratch_.end(), boxVerts_.begin() + c.box,
-                                   boxVerts_.begin() + c.box + 4);
-            } else {
-                verts_.insert(verts_.end(), c.v, c.v + 4);
-            }
             ++n;
         }
 
         // Re-set on EVERY run, not hoisted. A shader switch resets neither the
         // uniforms nor the bindings, and a stale uViewProj would silently draw
         // the second and every later plain run with the previous frame's
-        // projection. The GL_ARRAY_BUFFER bind is needed as well as the VAO
-        // bind: a VAO restores the attribute pointers' buffer bindings, not the
-        // current target that glBufferSubData writes through.
+        // projection.
         Shader* sh = (kind == QuadKind::Box) ? boxShader_.get() : shader_.get();
         if (!sh) { i += n; continue; }
         sh->use();
         sh->setMat4("uViewProj", viewProj_);
         sh->setInt("uTex", 0);
+
+        // The run's vertices go straight into the ring at a multiple of the
+        // vertex size, so the draw reaches them with a base vertex.
+        const std::size_t stride = (kind == QuadKind::Box) ? sizeof(BoxVertex) : sizeof(Vertex);
+        const StreamBuffer::Span span = stream_.Map(n * 4 * stride, stride);
+        if (kind == QuadKind::Box) {
+            if (auto* out = static_cast<BoxVertex*>(span.data)) {
+                for (size_t k = 0; k < n; ++k) {
+                    std::copy_n(boxVerts_.begin() + cmds_[i + k].box, 4, out + 4 * k);
+                }
+            }
+        } else if (auto* out = static_cast<Vertex*>(span.data)) {
+            for (size_t k = 0; k < n; ++k) std::copy_n(cmds_[i + k].v, 4, out + 4 * k);
+        }
+        stream_.Unmap();
         glBindVertexArray(kind == QuadKind::Box ? boxVao_ : vao_);
-        glBindBuffer(GL_ARRAY_BUFFER, kind == QuadKind::Box ? boxVbo_ : vbo_);
+        unsigned& pointed = (kind == QuadKind::Box) ? boxVaoBuffer_ : vaoBuffer_;
+        if (pointed != span.buffer) { // the ring grew into a new buffer
+            pointAttribs_(kind, span.buffer);
+            pointed = span.buffer;
+        }
 
         if (clip >= 0 && clip < int(clipHistory_.size())) {
             const ClipRect& r = clipHistory_[size_t(clip)];
@@ -514,15 +491,8 @@ void Renderer2D::flush_() {
         }
 
         glBindTexture(GL_TEXTURE_2D, tex);
-        if (kind == QuadKind::Box) {
-            glBufferSubData(GL_ARRAY_BUFFER, 0,
-                            GLsizeiptr(boxScratch_.size() * sizeof(BoxVertex)),
-                            boxScratch_.data());
-        } else {
-            glBufferSubData(GL_ARRAY_BUFFER, 0,
-                            GLsizeiptr(verts_.size() * sizeof(Vertex)), verts_.data());
-        }
-        glDrawElements(GL_TRIANGLES, GLsizei(n * 6), GL_UNSIGNED_INT, nullptr);
+        glDrawElementsBaseVertex(GL_TRIANGLES, GLsizei(n * 6), GL_UNSIGNED_INT, nullptr,
+                                 GLint(span.offset / stride));
         ++stats_.drawCalls;
         ++stats_.flushes;
         i += n;
@@ -532,6 +502,35 @@ void Renderer2D::flush_() {
     cmds_.clear();
 }
 
+void Renderer2D::pointAttribs_(QuadKind kind, unsigned buffer) {
+    // the kind's VAO is bound
+    struct Attr { int loc; int n; std::size_t off; };
+    const Attr kPlain[] = {
+        { 0, 2, offsetof(Vertex, pos)   },
+        { 1, 2, offsetof(Vertex, uv)    },
+        { 2, 4, offsetof(Vertex, color) },
+    };
+    // Seven attributes. GL 3.3 guarantees GL_MAX_VERTEX_ATTRIBS >= 16.
+    const Attr kBox[] = {
+        { 0, 2, offsetof(BoxVertex, pos)    },
+        { 1, 2, offsetof(BoxVertex, uv)     },
+        { 2, 4, offsetof(BoxVertex, color)  },
+        { 3, 2, offsetof(BoxVertex, local)  },
+        { 4, 2, offsetof(BoxVertex, half)   },
+        { 5, 4, offsetof(BoxVertex, border) },
+        { 6, 2, offsetof(BoxVertex, shape)  },
+    };
+    const bool box = kind == QuadKind::Box;
+    const Attr* first = box ? std::begin(kBox) : std::begin(kPlain);
+    const Attr* last = box ? std::end(kBox) : std::end(kPlain);
+    const GLsizei stride = box ? GLsizei(sizeof(BoxVertex)) : GLsizei(sizeof(Vertex));
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (const Attr* a = first; a != last; ++a) {
+        glEnableVertexAttribArray(GLuint(a->loc));
+        glVertexAttribPointer(GLuint(a->loc), a->n, GL_FLOAT, GL_FALSE, stride, (void*)a->off);
+    }
+}
+
 TexRegion CoverRegion(const glm::vec2& boxPx, const glm::vec2& imagePx) {
     if (boxPx.x <= 0.0f || boxPx.y <= 0.0f ||
         imagePx.x <= 0.0f || imagePx.y <= 0.0f) {
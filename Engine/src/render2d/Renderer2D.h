@@ -21,7 +21,13 @@
 // must change (different texture, clip rect, or the buffer fills). Sort layer
 // is applied as a stable sort before flushing, so a caller can emit in any
 // order and still get correct back-to-front painting.
+//
+// MEMORY: the quad commands are per-frame, so they live in a FrameAllocator
+// rewound at every Begin*, not in vectors that keep the capacity of the
+// busiest frame ever drawn.
 #include "../core/Core.h"
+#include "../core/FrameAllocator.h"
+#include "../core/StreamBuffer.h"
 
 #include <glm/glm.hpp>
 
@@ -167,6 +173,10 @@ namespace MyCoreEngine {
             int drawCalls = 0;
             int quads = 0;
             int flushes = 0; // state-change flushes; drawCalls == flushes
+            // Command memory of the last rewound Begin..End (one behind, see
+            // FrameAllocator::Stats), and its high-water mark.
+            std::size_t frameArenaBytes = 0;
+            std::size_t frameArenaPeakBytes = 0;
         };
         const Stats& stats() const { return stats_; }
 
@@ -183,7 +193,7 @@ namespace MyCoreEngine {
         // Which vertex stream (and therefore which shader) a quad belongs to.
         //
         // A discriminant on Cmd rather than a wider Vertex, because flush_
-        // stable_sorts Cmd BY VALUE: widening Vertex to carry the box fields
+        // sorts Cmd BY VALUE: widening Vertex to carry the box fields
         // would take sizeof(Cmd) from 144 to 304 bytes and more than double the
         // sort cost of every frame — a bill paid overwhelmingly by GLYPHS,
         // which are the great majority of quads and need none of it.
@@ -221,22 +231,29 @@ namespace MyCoreEngine {
 
         void beginCommon_(const glm::mat4& viewProj, int vpW, int vpH);
         void flush_();
+        // Points the kind's VAO attributes at `buffer` from byte 0; each run
+        // then picks its vertices with a base vertex.
+        void pointAttribs_(QuadKind kind, unsigned buffer);
         void pushQuad_(const Vertex v[4], unsigned texture, int layer);
         void pushBoxQuad_(const BoxVertex v[4], unsigned texture, int layer);
 
         bool ready_ = false;
         bool roundedReady_ = false;
-        unsigned vao_ = 0, vbo_ = 0, ibo_ = 0, whiteTex_ = 0;
-        unsigned boxVao_ = 0, boxVbo_ = 0;
+        unsigned vao_ = 0, ibo_ = 0, whiteTex_ = 0;
+        unsigned boxVao_ = 0;
+        // Both vertex streams, written straight into a fenced ring (see
+        // StreamBuffer), and the buffer each VAO's attributes point at.
+        StreamBuffer stream_;
+        unsigned vaoBuffer_ = 0, boxVaoBuffer_ = 0;
         std::unique_ptr<Shader> shader_;
         std::unique_ptr<Shader> boxShader_;
 
-        std::vector<Cmd>    cmds_;
-        std::vector<Vertex> verts_;   // scratch, reused across frames
+        // Declared before the lists that point into it, so it outlives them.
+        FrameAllocator frameMem_;
+        FrameVector<Cmd>    cmds_;
         // Submission-ordered, 4 per box quad; Cmd::box indexes it. Kept beside
         // the commands rather than inside them so a glyph Cmd stays 148 bytes.
-        std::vector<BoxVertex> boxVerts_;
-        std::vector<BoxVertex> boxScratch_;
+        FrameVector<BoxVertex> boxVerts_;
         std::vector<ClipRect> clipStack_;
         std::vector<ClipRect> clipHistory_; // resolved (intersected) rects
         // History index per stack level, so Pop restores its parent in O(1)
@@ -2,6 +2,7 @@
 
 #include "UIElement.h"
 #include "UIRepeat.h"   // kRepeatPresentProp -- the absent-slot gate
+#include "../core/Profiler.h"
 
 #include <algorithm>
 #include <cctype>
@@ -423,6 +424,7 @@ void UIBinder::noteShadowedDeclarations_(const UIElement& el, const UIStyleSheet
 
 void UIBinder::Rebuild(UIDocument& doc, UIBindingContext& ctx, std::string originName,
                        const UIStyleSheet* sheet) {
+    CSE_PROFILE_ZONE("UIBinder::Rebuild");
     entries_.clear();
     actions_.clear();
     convPool_.clear();
@@ -774,6 +776,7 @@ void UIBinder::recascadeFor_(UIElement* el) {
 }
 
 UIBindTick UIBinder::UpdateToSource() {
+    CSE_PROFILE_ZONE("UIBinder::UpdateToSource");
     UIBindTick tick;
     if (!doc_ || !ctx_) return tick;
 
@@ -861,6 +864,7 @@ void UIBinder::stampHoles_(Entry& e) {
 }
 
 UIBindTick UIBinder::UpdateToTarget() {
+    CSE_PROFILE_ZONE("UIBinder::UpdateToTarget");
     UIBindTick tick;
     if (!doc_ || !ctx_) return tick;
 
@@ -2,6 +2,7 @@
 
 #include "../render2d/Font.h"
 #include "../render2d/Renderer2D.h"
+#include "../core/Profiler.h"
 
 #include <yoga/Yoga.h>
 
@@ -807,6 +808,7 @@ bool UIElement::ScrollIntoView(const glm::vec2& posAbs, const glm::vec2& sizePx)
 }
 
 void UIDocument::Layout(float viewportW, float viewportH, const Font* font) {
+    CSE_PROFILE_ZONE("UIDocument::Layout");
     // Computed from the SURFACE, never from the viewport this document was
     // given: a document that occupies a corner of the screen must scale by how
     // big the SCREEN is, or a quarter-width panel would shrink its own text on
@@ -81,7 +81,23 @@ namespace {
         }
     }
 
+    // F9 writes the profiler's recent history as a Chrome trace into the
+    // working directory. Handled HERE, ahead of the UI mapping, because F9 is
+    // not a UI key and a game that bound it through InputMap would still get
+    // it -- this only reads the press. A fresh press only: auto-repeat would
+    // write a file per repeat while the key is held.
+    void captureProfilerTrace() {
+        static int n = 0;
+        const std::string path = "cse-trace-" + std::to_string(++n) + ".json";
+        std::string err;
+        if (MyCoreEngine::Profiler::WriteChromeTrace(path, &err))
+            std::cerr << "PLAYER: profiler trace written to " << path << std::endl;
+        else
+            std::cerr << "PLAYER: profiler trace not written: " << err << std::endl;
+    }
+
     void onKey(GLFWwindow*, int key, int, int action, int mods) {
+        if (key == GLFW_KEY_F9 && action == GLFW_PRESS) captureProfilerTrace();
         if (action == GLFW_RELEASE) return;  // press and auto-repeat only
         const MyCoreEngine::ui::UIKey k = mapKey(key);
         if (k == MyCoreEngine::ui::UIKey::None) return;
@@ -132,6 +148,7 @@ public:
         InitGL();
 
         AssetManager assets;
+        assets.SetIOService(&io()); // model files are read by the app's I/O thread
         Shader shader("Exported/Shaders/vertex.glsl", "Exported/Shaders/frag.glsl");
         if (!shader.isValid()) {
             fatal("shader failed to build — cannot render.");
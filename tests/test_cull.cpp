@@ -0,0 +1,592 @@
+// Visibility culling: the SoA bounds cache, its loose octree, the SIMD
+// cull kernel and the render proxies the loops after it read. Headless
+// tests — no GL needed; entities carry an empty ModelComponent, which is
+// all the cache looks at.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+namespace {
+
+// Deterministic scatter, so a failure reproduces.
+struct Lcg {
+    uint32_t s;
+    float next(float lo, float hi) {
+        s = s * 1664525u + 1013904223u;
+        return lo + (hi - lo) * float(s >> 8) / float(1u << 24);
+    }
+};
+
+Transform randomTransform(Lcg& rng, float spread) {
+    Transform t{};
+    t.position = { rng.next(-spread, spread), rng.next(-spread * 0.1f, spread * 0.1f), rng.next(-spread, spread) };
+    t.rotation = { rng.next(0.f, 360.f), rng.next(0.f, 360.f), rng.next(0.f, 360.f) };
+    t.scale = { rng.next(0.2f, 4.f), rng.next(0.2f, 4.f), rng.next(0.2f, 4.f) };
+    t.updateMatrix();
+    return t;
+}
+
+AABB randomBox(Lcg& rng) {
+    const glm::vec3 lo{ rng.next(-3.f, 0.f), rng.next(-3.f, 0.f), rng.next(-3.f, 0.f) };
+    return AABB{ lo, lo + glm::vec3(rng.next(0.05f, 6.f), rng.next(0.05f, 6.f), rng.next(0.05f, 6.f)) };
+}
+
+entt::entity makeRenderable(entt::registry& reg, const Transform& t, const AABB& b) {
+    const entt::entity e = reg.create();
+    reg.emplace<Transform>(e, t);
+    reg.emplace<AABB>(e, b);
+    reg.emplace<ModelComponent>(e);
+    return e;
+}
+
+Camera lookingDownMinusZ() {
+    Camera cam({ 0.f, 5.f, 0.f });
+    return cam; // default yaw faces -Z
+}
+
+CullParams paramsFor(const Camera& cam, float viewportH, float minPixels) {
+    CullParams p;
+    p.camX = cam.Position.x; p.camY = cam.Position.y; p.camZ = cam.Position.z;
+    p.tanHalfFov = std::tan(glm::radians(60.f) * 0.5f);
+    p.viewportHeightPx = viewportH;
+    p.minPixels = minPixels;
+    p.screenCull = minPixels > 0.f;
+    p.lodEnabled = true;
+    p.lodDistanceScale = 1.f;
+    return p;
+}
+
+// The per-entity code RenderScene ran before the cache, verbatim.
+struct LegacyResult { CullResult result; int lod; };
+LegacyResult legacyCull(const Frustum& f, const CullParams& p, const Transform& t, const AABB& bounds) {
+    if (!bounds.isOnFrustum(f, t)) return { kCullFrustum, 0 };
+    const glm::vec3 localC = (bounds.min + bounds.max) * 0.5f;
+    const glm::vec3 worldC = glm::vec3(t.modelMatrix * glm::vec4(localC, 1.f));
+    const float maxScale = std::max({ glm::length(glm::vec3(t.modelMatrix[0])),
+                                      glm::length(glm::vec3(t.modelMatrix[1])),
+                                      glm::length(glm::vec3(t.modelMatrix[2])) });
+    const float radius = std::max(0.01f, glm::length(bounds.max - bounds.min) * 0.5f * maxScale);
+    const float dist = glm::length(worldC - glm::vec3(p.camX, p.camY, p.camZ));
+    if (p.screenCull && dist > 1e-3f) {
+        const float pixelH = p.viewportHeightPx * radius / (dist * p.tanHalfFov);
+        if (pixelH < p.minPixels) return { kCullSmall, 0 };
+    }
+    const float ratio = dist / (radius * p.lodDistanceScale);
+    return { kCullVisible, (ratio > 60.f) ? 2 : (ratio > 25.f) ? 1 : 0 };
+}
+
+// Culls until every member has sat still long enough to move into the tree.
+void settleAll(BoundsCache& cache, const CullPlanes& planes, const CullParams& p) {
+    for (int guard = 0; guard < 1000 && cache.stats().dynamic > 0; ++guard) {
+        cache.Cull(planes, p);
+        cache.Sync();
+    }
+    ASSERT_EQ(cache.stats().dynamic, 0u);
+}
+
+// Hits() against legacyCull for every member; returns how often each
+// outcome came up.
+void expectLegacyDecisions(const BoundsCache& cache, entt::registry& reg,
+                           const Frustum& f, const CullParams& p, int counts[3]) {
+    std::unordered_map<entt::entity, BoundsCache::Hit> hits;
+    for (const auto& h : cache.Hits()) {
+        EXPECT_TRUE(hits.emplace(h.entity, h).second) << "reported twice";
+    }
+    for (std::size_t i = 0; i < cache.Size(); ++i) {
+        const entt::entity e = cache.Entity(i);
+        const LegacyResult want = legacyCull(f, p, reg.get<Transform>(e), reg.get<AABB>(e));
+        ++counts[want.result];
+        const auto it = hits.find(e);
+        if (want.result == kCullFrustum) {
+            EXPECT_TRUE(it == hits.end()) << "slot " << i;
+            continue;
+        }
+        ASSERT_TRUE(it != hits.end()) << "slot " << i;
+        EXPECT_EQ(it->second.result, want.result) << "slot " << i;
+        if (want.result == kCullVisible) EXPECT_EQ(it->second.lod, want.lod) << "slot " << i;
+    }
+}
+
+// Same arithmetic, in the same order, as the kernel's frustum test.
+bool boxOutside(const CullPlanes& pl, const glm::vec3& c, const glm::vec3& e) {
+    for (int k = 0; k < 6; ++k) {
+        const float r = e.x * std::abs(pl.nx[k]) + e.y * std::abs(pl.ny[k]) + e.z * std::abs(pl.nz[k]);
+        const float s = pl.nx[k] * c.x + pl.ny[k] * c.y + pl.nz[k] * c.z - pl.d[k];
+        if (-r > s) return true;
+    }
+    return false;
+}
+
+bool rayEntersBox(const glm::vec3& o, const glm::vec3& d, float maxT, const glm::vec3& c, const glm::vec3& e) {
+    float t0 = 0.f, t1 = maxT;
+    for (int a = 0; a < 3; ++a) {
+        const float mn = c[a] - e[a], mx = c[a] + e[a];
+        if (std::abs(d[a]) < 1e-8f) {
+            if (o[a] < mn || o[a] > mx) return false;
+            continue;
+        }
+        float tA = (mn - o[a]) / d[a], tB = (mx - o[a]) / d[a];
+        if (tA > tB) std::swap(tA, tB);
+        t0 = std::max(t0, tA);
+        t1 = std::min(t1, tB);
+        if (t0 > t1) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(Cull, CacheDecidesExactlyWhatThePerEntityTestsDid) {
+    entt::registry reg;
+    BoundsCache cache(reg);
+    Lcg rng{ 7u };
+    for (int i = 0; i < 5000; ++i) makeRenderable(reg, randomTransform(rng, 300.f), randomBox(rng));
+    cache.Sync();
+    ASSERT_EQ(cache.Size(), 5000u);
+
+    const Camera cam = lookingDownMinusZ();
+    const Frustum f = createFrustumFromCamera(cam, 16.f / 9.f, glm::radians(60.f), 0.1f, 400.f);
+    const CullPlanes planes = BoundsCache::PlanesFrom(f);
+    const CullParams p = paramsFor(cam, 1080.f, 4.f);
+
+    // all dynamic: the linear pass
+    cache.Cull(planes, p);
+    int counts[3] = {};
+    expectLegacyDecisions(cache, reg, f, p, counts);
+    // the scatter has to exercise every outcome, or this proves little
+    EXPECT_GT(counts[kCullFrustum], 0);
+    EXPECT_GT(counts[kCullSmall], 0);
+    EXPECT_GT(counts[kCullVisible], 0);
+
+    // all settled: the same decisions through the octree
+    settleAll(cache, planes, p);
+    cache.Cull(planes, p);
+    int settledCounts[3] = {};
+    expectLegacyDecisions(cache, reg, f, p, settledCounts);
+}
+
+TEST(Cull, SimdPathMatchesTheScalarOneBitForBit) {
+    // An odd count, so the vector loop leaves a scalar tail.
+    constexpr std::size_t kCount = 10007;
+    Lcg rng{ 99u };
+    std::vector<float> cx(kCount), cy(kCount), cz(kCount), ex(kCount), ey(kCount), ez(kCount), r(kCount);
+    for (std::size_t i = 0; i < kCount; ++i) {
+        cx[i] = rng.next(-500.f, 500.f); cy[i] = rng.next(-50.f, 50.f); cz[i] = rng.next(-500.f, 500.f);
+        ex[i] = rng.next(0.f, 8.f); ey[i] = rng.next(0.f, 8.f); ez[i] = rng.next(0.f, 8.f);
+        r[i] = std::max(0.01f, std::sqrt(ex[i] * ex[i] + ey[i] * ey[i] + ez[i] * ez[i]));
+    }
+    CullInput in;
+    in.cx = cx.data(); in.cy = cy.data(); in.cz = cz.data();
+    in.ex = ex.data(); in.ey = ey.data(); in.ez = ez.data();
+    in.radius = r.data();
+    in.count = kCount;
+
+    const Camera cam = lookingDownMinusZ();
+    const CullPlanes planes = BoundsCache::PlanesFrom(
+        createFrustumFromCamera(cam, 16.f / 9.f, glm::radians(60.f), 0.1f, 600.f));
+    for (float minPixels : { 0.f, 2.f, 12.f }) {
+        CullParams p = paramsFor(cam, 1080.f, minPixels);
+        for (bool lod : { false, true }) {
+            p.lodEnabled = lod;
+            std::vector<uint8_t> resS(kCount), lodS(kCount), resV(kCount, 0xff), lodV(kCount, 0xff);
+            CullBoundsScalar(in, planes, p, resS.data(), lodS.data());
+            CullBounds(in, planes, p, resV.data(), lodV.data());
+            EXPECT_EQ(0, std::memcmp(resS.data(), resV.data(), kCount))
+                << CullBackendName() << ", minPixels " << minPixels << ", lod " << lod;
+            EXPECT_EQ(0, std::memcmp(lodS.data(), lodV.data(), kCount))
+                << CullBackendName() << ", minPixels " << minPixels << ", lod " << lod;
+        }
+    }
+}
+
+TEST(Cull, MembershipFollowsTheComponents) {
+    entt::registry reg;
+    BoundsCache cache(reg);
+    Lcg rng{ 3u };
+    const entt::entity a = makeRenderable(reg, randomTransform(rng, 10.f), randomBox(rng));
+    const entt::entity b = makeRenderable(reg, randomTransform(rng, 10.f), randomBox(rng));
+    const entt::entity c = makeRenderable(reg, randomTransform(rng, 10.f), randomBox(rng));
+    const entt::entity bare = reg.create();
+    reg.emplace<Transform>(bare);
+    reg.emplace<AABB>(bare, randomBox(rng)); // no ModelComponent: not renderable
+    cache.Sync();
+    EXPECT_EQ(cache.Size(), 3u);
+    EXPECT_EQ(cache.SlotOf(bare), -1);
+
+    // losing one component leaves; the swapped-in slot stays addressable
+    reg.remove<AABB>(a);
+    EXPECT_EQ(cache.Size(), 2u);
+    EXPECT_EQ(cache.SlotOf(a), -1);
+    for (entt::entity e : { b, c }) {
+        const int32_t s = cache.SlotOf(e);
+        ASSERT_GE(s, 0);
+        EXPECT_EQ(cache.Entity(std::size_t(s)), e);
+    }
+
+    // a replaced AABB is picked up by the next Sync
+    const AABB bigger{ glm::vec3(-10.f), glm::vec3(10.f) };
+    reg.emplace_or_replace<AABB>(b, bigger);
+    cache.Sync();
+    const Transform& tb = reg.get<Transform>(b);
+    const glm::vec3 want = glm::vec3(tb.modelMatrix * glm::vec4(bigger.center, 1.f));
+    const glm::vec3 got = cache.Center(std::size_t(cache.SlotOf(b)));
+    EXPECT_FLOAT_EQ(got.x, want.x);
+    EXPECT_FLOAT_EQ(got.y, want.y);
+    EXPECT_FLOAT_EQ(got.z, want.z);
+
+    // so is a Transform replaced wholesale (undo restores a clean one)
+    Transform moved = reg.get<Transform>(c);
+    moved.position += glm::vec3(100.f, 0.f, 0.f);
+    moved.updateMatrix();
+    reg.emplace_or_replace<Transform>(c, moved);
+    cache.Sync();
+    EXPECT_FLOAT_EQ(cache.Center(std::size_t(cache.SlotOf(c))).x,
+                    (moved.modelMatrix * glm::vec4(reg.get<AABB>(c).center, 1.f)).x);
+
+    // destroyed entities leave, and a recycled handle is a stranger
+    reg.destroy(c);
+    EXPECT_EQ(cache.SlotOf(c), -1);
+    const entt::entity recycled = reg.create();
+    EXPECT_EQ(cache.SlotOf(recycled), -1);
+    EXPECT_EQ(cache.Size(), 1u);
+}
+
+TEST(Cull, UpdateTransformsKeepsTheBoundsOfMovedEntities) {
+    Scene scene;
+    auto& reg = scene.registry;
+    const AABB box{ glm::vec3(-1.f), glm::vec3(1.f) };
+    Transform pt{};
+    const entt::entity parent = makeRenderable(reg, pt, box);
+    Transform ct{};
+    ct.position = { 0.f, 2.f, 0.f };
+    const entt::entity child = makeRenderable(reg, ct, box);
+    reg.emplace<Parent>(child, Parent{ parent });
+    scene.UpdateTransforms();
+
+    auto centerOf = [&](entt::entity e) {
+        const int32_t s = scene.Bounds().SlotOf(e);
+        EXPECT_GE(s, 0);
+        return s >= 0 ? scene.Bounds().Center(std::size_t(s)) : glm::vec3(NAN);
+    };
+    EXPECT_FLOAT_EQ(centerOf(child).y, 2.f);
+
+    // moving only the parent carries the child's cached bounds along
+    auto& p = reg.get<Transform>(parent);
+    p.position = { 5.f, 0.f, 0.f };
+    p.scale = glm::vec3(3.f);
+    p.dirty = true;
+    scene.UpdateTransforms();
+    EXPECT_FLOAT_EQ(centerOf(parent).x, 5.f);
+    EXPECT_FLOAT_EQ(centerOf(child).x, 5.f);
+    EXPECT_FLOAT_EQ(centerOf(child).y, 6.f);
+    const int32_t cs = scene.Bounds().SlotOf(child);
+    EXPECT_FLOAT_EQ(scene.Bounds().Extents(std::size_t(cs)).x, 3.f);
+    EXPECT_FLOAT_EQ(scene.Bounds().Radius(std::size_t(cs)), std::sqrt(12.f) * 0.5f * 3.f);
+}
+
+// The draw-list loops read NoShadow and MaterialOverrides through the
+// RenderProxy Scene keeps beside every ModelComponent, so its bits must
+// track every way those components come and go.
+TEST(Cull, RenderProxyFollowsTheComponents) {
+    Scene scene;
+    auto& reg = scene.registry;
+    Lcg rng{ 11u };
+    auto flags = [&](entt::entity e) { return reg.get<RenderProxy>(e).flags; };
+
+    const entt::entity plain = makeRenderable(reg, randomTransform(rng, 10.f), randomBox(rng));
+    EXPECT_EQ(flags(plain), RenderProxy::kCastsShadow);
+
+    // flags set before the model arrives are picked up when it does
+    const entt::entity late = reg.create();
+    reg.emplace<NoShadow>(late);
+    reg.emplace<MaterialOverrides>(late);
+    EXPECT_FALSE(reg.any_of<RenderProxy>(late));
+    reg.emplace<ModelComponent>(late);
+    EXPECT_EQ(flags(late), RenderProxy::kHasOverrides);
+
+    reg.emplace<NoShadow>(plain);
+    EXPECT_EQ(flags(plain), 0);
+    reg.emplace<MaterialOverrides>(plain);
+    EXPECT_EQ(flags(plain), RenderProxy::kHasOverrides);
+    reg.emplace_or_replace<MaterialOverrides>(plain); // a replace keeps it
+    EXPECT_EQ(flags(plain), RenderProxy::kHasOverrides);
+    reg.remove<NoShadow>(plain);
+    reg.remove<MaterialOverrides>(plain);
+    EXPECT_EQ(flags(plain), RenderProxy::kCastsShadow);
+
+    // it leaves with the model, and a replaced model keeps it current
+    reg.emplace<NoShadow>(late);
+    reg.emplace_or_replace<ModelComponent>(late);
+    EXPECT_EQ(flags(late), RenderProxy::kHasOverrides);
+    reg.remove<ModelComponent>(late);
+    EXPECT_FALSE(reg.any_of<RenderProxy>(late));
+    reg.destroy(plain);
+    EXPECT_TRUE(reg.storage<RenderProxy>().empty());
+
+    scene.ResetToDefaults();
+    const entt::entity fresh = makeRenderable(reg, randomTransform(rng, 10.f), randomBox(rng));
+    EXPECT_EQ(flags(fresh), RenderProxy::kCastsShadow);
+}
+
+TEST(Cull, RenderProxyAnswersWhatTheLookupsDid) {
+    // What the draw-list loops ask per hit: does it cast, does it have
+    // overrides. The proxy must give the component probes' answer for
+    // every entity. The 100k timing of both is CullPerf in test_perf_cpu.
+    Scene scene;
+    auto& reg = scene.registry;
+    Lcg rng{ 77u };
+    std::size_t casters = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const entt::entity e = makeRenderable(reg, randomTransform(rng, 100.f), randomBox(rng));
+        if (i % 10 == 3) reg.emplace<NoShadow>(e);
+        if (i % 10 == 7) reg.emplace<MaterialOverrides>(e);
+    }
+    for (auto e : reg.view<ModelComponent>()) {
+        const uint8_t f = reg.get<RenderProxy>(e).flags;
+        EXPECT_EQ((f & RenderProxy::kCastsShadow) != 0, !reg.any_of<NoShadow>(e));
+        EXPECT_EQ((f & RenderProxy::kHasOverrides) != 0, reg.any_of<MaterialOverrides>(e));
+        casters += (f & RenderProxy::kCastsShadow) != 0;
+    }
+    EXPECT_EQ(casters, 900u);
+}
+
+TEST(Cull, StillEntitiesSettleAndMovedOnesComeBack) {
+    entt::registry reg;
+    BoundsCache cache(reg);
+    const AABB box{ glm::vec3(-1.f), glm::vec3(1.f) };
+    Transform t{};
+    t.position = { 0.f, 5.f, -20.f };
+    t.updateMatrix();
+    const entt::entity still = makeRenderable(reg, t, box);
+    t.position.x = 4.f;
+    t.updateMatrix();
+    const entt::entity mover = makeRenderable(reg, t, box);
+    cache.Sync();
+
+    const Camera cam = lookingDownMinusZ();
+    const CullPlanes planes = BoundsCache::PlanesFrom(
+        createFrustumFromCamera(cam, 16.f / 9.f, glm::radians(60.f), 0.1f, 400.f));
+    const CullParams p = paramsFor(cam, 1080.f, 0.f);
+
+    const uint64_t unsettled = cache.SettledEpoch();
+    for (uint32_t frame = 0; frame < BoundsCache::kSettleFrames; ++frame) {
+        EXPECT_FALSE(cache.IsSettled(still)) << "frame " << frame;
+        cache.Cull(planes, p);
+        cache.Sync();
+    }
+    EXPECT_TRUE(cache.IsSettled(still));
+    EXPECT_TRUE(cache.IsSettled(mover));
+    EXPECT_EQ(cache.stats().tree.items, 2u);
+    // settling changed the settled set; sitting still does not
+    const uint64_t settled = cache.SettledEpoch();
+    EXPECT_NE(settled, unsettled);
+    cache.Cull(planes, p);
+    cache.Sync();
+    EXPECT_EQ(cache.SettledEpoch(), settled);
+
+    // a replaced model (new meshes, new casters) counts as a move
+    const uint64_t beforeModel = cache.SettledEpoch();
+    const ModelComponent sameModel = reg.get<ModelComponent>(still);
+    reg.emplace_or_replace<ModelComponent>(still, sameModel);
+    cache.Sync();
+    EXPECT_FALSE(cache.IsSettled(still));
+    EXPECT_NE(cache.SettledEpoch(), beforeModel);
+    for (uint32_t frame = 0; frame < BoundsCache::kSettleFrames; ++frame) {
+        cache.Cull(planes, p);
+        cache.Sync();
+    }
+    ASSERT_TRUE(cache.IsSettled(still));
+
+    // moving one puts it back on the dynamic list at once...
+    const uint64_t beforeMove = cache.SettledEpoch();
+    t.position.x = 2000.f; // and out of view
+    t.updateMatrix();
+    cache.Update(mover, t.modelMatrix, box);
+    cache.Sync();
+    EXPECT_FALSE(cache.IsSettled(mover));
+    EXPECT_TRUE(cache.IsSettled(still));
+    EXPECT_EQ(cache.stats().dynamic, 1u);
+    EXPECT_NE(cache.SettledEpoch(), beforeMove);
+    EXPECT_FLOAT_EQ(cache.Center(std::size_t(cache.SlotOf(mover))).x, 2000.f);
+
+    // ...where the cull sees its new place, not the one the tree had
+    cache.Cull(planes, p);
+    ASSERT_EQ(cache.Hits().size(), 1u);
+    EXPECT_EQ(cache.Hits()[0].entity, still);
+
+    // leaving takes a settled entity out of the tree too
+    const uint64_t beforeLeave = cache.SettledEpoch();
+    reg.destroy(still);
+    EXPECT_EQ(cache.stats().tree.items, 0u);
+    EXPECT_NE(cache.SettledEpoch(), beforeLeave);
+    EXPECT_EQ(cache.Size(), 1u);
+}
+
+TEST(Cull, QueryAndRaycastFindWhatABruteForceScanFinds) {
+    entt::registry reg;
+    BoundsCache cache(reg);
+    Lcg rng{ 11u };
+    std::vector<entt::entity> all;
+    for (int i = 0; i < 4000; ++i) all.push_back(makeRenderable(reg, randomTransform(rng, 400.f), randomBox(rng)));
+    cache.Sync();
+
+    const Camera cam = lookingDownMinusZ();
+    const CullPlanes camPlanes = BoundsCache::PlanesFrom(
+        createFrustumFromCamera(cam, 16.f / 9.f, glm::radians(60.f), 0.1f, 400.f));
+    settleAll(cache, camPlanes, paramsFor(cam, 1080.f, 0.f));
+    // a mix: every fourth moves, so it is dynamic again
+    for (std::size_t i = 0; i < all.size(); i += 4) {
+        Transform moved = randomTransform(rng, 400.f);
+        cache.Update(all[i], moved.modelMatrix, reg.get<AABB>(all[i]));
+    }
+    cache.Sync();
+    ASSERT_GT(cache.stats().dynamic, 0u);
+    ASSERT_GT(cache.stats().tree.items, 0u);
+
+    // a shadow cascade's volume
+    const glm::mat4 lightVP = glm::ortho(-120.f, 120.f, -120.f, 120.f, 1.f, 600.f) *
+        glm::lookAt(glm::vec3(100.f, 300.f, 50.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    const CullPlanes light = BoundsCache::PlanesFromClip(lightVP);
+    std::vector<entt::entity> found;
+    BoundsCache::QueryScratch scratch;
+    cache.Query(light, found, scratch);
+    std::set<entt::entity> want;
+    for (std::size_t i = 0; i < cache.Size(); ++i) {
+        if (!boxOutside(light, cache.Center(i), cache.Extents(i))) want.insert(cache.Entity(i));
+    }
+    EXPECT_EQ(found.size(), want.size()) << "duplicates or misses";
+    EXPECT_EQ(std::set<entt::entity>(found.begin(), found.end()), want);
+    EXPECT_GT(want.size(), 0u);
+
+    // the settled and dynamic halves partition it
+    std::vector<entt::entity> settledHits, dynamicHits;
+    cache.Query(light, settledHits, scratch, BoundsCache::Members::Settled);
+    cache.Query(light, dynamicHits, scratch, BoundsCache::Members::Dynamic);
+    EXPECT_EQ(settledHits.size() + dynamicHits.size(), found.size());
+    std::set<entt::entity> both(settledHits.begin(), settledHits.end());
+    both.insert(dynamicHits.begin(), dynamicHits.end());
+    EXPECT_EQ(both, want);
+    for (auto e : settledHits) EXPECT_TRUE(cache.IsSettled(e));
+    for (auto e : dynamicHits) EXPECT_FALSE(cache.IsSettled(e));
+    EXPECT_GT(settledHits.size(), 0u);
+    EXPECT_GT(dynamicHits.size(), 0u);
+
+    for (int ray = 0; ray < 50; ++ray) {
+        const glm::vec3 o{ rng.next(-450.f, 450.f), rng.next(-60.f, 60.f), rng.next(-450.f, 450.f) };
+        const glm::vec3 d{ rng.next(-1.f, 1.f), rng.next(-0.2f, 0.2f), rng.next(-1.f, 1.f) };
+        const float maxT = ray % 2 ? FLT_MAX : 300.f;
+        std::vector<BoundsCache::RayHit> hits;
+        cache.Raycast(o, d, maxT, hits);
+        std::set<entt::entity> got, expected;
+        for (const auto& h : hits) got.insert(h.entity);
+        for (std::size_t i = 0; i < cache.Size(); ++i) {
+            if (rayEntersBox(o, d, maxT, cache.Center(i), cache.Extents(i))) expected.insert(cache.Entity(i));
+        }
+        EXPECT_EQ(got, expected) << "ray " << ray;
+    }
+}
+
+TEST(LooseOctree, MatchesABruteForceScanThroughEdits) {
+    Lcg rng{ 5u };
+    constexpr uint32_t kItems = 3000;
+    struct Item { float c[3], e[3]; bool in = false; };
+    std::vector<Item> items(kItems);
+    LooseOctree tree;
+    auto place = [&](uint32_t k, float spread, float maxExt) {
+        for (int a = 0; a < 3; ++a) {
+            items[k].c[a] = rng.next(-spread, spread);
+            items[k].e[a] = rng.next(0.f, maxExt);
+        }
+        items[k].in = tree.Insert(k, items[k].c, items[k].e, 1.f);
+        EXPECT_TRUE(items[k].in);
+    };
+    // tiny and huge items, near and far: the root has to grow
+    for (uint32_t k = 0; k < kItems; ++k) place(k, k % 2 ? 40.f : 4000.f, k % 5 ? 2.f : 300.f);
+    for (uint32_t k = 0; k < kItems; k += 3) { tree.Remove(k); items[k].in = false; }
+    for (uint32_t k = 0; k < kItems; k += 7) place(k, 9000.f, 3.f); // re-insert moves
+    std::size_t live = 0;
+    for (const Item& it : items) live += it.in;
+    EXPECT_EQ(tree.Size(), live);
+
+    const float nan = std::nanf("");
+    const float bad[3] = { nan, 0.f, 0.f }, ext[3] = { 1.f, 1.f, 1.f };
+    EXPECT_FALSE(tree.Insert(kItems, bad, ext, 1.f));
+    EXPECT_FALSE(tree.Contains(kItems));
+
+    for (int q = 0; q < 30; ++q) {
+        CullPlanes pl;
+        for (int k = 0; k < 6; ++k) {
+            const glm::vec3 n = glm::normalize(glm::vec3(rng.next(-1.f, 1.f), rng.next(-1.f, 1.f), rng.next(-1.f, 1.f)));
+            pl.nx[k] = n.x; pl.ny[k] = n.y; pl.nz[k] = n.z;
+            pl.d[k] = rng.next(-3000.f, 100.f);
+        }
+        std::set<uint32_t> want, got;
+        for (uint32_t k = 0; k < kItems; ++k) {
+            const glm::vec3 c{ items[k].c[0], items[k].c[1], items[k].c[2] };
+            const glm::vec3 e{ items[k].e[0], items[k].e[1], items[k].e[2] };
+            if (items[k].in && !boxOutside(pl, c, e)) want.insert(k);
+        }
+        tree.Query(pl, [&](const LooseOctree::Batch& b) {
+            for (std::size_t i = 0; i < b.bounds.count; ++i) {
+                const glm::vec3 c{ b.bounds.cx[i], b.bounds.cy[i], b.bounds.cz[i] };
+                const glm::vec3 e{ b.bounds.ex[i], b.bounds.ey[i], b.bounds.ez[i] };
+                ASSERT_LT(b.keys[i], kItems);
+                EXPECT_TRUE(items[b.keys[i]].in) << "removed key " << b.keys[i] << " still in the tree";
+                if (b.inside) EXPECT_FALSE(boxOutside(pl, c, e)) << "node claimed inside wrongly";
+                if (b.inside || !boxOutside(pl, c, e)) got.insert(b.keys[i]);
+            }
+        });
+        EXPECT_EQ(got, want) << "query " << q;
+    }
+}
+
+TEST(LooseOctree, QueryFindsWhatTheFlatPassFinds) {
+    // The octree walk (the kernel per straddling node, no frustum test for
+    // nodes inside) must make the same visible set as the flat pass. The
+    // same layout at up to 1M items is timed by CullPerf in test_perf_cpu.
+    const Camera cam = lookingDownMinusZ();
+    const CullPlanes planes = BoundsCache::PlanesFrom(
+        createFrustumFromCamera(cam, 16.f / 9.f, glm::radians(60.f), 0.1f, 300.f));
+    const CullPlanes all = CullPlanesAcceptAll();
+    const CullParams p = paramsFor(cam, 1080.f, 2.f);
+    constexpr std::size_t kCount = 10000;
+    constexpr float kPerSquareUnit = 0.05f;
+
+    Lcg rng{ 77u };
+    const float half = 0.5f * std::sqrt(float(kCount) / kPerSquareUnit);
+    std::vector<float> cx(kCount), cy(kCount), cz(kCount), ex(kCount), ey(kCount), ez(kCount), r(kCount);
+    LooseOctree tree;
+    for (std::size_t i = 0; i < kCount; ++i) {
+        cx[i] = rng.next(-half, half); cy[i] = rng.next(0.f, 10.f); cz[i] = rng.next(-half, half);
+        ex[i] = rng.next(0.2f, 2.f); ey[i] = rng.next(0.2f, 2.f); ez[i] = rng.next(0.2f, 2.f);
+        r[i] = std::sqrt(ex[i] * ex[i] + ey[i] * ey[i] + ez[i] * ez[i]);
+        const float c[3] = { cx[i], cy[i], cz[i] }, e[3] = { ex[i], ey[i], ez[i] };
+        ASSERT_TRUE(tree.Insert(uint32_t(i), c, e, r[i]));
+    }
+    CullInput in;
+    in.cx = cx.data(); in.cy = cy.data(); in.cz = cz.data();
+    in.ex = ex.data(); in.ey = ey.data(); in.ez = ez.data();
+    in.radius = r.data();
+    in.count = kCount;
+    std::vector<uint8_t> res(kCount), lod(kCount);
+
+    CullBounds(in, planes, p, res.data(), lod.data());
+    const std::size_t flatVisible = std::size_t(std::count(res.begin(), res.end(), uint8_t(kCullVisible)));
+    std::size_t treeVisible = 0;
+    tree.Query(planes, [&](const LooseOctree::Batch& b) {
+        CullBounds(b.bounds, b.inside ? all : planes, p, res.data(), lod.data());
+        for (std::size_t i = 0; i < b.bounds.count; ++i) treeVisible += res[i] == kCullVisible;
+    });
+    EXPECT_GT(flatVisible, 0u);
+    EXPECT_EQ(treeVisible, flatVisible);
+}
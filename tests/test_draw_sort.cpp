@@ -0,0 +1,178 @@
+// Draw-list ordering: packed 64-bit keys and their radix sort. Headless tests
+// — no GL needed; meshes are stand-in addresses, the sorter only compares
+// them.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+namespace {
+
+struct Lcg {
+    uint32_t s;
+    uint32_t next() {
+        s = s * 1664525u + 1013904223u;
+        return s >> 8;
+    }
+    float next(float lo, float hi) { return lo + (hi - lo) * float(next()) / float(1u << 24); }
+};
+
+// DrawItem as RenderScene sorted it before the packed keys: the matrix in
+// the item, moved by every swap.
+struct LegacyItem {
+    uint64_t texKey = 0;
+    const void* mesh = nullptr;
+    glm::mat4 model{ 1.0f };
+    float depth = 0.f;
+    int lod = 0;
+    entt::entity entity = entt::null;
+    int alphaMode = 0;
+    bool doubleSided = false;
+    int shadingModel = 0;
+};
+
+// The comparator RenderScene used, verbatim.
+bool legacyLess(const LegacyItem& a, const LegacyItem& b) {
+    if (a.alphaMode != b.alphaMode) return a.alphaMode < b.alphaMode;
+    if (a.doubleSided != b.doubleSided) return !a.doubleSided;
+    if (a.shadingModel != b.shadingModel) return a.shadingModel < b.shadingModel;
+    if (a.texKey != b.texKey) return a.texKey < b.texKey;
+    if (a.mesh != b.mesh) return (uintptr_t)a.mesh < (uintptr_t)b.mesh;
+    if (a.lod != b.lod) return a.lod < b.lod;
+    return a.depth < b.depth;
+}
+
+// What makes two items share a run (RenderScene's run-formation test).
+auto runKey(const LegacyItem& it) {
+    return std::make_tuple(it.alphaMode, it.doubleSided, it.shadingModel, it.texKey,
+                           reinterpret_cast<uintptr_t>(it.mesh), it.lod);
+}
+
+// A frame's worth of opaque items: a few hundred materials and meshes, some
+// masked, double-sided and toon ones, three LODs.
+std::vector<LegacyItem> makeItems(std::size_t count, uint32_t seed) {
+    Lcg rng{ seed };
+    std::vector<uint64_t> materials(300);
+    for (auto& m : materials) m = (uint64_t(rng.next()) << 40) ^ (uint64_t(rng.next()) << 20) ^ rng.next();
+    std::vector<LegacyItem> items(count);
+    for (auto& it : items) {
+        it.texKey = materials[rng.next() % materials.size()];
+        it.mesh = reinterpret_cast<const void*>(uintptr_t(0x10000 + 64 * (rng.next() % 500)));
+        it.depth = rng.next(-5.f, 500.f);
+        it.lod = int(rng.next() % 3);
+        it.alphaMode = rng.next() % 5 == 0 ? 1 : 0;
+        it.doubleSided = rng.next() % 7 == 0;
+        it.shadingModel = rng.next() % 4 == 0 ? 1 : 0;
+        it.model[3] = glm::vec4(it.depth, 0.f, 0.f, 1.f);
+    }
+    return items;
+}
+
+void addAll(DrawSorter& sorter, const std::vector<LegacyItem>& items) {
+    sorter.Clear();
+    for (const auto& it : items) {
+        sorter.Add({ it.alphaMode, it.doubleSided, it.shadingModel, it.texKey, it.mesh, it.lod, it.depth });
+    }
+}
+
+// The sorted sequence must be the comparator's, run for run: same run keys
+// in the same order, same sizes, each run front to back (up to the depth
+// bits the key keeps).
+void expectComparatorOrder(const std::vector<LegacyItem>& items, const std::vector<uint32_t>& order) {
+    ASSERT_EQ(order.size(), items.size());
+    std::vector<LegacyItem> want = items;
+    std::sort(want.begin(), want.end(), legacyLess);
+
+    std::size_t runs = 0;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const LegacyItem& got = items[order[i]];
+        ASSERT_EQ(runKey(got), runKey(want[i])) << "position " << i;
+        if (i == 0 || runKey(got) != runKey(items[order[i - 1]])) {
+            ++runs;
+            continue;
+        }
+        const float prev = items[order[i - 1]].depth;
+        if (got.depth < prev) {
+            // only a tie in the kept bits may reorder
+            EXPECT_EQ(DepthKey(got.depth) >> (32 - DrawSorter::kDepthBits),
+                      DepthKey(prev) >> (32 - DrawSorter::kDepthBits)) << "position " << i;
+        }
+    }
+    EXPECT_GT(runs, 1u);
+}
+
+} // namespace
+
+TEST(DrawSort, RadixSortMatchesAStableSort) {
+    Lcg rng{ 1u };
+    std::vector<SortKey> scratch;
+    for (std::size_t n : { std::size_t(0), std::size_t(1), std::size_t(2), std::size_t(255), std::size_t(100003) }) {
+        std::vector<SortKey> keys(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            uint64_t k = (uint64_t(rng.next()) << 40) ^ (uint64_t(rng.next()) << 16) ^ rng.next();
+            if (i % 3 == 0) k &= 0xffff; // duplicates and constant high digits
+            keys[i] = { k, uint32_t(i) };
+        }
+        std::vector<SortKey> want = keys;
+        std::stable_sort(want.begin(), want.end(), [](const SortKey& a, const SortKey& b) { return a.key < b.key; });
+        RadixSortKeys(keys, scratch);
+        for (std::size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(keys[i].key, want[i].key) << "n " << n << ", position " << i;
+            ASSERT_EQ(keys[i].index, want[i].index) << "n " << n << ", position " << i << " (not stable)";
+        }
+    }
+}
+
+TEST(DrawSort, DepthKeyKeepsFloatOrder) {
+    const float depths[] = { -1e30f, -5.f, -1e-30f, -0.f, 0.f, 1e-30f, 2.f, 2.0000002f, 1e30f };
+    for (std::size_t i = 0; i + 1 < sizeof(depths) / sizeof(depths[0]); ++i) {
+        EXPECT_LE(DepthKey(depths[i]), DepthKey(depths[i + 1])) << depths[i] << " vs " << depths[i + 1];
+    }
+    EXPECT_LT(DepthKey(-5.f), DepthKey(2.f));
+}
+
+TEST(DrawSort, RunsFormExactlyAsTheComparatorOrderedThem) {
+    DrawSorter sorter;
+    for (uint32_t seed : { 3u, 4u, 5u }) {
+        const auto items = makeItems(20000, seed);
+        addAll(sorter, items);
+        sorter.Sort();
+        EXPECT_FALSE(sorter.FellBack());
+        expectComparatorOrder(items, sorter.Order());
+    }
+
+    // an all-opaque, single-sided, PBR scene: the old {texKey, mesh, lod,
+    // depth} order
+    auto plain = makeItems(5000, 6u);
+    for (auto& it : plain) { it.alphaMode = 0; it.doubleSided = false; it.shadingModel = 0; }
+    addAll(sorter, plain);
+    sorter.Sort();
+    expectComparatorOrder(plain, sorter.Order());
+}
+
+TEST(DrawSort, FallsBackToComparisonsPastTheKeyFields) {
+    // more distinct meshes than the mesh field holds
+    const std::size_t meshes = (std::size_t(1) << DrawSorter::kMeshBits) + 100;
+    auto items = makeItems(meshes * 2, 9u);
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        items[i].mesh = reinterpret_cast<const void*>(uintptr_t(0x10000 + 64 * (i % meshes)));
+    }
+    DrawSorter sorter;
+    addAll(sorter, items);
+    sorter.Sort();
+    EXPECT_TRUE(sorter.FellBack());
+    expectComparatorOrder(items, sorter.Order());
+
+    // a LOD past its two bits
+    auto deep = makeItems(1000, 10u);
+    deep[17].lod = 5;
+    addAll(sorter, deep);
+    sorter.Sort();
+    EXPECT_TRUE(sorter.FellBack());
+    expectComparatorOrder(deep, sorter.Order());
+}
@@ -65,3 +65,78 @@ TEST(FixedTimestep, SetStepClampsToMinimum) {
     ts.advance(0.001f, [&](float) { ++calls; }, 4);
     EXPECT_LE(calls, 4);
 }
+
+TEST(FixedTimestep, DropPolicyCountsWhatItDrops) {
+    FixedTimestep ts(0.01f);
+    ts.advance(0.105f, [](float) {}, 8); // 10 owed, 8 run, 2 dropped
+    EXPECT_EQ(ts.metrics().droppedTicks, 2u);
+    EXPECT_EQ(ts.debtTicks(), 0);
+    EXPECT_TRUE(ts.runningBehind()) << "a frame that hit the cap must say so, even when it dropped";
+    ts.advance(0.01f, [](float) {}, 8);
+    EXPECT_FALSE(ts.runningBehind());
+}
+
+TEST(FixedTimestep, SpreadPolicyPaysOffASpikeOverLaterFrames) {
+    // A power-of-two step keeps the tick arithmetic exact, so the counts
+    // below are not at the mercy of float rounding.
+    const float kStep = 1.f / 64.f;
+    FixedTimestep ts(kStep);
+    ts.setCatchUpPolicy(FixedTimestep::CatchUpPolicy::SpreadBacklog);
+    ts.setMaxDebtTicks(100);
+    int calls = 0;
+    auto tick = [&](float) { ++calls; };
+
+    // A hitch worth 20 ticks: 8 may run this frame, 12 are carried.
+    EXPECT_EQ(ts.advance(20 * kStep, tick, 8), 8);
+    EXPECT_EQ(ts.debtTicks(), 12);
+    EXPECT_TRUE(ts.runningBehind());
+    EXPECT_EQ(ts.metrics().droppedTicks, 0u) << "a backlog under the debt cap must not be dropped";
+
+    // Normal frames (one tick each) pay 7 extra per frame until caught up.
+    int frames = 0;
+    while (ts.runningBehind() && frames < 10) {
+        const int steps = ts.advance(kStep, tick, 8);
+        EXPECT_LE(steps, 8) << "catch-up exceeded the per-frame bound";
+        ++frames;
+    }
+    EXPECT_FALSE(ts.runningBehind());
+    EXPECT_EQ(frames, 2) << "12 owed + 1 per frame at 8 per frame clears in two frames";
+    EXPECT_EQ(ts.debtTicks(), 0);
+    // Every tick of simulated time the wall clock asked for was simulated.
+    EXPECT_EQ(calls, 20 + frames);
+    EXPECT_EQ(ts.metrics().peakDebtTicks, 12);
+}
+
+TEST(FixedTimestep, SpreadPolicyCapsTheDebtSoOverloadCannotSpiral) {
+    FixedTimestep ts(0.01f);
+    ts.setCatchUpPolicy(FixedTimestep::CatchUpPolicy::SpreadBacklog);
+    ts.setMaxDebtTicks(5);
+    // A machine that can only ever run 2 ticks a frame while 4 are due.
+    for (int f = 0; f < 50; ++f) ts.advance(0.04f, [](float) {}, 2);
+    EXPECT_EQ(ts.debtTicks(), 5) << "the debt kept growing past its cap";
+    EXPECT_TRUE(ts.runningBehind());
+    EXPECT_EQ(ts.metrics().behindFrames, 50);
+    // 50 frames * 4 due - 50 * 2 run - 5 still owed
+    EXPECT_NEAR((double)ts.metrics().droppedTicks, 95.0, 1.0);
+}
+
+TEST(FixedTimestep, AlphaStaysAFractionWhileTicksAreOwed) {
+    FixedTimestep ts(0.01f);
+    ts.setCatchUpPolicy(FixedTimestep::CatchUpPolicy::SpreadBacklog);
+    ts.advance(0.1255f, [](float) {}, 4); // 12.55 owed, 4 run
+    EXPECT_EQ(ts.debtTicks(), 8);
+    EXPECT_NEAR(ts.alpha(), 0.55f, 1e-2f) << "owed whole ticks leaked into the interpolation factor";
+}
+
+TEST(FixedTimestep, ResetClearsDebtAndMetrics) {
+    FixedTimestep ts(0.01f);
+    ts.setCatchUpPolicy(FixedTimestep::CatchUpPolicy::SpreadBacklog);
+    ts.advance(1.f, [](float) {}, 8);
+    ASSERT_TRUE(ts.runningBehind());
+    ts.reset();
+    EXPECT_FALSE(ts.runningBehind());
+    EXPECT_EQ(ts.debtTicks(), 0);
+    EXPECT_EQ(ts.metrics().peakDebtTicks, 0);
+    EXPECT_EQ(ts.metrics().droppedTicks, 0u);
+    EXPECT_EQ(ts.advance(0.01f, [](float) {}, 8), 1) << "debt survived a reset";
+}
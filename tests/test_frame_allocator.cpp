@@ -0,0 +1,215 @@
+// Per-frame memory: linear arenas, the double-buffered FrameAllocator, its
+// per-thread sub-arenas and the STL adapter. Pure CPU.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "Engine.h"
+
+using MyCoreEngine::FrameAllocator;
+using MyCoreEngine::FrameVector;
+using MyCoreEngine::LinearArena;
+
+TEST(LinearArena, HandsOutAlignedNonOverlappingMemory) {
+    LinearArena arena(1024);
+    std::vector<std::pair<std::uintptr_t, std::size_t>> blocks;
+    const std::size_t aligns[] = { 1, 4, 16, 64 };
+    for (int i = 0; i < 200; ++i) {
+        const std::size_t align = aligns[i % 4];
+        const std::size_t bytes = 1 + (i * 37) % 300;
+        void* p = arena.allocate(bytes, align);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ((std::uintptr_t)p % align, 0u) << "allocation " << i;
+        std::memset(p, 0xAB, bytes); // ASan: the whole block is ours
+        blocks.emplace_back((std::uintptr_t)p, bytes);
+    }
+    std::sort(blocks.begin(), blocks.end());
+    for (std::size_t i = 1; i < blocks.size(); ++i) {
+        EXPECT_LE(blocks[i - 1].first + blocks[i - 1].second, blocks[i].first)
+            << "two live allocations overlap";
+    }
+    // bigger than a chunk: gets one of its own rather than failing
+    void* big = arena.allocate(10 * 1024, 16);
+    ASSERT_NE(big, nullptr);
+    std::memset(big, 0, 10 * 1024);
+}
+
+TEST(LinearArena, OnlyTheNewestAllocationCanBeGivenBack) {
+    LinearArena arena;
+    const uint64_t gen = arena.generation();
+    void* a = arena.allocate(100, 8);
+    void* b = arena.allocate(100, 8);
+    const std::size_t used = arena.used();
+    arena.deallocate(a, 100, gen);
+    EXPECT_EQ(arena.used(), used) << "freeing a block that is not on top must be a no-op";
+    arena.deallocate(b, 100, gen);
+    EXPECT_LT(arena.used(), used);
+    EXPECT_EQ(arena.allocate(100, 8), b) << "the given-back bytes were not reused";
+}
+
+TEST(LinearArena, ResetRewindsAndIgnoresStaleFrees) {
+    LinearArena arena;
+    const uint64_t gen = arena.generation();
+    void* first = arena.allocate(256, 16);
+    arena.allocate(256, 16);
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_NE(arena.generation(), gen);
+
+    void* again = arena.allocate(256, 16);
+    EXPECT_EQ(again, first) << "a rewound arena should hand out the same memory again";
+    const std::size_t used = arena.used();
+    arena.deallocate(again, 256, gen); // a pointer from the previous generation
+    EXPECT_EQ(arena.used(), used) << "a stale free rolled back this frame's allocation";
+}
+
+TEST(LinearArena, AOneOffSpikeIsReleasedAfterTwoTrimWindows) {
+    LinearArena arena(16 * 1024);
+    auto frame = [&](std::size_t bytes) {
+        for (std::size_t done = 0; done < bytes; done += 4096) arena.allocate(4096, 16);
+        arena.reset();
+    };
+    for (int i = 0; i < 10; ++i) frame(32 * 1024);
+    const std::size_t steady = arena.reserved();
+
+    frame(8 * 1024 * 1024); // one huge frame
+    EXPECT_GE(arena.reserved(), 8u * 1024 * 1024) << "the spike's memory is kept while it is recent";
+
+    for (unsigned i = 0; i < 2 * LinearArena::kTrimWindowFrames; ++i) frame(32 * 1024);
+    EXPECT_LE(arena.reserved(), 2 * steady + 16 * 1024)
+        << "a spike 2 trim windows ago still pins " << arena.reserved() << " bytes";
+    EXPECT_GT(arena.reserved(), 0u) << "the steady frame's own memory was released too";
+}
+
+TEST(FrameAllocator, LastFramesMemoryStaysValidForOneMoreFrame) {
+    FrameAllocator frames;
+    frames.BeginFrame();
+    FrameVector<int> older = frames.MakeVector<int>(1000);
+    for (int i = 0; i < 1000; ++i) older.push_back(i);
+
+    frames.BeginFrame(); // the next frame allocates from the OTHER buffer
+    FrameVector<int> newer = frames.MakeVector<int>(1000);
+    for (int i = 0; i < 1000; ++i) newer.push_back(-i);
+
+    EXPECT_TRUE(older.get_allocator().current());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(older[i], i) << "the previous frame's list was overwritten by this frame's";
+    }
+
+    frames.BeginFrame(); // and the one after that rewinds it
+    EXPECT_FALSE(older.get_allocator().current())
+        << "a list two frames old must be recognisably stale";
+    EXPECT_TRUE(newer.get_allocator().current());
+}
+
+TEST(FrameAllocator, RefreshReusesInPlaceWithinAFrameAndReseatsAcrossFrames) {
+    FrameAllocator frames;
+    FrameVector<int> list; // heap-backed until its first Refresh
+    frames.Refresh(list, 64);
+    for (int i = 0; i < 64; ++i) list.push_back(i);
+    const int* storage = list.data();
+
+    frames.Refresh(list, 64); // same frame: cleared, same storage
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.data(), storage) << "a same-frame refresh re-carved the list";
+
+    for (int f = 0; f < 4; ++f) {
+        frames.BeginFrame();
+        frames.Refresh(list, 64);
+        EXPECT_TRUE(list.get_allocator().current());
+        EXPECT_GE(list.capacity(), 64u);
+        for (int i = 0; i < 64; ++i) list.push_back(f * 100 + i);
+        EXPECT_EQ(list[63], f * 100 + 63);
+    }
+}
+
+// The parallel list builders refresh member lists on whichever worker picks
+// the view up, so a list's old storage can sit in another thread's arena,
+// at the top of its bump pointer and still under a live generation. Refresh
+// must leave that arena alone: the other thread may be allocating from it.
+TEST(FrameAllocator, RefreshNeverFreesIntoAnotherThreadsArena) {
+    FrameAllocator frames;
+    MyCoreEngine::JobSystem jobs(1);
+    FrameVector<int> list;
+    LinearArena* workerArena = nullptr;
+    jobs.submit([&] {
+        frames.Refresh(list, 256);
+        for (int i = 0; i < 256; ++i) list.push_back(i);
+        workerArena = list.get_allocator().arena();
+    });
+    jobs.waitIdle();
+    ASSERT_NE(workerArena, nullptr);
+    ASSERT_NE(workerArena, &frames.Local());
+    const std::size_t used = workerArena->used();
+
+    frames.Refresh(list, 16); // the main thread, same frame
+    EXPECT_EQ(workerArena->used(), used) << "the refresh gave bytes back to the worker's arena";
+    EXPECT_EQ(list.get_allocator().arena(), &frames.Local());
+    EXPECT_TRUE(list.empty());
+    EXPECT_GE(list.capacity(), 16u);
+}
+
+TEST(FrameAllocator, EachJobSystemWorkerBuildsIntoItsOwnArena) {
+    FrameAllocator frames;
+    MyCoreEngine::JobSystem jobs(3);
+    constexpr int kLists = 64;
+    constexpr int kItems = 2000;
+
+    std::mutex m;
+    std::set<LinearArena*> arenas;
+    std::vector<FrameVector<int>> built(kLists);
+    frames.BeginFrame();
+    for (int l = 0; l < kLists; ++l) {
+        jobs.submit([&, l] {
+            FrameVector<int> v = frames.MakeVector<int>();
+            for (int i = 0; i < kItems; ++i) v.push_back(l * kItems + i); // grows in the arena
+            std::lock_guard<std::mutex> lk(m);
+            arenas.insert(v.get_allocator().arena());
+            built[l] = std::move(v);
+        });
+    }
+    jobs.waitIdle();
+
+    for (int l = 0; l < kLists; ++l) {
+        ASSERT_EQ((int)built[l].size(), kItems);
+        for (int i = 0; i < kItems; ++i) {
+            ASSERT_EQ(built[l][i], l * kItems + i) << "list " << l << " was corrupted by another thread";
+        }
+    }
+    EXPECT_GE(arenas.size(), 1u);
+    EXPECT_LE(arenas.size(), 3u) << "more arenas than worker threads";
+    EXPECT_FALSE(arenas.count(&frames.Local())) << "a worker allocated from the main thread's arena";
+
+    frames.BeginFrame();
+    frames.BeginFrame(); // rewinds the frame the workers built in
+    const FrameAllocator::Stats s = frames.stats();
+    EXPECT_GE(s.lastFrameBytes, std::size_t(kLists) * kItems * sizeof(int))
+        << "the workers' arenas were not counted in the frame's usage";
+    EXPECT_GE(s.threads, 2u);
+}
+
+TEST(FrameAllocator, StatsAreOneFrameBehindAndKeepThePeak) {
+    FrameAllocator frames;
+    auto frame = [&](std::size_t bytes) {
+        frames.BeginFrame();
+        frames.Local().allocate(bytes, 16);
+    };
+    frame(1000);
+    frame(500000);
+    frame(2000);
+    frame(3000);
+    // This BeginFrame rewound (and measured) the frame BEFORE the one that
+    // just ended — the 500000-byte one, not the 2000-byte one.
+    FrameAllocator::Stats s = frames.stats();
+    EXPECT_GE(s.lastFrameBytes, 500000u);
+    frame(4000);
+    s = frames.stats();
+    EXPECT_LT(s.lastFrameBytes, 10000u);
+    EXPECT_GE(s.peakFrameBytes, 500000u) << "the high-water mark forgot the spike";
+    EXPECT_EQ(s.frames, 5u);
+}
@@ -127,9 +127,6 @@ namespace {
         std::vector<unsigned char> runPass(bool enabled) {
             PassContext ctx{};
             ctx.defaultFBO = dstFBO;
-            ctx.ldrTex_A = srcTex;       // the chain source (tonemap's output)
-            ctx.postSrcTex = srcTex;     // what nextPostTarget() hands the pass
-            ctx.postPassesLeft = 1;      // FXAA is the sole/final pass -> defaultFBO
             ctx.fsQuadVAO = quadVAO;
 
             FrameParams fp{};
@@ -139,6 +136,24 @@ namespace {
             FXAAPass pass;
             pass.setup(ctx);
 
+            Scene scene;
+            scene.SetAAEnabled(enabled); // FXAA now gates on the scene AA toggle
+            Camera cam;
+
+            // FXAA as the sole post stage: it reads the chain source (tonemap's
+            // output) and, presented, writes the output. Disabled, it is not
+            // declared, as in the pipeline.
+            RenderGraph graph;
+            ctx.graph = &graph;
+            ctx.res.output = graph.Import("Output", dstFBO, 0);
+            ctx.res.ldr = graph.Import("Tonemap", 0, srcTex);
+            if (pass.enabled(ctx, scene)) {
+                RenderGraph::PassBuilder b = graph.AddPass(pass.name());
+                pass.declare(b, ctx, fp);
+            }
+            graph.Present(ctx.res.ldr, ctx.res.output);
+            graph.Compile();
+
             // Clear to mid-grey so "the pass did nothing" is distinguishable
             // from "the pass wrote black".
             glBindFramebuffer(GL_FRAMEBUFFER, dstFBO);
@@ -146,9 +161,6 @@ namespace {
             glClearColor(0.5f, 0.5f, 0.5f, 1.f);
             glClear(GL_COLOR_BUFFER_BIT);
 
-            Scene scene;
-            scene.SetAAEnabled(enabled); // FXAA now gates on the scene AA toggle
-            Camera cam;
             pass.execute(ctx, scene, cam, fp);
 
             std::vector<unsigned char> out(kSize * kSize * 4, 0);
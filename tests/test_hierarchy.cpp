@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <vector>
 
 #include "Engine.h"
 
@@ -156,6 +157,94 @@ TEST(Hierarchy, DanglingParentActsAsRoot) {
     expectVec3Near(worldPos(scene, child), { 1.f, 2.f, 3.f });
 }
 
+// --- persistent walk order (TransformHierarchy) -----------------------------
+
+TEST(Hierarchy, EverydayEditsDoNotRebuildTheOrder) {
+    Scene scene;
+    auto a = makeNode(scene, { 1.f, 0.f, 0.f }, "A");
+    auto b = makeNode(scene, { 0.f, 1.f, 0.f }, "B");
+    scene.UpdateTransforms();
+    const uint64_t rebuilds = scene.HierarchyStats().rebuilds;
+
+    // spawning under an existing parent, unparenting, re-pointing at an
+    // older entity and destroying are all absorbed in place
+    auto c = makeNode(scene, { 0.f, 0.f, 1.f }, "C");
+    scene.registry.emplace<Parent>(c, Parent{ b });
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, c), { 0.f, 1.f, 1.f });
+
+    scene.registry.replace<Parent>(c, Parent{ a });
+    scene.registry.get<Transform>(c).dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, c), { 1.f, 0.f, 1.f });
+
+    scene.registry.remove<Parent>(c);
+    scene.registry.get<Transform>(c).dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, c), { 0.f, 0.f, 1.f });
+
+    scene.registry.destroy(b);
+    scene.UpdateTransforms();
+    EXPECT_EQ(scene.HierarchyStats().rebuilds, rebuilds)
+        << "a routine edit re-sorted the whole hierarchy";
+}
+
+TEST(Hierarchy, ReparentUnderANewerEntityKeepsParentsFirst) {
+    Scene scene;
+    auto child = makeNode(scene, { 0.f, 5.f, 0.f }, "C");
+    auto grandchild = makeNode(scene, { 0.f, 0.f, 2.f }, "G");
+    scene.registry.emplace<Parent>(grandchild, Parent{ child });
+    scene.UpdateTransforms();
+
+    // the new parent is created AFTER the subtree it adopts: the walk must
+    // still reach it first, or the children read a stale parent matrix
+    auto parent = makeNode(scene, { 10.f, 0.f, 0.f }, "P");
+    scene.registry.emplace<Parent>(child, Parent{ parent });
+    scene.registry.get<Transform>(child).dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, child), { 10.f, 5.f, 0.f });
+    expectVec3Near(worldPos(scene, grandchild), { 10.f, 5.f, 2.f });
+
+    auto& pt = scene.registry.get<Transform>(parent);
+    pt.position.x = 30.f;
+    pt.dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, grandchild), { 30.f, 5.f, 2.f });
+}
+
+TEST(Hierarchy, ParentThatGainsATransformLaterAdoptsItsChildren) {
+    Scene scene;
+    // load order: the link exists before its target is a transform node
+    entt::entity parent = scene.createEntity();
+    auto child = makeNode(scene, { 0.f, 1.f, 0.f }, "C");
+    scene.registry.emplace<Parent>(child, Parent{ parent });
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, child), { 0.f, 1.f, 0.f }); // a root for now
+
+    Transform t{};
+    t.position = { 4.f, 0.f, 0.f };
+    scene.registry.emplace<Transform>(parent, t);
+    scene.registry.get<Transform>(child).dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, child), { 4.f, 1.f, 0.f });
+}
+
+TEST(Hierarchy, BreakingACycleThawsItsMembers) {
+    Scene scene;
+    auto a = makeNode(scene, { 1.f, 0.f, 0.f }, "A");
+    auto b = makeNode(scene, { 0.f, 2.f, 0.f }, "B");
+    // corrupt data: SetParentKeepWorld refuses this, raw emplace does not
+    scene.registry.emplace<Parent>(a, Parent{ b });
+    scene.registry.emplace<Parent>(b, Parent{ a });
+    scene.UpdateTransforms(); // frozen, must not hang or crash
+
+    scene.registry.remove<Parent>(a);
+    scene.registry.get<Transform>(a).dirty = true;
+    scene.UpdateTransforms();
+    expectVec3Near(worldPos(scene, a), { 1.f, 0.f, 0.f });
+    expectVec3Near(worldPos(scene, b), { 1.f, 2.f, 0.f });
+}
+
 // --- game camera entity (Scene/Game split) ---------------------------------
 
 TEST(GameCamera, SyncMatchesWorldPose) {
@@ -322,3 +411,117 @@ TEST(EntityIdentity, IndexIsStableAcrossAReloadButTheRawHandleIsNot) {
     }
 }
 
+
+// --- steady state: 1% dirty ------------------------------------------------
+//
+// The per-frame shape the persistent order exists for: a few entities of a
+// large hierarchy move each frame. The order must not be re-sorted, and
+// every matrix must still resolve. The timed version (100k entities, next
+// to the per-frame children map it replaced) is HierarchyPerf in
+// test_perf_cpu.
+
+TEST(Hierarchy, OnePercentDirtyFramesKeepTheOrder) {
+    constexpr int kEntities = 4000;
+    constexpr int kChain = 4;       // root + 3 levels of children
+    constexpr int kDirty = kEntities / 100;
+    constexpr int kFrames = 5;
+
+    Scene scene;
+    std::vector<entt::entity> all;
+    all.reserve(kEntities);
+    for (int i = 0; i < kEntities; ++i) {
+        const entt::entity e = scene.registry.create();
+        Transform t{};
+        t.position = { float(i % 97), float(i % kChain), float(i / 97) * 0.01f };
+        t.rotation = { 0.f, float(i % 360), 0.f };
+        scene.registry.emplace<Transform>(e, t);
+        if (i % kChain != 0) scene.registry.emplace<Parent>(e, Parent{ all.back() });
+        all.push_back(e);
+    }
+    scene.UpdateTransforms(); // the one full resolve (and the one sort)
+    const uint64_t rebuilds = scene.HierarchyStats().rebuilds;
+
+    uint32_t rng = 12345u;
+    for (int f = 0; f < kFrames; ++f) {
+        for (int d = 0; d < kDirty; ++d) {
+            rng = rng * 1664525u + 1013904223u;
+            auto& t = scene.registry.get<Transform>(all[(rng >> 8) % kEntities]);
+            t.position.y += 0.5f;
+            t.dirty = true;
+        }
+        scene.UpdateTransforms();
+    }
+    EXPECT_EQ(scene.HierarchyStats().rebuilds, rebuilds)
+        << "steady-state frames re-sorted the hierarchy";
+
+    // and it still resolves the hierarchy: spot-check against the chain walk
+    for (int i = 0; i < kEntities; i += 97) {
+        const glm::mat4 want = ResolveWorldMatrix(scene.registry, all[i]);
+        const glm::mat4& got = scene.registry.get<Transform>(all[i]).modelMatrix;
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                ASSERT_NEAR(got[c][r], want[c][r], 1e-3f) << "entity " << i;
+            }
+        }
+    }
+}
+
+// --- parallel propagation ----------------------------------------------------
+
+TEST(Hierarchy, ParallelPassMatchesTheSerialOneExactly) {
+    // Two identical scenes, one resolved on the caller alone, one through a
+    // JobSystem. Large enough to take the parallel path (several waves of
+    // several chunks), with casters spread through every level so the
+    // merged dirty-caster list has something to get wrong.
+    constexpr int kEntities = 24000, kChain = 4;
+    auto stub = std::make_shared<Model>("__caster_stub__.obj");
+    auto build = [&](Scene& scene, std::vector<entt::entity>& all) {
+        for (int i = 0; i < kEntities; ++i) {
+            const entt::entity e = scene.registry.create();
+            Transform t{};
+            t.position = { float(i % 53), float(i % kChain), float(i / 53) };
+            t.rotation = { float(i % 7) * 10.f, float(i % 360), 0.f };
+            scene.registry.emplace<Transform>(e, t);
+            if (i % kChain != 0) scene.registry.emplace<Parent>(e, Parent{ all.back() });
+            if (i % 5 == 0) {
+                scene.registry.emplace<ModelComponent>(e, ModelComponent{ stub });
+                scene.registry.emplace<AABB>(e, AABB{ glm::vec3(-1.f), glm::vec3(1.f) });
+            }
+            all.push_back(e);
+        }
+    };
+    Scene serial, parallel;
+    std::vector<entt::entity> a, b;
+    build(serial, a);
+    build(parallel, b);
+    JobSystem jobs(3);
+
+    auto expectSame = [&] {
+        ASSERT_EQ(serial.DirtyCasterCount(), parallel.DirtyCasterCount());
+        for (std::size_t i = 0; i < serial.DirtyCasterCount(); ++i) {
+            ASSERT_EQ(serial.DirtyCasterSphere(i), parallel.DirtyCasterSphere(i))
+                << "dirty caster " << i << " differs: the merge is not in a stable order";
+        }
+        for (int i = 0; i < kEntities; ++i) {
+            ASSERT_EQ(serial.registry.get<Transform>(a[i]).modelMatrix,
+                      parallel.registry.get<Transform>(b[i]).modelMatrix) << "entity " << i;
+        }
+    };
+
+    serial.UpdateTransforms();
+    parallel.UpdateTransforms(&jobs);
+    expectSame();
+    EXPECT_GT(serial.DirtyCasterCount(), 0u);
+
+    // then a frame with scattered movers at every depth, roots included
+    for (int i = 0; i < kEntities; i += 37) {
+        for (Scene* s : { &serial, &parallel }) {
+            auto& t = s->registry.get<Transform>((s == &serial ? a : b)[i]);
+            t.rotation.y += 15.f;
+            t.dirty = true;
+        }
+    }
+    serial.UpdateTransforms();
+    parallel.UpdateTransforms(&jobs);
+    expectSame();
+}
@@ -0,0 +1,249 @@
+// The I/O service: whole-file reads on a dedicated thread, coalescing of
+// duplicate paths, read-ahead (explicit and model-directory siblings), the
+// read-ahead budget, the bounded queue, and shutdown. Pure CPU + temp files.
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Engine.h"
+
+namespace fs = std::filesystem;
+using MyCoreEngine::IOBlobPtr;
+using MyCoreEngine::IOService;
+using MyCoreEngine::IOTicket;
+
+namespace {
+
+// A directory per test, named after it, so a crashed run's leftovers are
+// recognisable and a rerun starts clean.
+class ScratchDir {
+public:
+    ScratchDir() {
+        const ::testing::TestInfo* info =
+            ::testing::UnitTest::GetInstance()->current_test_info();
+        dir_ = fs::temp_directory_path() /
+               ("cse_io_service_" + std::string(info ? info->name() : "unnamed"));
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+        fs::create_directories(dir_);
+    }
+    ~ScratchDir() {
+        std::error_code ec;
+        fs::remove_all(dir_, ec);
+    }
+    std::string write(const std::string& name, const std::string& bytes) const {
+        const fs::path p = dir_ / name;
+        std::ofstream(p, std::ios::binary) << bytes;
+        return p.generic_string();
+    }
+    std::string path(const std::string& name) const { return (dir_ / name).generic_string(); }
+
+private:
+    fs::path dir_;
+};
+
+// Parks the I/O thread inside a Read callback until released, so the test
+// controls exactly what is queued behind it.
+class IOGate {
+public:
+    IOService::Callback hold() {
+        return [this](const IOBlobPtr&) {
+            std::unique_lock<std::mutex> lk(m_);
+            held_ = true;
+            cv_.notify_all();
+            cv_.wait(lk, [&] { return open_; });
+        };
+    }
+    void waitHeld() {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [&] { return held_; });
+    }
+    void release() {
+        std::lock_guard<std::mutex> lk(m_);
+        open_ = true;
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool held_ = false, open_ = false;
+};
+
+std::string asString(const IOBlobPtr& b) { return std::string(b->bytes.begin(), b->bytes.end()); }
+
+} // namespace
+
+TEST(IOService, ReadsWholeFilesAndReportsMissingOnes) {
+    ScratchDir dir;
+    std::string big(300000, '\0');
+    for (std::size_t i = 0; i < big.size(); ++i) big[i] = char(i * 7);
+    const std::string path = dir.write("big.bin", big);
+
+    IOService io;
+    const IOBlobPtr got = io.ReadNow(path);
+    ASSERT_TRUE(got->ok) << got->error;
+    EXPECT_EQ(asString(got), big);
+
+    const IOBlobPtr missing = io.ReadNow(dir.path("nope.png"));
+    EXPECT_FALSE(missing->ok);
+    EXPECT_FALSE(missing->error.empty()) << "a failed read must say why";
+    EXPECT_TRUE(missing->bytes.empty());
+}
+
+TEST(IOService, DuplicateReadsOfOnePathShareOneDiskRead) {
+    ScratchDir dir;
+    const std::string first = dir.write("first.txt", "first");
+    const std::string shared = dir.write("shared.txt", "shared bytes");
+
+    IOService io;
+    IOGate gate;
+    io.Read(first, gate.hold());
+    gate.waitHeld(); // everything below queues behind the parked read
+
+    std::atomic<int> callbacks{ 0 };
+    auto count = [&](const IOBlobPtr& b) { if (b->ok) ++callbacks; };
+    const IOTicket a = io.Read(shared, count);
+    const IOTicket b = io.Read(dir.path("./shared.txt"), count); // same file, other spelling
+    const IOTicket c = io.Read(shared, count);
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(a, c);
+
+    gate.release();
+    EXPECT_EQ(asString(a->wait()), "shared bytes");
+    io.waitIdle();
+    EXPECT_EQ(callbacks.load(), 3) << "every coalesced caller gets its callback";
+    const IOService::Stats s = io.stats();
+    EXPECT_EQ(s.reads, 2u) << "three Reads of one path hit the disk more than once";
+    EXPECT_EQ(s.coalesced, 2u);
+}
+
+TEST(IOService, ReadAheadIsClaimedByTheNextReadAndThenForgotten) {
+    ScratchDir dir;
+    const std::string path = dir.write("diffuse.png", std::string(1000, 'p'));
+
+    IOService io;
+    io.ReadAhead(path);
+    io.waitIdle();
+    EXPECT_EQ(io.stats().residentBytes, 1000u);
+
+    bool inline_ = false;
+    const std::thread::id me = std::this_thread::get_id();
+    const IOTicket t = io.Read(path, [&](const IOBlobPtr&) { inline_ = std::this_thread::get_id() == me; });
+    ASSERT_TRUE(t->ready()) << "resident bytes should not go back through the queue";
+    EXPECT_TRUE(inline_) << "a resident hit runs its callback on the caller";
+    EXPECT_EQ(t->wait()->bytes.size(), 1000u);
+
+    IOService::Stats s = io.stats();
+    EXPECT_EQ(s.reads, 1u);
+    EXPECT_EQ(s.readAheadHits, 1u);
+    EXPECT_EQ(s.residentBytes, 0u) << "a claimed blob must leave the read-ahead set";
+
+    io.ReadNow(path); // nothing resident now: a real read
+    EXPECT_EQ(io.stats().reads, 2u);
+}
+
+TEST(IOService, ModelSiblingsAreReadAheadButOnlyTheKindsAnImportOpens) {
+    ScratchDir dir;
+    const std::string model = dir.write("crate.obj", "v 0 0 0\n");
+    dir.write("crate.mtl", "newmtl m\n");
+    dir.write("Crate_Diffuse.PNG", std::string(64, 'd'));
+    dir.write("notes.txt", "not a model file");
+
+    IOService io;
+    io.ReadAheadSiblings(model);
+    io.waitIdle();
+    IOService::Stats s = io.stats();
+    EXPECT_EQ(s.readAheadIssued, 2u) << "expected the .mtl and the texture, nothing else";
+    EXPECT_EQ(s.reads, 2u);
+
+    io.ReadNow(dir.path("crate.mtl"));
+    io.ReadNow(dir.path("Crate_Diffuse.PNG"));
+    io.ReadNow(model);
+    s = io.stats();
+    EXPECT_EQ(s.readAheadHits, 2u);
+    EXPECT_EQ(s.reads, 3u) << "only the model itself should have needed the disk";
+}
+
+TEST(IOService, TheReadAheadBudgetEvictsTheOldestUnclaimedFile) {
+    ScratchDir dir;
+    const std::string a = dir.write("a.bin", std::string(400, 'a'));
+    const std::string b = dir.write("b.bin", std::string(400, 'b'));
+    const std::string c = dir.write("c.bin", std::string(400, 'c'));
+
+    IOService io(IOService::kDefaultQueueCapacity, /*readAheadBudgetBytes=*/1000);
+    io.ReadAhead(a);
+    io.ReadAhead(b);
+    io.ReadAhead(c);
+    io.waitIdle();
+    IOService::Stats s = io.stats();
+    EXPECT_LE(s.residentBytes, 1000u);
+    EXPECT_EQ(s.readAheadEvicted, 1u);
+
+    io.ReadNow(c);
+    EXPECT_EQ(io.stats().readAheadHits, 1u) << "the newest hint should still be resident";
+    io.ReadNow(a);
+    EXPECT_EQ(io.stats().readAheadHits, 1u) << "the oldest hint should have been evicted";
+}
+
+TEST(IOService, AFullQueueDropsHintsAndMakesReadsWait) {
+    ScratchDir dir;
+    const std::string park = dir.write("park.txt", "x");
+    std::string paths[6];
+    for (int i = 0; i < 6; ++i) paths[i] = dir.write("f" + std::to_string(i) + ".txt", "y");
+
+    IOService io(/*queueCapacity=*/4);
+    IOGate gate;
+    io.Read(park, gate.hold());
+    gate.waitHeld();
+
+    io.Read(paths[0]);
+    io.Read(paths[1]); // queue half full: hints are refused from here on
+    io.ReadAhead(paths[2]);
+    EXPECT_EQ(io.stats().readAheadDropped, 1u);
+
+    io.Read(paths[3]);
+    io.Read(paths[4]); // full
+    std::atomic<bool> returned{ false };
+    std::thread late([&] { io.Read(paths[5]); returned = true; });
+    while (io.stats().queueFullWaits == 0) std::this_thread::yield();
+    EXPECT_FALSE(returned.load()) << "a Read past the bound was queued anyway";
+
+    gate.release();
+    late.join();
+    EXPECT_TRUE(returned.load());
+    io.waitIdle();
+    EXPECT_EQ(io.stats().reads, 6u); // park + five demand reads; the hint never ran
+    EXPECT_LE(io.stats().queuePeak, 4u);
+}
+
+TEST(IOService, ShutdownNeverLeavesAWaiterHanging) {
+    ScratchDir dir;
+    const std::string park = dir.write("park.txt", "x");
+    const std::string queued = dir.write("queued.txt", "y");
+
+    auto io = std::make_unique<IOService>();
+    IOGate gate;
+    io->Read(park, gate.hold());
+    gate.waitHeld();
+    const IOTicket t = io->Read(queued);
+
+    std::thread killer([&] { io.reset(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    gate.release();
+    killer.join();
+    // Read or failed, depending on whether the destructor beat the I/O
+    // thread back to its queue — but answered either way.
+    const IOBlobPtr b = t->wait();
+    if (!b->ok) {
+        EXPECT_FALSE(b->error.empty());
+    }
+}
@@ -3,10 +3,15 @@
 // can't flake them.
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
@@ -210,3 +215,171 @@ TEST(JobSystem, AutoWorkerCountIsBoundedAndNonZero) {
     EXPECT_GE(jobs.workerCount(), 1u);
     EXPECT_LE(jobs.workerCount(), 4u);
 }
+
+TEST(JobSystem, CompletionsRunInTheOrderTheirJobsFinished) {
+    // one worker finishes jobs in submission order, so the completions must
+    // come out in that order too — the pump takes the completion STACK in
+    // one exchange, and forgetting to reverse it would run each batch
+    // newest-first. Pumped with a tiny budget so the order also has to
+    // survive a batch being split across pumps.
+    JobSystem jobs(1);
+    std::vector<int> order;
+    for (int i = 0; i < 64; ++i) {
+        jobs.submit([] {}, [&order, i] { order.push_back(i); });
+    }
+    jobs.waitIdle();
+    while (jobs.pendingCompletions() > 0) jobs.pumpCompletions(0.f);
+
+    ASSERT_EQ(order.size(), 64u);
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_EQ(order[i], i) << "completion " << i << " ran out of order";
+    }
+}
+
+TEST(JobSystem, ClosuresTooBigToStoreInlineStillRunAndAreFreed) {
+    // the small-buffer job type must fall back to the heap, not refuse a
+    // big capture — and the captures must be released once the job ran,
+    // not kept alive by a recycled slot
+    JobSystem jobs(2);
+    auto token = std::make_shared<int>(7);
+    std::array<char, 512> big{};
+    big[511] = 42;
+    std::atomic<int> sum{ 0 };
+    jobs.submit([big, token, &sum] { sum.fetch_add(big[511] + *token); },
+                [big, token, &sum] { sum.fetch_add(big[511]); });
+    jobs.waitIdle();
+    jobs.pumpCompletions(10.f);
+    EXPECT_EQ(sum.load(), 42 + 7 + 42);
+    EXPECT_EQ(token.use_count(), 1)
+        << "a finished job's closure is still holding its captures";
+}
+
+TEST(JobSystem, AnEmptyStdFunctionCompletionMeansNoCompletion) {
+    JobSystem jobs(1);
+    std::function<void()> none;
+    jobs.submit([] {}, none);
+    jobs.waitIdle();
+    EXPECT_EQ(jobs.pendingCompletions(), 0u)
+        << "an empty std::function was queued as a completion (it would throw when pumped)";
+}
+
+TEST(JobSystem, ThousandsOfTinyJobsUnderContention) {
+    // The cooker's shape: many jobs that finish almost at once, all with a
+    // completion, while the main thread pumps. Nothing may be lost and no
+    // completion may run off the main thread. The timed version of this
+    // load is JobSystemPerf in test_perf_cpu.
+    JobSystem jobs(4);
+    constexpr int kThreads = 4, kPerThread = 1000, kTotal = kThreads * kPerThread;
+    std::atomic<int> executed{ 0 };
+    int completions = 0; // main thread only
+    std::atomic<int> completionsOffMain{ 0 };
+
+    std::vector<std::thread> submitters;
+    for (int t = 0; t < kThreads; ++t) {
+        submitters.emplace_back([&] {
+            for (int i = 0; i < kPerThread; ++i) {
+                jobs.submit(
+                    [&] { executed.fetch_add(1, std::memory_order_relaxed); },
+                    [&] {
+                        if (!jobs.isMainThread()) completionsOffMain.fetch_add(1);
+                        ++completions;
+                    });
+            }
+        });
+    }
+
+    // generous for 4k trivial jobs; only a stuck queue gets near it
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (completions < kTotal && std::chrono::steady_clock::now() < deadline) {
+        if (jobs.pumpCompletions(1.f) == 0) std::this_thread::yield();
+    }
+    for (auto& t : submitters) t.join();
+    EXPECT_EQ(completions, kTotal) << "completions still missing after 5 s — queue is stuck";
+    jobs.waitIdle();
+    jobs.pumpCompletions(1e6f);
+
+    EXPECT_EQ(executed.load(), kTotal) << "jobs were lost under contention";
+    EXPECT_EQ(completions, kTotal) << "completions were lost under contention";
+    EXPECT_EQ(completionsOffMain.load(), 0) << "a completion ran off the main thread";
+    EXPECT_EQ(jobs.pendingCompletions(), 0u);
+}
+
+// --- parallelFor ---------------------------------------------------------
+
+TEST(JobSystem, ParallelForCoversEveryIndexOnceInFixedChunks) {
+    JobSystem jobs(3);
+    constexpr std::size_t kCount = 10007, kGrain = 64; // ragged last chunk
+    std::vector<std::atomic<int>> hits(kCount);
+    std::vector<std::pair<std::size_t, std::size_t>> ranges(
+        JobSystem::chunkCount(kCount, kGrain));
+    jobs.parallelFor(kCount, kGrain, [&](std::size_t b, std::size_t e, std::size_t c) {
+        ranges[c] = { b, e }; // each chunk index is handed out once
+        for (std::size_t i = b; i < e; ++i) hits[i].fetch_add(1);
+    });
+    for (std::size_t i = 0; i < kCount; ++i) ASSERT_EQ(hits[i].load(), 1) << "index " << i;
+    for (std::size_t c = 0; c < ranges.size(); ++c) {
+        // the layout is a pure function of (count, grain), not of scheduling
+        EXPECT_EQ(ranges[c].first, c * kGrain);
+        EXPECT_EQ(ranges[c].second, std::min(kCount, (c + 1) * kGrain));
+    }
+}
+
+TEST(JobSystem, ParallelForMakesProgressWithEveryWorkerBusy) {
+    JobSystem jobs(2);
+    std::mutex m;
+    std::condition_variable cv;
+    bool release = false;
+    for (unsigned i = 0; i < jobs.workerCount(); ++i) {
+        jobs.submit([&] {
+            std::unique_lock<std::mutex> lk(m);
+            cv.wait(lk, [&] { return release; });
+        });
+    }
+    // the helpers queue behind the parked jobs: the caller must do it all
+    std::atomic<int> sum{ 0 };
+    const auto self = std::this_thread::get_id();
+    std::atomic<bool> allOnCaller{ true };
+    jobs.parallelFor(1000, 10, [&](std::size_t b, std::size_t e, std::size_t) {
+        if (std::this_thread::get_id() != self) allOnCaller = false;
+        for (std::size_t i = b; i < e; ++i) sum.fetch_add(1);
+    });
+    EXPECT_EQ(sum.load(), 1000);
+    EXPECT_TRUE(allOnCaller.load());
+
+    // the late helpers find nothing left and must not touch the finished call
+    {
+        std::lock_guard<std::mutex> lk(m);
+        release = true;
+    }
+    cv.notify_all();
+    jobs.waitIdle();
+}
+
+TEST(JobSystem, ParallelForRethrowsOnTheCallerAfterEveryChunk) {
+    JobSystem jobs(2);
+    std::atomic<int> finished{ 0 };
+    EXPECT_THROW(
+        jobs.parallelFor(64, 1, [&](std::size_t b, std::size_t, std::size_t) {
+            if (b == 5) throw std::runtime_error("chunk 5");
+            finished.fetch_add(1);
+        }),
+        std::runtime_error);
+    EXPECT_EQ(finished.load(), 63) << "a throwing chunk must not cancel the others";
+
+    // a single chunk runs inline, and so does its exception
+    EXPECT_THROW(jobs.parallelFor(3, 8, [](std::size_t, std::size_t, std::size_t) {
+        throw std::runtime_error("inline");
+    }), std::runtime_error);
+    jobs.parallelFor(0, 8, [](std::size_t, std::size_t, std::size_t) { FAIL(); });
+}
+
+TEST(JobSystem, ParallelForNestsWithoutDeadlock) {
+    JobSystem jobs(2);
+    std::atomic<int> leaves{ 0 };
+    jobs.parallelFor(8, 1, [&](std::size_t, std::size_t, std::size_t) {
+        jobs.parallelFor(16, 2, [&](std::size_t b, std::size_t e, std::size_t) {
+            leaves.fetch_add(int(e - b));
+        });
+    });
+    EXPECT_EQ(leaves.load(), 8 * 16);
+}
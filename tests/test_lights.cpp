@@ -9,6 +9,7 @@
 
 #include "Engine.h"
 
+#include <cstring>
 #include <vector>
 
 using namespace MyCoreEngine;
@@ -136,3 +137,181 @@ TEST(Lights, WorldPositionIsCorrectWithDirtyTransforms) {
         << "light built from a stale identity matrix instead of its real pose";
     EXPECT_FLOAT_EQ(out[0].position.z, 9.f);
 }
+
+// --- Clustered assignment ----------------------------------------------------
+//
+// LightClusters is glm-free, so these drive it with plain view-space spheres.
+// The property that matters is CONSERVATIVE: a fragment must find every light
+// that reaches it in its own cluster's list. Extra entries only cost time;
+// a missing one is a lamp that switches off as the camera turns.
+
+namespace {
+    struct Lcg {
+        uint32_t s;
+        float next(float lo, float hi) {
+            s = s * 1664525u + 1013904223u;
+            return lo + (hi - lo) * float(s >> 8) / float(1u << 24);
+        }
+    };
+
+    ClusterGridDesc testGrid() {
+        ClusterGridDesc g;
+        g.nearZ = 0.1f;
+        g.farZ = 200.f;
+        g.tanHalfFovY = 0.57735f; // 60 deg
+        g.aspect = 16.f / 9.f;
+        g.viewportW = 1280.f;
+        g.viewportH = 720.f;
+        return g;
+    }
+
+    bool listed(const LightClusters& lc, uint32_t cluster, uint32_t light) {
+        const LightClusters::Range r = lc.Cluster(cluster);
+        for (uint32_t i = 0; i < r.count; ++i) {
+            if (lc.Indices()[r.offset + i] == light) return true;
+        }
+        return false;
+    }
+}
+
+TEST(LightClusters, EveryLightReachingAFragmentIsInItsCluster) {
+    const ClusterGridDesc g = testGrid();
+    Lcg rng{ 7u };
+    std::vector<LightSphere> lights;
+    for (int i = 0; i < 200; ++i) {
+        lights.push_back({ rng.next(-60.f, 60.f), rng.next(-30.f, 30.f),
+                           rng.next(-150.f, 5.f), rng.next(0.5f, 12.f) });
+    }
+    LightClusters lc;
+    lc.Build(g, lights.data(), lights.size());
+    ASSERT_EQ(lc.Dropped(), 0u);
+
+    // fragments: random pixels at random depths, reconstructed to view space
+    // the way the projection would have placed them
+    int checked = 0;
+    for (int f = 0; f < 20000; ++f) {
+        const float px = rng.next(0.f, g.viewportW);
+        const float py = rng.next(0.f, g.viewportH);
+        const float depth = rng.next(g.nearZ, g.farZ);
+        const float ndcX = px / g.viewportW * 2.f - 1.f;
+        const float ndcY = py / g.viewportH * 2.f - 1.f;
+        const float vx = ndcX * depth * g.tanHalfFovY * g.aspect;
+        const float vy = ndcY * depth * g.tanHalfFovY;
+        const float vz = -depth;
+        const uint32_t c = lc.ClusterAt(px, py, depth);
+        for (uint32_t li = 0; li < lights.size(); ++li) {
+            const LightSphere& L = lights[li];
+            const float dx = vx - L.x, dy = vy - L.y, dz = vz - L.z;
+            if (dx * dx + dy * dy + dz * dz > L.radius * L.radius * 0.999f) continue;
+            ++checked;
+            ASSERT_TRUE(listed(lc, c, li))
+                << "light " << li << " reaches pixel (" << px << ", " << py
+                << ") at depth " << depth << " but is not in cluster " << c;
+        }
+    }
+    EXPECT_GT(checked, 100) << "the sample never landed inside a light";
+}
+
+TEST(LightClusters, ListsAreTighterThanEveryLightEverywhere) {
+    const ClusterGridDesc g = testGrid();
+    std::vector<LightSphere> lights = {
+        { 0.f, 0.f, -10.f, 2.f },     // small, centre of view
+        { 0.f, 0.f, 10.f, 3.f },      // behind the camera
+        { 500.f, 0.f, -20.f, 5.f },   // far off to the side
+        { 0.f, 0.f, -400.f, 10.f },   // beyond the far plane
+    };
+    LightClusters lc;
+    lc.Build(g, lights.data(), lights.size());
+
+    // only the first light is visible, and only near the middle of the screen
+    uint32_t total = 0;
+    for (uint32_t c = 0; c < lc.ClusterCount(); ++c) {
+        const LightClusters::Range r = lc.Cluster(c);
+        for (uint32_t i = 0; i < r.count; ++i) EXPECT_EQ(lc.Indices()[r.offset + i], 0u);
+        total += r.count;
+    }
+    EXPECT_GT(total, 0u);
+    EXPECT_LT(total, lc.ClusterCount() / 20) << "a 2 m light filled the frustum";
+    EXPECT_TRUE(listed(lc, lc.ClusterAt(640.f, 360.f, 10.f), 0u));
+    EXPECT_FALSE(listed(lc, lc.ClusterAt(10.f, 10.f, 10.f), 0u));
+    EXPECT_FALSE(listed(lc, lc.ClusterAt(640.f, 360.f, 100.f), 0u));
+}
+
+TEST(LightClusters, SlicesAreExponentialAndClamped) {
+    LightClusters lc;
+    const ClusterGridDesc g = testGrid();
+    lc.Build(g, nullptr, 0);
+    EXPECT_EQ(lc.SliceOf(0.f), 0u);
+    EXPECT_EQ(lc.SliceOf(g.nearZ * 1.0001f), 0u);
+    EXPECT_EQ(lc.SliceOf(g.farZ * 10.f), g.slices - 1);
+    // equal depth RATIOS cover equal numbers of slices
+    const int a = int(lc.SliceOf(16.f)) - int(lc.SliceOf(1.f));
+    const int b = int(lc.SliceOf(160.f)) - int(lc.SliceOf(10.f));
+    EXPECT_NEAR(a, b, 1);
+}
+
+TEST(LightClusters, OverflowDropsTheLowestPriorityLightsFirst) {
+    ClusterGridDesc g = testGrid();
+    // 256 lights that each cover the whole frustum: 256 x 3456 pairs
+    std::vector<LightSphere> lights(LightClusters::kMaxLights, LightSphere{ 0.f, 0.f, -50.f, 1000.f });
+    LightClusters lc;
+    lc.Build(g, lights.data(), lights.size());
+
+    EXPECT_GT(lc.Dropped(), 0u);
+    EXPECT_EQ(lc.Indices().size(), size_t(LightClusters::kMaxIndices));
+    // the first light is everywhere; the last one, nowhere
+    for (uint32_t c = 0; c < lc.ClusterCount(); ++c) {
+        EXPECT_TRUE(listed(lc, c, 0u));
+        EXPECT_FALSE(listed(lc, c, LightClusters::kMaxLights - 1));
+    }
+}
+
+TEST(LightClusters, OversizedGridsShrinkToFitTheUniformBlock) {
+    ClusterGridDesc g = testGrid();
+    g.tilesX = 64;
+    g.tilesY = 36;
+    g.slices = 32;
+    LightClusters lc;
+    lc.Build(g, nullptr, 0);
+    EXPECT_LE(lc.ClusterCount(), LightClusters::kMaxClusters);
+    EXPECT_EQ(lc.Grid().tilesX, 64u);
+    EXPECT_EQ(lc.Grid().tilesY, 36u);
+    EXPECT_GE(lc.Grid().slices, 1u);
+}
+
+// The packed words are what the shader reads: decode them the GLSL way.
+TEST(LightClusters, PackedBlocksDecodeToTheSameLists) {
+    const ClusterGridDesc g = testGrid();
+    Lcg rng{ 11u };
+    std::vector<LightSphere> lights;
+    for (int i = 0; i < 64; ++i) {
+        lights.push_back({ rng.next(-40.f, 40.f), rng.next(-20.f, 20.f),
+                           rng.next(-120.f, -1.f), rng.next(1.f, 15.f) });
+    }
+    LightClusters lc;
+    lc.Build(g, lights.data(), lights.size());
+
+    std::vector<uint32_t> grid, index;
+    lc.PackGrid(grid);
+    lc.PackIndices(index);
+    ASSERT_EQ(grid.size() * 4, LightClusters::kGridBlockBytes);
+    ASSERT_EQ(index.size() * 4, LightClusters::kIndexBlockBytes);
+    EXPECT_EQ(grid[0], g.tilesX);
+    EXPECT_EQ(grid[1], g.tilesY);
+    EXPECT_EQ(grid[2], g.slices);
+    float tileW = 0.f;
+    std::memcpy(&tileW, &grid[6], sizeof(float));
+    EXPECT_FLOAT_EQ(tileW, g.viewportW / float(g.tilesX));
+
+    for (uint32_t c = 0; c < lc.ClusterCount(); ++c) {
+        const uint32_t rec = grid[8 + (c >> 2) * 4 + (c & 3)]; // record[c / 4][c % 4]
+        const LightClusters::Range r = lc.Cluster(c);
+        ASSERT_EQ(rec & 0xffffu, r.offset);
+        ASSERT_EQ(rec >> 16, r.count);
+        for (uint32_t i = 0; i < r.count; ++i) {
+            const uint32_t j = r.offset + i;
+            const uint32_t word = index[(j >> 4) * 4 + ((j >> 2) & 3)]; // index[j / 16][(j / 4) % 4]
+            ASSERT_EQ((word >> ((j & 3) * 8)) & 0xffu, lc.Indices()[j]);
+        }
+    }
+}
@@ -0,0 +1,123 @@
+// Shared mesh buffers: the range bookkeeping behind MeshArena. Headless —
+// RangeAllocator is plain offsets; the GL side is exercised by the scene
+// and perf tests.
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+namespace {
+
+struct Lcg {
+    uint32_t s;
+    uint32_t next() {
+        s = s * 1664525u + 1013904223u;
+        return s >> 8;
+    }
+};
+
+} // namespace
+
+TEST(RangeAllocator, AllocatesFirstFitFromTheLowestOffset) {
+    RangeAllocator a;
+    a.Reset(100);
+    EXPECT_EQ(a.Allocate(10), 0u);
+    EXPECT_EQ(a.Allocate(20), 10u);
+    EXPECT_EQ(a.Allocate(30), 30u);
+    EXPECT_EQ(a.Used(), 60u);
+
+    a.Free(10, 20); // hole [10, 30)
+    EXPECT_EQ(a.Allocate(25), 60u) << "the hole is too small: past the end";
+    EXPECT_EQ(a.Allocate(5), 10u) << "the lowest block that fits";
+    EXPECT_EQ(a.Allocate(50), RangeAllocator::kNone) << "15 left at the end, 15 in the hole";
+    EXPECT_EQ(a.Allocate(0), RangeAllocator::kNone);
+}
+
+TEST(RangeAllocator, FreeMergesWithBothNeighbours) {
+    RangeAllocator a;
+    a.Reset(90);
+    const uint32_t x = a.Allocate(30), y = a.Allocate(30), z = a.Allocate(30);
+    a.Free(x, 30);
+    a.Free(z, 30);
+    EXPECT_EQ(a.FreeBlocks(), 2u);
+    a.Free(y, 30); // joins the block before and the block after
+    EXPECT_EQ(a.FreeBlocks(), 1u);
+    EXPECT_EQ(a.LargestFree(), 90u);
+    EXPECT_EQ(a.Used(), 0u);
+    EXPECT_EQ(a.Allocate(90), 0u) << "a fully freed allocator hands out its whole capacity";
+}
+
+TEST(RangeAllocator, GrowJoinsTheFreeTail) {
+    RangeAllocator a;
+    a.Reset(64);
+    EXPECT_EQ(a.Allocate(60), 0u);
+    EXPECT_EQ(a.Allocate(10), RangeAllocator::kNone);
+    a.Grow(128);
+    EXPECT_EQ(a.Capacity(), 128u);
+    EXPECT_EQ(a.FreeBlocks(), 1u) << "the 4 left at the end and the new 64 are one block";
+    EXPECT_EQ(a.Allocate(10), 60u);
+
+    a.Grow(100); // never shrinks
+    EXPECT_EQ(a.Capacity(), 128u);
+}
+
+TEST(RangeAllocator, EndCountsHolesButNotTheFreeTail) {
+    RangeAllocator a;
+    a.Reset(1000);
+    EXPECT_EQ(a.End(), 0u);
+    const uint32_t x = a.Allocate(100);
+    a.Allocate(100);
+    EXPECT_EQ(a.End(), 200u);
+    a.Free(x, 100);
+    EXPECT_EQ(a.End(), 200u) << "a hole below the last range still counts";
+    EXPECT_EQ(a.End() - a.Used(), 100u) << "what MeshArena::Compact would win back";
+
+    a.Reset(10);
+    a.Allocate(10);
+    EXPECT_EQ(a.End(), 10u) << "full: no free tail";
+}
+
+// Random allocate/free against a plain list of live ranges: never overlap,
+// never leave capacity, and Used always equals the live total.
+TEST(RangeAllocator, RandomTrafficNeverOverlaps) {
+    RangeAllocator a;
+    a.Reset(4096);
+    std::vector<std::pair<uint32_t, uint32_t>> live;
+    Lcg rng{ 7 };
+    for (int step = 0; step < 5000; ++step) {
+        if (live.empty() || rng.next() % 3 != 0) {
+            const uint32_t n = 1 + rng.next() % 200;
+            uint32_t off = a.Allocate(n);
+            if (off == RangeAllocator::kNone) {
+                a.Grow(a.Capacity() * 2);
+                off = a.Allocate(n);
+            }
+            ASSERT_NE(off, RangeAllocator::kNone);
+            ASSERT_LE(off + n, a.Capacity());
+            live.emplace_back(off, n);
+        }
+        else {
+            const std::size_t k = rng.next() % live.size();
+            a.Free(live[k].first, live[k].second);
+            live[k] = live.back();
+            live.pop_back();
+        }
+
+        uint32_t used = 0;
+        for (const auto& r : live) used += r.second;
+        ASSERT_EQ(a.Used(), used);
+    }
+
+    std::sort(live.begin(), live.end());
+    for (std::size_t i = 1; i < live.size(); ++i) {
+        EXPECT_LE(live[i - 1].first + live[i - 1].second, live[i].first) << "ranges " << i - 1 << ", " << i;
+    }
+    for (const auto& r : live) a.Free(r.first, r.second);
+    EXPECT_EQ(a.FreeBlocks(), 1u) << "everything returned must coalesce back to one block";
+    EXPECT_EQ(a.LargestFree(), a.Capacity());
+}
@@ -4,8 +4,10 @@
 // under its GL fixture.
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cfloat>
+#include <cmath>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -14,6 +16,8 @@
 
 #include "Engine.h"
 
+#include <glm/gtc/packing.hpp>
+
 using namespace MyCoreEngine;
 
 namespace {
@@ -250,3 +254,84 @@ TEST_F(ModelDecodeTest, ConcurrentTexturedGridDecodesAreIdentical) {
     std::error_code ec;
     std::filesystem::remove_all("decode_hl", ec);
 }
+
+// --- Packed vertex layout ---------------------------------------------------
+//
+// Decode the packed words the way GL's vertex fetch does (GL 4.2+ snorm
+// rule, which every current driver uses) and check what the shader would
+// see is within the formats' precision of the float Vertex.
+
+namespace {
+
+glm::vec4 fetchSnorm1010102(uint32_t w) {
+    auto field = [&](int shift, int bits) {
+        int v = int((w >> shift) & ((1u << bits) - 1u));
+        if (v & (1 << (bits - 1))) v -= (1 << bits); // sign-extend
+        return std::max(float(v) / float((1 << (bits - 1)) - 1), -1.f);
+    };
+    return { field(0, 10), field(10, 10), field(20, 10), field(30, 2) };
+}
+
+} // namespace
+
+TEST(PackedVertex, QuantizesWithinFormatPrecision) {
+    Vertex v{};
+    v.Position = { 123.456f, -0.001f, 98765.f };
+    v.Normal = glm::normalize(glm::vec3(0.3f, -0.8f, 0.52f));
+    v.Tangent = glm::normalize(glm::vec3(0.9f, 0.3f, 0.1f));
+    v.Bitangent = glm::cross(v.Normal, v.Tangent);
+    v.TexCoords = { 3.25f, -1.5f }; // tiling UVs outside [0,1]
+
+    const PackedVertex p = PackVertex(v);
+    // position is float: exact
+    EXPECT_EQ(p.Position[0], v.Position.x);
+    EXPECT_EQ(p.Position[1], v.Position.y);
+    EXPECT_EQ(p.Position[2], v.Position.z);
+
+    const glm::vec4 n = fetchSnorm1010102(p.Normal);
+    const glm::vec4 t = fetchSnorm1010102(p.Tangent);
+    // 10 bits: within a quarter of a degree once renormalized
+    EXPECT_GT(glm::dot(glm::normalize(glm::vec3(n)), v.Normal), std::cos(glm::radians(0.25f)));
+    EXPECT_GT(glm::dot(glm::normalize(glm::vec3(t)), v.Tangent), std::cos(glm::radians(0.25f)));
+    EXPECT_EQ(t.w, 1.f);
+
+    // half UVs: 11 significant bits
+    EXPECT_NEAR(glm::unpackHalf1x16(p.TexCoords[0]), 3.25f, 1e-3f);
+    EXPECT_NEAR(glm::unpackHalf1x16(p.TexCoords[1]), -1.5f, 1e-3f);
+}
+
+TEST(PackedVertex, MirroredUVsKeepTheirHandedness) {
+    Vertex v{};
+    v.Normal = { 0.f, 1.f, 0.f };
+    v.Tangent = { 1.f, 0.f, 0.f };
+    v.Bitangent = -glm::cross(v.Normal, v.Tangent); // mirrored
+    EXPECT_LT(fetchSnorm1010102(PackVertex(v).Tangent).w, 0.f);
+    v.Bitangent = glm::cross(v.Normal, v.Tangent);
+    EXPECT_GT(fetchSnorm1010102(PackVertex(v).Tangent).w, 0.f);
+
+    // untangented vertices (no UVs) pack as zero, right-handed
+    Vertex bare{};
+    bare.Normal = { 0.f, 0.f, 1.f };
+    EXPECT_EQ(fetchSnorm1010102(PackVertex(bare).Tangent), glm::vec4(0.f, 0.f, 0.f, 1.f));
+}
+
+// The layout is chosen when the decode starts, and the worker does the
+// packing: finalize only uploads.
+TEST_F(ModelDecodeTest, DecodePacksOnTheWorkerForThePackedLayout) {
+    const VertexFormat saved = Mesh::GetVertexFormat();
+
+    Mesh::SetVertexFormat(VertexFormat::Packed);
+    const ModelCPUData packed = Model::Decode(kObj);
+    ASSERT_TRUE(packed.valid);
+    EXPECT_EQ(packed.vertexFormat, VertexFormat::Packed);
+    ASSERT_EQ(packed.meshes[0].packed.size(), packed.meshes[0].vertices.size());
+    EXPECT_EQ(packed.meshes[0].packed[0].Position[0], packed.meshes[0].vertices[0].Position.x);
+    EXPECT_LT(sizeof(PackedVertex) * 2, sizeof(Vertex)) << "less than half the bytes per vertex";
+
+    Mesh::SetVertexFormat(VertexFormat::Full);
+    const ModelCPUData full = Model::Decode(kObj);
+    EXPECT_EQ(full.vertexFormat, VertexFormat::Full);
+    EXPECT_TRUE(full.meshes[0].packed.empty());
+
+    Mesh::SetVertexFormat(saved);
+}
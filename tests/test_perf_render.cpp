@@ -35,6 +35,7 @@
 #include <cstdlib>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 using namespace MyCoreEngine;
@@ -149,9 +150,12 @@ namespace {
             entt::entity hero = entt::null;
         };
 
-        static BuiltScene buildGrid(Scene& scene, int nx, int nz, float spacing = 10.f) {
+        // `model` overrides the cached backpack (the vertex-layout A/B
+        // loads its own copies)
+        static BuiltScene buildGrid(Scene& scene, int nx, int nz, float spacing = 10.f,
+                                    std::shared_ptr<Model> model = nullptr) {
             BuiltScene out;
-            auto model = assets->GetModel("Exported/Model/backpack.obj");
+            if (!model) model = assets->GetModel("Exported/Model/backpack.obj");
             if (!model || model->Meshes().empty()) {
                 ADD_FAILURE() << "backpack.obj failed to load";
                 return out;
@@ -204,6 +208,7 @@ namespace {
             double p95Ms = 0.0;
             double cpuMedianMs = 0.0; // until RenderFrame returns (pre-glFinish)
             RenderStats stats{};
+            std::vector<GpuPassTime> gpu; // per pass, smoothed; empty without timer queries
         };
 
         static PerfResult measure(const char* name, Scene& scene, Camera& cam,
@@ -255,6 +260,12 @@ namespace {
                         r.stats.submitted, r.stats.instances, r.stats.culled,
                         r.stats.lodInstances[0], r.stats.lodInstances[1],
                         r.stats.lodInstances[2]);
+            r.gpu = renderer.GpuPassTimes();
+            if (!r.gpu.empty()) {
+                std::printf("[PERF]   gpu");
+                for (const GpuPassTime& t : r.gpu) std::printf("  %s %.2f", t.name, t.avgMs);
+                std::printf(" ms\n");
+            }
             std::fflush(stdout);
             return r;
         }
@@ -336,6 +347,167 @@ TEST_F(PerfFixture, FXAA_CostIsSmall) {
         << "FXAA is costing far more than one fullscreen pass should";
 }
 
+// Vertex layout A/B, inside one run like FXAA above: the backpack uploaded
+// as the Full float Vertex and as PackedVertex (Model.h), VRAM read off the
+// buffers themselves, frame time on the wide 25x25 shot where vertex fetch
+// is the bound. The fetch figure is an upper bound — every vertex of every
+// submitted instance — since LOD draws touch fewer.
+TEST_F(PerfFixture, PackedVertices_HalveVertexMemory) {
+    const VertexFormat saved = Mesh::GetVertexFormat();
+    Mesh::SetVertexFormat(VertexFormat::Full);
+    auto full = std::make_shared<Model>("Exported/Model/backpack.obj");
+    Mesh::SetVertexFormat(VertexFormat::Packed);
+    auto packed = std::make_shared<Model>("Exported/Model/backpack.obj");
+    Mesh::SetVertexFormat(saved);
+    ASSERT_FALSE(full->Meshes().empty());
+    ASSERT_FALSE(packed->Meshes().empty());
+
+    auto vertexBytes = [](const Model& m) {
+        size_t bytes = 0;
+        for (const Mesh& mesh : m.Meshes()) bytes += mesh.VertexBytes();
+        return bytes;
+    };
+    const size_t fullBytes = vertexBytes(*full);
+    const size_t packedBytes = vertexBytes(*packed);
+    EXPECT_EQ(packed->Meshes()[0].Format(), VertexFormat::Packed);
+    EXPECT_LT(packedBytes * 2, fullBytes) << "packed vertices should take under half the VRAM";
+
+    Camera cam;
+    aim(cam, { 0.f, 110.f, 150.f }, { 0.f, 0.f, 0.f });
+    Scene a;
+    buildGrid(a, 25, 25, 10.f, full);
+    const auto rFull = measure("vertices full (56 B)", a, cam);
+    Scene b;
+    buildGrid(b, 25, 25, 10.f, packed);
+    const auto rPacked = measure("vertices packed (24 B)", b, cam);
+
+    const double mb = 1024.0 * 1024.0;
+    std::printf("[PERF] vertex buffers       %7.2f MB -> %7.2f MB per backpack\n",
+                fullBytes / mb, packedBytes / mb);
+    std::printf("[PERF] vertex fetch/frame   %7.0f MB -> %7.0f MB (upper bound)\n",
+                double(fullBytes) * rFull.stats.submitted / mb,
+                double(packedBytes) * rPacked.stats.submitted / mb);
+    std::printf("[PERF] vertex layout delta  %+7.3f ms (full %.2f -> packed %.2f)\n",
+                rPacked.medianMs - rFull.medianMs, rFull.medianMs, rPacked.medianMs);
+
+    EXPECT_EQ(rPacked.stats.submitted, rFull.stats.submitted) << "the layout changed what was drawn";
+    // fewer bytes per vertex must never cost frame time (noise headroom)
+    EXPECT_LT(rPacked.medianMs, rFull.medianMs * 1.25 * budgetScale())
+        << "the packed layout is slower than the float one";
+}
+
+// Shared mesh buffers: the same backpack uploaded into the arena and into
+// per-mesh buffers, drawn from the same wide shot. In the arena every mesh
+// is a base vertex into one VAO, so the color pass binds it once.
+TEST_F(PerfFixture, SharedMeshBuffers_OneVaoBind) {
+    Mesh::SetSharedBuffers(false);
+    auto owned = std::make_shared<Model>("Exported/Model/backpack.obj");
+    Mesh::SetSharedBuffers(true);
+    auto shared = std::make_shared<Model>("Exported/Model/backpack.obj");
+    ASSERT_FALSE(owned->Meshes().empty());
+    ASSERT_FALSE(owned->Meshes()[0].InArena());
+    ASSERT_TRUE(shared->Meshes()[0].InArena());
+
+    Camera cam;
+    aim(cam, { 0.f, 110.f, 150.f }, { 0.f, 0.f, 0.f });
+    Scene a;
+    buildGrid(a, 25, 25, 10.f, owned);
+    const auto rOwned = measure("mesh buffers owned", a, cam);
+    Scene b;
+    buildGrid(b, 25, 25, 10.f, shared);
+    const auto rShared = measure("mesh buffers shared", b, cam);
+
+    std::printf("[PERF] VAO binds/frame      %7u -> %7u (%zu meshes per backpack)\n",
+                rOwned.stats.vaoBinds, rShared.stats.vaoBinds, shared->Meshes().size());
+    std::printf("[PERF] mesh buffers delta   %+7.3f ms (owned %.2f -> shared %.2f)\n",
+                rShared.medianMs - rOwned.medianMs, rOwned.medianMs, rShared.medianMs);
+
+    EXPECT_EQ(rShared.stats.submitted, rOwned.stats.submitted) << "the buffers changed what was drawn";
+    EXPECT_EQ(rShared.stats.vaoBinds, 1u) << "one vertex format, one VAO";
+    EXPECT_LE(rShared.stats.vaoBinds, rOwned.stats.vaoBinds);
+    EXPECT_LT(rShared.medianMs, rOwned.medianMs * 1.25 * budgetScale())
+        << "base-vertex draws from the arena are slower than per-mesh VAOs";
+}
+
+// Multi-draw indirect: the same arena backpack grid with and without it.
+// The backpack's meshes share one material, so each LOD/mesh run of the
+// wide shot joins one indirect call instead of issuing its own.
+TEST_F(PerfFixture, MultiDrawIndirect_FoldsRuns) {
+    if (!GetGLCaps().multiDrawIndirect) {
+        GTEST_SKIP() << "needs GL 4.3 or ARB_multi_draw_indirect + ARB_base_instance";
+    }
+    Camera cam;
+    aim(cam, { 0.f, 110.f, 150.f }, { 0.f, 0.f, 0.f });
+    Scene a;
+    a.SetMultiDrawEnabled(false);
+    buildGrid(a, 25, 25, 10.f);
+    const auto rPerRun = measure("multi-draw off", a, cam);
+    Scene b;
+    buildGrid(b, 25, 25, 10.f);
+    const auto rMulti = measure("multi-draw on", b, cam);
+
+    const unsigned callsPerRun = rPerRun.stats.draws + rPerRun.stats.instancedDraws;
+    const unsigned callsMulti = rMulti.stats.draws + rMulti.stats.instancedDraws + rMulti.stats.multiDraws;
+    std::printf("[PERF] color-pass calls     %7u -> %7u (%u multi-draws, %u draws saved)\n",
+                callsPerRun, callsMulti, rMulti.stats.multiDraws, rMulti.stats.drawsSaved);
+    std::printf("[PERF] multi-draw delta     %+7.3f ms (off %.2f -> on %.2f)\n",
+                rMulti.medianMs - rPerRun.medianMs, rPerRun.medianMs, rMulti.medianMs);
+
+    EXPECT_EQ(rMulti.stats.submitted, rPerRun.stats.submitted) << "batching changed what was drawn";
+    EXPECT_GT(rMulti.stats.drawsSaved, 0u);
+    EXPECT_EQ(callsMulti + rMulti.stats.drawsSaved, callsPerRun);
+    EXPECT_LT(rMulti.medianMs, rPerRun.medianMs * 1.25 * budgetScale())
+        << "indirect batches are slower than one call per run";
+}
+
+// Uniform blocks: a grid whose every backpack has its own material, so each
+// run binds a material block, with the upload of unchanged blocks skipped
+// and forced. At rest nothing changes, so the skip should leave only the
+// binds; timed on the CPU side, where the uploads are issued.
+TEST_F(PerfFixture, UniformBlocks_SkipUnchangedUploads) {
+    auto build = [](Scene& scene) {
+        buildGrid(scene, 25, 25, 10.f);
+        int i = 0;
+        for (auto e : scene.registry.view<ModelComponent>()) {
+            const auto& mc = scene.registry.get<ModelComponent>(e);
+            if (mc.model != backpack) continue;
+            auto mat = std::make_shared<Material>();
+            mat->baseColor = glm::vec3(0.5f + 0.5f * float(i++ % 7) / 6.f, 0.8f, 0.8f);
+            auto& ov = scene.registry.emplace<MaterialOverrides>(e);
+            for (const Mesh& m : mc.model->Meshes()) ov.byIndex[m.MaterialIndex()] = mat;
+        }
+    };
+    constexpr int kFrames = 40 + 120; // measure's warmup + timed frames
+    Camera cam;
+    aim(cam, { 0.f, 110.f, 150.f }, { 0.f, 0.f, 0.f });
+
+    Scene a;
+    build(a);
+    UniformBuffer::SetSkipUnchanged(false);
+    UniformBuffer::ResetStats();
+    const auto rForced = measure("uniform blocks forced", a, cam);
+    const UniformBuffer::Stats sForced = UniformBuffer::GetStats();
+    UniformBuffer::SetSkipUnchanged(true);
+
+    Scene b;
+    build(b);
+    UniformBuffer::ResetStats();
+    const auto rSkip = measure("uniform blocks skipped", b, cam);
+    const UniformBuffer::Stats sSkip = UniformBuffer::GetStats();
+
+    std::printf("[PERF] block uploads/frame  %7.1f -> %7.1f (%.1f binds)\n",
+                double(sForced.uploads) / kFrames, double(sSkip.uploads) / kFrames,
+                double(sSkip.binds) / kFrames);
+    std::printf("[PERF] uniform blocks delta %+7.3f ms cpu (forced %.2f -> skipped %.2f)\n",
+                rSkip.cpuMedianMs - rForced.cpuMedianMs, rForced.cpuMedianMs, rSkip.cpuMedianMs);
+
+    EXPECT_EQ(rSkip.stats.submitted, rForced.stats.submitted);
+    EXPECT_EQ(sForced.uploads, sForced.binds);
+    EXPECT_LT(sSkip.uploads * 10, sSkip.binds) << "a scene at rest keeps re-uploading its blocks";
+    EXPECT_LT(rSkip.cpuMedianMs, rForced.cpuMedianMs * 1.25 * budgetScale())
+        << "comparing blocks costs more than uploading them";
+}
+
 // Scenario 1: static camera over the editor's default 20x20 spawn grid.
 TEST_F(PerfFixture, AtRest_SpawnView) {
     Scene scene;
@@ -421,6 +593,50 @@ TEST_F(PerfFixture, WideView_MovingWithDynamicCaster) {
         << "move+spin wide-view frame regressed vs baseline";
 }
 
+// GPU pass timing: the passes that ran report a time each, in the order they
+// ran, and turning timing off reports nothing. Which pass owns the GPU is
+// printed, not asserted -- that is the machine's answer, not the engine's.
+TEST_F(PerfFixture, GpuPassTimes_CoverThePipeline) {
+    if (!GpuTimers::Supported()) {
+        GTEST_SKIP() << "needs GL_TIME_ELAPSED queries with a non-zero counter";
+    }
+    Scene scene;
+    buildGrid(scene, 20, 20);
+    Camera cam;
+    aim(cam, { 0.f, 10.f, 40.f }, { 0.f, 0.f, 0.f });
+
+    Renderer renderer;
+    RenderTarget rt;
+    rt.Create(1920, 1080);
+    renderer.Setup(rt.width(), rt.height());
+    renderer.SetGpuTimingEnabled(false);
+    for (int i = 0; i < 4; ++i) {
+        renderer.RenderFrame(scene, *shader, cam, rt.width(), rt.height(), 1.f / 60.f, rt.fbo());
+    }
+    EXPECT_TRUE(renderer.GpuPassTimes().empty()) << "timing off still reported passes";
+
+    const auto timed = measure("gpu timing on", scene, cam);
+    ASSERT_FALSE(timed.gpu.empty()) << "no pass reported a GPU time";
+    auto at = [&](const char* name) {
+        for (size_t i = 0; i < timed.gpu.size(); ++i) {
+            if (std::string(timed.gpu[i].name) == name) return int(i);
+        }
+        return -1;
+    };
+    const int shadows = at("ShadowCSM"), forward = at("ForwardOpaque"), tonemap = at("Tonemap");
+    EXPECT_GE(shadows, 0);
+    EXPECT_GE(forward, 0);
+    EXPECT_GE(tonemap, 0);
+    EXPECT_LT(shadows, forward) << "not in the order the passes ran";
+    EXPECT_LT(forward, tonemap) << "not in the order the passes ran";
+    float total = 0.f;
+    for (const GpuPassTime& t : timed.gpu) {
+        EXPECT_GE(t.ms, 0.f) << t.name;
+        total += t.ms;
+    }
+    EXPECT_GT(total, 0.f);
+}
+
 // Scenario 4: dynamic caster — the center entity spins every frame
 // (dirty transform), driving the view-depth-scoped shadow invalidation.
 TEST_F(PerfFixture, DynamicCasterShadows) {
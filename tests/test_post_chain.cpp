@@ -1,23 +1,28 @@
-// LDR post-process chain: ping-pong routing and GL-state hygiene.
+// LDR post-process chain: render-graph routing and GL-state hygiene.
 //
 // Two invariants of the M1/M2/M4 post stack had no coverage at all, and both
 // fail SILENTLY — the symptom is a black or frozen frame, or a corrupted later
 // pass, with nothing logged and no test red.
 //
-// 1. ROUTING. Renderer::countLdrPostPasses_ tells the chain how many passes
-//    will run; each enabled pass then consumes exactly one slot via
-//    nextPostTarget(), and the last one resolves to defaultFBO. If a pass's own
-//    enable predicate ever stops matching the count — a new guard, a shader
-//    that failed to compile, an effect added to the count but returning early —
-//    the final image is written into an off-screen ping-pong buffer and the
-//    screen shows whatever was there before. These tests assert the exact
-//    contract ("consumes one slot IFF enabled") over every combination.
+// 1. ROUTING. Each enabled pass declares one stage of the chain into the
+//    frame's RenderGraph, reading the stage before; the pipeline presents the
+//    last one as the output. If a pass is declared but then declines to draw —
+//    a new guard, a shader that failed to compile, an effect whose enabled()
+//    no longer matches what execute() checks — the final image is never
+//    written and the screen shows whatever was there before. These tests run
+//    the chain the way RenderPipeline does and assert that every declared pass
+//    draws, every other one does not, over every combination.
 //
 // 2. GL STATE. The pipeline runs passes in a bare loop with no inter-pass
 //    reset, so a pass that leaves blend/depth/cull changed corrupts the NEXT
 //    pass and the next frame's opaque draw. That already shipped once
 //    (SkyboxPass leaving GL_CULL_FACE off). Each pass is checked against the
 //    baseline it was handed.
+//
+// 3. FUSION. PostUberPass runs outline, grade and vignette as one shader that
+//    restates their maths. If the two ever drift the fused frame is quietly a
+//    different picture; the fused path is compared against the chain pixel by
+//    pixel.
 
 #include <gtest/gtest.h>
 #include <glad/glad.h>
@@ -28,8 +33,12 @@
 #include "../Engine/src/render/passes/ColorGradePass.h"
 #include "../Engine/src/render/passes/VignettePass.h"
 #include "../Engine/src/render/passes/FXAAPass.h"
+#include "../Engine/src/render/passes/PostUberPass.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
+#include <string>
 #include <vector>
 
 using namespace MyCoreEngine;
@@ -38,23 +47,24 @@ namespace {
 
 constexpr int kSize = 32;
 
-// What the Renderer budgets, asked the same way it asks: of the passes. This
-// used to restate the predicate ("outline.enabled || grade.enabled || ...")
-// exactly as countLdrPostPasses_ did, which meant the test agreed with the bug
-// -- both ignored that a pass ALSO needs a valid shader, and that the outline
-// needs scene depth. See OutlineWithoutSceneDepthIsNotCounted below.
+// How many stages the pipeline will declare, asked the way it asks: of the
+// passes. An earlier version restated the predicate ("outline.enabled ||
+// grade.enabled || ...") and so agreed with the bug it was meant to catch --
+// both ignored that a pass ALSO needs a valid shader, and that the outline
+// needs scene depth. See OutlineWithoutSceneDepthIsNotDeclared below.
 int expectedLdrCount(const std::vector<std::unique_ptr<IRenderPass>>& chain,
                      const PassContext& ctx, const Scene& s) {
     int n = 0;
-    for (const auto& pass : chain) if (pass->wantsLdrSlot(ctx, s)) ++n;
+    for (const auto& pass : chain) if (pass->enabled(ctx, s)) ++n;
     return n;
 }
 
 class PostChainTest : public ::testing::Test {
 protected:
     static GLFWwindow* win;
-    // Two ping-pong buffers plus a stand-in "screen".
-    GLuint texA = 0, fboA = 0, texB = 0, fboB = 0;
+    // The chain's source (tonemap's output) plus a stand-in "screen". The
+    // stages in between are the graph's transients.
+    GLuint texA = 0, fboA = 0;
     GLuint screenTex = 0, screenFBO = 0;
     GLuint depthTex = 0;         // OutlinePass samples scene depth
     GLuint quadVAO = 0, quadVBO = 0;
@@ -99,7 +109,6 @@ protected:
     void SetUp() override {
         // Distinct fills so "which buffer did the pass write into?" is decidable.
         makeColorTarget(texA, fboA, 40);
-        makeColorTarget(texB, fboB, 80);
         makeColorTarget(screenTex, screenFBO, 200);
 
         glGenTextures(1, &depthTex);
@@ -127,34 +136,59 @@ protected:
         glBindVertexArray(0);
     }
     void TearDown() override {
-        for (GLuint* t : { &texA, &texB, &screenTex, &depthTex })
+        targets.Release();
+        for (GLuint* t : { &texA, &screenTex, &depthTex })
             if (*t) { glDeleteTextures(1, t); *t = 0; }
-        for (GLuint* f : { &fboA, &fboB, &screenFBO })
+        for (GLuint* f : { &fboA, &screenFBO })
             if (*f) { glDeleteFramebuffers(1, f); *f = 0; }
         if (quadVBO) { glDeleteBuffers(1, &quadVBO); quadVBO = 0; }
         if (quadVAO) { glDeleteVertexArrays(1, &quadVAO); quadVAO = 0; }
     }
 
-    // postPassesLeft is left at 0 deliberately: the budget can only be computed
-    // once the passes exist and have been set up, exactly as in the Renderer.
+    RenderGraph graph;
+    TransientTargets targets;
+
     // withSceneDepth=false stands in for a frame with no depth texture, which
-    // the outline needs and the old count did not ask about.
+    // the outline needs and an earlier count did not ask about.
     PassContext makeCtx(bool withSceneDepth = true) {
         PassContext ctx{};
         ctx.defaultFBO = screenFBO;
         ctx.hdrDepthTex = withSceneDepth ? depthTex : 0;
-        ctx.ldrFBO_A = fboA; ctx.ldrTex_A = texA;
-        ctx.ldrFBO_B = fboB; ctx.ldrTex_B = texB;
-        ctx.postSrcTex = texA;        // tonemap wrote buffer A
         ctx.fsQuadVAO = quadVAO;
         return ctx;
     }
 
-    // Build the chain, set it up, and budget it the way the Renderer does.
-    static void budget(std::vector<std::unique_ptr<IRenderPass>>& chain,
-                       PassContext& ctx, const Scene& scene) {
+    // Declares the chain the way RenderPipeline::executeAll does, with buffer
+    // A standing in for tonemap's output, and returns the passes declared, in
+    // graph order. The graph is compiled and its targets made.
+    std::vector<IRenderPass*> declare(std::vector<std::unique_ptr<IRenderPass>>& chain,
+                                      PassContext& ctx, const Scene& scene) {
         for (auto& pass : chain) pass->setup(ctx);
-        ctx.postPassesLeft = expectedLdrCount(chain, ctx, scene);
+        graph.Reset();
+        ctx.graph = &graph;
+        ctx.res = PassContext::FrameResources{};
+        ctx.res.output = graph.Import("Output", screenFBO, screenTex);
+        ctx.res.ldr = graph.Import("Tonemap", fboA, texA);
+        std::vector<IRenderPass*> declared;
+        for (auto& pass : chain) {
+            if (!pass->enabled(ctx, scene)) continue;
+            RenderGraph::PassBuilder b = graph.AddPass(pass->name());
+            pass->declare(b, ctx, frameParams());
+            declared.push_back(pass.get());
+        }
+        graph.Present(ctx.res.ldr, ctx.res.output);
+        graph.Compile();
+        targets.Realize(graph);
+        return declared;
+    }
+
+    // Runs every pass of the chain, declared or not, the undeclared ones
+    // having to decline. Returns how many drew.
+    int runAll(std::vector<std::unique_ptr<IRenderPass>>& chain, PassContext& ctx,
+               Scene& scene, Camera& cam) {
+        int drew = 0;
+        for (auto& p : chain) if (p->execute(ctx, scene, cam, frameParams())) ++drew;
+        return drew;
     }
 
     // The GL state the pipeline hands every pass (Renderer::Setup's baseline).
@@ -206,6 +240,15 @@ std::vector<std::unique_ptr<IRenderPass>> makeLdrChain() {
     return v;
 }
 
+// The pipeline's full order: the fused pass first, then the effects it can
+// stand in for, then FXAA.
+std::vector<std::unique_ptr<IRenderPass>> makeFusableChain() {
+    std::vector<std::unique_ptr<IRenderPass>> v;
+    v.push_back(std::make_unique<PostUberPass>());
+    for (auto& p : makeLdrChain()) v.push_back(std::move(p));
+    return v;
+}
+
 void configure(Scene& s, bool outline, bool grade, bool vignette, bool fxaa) {
     auto& p = s.PostFX();
     p.outline.enabled = outline;
@@ -217,10 +260,10 @@ void configure(Scene& s, bool outline, bool grade, bool vignette, bool fxaa) {
 } // namespace
 
 // THE routing invariant, over all 16 on/off combinations: every enabled pass
-// consumes exactly one slot, every disabled pass consumes none, and the chain
-// ends with the budget exactly spent. A mismatch here is precisely the desync
-// that silently sends the final image to an off-screen buffer.
-TEST_F(PostChainTest, EveryPassConsumesOneSlotIffEnabled) {
+// is declared, survives Compile and draws; every disabled pass is not declared
+// and declines; and the last stage is the output. A mismatch here is
+// precisely what silently leaves the screen unwritten.
+TEST_F(PostChainTest, EveryPassDrawsIffEnabled) {
     for (int mask = 0; mask < 16; ++mask) {
         const bool outline  = (mask & 1) != 0;
         const bool grade    = (mask & 2) != 0;
@@ -232,34 +275,33 @@ TEST_F(PostChainTest, EveryPassConsumesOneSlotIffEnabled) {
         Camera cam;
         PassContext ctx = makeCtx();
         auto chain = makeLdrChain();
-        budget(chain, ctx, scene);
-        // Every shader compiles here and scene depth is present, so the budget
-        // must equal the number of effects switched on.
-        ASSERT_EQ(ctx.postPassesLeft, (int)outline + (int)grade + (int)vignette + (int)fxaa)
-            << "mask " << mask;
+        const auto declared = declare(chain, ctx, scene);
+        const int on = (int)outline + (int)grade + (int)vignette + (int)fxaa;
+        // Every shader compiles here and scene depth is present, so the chain
+        // must be exactly the effects switched on, none of them culled.
+        ASSERT_EQ((int)declared.size(), on) << "mask " << mask;
+        ASSERT_EQ((int)graph.Order().size(), on) << "mask " << mask;
+        EXPECT_LE(graph.Slots().size(), 2u) << "the chain folds into two targets";
+        if (on > 0) {
+            EXPECT_EQ(graph.Fbo(ctx.res.ldr), screenFBO)
+                << "the last stage is not the output (mask " << mask << ")";
+        }
 
         const bool wants[4] = { outline, grade, vignette, fxaa };
         const char* names[4] = { "Outline", "ColorGrade", "Vignette", "FXAA" };
 
         for (size_t i = 0; i < chain.size(); ++i) {
-            const int before = ctx.postPassesLeft;
-            chain[i]->execute(ctx, scene, cam, frameParams());
-            const int consumed = before - ctx.postPassesLeft;
-            EXPECT_EQ(consumed, wants[i] ? 1 : 0)
-                << names[i] << " consumed " << consumed << " chain slots while "
+            const bool drew = chain[i]->execute(ctx, scene, cam, frameParams());
+            EXPECT_EQ(drew, wants[i])
+                << names[i] << (drew ? " drew" : " declined") << " while "
                 << (wants[i] ? "ENABLED" : "DISABLED") << " (mask " << mask << ")"
-                << " — its predicate no longer agrees with countLdrPostPasses_, so the"
-                << " final image lands in an off-screen buffer";
+                << " — its enabled() no longer agrees with what execute() checks";
         }
-
-        EXPECT_EQ(ctx.postPassesLeft, 0)
-            << "chain budget not exactly spent for mask " << mask
-            << ": the last enabled pass did not resolve to defaultFBO";
     }
 }
 
 // With effects enabled the final pass must write to the screen FBO, not leave
-// the image sitting in a ping-pong buffer. Asserted by content: the screen
+// the image sitting in a transient target. Asserted by content: the screen
 // starts at a value no pass would coincidentally reproduce.
 TEST_F(PostChainTest, FinalPassLandsOnTheDefaultFBO) {
     Scene scene;
@@ -267,8 +309,8 @@ TEST_F(PostChainTest, FinalPassLandsOnTheDefaultFBO) {
     Camera cam;
     PassContext ctx = makeCtx();
     auto chain = makeLdrChain();
-    budget(chain, ctx, scene);
-    for (auto& p : chain) p->execute(ctx, scene, cam, frameParams());
+    declare(chain, ctx, scene);
+    EXPECT_EQ(runAll(chain, ctx, scene, cam), 4);
 
     std::vector<unsigned char> px(kSize * kSize * 4, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, screenFBO);
@@ -283,7 +325,7 @@ TEST_F(PostChainTest, FinalPassLandsOnTheDefaultFBO) {
         if (px[i] != 200) { wrote = true; break; }
     }
     EXPECT_TRUE(wrote) << "nothing reached defaultFBO — the chain wrote its final "
-                          "image into an off-screen ping-pong buffer";
+                          "image into an off-screen target";
 }
 
 // No pass may leave GL state changed: the pipeline has no inter-pass reset, so
@@ -297,7 +339,7 @@ TEST_F(PostChainTest, PassesRestoreGLState) {
         Camera cam;
         PassContext ctx = makeCtx();
         auto chain = makeLdrChain();
-        budget(chain, ctx, scene);
+        declare(chain, ctx, scene);
 
         setBaselineState();
         const GLState before = captureState();
@@ -314,18 +356,19 @@ TEST_F(PostChainTest, PassesRestoreGLState) {
     }
 }
 
-// A disabled pass must be a true no-op: it must not touch the chain budget
-// (covered above) and must not write to any target either.
+// A disabled pass must be a true no-op: it is not declared (covered above) and
+// must not write to any target either.
 TEST_F(PostChainTest, DisabledPassesLeaveTheImageUntouched) {
     Scene scene;
     configure(scene, false, false, false, false); // nothing enabled
     Camera cam;
     PassContext ctx = makeCtx();
     auto chain = makeLdrChain();
-    budget(chain, ctx, scene);
-    EXPECT_EQ(ctx.postPassesLeft, 0) << "no effects => no chain";
+    declare(chain, ctx, scene);
+    EXPECT_TRUE(graph.Order().empty()) << "no effects => no chain";
+    EXPECT_EQ(targets.Count(), 0) << "no effects => no targets";
 
-    for (auto& p : chain) p->execute(ctx, scene, cam, frameParams());
+    EXPECT_EQ(runAll(chain, ctx, scene, cam), 0);
 
     std::vector<unsigned char> px(kSize * kSize * 4, 0);
     glBindFramebuffer(GL_FRAMEBUFFER, screenFBO);
@@ -337,32 +380,32 @@ TEST_F(PostChainTest, DisabledPassesLeaveTheImageUntouched) {
 }
 
 // THE MISCOUNT. The outline needs the scene depth texture as well as the effect
-// switch, but the budget used to ask only about the switch. A frame with the
-// outline enabled and no depth texture was therefore budgeted for one more pass
-// than would run, nothing ever reached isFinal, and the finished image was left
-// in a ping-pong buffer -- a window showing the clear colour, with nothing
-// logged. The same shape occurs whenever a post shader fails to compile, which
-// is far more likely and just as invisible.
+// switch, but the chain budget of the ping-pong days asked only about the
+// switch. A frame with the outline enabled and no depth texture was therefore
+// budgeted for one more pass than would run, nothing ever reached the screen,
+// and the finished image was left off-screen -- a window showing the clear
+// colour, with nothing logged. The same shape occurs whenever a post shader
+// fails to compile, which is far more likely and just as invisible. The graph
+// has the same exposure through enabled(): a pass declared but declining
+// leaves its stage, and so the output, unwritten.
 //
 // It is asserted here through hdrDepthTex because that is the one arm of the
 // predicate a test can switch off without breaking the shader on disk.
-TEST_F(PostChainTest, OutlineWithoutSceneDepthIsNotCounted) {
+TEST_F(PostChainTest, OutlineWithoutSceneDepthIsNotDeclared) {
     Scene scene;
     configure(scene, /*outline*/true, /*grade*/false, /*vignette*/true, /*fxaa*/false);
     Camera cam;
     PassContext ctx = makeCtx(/*withSceneDepth*/false);
     auto chain = makeLdrChain();
-    budget(chain, ctx, scene);
-
-    ASSERT_EQ(ctx.postPassesLeft, 1)
-        << "the outline was budgeted a slot it cannot use: it has no scene depth "
-           "texture this frame, so it will decline, and the vignette after it will "
-           "never see itself as the final pass";
+    const auto declared = declare(chain, ctx, scene);
 
-    for (auto& pass : chain) pass->execute(ctx, scene, cam, frameParams());
+    ASSERT_EQ(declared.size(), 1u)
+        << "the outline was declared though it cannot draw: it has no scene depth "
+           "texture this frame, so it will decline, and the stage the vignette "
+           "reads will never be written";
+    EXPECT_EQ(expectedLdrCount(chain, ctx, scene), 1);
 
-    EXPECT_EQ(ctx.postPassesLeft, 0)
-        << "chain budget not exactly spent: " << ctx.postPassesLeft << " left over";
+    EXPECT_EQ(runAll(chain, ctx, scene, cam), 1);
 
     // And the consequence, in pixels: the vignette had to resolve to the screen.
     std::vector<unsigned char> px(kSize * kSize * 4, 0);
@@ -374,5 +417,123 @@ TEST_F(PostChainTest, OutlineWithoutSceneDepthIsNotCounted) {
     const size_t mid = ((size_t)(kSize / 2) * kSize + (kSize / 2)) * 4;
     EXPECT_LT(px[mid], 120)
         << "the screen still holds its seed value, so the last pass wrote into an "
-           "off-screen ping-pong buffer instead of the default FBO";
+           "off-screen target instead of the default FBO";
+}
+
+// THE FUSION INVARIANT. For every combination the fused pass takes (two or
+// three of outline, grade and vignette), one pass must paint what the chain
+// paints. The source is a colour ramp and the depth has a step, so every
+// effect has something to change; the settings are off neutral for the same
+// reason. The chain rounds to RGBA8 between stages and the fused pass does
+// not, so they may differ by that rounding, carried through the grade's gain
+// and contrast: a couple of steps, never more than three.
+TEST_F(PostChainTest, FusedPassMatchesTheChain) {
+    std::vector<unsigned char> ramp(kSize * kSize * 4);
+    std::vector<float> depth(kSize * kSize);
+    for (int y = 0; y < kSize; ++y) {
+        for (int x = 0; x < kSize; ++x) {
+            unsigned char* px = &ramp[(size_t(y) * kSize + x) * 4];
+            px[0] = (unsigned char)(x * 255 / (kSize - 1));
+            px[1] = (unsigned char)(y * 255 / (kSize - 1));
+            px[2] = (unsigned char)(128 + (x - y) * 2);
+            px[3] = 255;
+            depth[size_t(y) * kSize + x] = (x >= kSize / 3 && x < 2 * kSize / 3) ? 0.5f : 0.98f;
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, texA);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, ramp.data());
+    glBindTexture(GL_TEXTURE_2D, depthTex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, kSize, kSize, GL_DEPTH_COMPONENT, GL_FLOAT, depth.data());
+
+    auto render = [&](Scene& scene, std::vector<std::string>& order) {
+        Camera cam;
+        PassContext ctx = makeCtx();
+        auto chain = makeFusableChain();
+        declare(chain, ctx, scene);
+        order.clear();
+        for (int i : graph.Order()) order.emplace_back(graph.PassName(i));
+        runAll(chain, ctx, scene, cam);
+        std::vector<unsigned char> px(kSize * kSize * 4, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, screenFBO);
+        glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return px;
+    };
+
+    for (int mask : { 3, 5, 6, 7 }) {
+        const bool outline = (mask & 1) != 0, grade = (mask & 2) != 0, vignette = (mask & 4) != 0;
+        Scene scene;
+        configure(scene, outline, grade, vignette, /*fxaa*/false);
+        auto& p = scene.PostFX();
+        p.colorGrade.contrast = 1.2f;
+        p.colorGrade.saturation = 0.8f;
+        p.colorGrade.temperature = 0.3f;
+        p.colorGrade.lift = 0.05f;
+        p.colorGrade.gain = 1.1f;
+        p.vignette.intensity = 0.6f;
+
+        std::vector<std::string> chainOrder, fusedOrder;
+        p.fused = false;
+        const auto reference = render(scene, chainOrder);
+        p.fused = true;
+        const auto fused = render(scene, fusedOrder);
+
+        ASSERT_EQ((int)chainOrder.size(), (int)outline + (int)grade + (int)vignette) << "mask " << mask;
+        ASSERT_EQ(fusedOrder, std::vector<std::string>{ "PostUber" })
+            << "mask " << mask << ": the effects the fused pass applied ran again";
+
+        int worst = 0;
+        for (size_t i = 0; i < reference.size(); ++i) {
+            if (i % 4 == 3) continue;
+            worst = std::max(worst, std::abs(int(reference[i]) - int(fused[i])));
+        }
+        EXPECT_LE(worst, 3) << "mask " << mask << ": the fused shader no longer paints "
+                               "what the chain does (worst channel off by " << worst << ")";
+    }
+}
+
+// FXAA reads its neighbours and cannot be fused: it runs after the fused
+// pass, and still resolves to the output. One effect alone is left to its own
+// pass, there being nothing to save.
+TEST_F(PostChainTest, FusionLeavesFXAAAndLoneEffectsAlone) {
+    PassContext ctx = makeCtx();
+    auto orderOf = [&](Scene& scene) {
+        ctx = makeCtx();
+        auto chain = makeFusableChain();
+        declare(chain, ctx, scene);
+        std::vector<std::string> order;
+        for (int i : graph.Order()) order.emplace_back(graph.PassName(i));
+        return order;
+    };
+
+    Scene all;
+    configure(all, true, true, true, true);
+    EXPECT_EQ(orderOf(all), (std::vector<std::string>{ "PostUber", "FXAA" }));
+    EXPECT_EQ(graph.Fbo(ctx.res.ldr), screenFBO) << "FXAA's stage is the output";
+    EXPECT_EQ(graph.Slots().size(), 1u) << "one intermediate target, where the chain needs two";
+
+    Scene lone;
+    configure(lone, false, false, true, true);
+    EXPECT_EQ(orderOf(lone), (std::vector<std::string>{ "Vignette", "FXAA" }));
+
+    Scene noDepth; // the outline cannot join without scene depth either way
+    configure(noDepth, true, true, false, false);
+    EXPECT_EQ(PostUberPass::FusedEffects(makeCtx(/*withSceneDepth*/false), noDepth), 0u);
+}
+
+// Each combination compiles once and is kept.
+TEST_F(PostChainTest, FusedPermutationsAreCompiledOnce) {
+    PostUberPass pass;
+    PassContext ctx = makeCtx();
+    Scene scene;
+    configure(scene, true, true, false, false);
+    EXPECT_TRUE(pass.enabled(ctx, scene));
+    EXPECT_TRUE(pass.enabled(ctx, scene));
+    EXPECT_EQ(pass.CompiledPermutations(), 1);
+    configure(scene, true, true, true, false);
+    EXPECT_TRUE(pass.enabled(ctx, scene));
+    EXPECT_EQ(pass.CompiledPermutations(), 2);
+    configure(scene, false, false, true, false);
+    EXPECT_FALSE(pass.enabled(ctx, scene)) << "one effect is not fused";
+    EXPECT_EQ(pass.CompiledPermutations(), 2);
 }
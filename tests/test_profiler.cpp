@@ -0,0 +1,136 @@
+// CPU profiler: zones, per-thread rings, Chrome-trace export. Pure CPU.
+// The profiler is process-global, so every test clears it first and looks
+// only for zone names it recorded itself.
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Engine.h"
+
+using MyCoreEngine::Profiler;
+using MyCoreEngine::ProfileEvent;
+
+namespace {
+    std::vector<ProfileEvent> named(const char* name) {
+        std::vector<ProfileEvent> out;
+        for (const auto& e : Profiler::Snapshot()) {
+            if (e.name && std::string(e.name) == name) out.push_back(e);
+        }
+        return out;
+    }
+
+    struct ProfilerTest : ::testing::Test {
+        void SetUp() override {
+            if (!Profiler::kCompiledIn) GTEST_SKIP() << "profiler compiled out";
+            Profiler::SetEnabled(true);
+            Profiler::Clear();
+        }
+        void TearDown() override { Profiler::SetEnabled(true); }
+    };
+}
+
+TEST_F(ProfilerTest, NestedZonesRecordDepthAndContainEachOther) {
+    {
+        CSE_PROFILE_ZONE("test.outer");
+        {
+            CSE_PROFILE_ZONE("test.inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    const auto outer = named("test.outer");
+    const auto inner = named("test.inner");
+    ASSERT_EQ(outer.size(), 1u);
+    ASSERT_EQ(inner.size(), 1u);
+    EXPECT_EQ(inner[0].depth, outer[0].depth + 1) << "the inner zone was not recorded one level down";
+    EXPECT_LE(outer[0].startNs, inner[0].startNs);
+    EXPECT_GE(outer[0].endNs, inner[0].endNs)
+        << "the outer zone ended before the zone it contains -- the trace would show them side by side";
+    EXPECT_GT(inner[0].endNs - inner[0].startNs, 500000u) << "a 1ms sleep measured under 0.5ms";
+}
+
+TEST_F(ProfilerTest, AJobSystemWorkerRecordsOnItsOwnNamedLane) {
+    {
+        CSE_PROFILE_ZONE("test.main");
+    }
+    {
+        MyCoreEngine::JobSystem jobs(1);
+        jobs.submit([] { CSE_PROFILE_ZONE("test.onWorker"); });
+        jobs.waitIdle();
+    }
+    const auto onMain = named("test.main");
+    const auto onWorker = named("test.onWorker");
+    ASSERT_EQ(onMain.size(), 1u);
+    ASSERT_EQ(onWorker.size(), 1u)
+        << "a zone from a worker that has since exited was lost -- retired rings must stay exportable";
+    EXPECT_NE(onMain[0].threadId, onWorker[0].threadId);
+
+    const auto trace = nlohmann::json::parse(Profiler::ChromeTraceJson());
+    bool laneNamed = false;
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["ph"] == "M" && e["tid"] == onWorker[0].threadId &&
+            e["args"]["name"] == "JobSystem worker") laneNamed = true;
+    }
+    EXPECT_TRUE(laneNamed) << "the worker's lane is unnamed in the exported trace";
+}
+
+TEST_F(ProfilerTest, TheRingOverwritesInsteadOfGrowing) {
+    // on a fresh thread, so the count is exactly this ring's
+    std::thread([] {
+        for (std::size_t i = 0; i < Profiler::kRingEvents + 500; ++i) {
+            CSE_PROFILE_ZONE("test.flood");
+        }
+    }).join();
+    EXPECT_EQ(named("test.flood").size(), Profiler::kRingEvents)
+        << "an always-on recorder must keep the LAST kRingEvents zones, no more";
+}
+
+TEST_F(ProfilerTest, ExportIsChromeTraceJson) {
+    {
+        CSE_PROFILE_ZONE("test.\"quoted\"\\name");
+    }
+    const std::string text = Profiler::ChromeTraceJson();
+    nlohmann::json trace;
+    ASSERT_NO_THROW(trace = nlohmann::json::parse(text)) << text.substr(0, 400);
+    ASSERT_TRUE(trace.contains("traceEvents"));
+
+    bool found = false;
+    for (const auto& e : trace["traceEvents"]) {
+        if (e["ph"] != "X") continue;
+        ASSERT_TRUE(e.contains("ts") && e.contains("dur") && e.contains("tid")) << e.dump();
+        EXPECT_GE(e["dur"].get<double>(), 0.0);
+        if (e["name"] == "test.\"quoted\"\\name") found = true;
+    }
+    EXPECT_TRUE(found) << "a zone name with quotes and a backslash did not survive escaping";
+}
+
+TEST_F(ProfilerTest, DisabledRecordsNothingAndLeavesDepthAlone) {
+    Profiler::SetEnabled(false);
+    {
+        CSE_PROFILE_ZONE("test.whileOff");
+    }
+    Profiler::SetEnabled(true);
+    {
+        CSE_PROFILE_ZONE("test.afterOn");
+    }
+    EXPECT_TRUE(named("test.whileOff").empty()) << "a zone recorded while the profiler was off";
+    const auto after = named("test.afterOn");
+    ASSERT_EQ(after.size(), 1u);
+    EXPECT_EQ(after[0].depth, 0u) << "an unrecorded zone still moved the thread's depth";
+}
+
+TEST_F(ProfilerTest, ClearDropsHistoryButKeepsRecording) {
+    {
+        CSE_PROFILE_ZONE("test.beforeClear");
+    }
+    Profiler::Clear();
+    {
+        CSE_PROFILE_ZONE("test.afterClear");
+    }
+    EXPECT_TRUE(named("test.beforeClear").empty());
+    EXPECT_EQ(named("test.afterClear").size(), 1u);
+}
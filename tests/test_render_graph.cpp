@@ -0,0 +1,168 @@
+// Render graph: culling, order and transient aliasing. Headless — RenderGraph
+// is plain bookkeeping over declared reads and writes; the GL side
+// (TransientTargets, the passes drawing into them) is exercised by the post
+// chain tests.
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "Engine.h"
+
+namespace {
+
+const TargetDesc kFull{ 64, 32, TargetDesc::Format::RGBA8 };
+const TargetDesc kHalfHdr{ 32, 16, TargetDesc::Format::RGBA16F };
+
+std::vector<std::string> orderNames(const RenderGraph& g) {
+    std::vector<std::string> out;
+    for (int i : g.Order()) out.emplace_back(g.PassName(i));
+    return out;
+}
+
+// tonemap, then one post stage per name, each reading the one before, the
+// last presented as the output -- what RenderPipeline declares
+struct Chain {
+    RenderGraph g;
+    RenderGraph::Resource output = RenderGraph::kNone, hdr = RenderGraph::kNone;
+    std::vector<RenderGraph::Resource> stages; // tonemap's target first
+
+    explicit Chain(std::vector<const char*> names) {
+        output = g.Import("Output", 7, 0);
+        hdr = g.Import("HDR", 3, 4);
+        auto tm = g.AddPass("Tonemap");
+        tm.Read(hdr);
+        stages.push_back(tm.Create("Tonemap", kFull));
+        for (const char* n : names) {
+            auto b = g.AddPass(n);
+            b.Read(stages.back());
+            stages.push_back(b.Create(n, kFull));
+        }
+        g.Present(stages.back(), output);
+        g.Compile();
+    }
+};
+
+} // namespace
+
+TEST(RenderGraph, PostChainFoldsIntoTwoTargets) {
+    Chain c({ "Outline", "ColorGrade", "Vignette", "FXAA" });
+    EXPECT_EQ(orderNames(c.g), (std::vector<std::string>{ "Tonemap", "Outline", "ColorGrade", "Vignette", "FXAA" }));
+    ASSERT_EQ(c.g.Slots().size(), 2u) << "four intermediate stages, never more than two alive";
+    EXPECT_EQ(c.g.SlotOf(c.stages[0]), 0);
+    EXPECT_EQ(c.g.SlotOf(c.stages[1]), 1) << "read and written by one pass: never one slot";
+    EXPECT_EQ(c.g.SlotOf(c.stages[2]), 0);
+    EXPECT_EQ(c.g.SlotOf(c.stages[3]), 1);
+    EXPECT_EQ(c.g.SlotOf(c.stages[4]), -1) << "presented";
+    EXPECT_EQ(c.g.Fbo(c.stages[4]), 7u) << "the last stage draws into the output";
+}
+
+TEST(RenderGraph, OneStageNeedsOneTarget) {
+    Chain c({ "FXAA" });
+    EXPECT_EQ(c.g.Slots().size(), 1u) << "the old ping-pong pair always made two";
+    EXPECT_EQ(c.g.Fbo(c.stages[1]), 7u);
+}
+
+TEST(RenderGraph, NoPostStageTonemapsIntoTheOutput) {
+    Chain c({});
+    EXPECT_TRUE(c.g.Slots().empty());
+    EXPECT_EQ(c.g.Fbo(c.stages[0]), 7u);
+    EXPECT_EQ(c.g.Texture(c.hdr), 4u);
+}
+
+TEST(RenderGraph, LifetimesSpanFirstToLastUse) {
+    Chain c({ "Outline", "FXAA" });
+    EXPECT_EQ(c.g.FirstUse(c.stages[0]), 0);
+    EXPECT_EQ(c.g.LastUse(c.stages[0]), 1);
+    EXPECT_EQ(c.g.FirstUse(c.stages[1]), 1);
+    EXPECT_EQ(c.g.LastUse(c.stages[1]), 2);
+}
+
+TEST(RenderGraph, PassesNobodyReadsAreCulled) {
+    RenderGraph g;
+    const auto output = g.Import("Output", 0, 0);
+    auto a = g.AddPass("Producer");
+    const auto t = a.Create("T", kFull);
+    auto dead = g.AddPass("Dead");
+    dead.Read(t);
+    dead.Create("Unread", kFull);
+    auto sink = g.AddPass("Sink");
+    sink.Read(t);
+    sink.Write(output);
+    g.Compile();
+
+    EXPECT_EQ(orderNames(g), (std::vector<std::string>{ "Producer", "Sink" }));
+    EXPECT_TRUE(g.Culled(1));
+    EXPECT_EQ(g.Slots().size(), 1u) << "a culled pass's target is never made";
+}
+
+TEST(RenderGraph, CullingFollowsTheChainBack) {
+    RenderGraph g;
+    g.Import("Output", 0, 0);
+    auto a = g.AddPass("A");
+    const auto t = a.Create("T", kFull);
+    auto b = g.AddPass("B");
+    b.Read(t);
+    b.Create("U", kFull); // nobody reads U, so B goes, and with it A
+    g.Compile();
+    EXPECT_TRUE(g.Order().empty());
+    EXPECT_TRUE(g.Slots().empty());
+}
+
+TEST(RenderGraph, ImportedWritersAlwaysRun) {
+    RenderGraph g;
+    const auto shadows = g.Import("ShadowMaps", 0, 0);
+    const auto hdr = g.Import("HDR", 1, 2);
+    g.AddPass("Shadows").Write(shadows);
+    auto fwd = g.AddPass("Forward");
+    fwd.Read(shadows);
+    fwd.Write(hdr);
+    g.Compile();
+    EXPECT_EQ(orderNames(g), (std::vector<std::string>{ "Shadows", "Forward" }));
+    EXPECT_EQ(g.SlotOf(hdr), -1);
+}
+
+// A pass's scratch pair lives inside it: the two overlap each other but not
+// the post chain, and RGBA16F never shares with RGBA8.
+TEST(RenderGraph, SlotsShareOnlyAMatchingDesc) {
+    RenderGraph g;
+    const auto output = g.Import("Output", 0, 0);
+    const auto hdr = g.Import("HDR", 1, 2);
+    auto bloom = g.AddPass("Bloom");
+    bloom.Read(hdr);
+    const auto a = bloom.Create("Bloom.A", kHalfHdr);
+    const auto b = bloom.Create("Bloom.B", kHalfHdr);
+    bloom.Write(hdr);
+    auto tm = g.AddPass("Tonemap");
+    tm.Read(hdr);
+    const auto ldr = tm.Create("Tonemap", kFull);
+    auto fx = g.AddPass("FXAA");
+    fx.Read(ldr);
+    const auto out = fx.Create("FXAA", kFull);
+    g.Present(out, output);
+    g.Compile();
+
+    ASSERT_EQ(g.Slots().size(), 3u);
+    EXPECT_NE(g.SlotOf(a), g.SlotOf(b));
+    EXPECT_EQ(g.Slots()[size_t(g.SlotOf(a))], kHalfHdr);
+    EXPECT_EQ(g.Slots()[size_t(g.SlotOf(ldr))], kFull);
+}
+
+TEST(RenderGraph, ResolvesToBoundSlots) {
+    Chain c({ "Vignette", "FXAA" });
+    c.g.BindSlot(0, 11, 21);
+    c.g.BindSlot(1, 12, 22);
+    EXPECT_EQ(c.g.Fbo(c.stages[0]), 11u);
+    EXPECT_EQ(c.g.Texture(c.stages[0]), 21u);
+    EXPECT_EQ(c.g.Texture(c.stages[1]), 22u);
+    EXPECT_EQ(c.g.Fbo(RenderGraph::kNone), 0u);
+}
+
+TEST(RenderGraph, ResetStartsAnEmptyFrame) {
+    Chain c({ "FXAA" });
+    c.g.Reset();
+    c.g.Compile();
+    EXPECT_EQ(c.g.PassCount(), 0);
+    EXPECT_TRUE(c.g.Order().empty());
+    EXPECT_TRUE(c.g.Slots().empty());
+}
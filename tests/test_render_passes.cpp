@@ -862,3 +862,46 @@ TEST_F(GLFixture, ForceUpdateRebuildsEveryCascadeEvenWithNothingMoving) {
         << " of 4 cascades with the camera still -- a scene swap would keep "
            "rendering the departed scene\'s shadows";
 }
+
+// A program linked once loads from ShaderCache the second time instead of
+// compiling, and the loaded program draws the same as the compiled one.
+TEST_F(GLFixture, ShaderCache_SecondBuildLoadsTheBinary) {
+    if (!GetGLCaps().programBinary) {
+        GTEST_SKIP() << "needs GL 4.1 or ARB_get_program_binary with a binary format";
+    }
+    ShaderCache::Clear();
+    ShaderCache::ResetStats();
+    const std::string_view defines = "#define SHADER_CACHE_TEST\n"; // a key no other test shares
+
+    Shader compiled("Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/tonemap_frag.glsl", defines);
+    ASSERT_TRUE(compiled.isValid());
+    ASSERT_EQ(ShaderCache::GetStats().misses, 1u);
+    ASSERT_EQ(ShaderCache::GetStats().stored, 1u);
+
+    Shader loaded("Exported/Shaders/tonemap_vert.glsl", "Exported/Shaders/tonemap_frag.glsl", defines);
+    ASSERT_TRUE(loaded.isValid());
+    EXPECT_EQ(ShaderCache::GetStats().hits, 1u);
+    EXPECT_EQ(ShaderCache::GetStats().misses, 1u) << "the second build compiled again";
+
+    auto draw = [](Shader& s) {
+        PassContext ctx{}; GLFixture::makeHDR(ctx, 64, 64);
+        ctx.tonemapShader = &s;
+        ctx.exposure = 1.0f;
+        glBindFramebuffer(GL_FRAMEBUFFER, ctx.hdrFBO);
+        glViewport(0, 0, 64, 64);
+        glDisable(GL_DEPTH_TEST);
+        glClearColor(2.0f, 1.5f, 0.5f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        TonemapPass pass;
+        pass.setup(ctx);
+        NullScene scene;
+        Camera cam;
+        FrameParams fp{}; fp.viewportW = 64; fp.viewportH = 64;
+        EXPECT_TRUE(pass.execute(ctx, scene, cam, fp));
+        std::array<uint8_t, 4> px{ 0,0,0,0 };
+        glReadPixels(0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, px.data());
+        return px;
+    };
+    EXPECT_EQ(draw(compiled), draw(loaded));
+    ShaderCache::Clear();
+}
@@ -1225,6 +1225,8 @@ TEST(SceneSerializer, AbsentSettingsResetToDefaultsNotThePreviousScene) {
     s.SetQualityLevel(Scene::QualityLevel::Low);
     s.SetAAEnabled(false);
     s.SetSmallCullEnabled(true);
+    s.SetClusteredLightsEnabled(false);
+    s.SetMultiDrawEnabled(false);
     EnvironmentSettings env;
     env.hdriPath = "Exported/Env/somebody_elses_sky.hdr";
     s.SetEnvironment(env);
@@ -1238,6 +1240,8 @@ TEST(SceneSerializer, AbsentSettingsResetToDefaultsNotThePreviousScene) {
     EXPECT_EQ(s.GetQualityLevel(), Scene::QualityLevel::Custom);
     EXPECT_TRUE(s.GetAAEnabled());
     EXPECT_FALSE(s.GetSmallCullEnabled());
+    EXPECT_TRUE(s.GetClusteredLightsEnabled());
+    EXPECT_TRUE(s.GetMultiDrawEnabled());
     EXPECT_EQ(s.Environment().hdriPath, EnvironmentSettings{}.hdriPath)
         << "the previous scene's HDRi survived into a file that never named one";
 
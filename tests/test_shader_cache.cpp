@@ -0,0 +1,86 @@
+// Shader cache: the keys programs are found by and the file a linked binary
+// persists as. Headless — the driver side (glGetProgramBinary/glProgramBinary)
+// needs a context and a driver that offers a binary format, and is exercised
+// by the render pass tests where it has one.
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+TEST(ShaderCache, KeyFollowsEitherStage) {
+    const uint64_t k = ShaderCache::Key("#version 330 core\nvoid main(){}", "frag");
+    EXPECT_EQ(k, ShaderCache::Key("#version 330 core\nvoid main(){}", "frag"));
+    EXPECT_NE(k, ShaderCache::Key("#version 330 core\nvoid main(){ }", "frag"));
+    EXPECT_NE(k, ShaderCache::Key("#version 330 core\nvoid main(){}", "frag2"));
+}
+
+TEST(ShaderCache, EachPermutationIsItsOwnKey) {
+    const char* v = "#version 330 core\n";
+    EXPECT_NE(ShaderCache::Key(v, "#version 330 core\n#define POST_GRADE\n"),
+              ShaderCache::Key(v, "#version 330 core\n#define POST_VIGNETTE\n"));
+}
+
+TEST(ShaderCache, KeyKeepsTheStagesApart) {
+    // the same bytes split differently between the stages is another program
+    EXPECT_NE(ShaderCache::Key("ab", "c"), ShaderCache::Key("a", "bc"));
+    EXPECT_NE(ShaderCache::Key("abc", ""), ShaderCache::Key("", "abc"));
+}
+
+TEST(ShaderCache, DriverKeyFollowsEveryString) {
+    const uint64_t d = ShaderCache::DriverKey("Vendor", "GPU", "4.6 123.45");
+    EXPECT_EQ(d, ShaderCache::DriverKey("Vendor", "GPU", "4.6 123.45"));
+    EXPECT_NE(d, ShaderCache::DriverKey("Vendor", "GPU", "4.6 123.46")) << "a driver update";
+    EXPECT_NE(d, ShaderCache::DriverKey("Vendor", "GPU2", "4.6 123.45")) << "another card";
+    EXPECT_NE(d, ShaderCache::DriverKey("Other", "GPU", "4.6 123.45"));
+}
+
+TEST(ShaderCache, FileNameIsTheKeyInHex) {
+    EXPECT_EQ(ShaderCache::FileName(0x0123456789abcdefull), "0123456789abcdef.bin");
+    EXPECT_EQ(ShaderCache::FileName(0x2aull), "000000000000002a.bin");
+}
+
+TEST(ShaderCache, FileRoundTrips) {
+    const std::vector<uint8_t> binary{ 1, 2, 3, 250, 0, 7 };
+    const uint64_t driver = ShaderCache::DriverKey("V", "R", "1");
+    const std::vector<uint8_t> file = ShaderCache::Encode(driver, 0x1234u, binary);
+
+    uint32_t format = 0;
+    std::vector<uint8_t> out;
+    ASSERT_TRUE(ShaderCache::Decode(file, driver, format, out));
+    EXPECT_EQ(format, 0x1234u);
+    EXPECT_EQ(out, binary);
+}
+
+TEST(ShaderCache, AnotherDriversFileIsRefused) {
+    const std::vector<uint8_t> file =
+        ShaderCache::Encode(ShaderCache::DriverKey("V", "R", "1"), 1u, { 1, 2, 3 });
+    uint32_t format = 0;
+    std::vector<uint8_t> out;
+    EXPECT_FALSE(ShaderCache::Decode(file, ShaderCache::DriverKey("V", "R", "2"), format, out));
+    EXPECT_TRUE(out.empty());
+}
+
+TEST(ShaderCache, DamagedFilesAreRefused) {
+    const uint64_t driver = ShaderCache::DriverKey("V", "R", "1");
+    const std::vector<uint8_t> file = ShaderCache::Encode(driver, 1u, { 1, 2, 3, 4 });
+    uint32_t format = 0;
+    std::vector<uint8_t> out;
+
+    std::vector<uint8_t> cut(file.begin(), file.end() - 1);
+    EXPECT_FALSE(ShaderCache::Decode(cut, driver, format, out)) << "truncated payload";
+    std::vector<uint8_t> header(file.begin(), file.begin() + 10);
+    EXPECT_FALSE(ShaderCache::Decode(header, driver, format, out)) << "truncated header";
+    std::vector<uint8_t> longer = file;
+    longer.push_back(0);
+    EXPECT_FALSE(ShaderCache::Decode(longer, driver, format, out)) << "trailing bytes";
+    std::vector<uint8_t> magic = file;
+    magic[0] ^= 0xff;
+    EXPECT_FALSE(ShaderCache::Decode(magic, driver, format, out)) << "not a cache file";
+    EXPECT_FALSE(ShaderCache::Decode({}, driver, format, out));
+    EXPECT_FALSE(ShaderCache::Decode(ShaderCache::Encode(driver, 1u, {}), driver, format, out))
+        << "an empty binary never loads";
+}
@@ -0,0 +1,63 @@
+// Streaming buffers: the segment bookkeeping behind StreamBuffer. Headless —
+// StreamRing is plain offsets; the GL side (mapping, fences) is exercised by
+// the scene and 2D renderer tests.
+#include <gtest/gtest.h>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+TEST(StreamRing, BumpsThroughTheSegmentAtEachAlignment) {
+    StreamRing r;
+    r.Reset(256);
+    EXPECT_EQ(r.Allocate(10, 4), 0u);
+    EXPECT_EQ(r.Allocate(64, 16), 16u) << "rounded up to the alignment";
+    EXPECT_EQ(r.Allocate(32, 32), 96u) << "a vertex stride need not be a power of two";
+    EXPECT_EQ(r.Used(), 128u);
+    EXPECT_EQ(r.Allocate(72, 72), 144u);
+    EXPECT_EQ(r.Allocate(0, 4), StreamRing::kNone);
+}
+
+TEST(StreamRing, SpillIsReportedNotWrapped) {
+    StreamRing r;
+    r.Reset(100);
+    EXPECT_EQ(r.Allocate(60, 1), 0u);
+    EXPECT_EQ(r.Allocate(50, 1), StreamRing::kNone) << "past the segment: the caller decides";
+    EXPECT_EQ(r.Used(), 60u) << "a failed allocation takes nothing";
+    EXPECT_EQ(r.Allocate(40, 1), 60u) << "exactly the rest still fits";
+    EXPECT_EQ(r.Allocate(1, 1), StreamRing::kNone);
+    EXPECT_EQ(r.Allocate(200, 1), StreamRing::kNone);
+}
+
+TEST(StreamRing, AdvanceCyclesTheSegments) {
+    StreamRing r;
+    r.Reset(128);
+    for (int frame = 0; frame < 2 * StreamRing::kSegments; ++frame) {
+        const int segment = frame % StreamRing::kSegments;
+        EXPECT_EQ(r.Segment(), segment);
+        EXPECT_EQ(r.Allocate(16, 16), std::size_t(segment) * 128) << "frame " << frame;
+        EXPECT_EQ(r.Advance(), segment) << "closes the segment it wrote";
+    }
+    EXPECT_EQ(r.Capacity(), 128u * StreamRing::kSegments);
+}
+
+TEST(StreamRing, AnIdleFrameKeepsItsSegment) {
+    StreamRing r;
+    r.Reset(64);
+    EXPECT_EQ(r.Advance(), -1) << "nothing written: nothing to fence";
+    EXPECT_EQ(r.Segment(), 0);
+    r.Allocate(8, 8);
+    EXPECT_EQ(r.Advance(), 0);
+    EXPECT_EQ(r.Segment(), 1);
+    EXPECT_EQ(r.Used(), 0u);
+}
+
+TEST(StreamRing, GrowToFitsTheFrameAndAtLeastDoubles) {
+    StreamRing r;
+    r.Reset(100);
+    r.Allocate(90, 1);
+    EXPECT_EQ(r.GrowTo(20, 1), 200u);
+    EXPECT_EQ(r.GrowTo(500, 16), 800u) << "90 used + 500 + alignment slack";
+    r.Reset(r.GrowTo(500, 16));
+    EXPECT_NE(r.Allocate(500, 16), StreamRing::kNone);
+}
@@ -0,0 +1,102 @@
+// Albedo texture arrays: the layer bookkeeping behind TextureArrays.
+// Headless — TextureLayerTable is plain ids and sizes; the GL copies are
+// exercised by the scene tests.
+#include <gtest/gtest.h>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+TEST(TextureLayerTable, FirstOfAClassWaitsForASecond) {
+    TextureLayerTable t;
+    const auto a = t.Add(10, 512, 512, true);
+    EXPECT_FALSE(a.copy) << "a lone texture gains nothing from an array";
+    EXPECT_EQ(a.slot.cls, -1);
+    EXPECT_EQ(t.Find(10).cls, -1);
+
+    const auto b = t.Add(11, 512, 512, true);
+    EXPECT_TRUE(b.created);
+    EXPECT_FALSE(b.grew);
+    EXPECT_EQ(b.promoted, 10u) << "the waiting texture moves in with the second";
+    EXPECT_TRUE(b.copy);
+    EXPECT_EQ(b.slot.layer, 1);
+    EXPECT_EQ(b.capacity, TextureLayerTable::kInitialLayers);
+    EXPECT_EQ(t.Find(10).layer, 0);
+    EXPECT_EQ(t.Find(10).cls, b.slot.cls);
+    EXPECT_EQ(t.Classes()[b.slot.cls].waiting, 0u);
+}
+
+TEST(TextureLayerTable, SizeAndColourSpaceSplitClasses) {
+    TextureLayerTable t;
+    t.Add(1, 256, 256, true);
+    t.Add(2, 256, 256, true);
+    t.Add(3, 256, 256, false); // linear: a different array
+    t.Add(4, 256, 128, true);  // different size
+    t.Add(5, 256, 128, true);
+    EXPECT_EQ(t.Classes().size(), 3u);
+    EXPECT_EQ(t.Find(1).cls, t.Find(2).cls);
+    EXPECT_EQ(t.Find(3).cls, -1) << "alone in its class";
+    EXPECT_NE(t.Find(4).cls, -1);
+    EXPECT_NE(t.Find(4).cls, t.Find(1).cls);
+}
+
+TEST(TextureLayerTable, GrowsByDoublingAndKeepsLayers) {
+    TextureLayerTable t;
+    for (unsigned id = 1; id <= 4; ++id) t.Add(id, 64, 64, false);
+    const auto fifth = t.Add(5, 64, 64, false);
+    EXPECT_TRUE(fifth.grew);
+    EXPECT_FALSE(fifth.created);
+    EXPECT_EQ(fifth.capacity, 2 * TextureLayerTable::kInitialLayers);
+    EXPECT_EQ(fifth.slot.layer, 4);
+    for (unsigned id = 1; id <= 4; ++id) EXPECT_EQ(t.Find(id).layer, int(id - 1)) << "texture " << id;
+}
+
+TEST(TextureLayerTable, RepeatAddsCopyNothing) {
+    TextureLayerTable t;
+    t.Add(1, 32, 32, true);
+    t.Add(2, 32, 32, true);
+    const auto again = t.Add(2, 32, 32, true);
+    EXPECT_FALSE(again.copy);
+    EXPECT_FALSE(again.created);
+    EXPECT_EQ(again.slot.layer, 1);
+    EXPECT_EQ(t.Classes()[again.slot.cls].layers, 2);
+
+    const auto waiting = t.Add(7, 16, 16, true);
+    EXPECT_FALSE(t.Add(7, 16, 16, true).copy);
+    EXPECT_EQ(waiting.slot.cls, -1);
+    EXPECT_EQ(t.Classes().back().waiting, 7u) << "re-adding the waiting texture must not pair it with itself";
+}
+
+TEST(TextureLayerTable, AFullClassLeavesTexturesOnTheirOwn) {
+    TextureLayerTable t(6);
+    for (unsigned id = 1; id <= 6; ++id) t.Add(id, 8, 8, false);
+    EXPECT_EQ(t.Classes()[0].capacity, 6) << "growth stops at the layer limit";
+    const auto seventh = t.Add(7, 8, 8, false);
+    EXPECT_FALSE(seventh.copy);
+    EXPECT_EQ(seventh.slot.cls, -1);
+    EXPECT_EQ(t.Find(7).cls, -1);
+    EXPECT_EQ(t.Find(6).layer, 5);
+}
+
+TEST(TextureLayerTable, RemovedLayersAreReused) {
+    TextureLayerTable t;
+    for (unsigned id = 1; id <= 3; ++id) t.Add(id, 16, 16, false);
+    const int cls = t.Find(2).cls;
+    t.Remove(2);
+    EXPECT_EQ(t.Find(2).cls, -1) << "a deleted texture's name must not keep its layer";
+    EXPECT_EQ(t.Classes()[cls].layers, 2);
+
+    // GL hands the name out again: the new texture is copied, into the freed layer
+    const auto reused = t.Add(2, 16, 16, false);
+    EXPECT_TRUE(reused.copy);
+    EXPECT_FALSE(reused.grew);
+    EXPECT_EQ(reused.slot.layer, 1);
+    EXPECT_EQ(t.Classes()[cls].layers, 3);
+    EXPECT_EQ(t.Find(1).layer, 0);
+    EXPECT_EQ(t.Find(3).layer, 2);
+
+    t.Add(9, 8, 8, true);
+    t.Remove(9);
+    EXPECT_EQ(t.Classes().back().waiting, 0u) << "a removed texture cannot be promoted";
+    t.Remove(42); // never added: nothing to do
+}
@@ -2,10 +2,11 @@
 //
 // The contract worth pinning is what makes it NOT a post-process:
 //  - it must draw into ctx.defaultFBO (the final image), and
-//  - it must NEVER consume an LDR ping-pong slot. If it ever did, the real
-//    final image would be routed into an off-screen buffer and the screen would
-//    show a stale frame — the silent-black-screen failure test_post_chain
-//    exists to catch, reached from a different direction.
+//  - it must NEVER declare a post chain stage. If it ever did, the pipeline
+//    would present the UI's stage as the output, the real final image would be
+//    left in an off-screen target and the screen would show a stale frame —
+//    the silent-black-screen failure test_post_chain exists to catch, reached
+//    from a different direction.
 #include <gtest/gtest.h>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -86,7 +87,7 @@ GLFWwindow* UIPassTest::win = nullptr;
 
 } // namespace
 
-TEST_F(UIPassTest, DrawsOntoTheDefaultFBOAndNeverConsumesAChainSlot) {
+TEST_F(UIPassTest, DrawsOntoTheDefaultFBOAndNeverDeclaresAChainStage) {
     UIDrawFn draw = [](Renderer2D& r, int w, int h, float) {
         r.DrawQuad({ 0.f, 0.f }, { float(w) * 0.5f, float(h) * 0.5f }, { 1, 0, 0, 1 });
     };
@@ -95,17 +96,24 @@ TEST_F(UIPassTest, DrawsOntoTheDefaultFBOAndNeverConsumesAChainSlot) {
     PassContext ctx{};
     ctx.defaultFBO = fbo;
     // Pretend a post chain is mid-flight. The UI overlay must not touch this.
-    ctx.postPassesLeft = 3;
-    ctx.ldrFBO_A = 12345; ctx.ldrTex_A = 999; // bogus: must never be used
-    ctx.postSrcTex = 999;
+    RenderGraph graph;
+    ctx.graph = &graph;
+    ctx.res.output = graph.Import("Output", fbo, 0);
+    const RenderGraph::Resource chain = graph.Import("Tonemap", 12345, 999); // bogus: must never be used
+    ctx.res.ldr = chain;
 
     pass.setup(ctx);
     Scene scene; Camera cam;
-    EXPECT_TRUE(pass.execute(ctx, scene, cam, fp()));
+    ASSERT_TRUE(pass.enabled(ctx, scene));
+    RenderGraph::PassBuilder b = graph.AddPass(pass.name());
+    pass.declare(b, ctx, fp());
+    graph.Compile();
+    EXPECT_EQ(ctx.res.ldr, chain)
+        << "UIPass declared a post chain stage — it is an overlay, not a "
+           "stage, and doing so routes the real final image off-screen";
+    ASSERT_EQ(graph.Order().size(), 1u) << "writing the output, the overlay is never culled";
 
-    EXPECT_EQ(ctx.postPassesLeft, 3)
-        << "UIPass consumed an LDR ping-pong slot — it is an overlay, not a "
-           "chain stage, and doing so routes the real final image off-screen";
+    EXPECT_TRUE(pass.execute(ctx, scene, cam, fp()));
 
     const auto px = readback();
     // Top-left quadrant painted (screen space is y-down), bottom-right clear.
@@ -122,13 +130,12 @@ TEST_F(UIPassTest, IsANoOpWithoutACallback) {
     UIPass pass(&r2d, &empty);
     PassContext ctx{};
     ctx.defaultFBO = fbo;
-    ctx.postPassesLeft = 2;
     pass.setup(ctx);
 
     Scene scene; Camera cam;
+    EXPECT_FALSE(pass.enabled(ctx, scene)) << "so the pipeline does not declare it";
     EXPECT_FALSE(pass.execute(ctx, scene, cam, fp()))
         << "a UI pass with no callback must report that it did nothing";
-    EXPECT_EQ(ctx.postPassesLeft, 2);
 
     const auto px = readback();
     for (size_t i = 0; i < px.size(); i += 4) {
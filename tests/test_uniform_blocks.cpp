@@ -0,0 +1,92 @@
+// Uniform blocks: the std140 mirrors of the forward shader's FrameGlobals and
+// MaterialBlock, and how a material packs into its block. Headless — the
+// offsets are the ones frag.glsl's declarations get under std140, and the
+// packing is plain data; the GL side is exercised by the scene tests.
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstring>
+
+#include "Engine.h"
+
+using namespace MyCoreEngine;
+
+TEST(UniformBlocks, FrameGlobalsMatchesStd140) {
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, lightVP), 0u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, csmSplits), 256u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, cascadeKernel), 288u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, camPos), 304u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, lightIntensity), 316u) << "a float fills a vec3's slot";
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, prefilterMipCount), 348u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, splitBlend), 352u);
+    EXPECT_EQ(offsetof(FrameGlobalsBlock, numLights), 404u);
+    EXPECT_EQ(sizeof(FrameGlobalsBlock) % 16, 0u);
+}
+
+TEST(UniformBlocks, MaterialBlockMatchesStd140) {
+    EXPECT_EQ(offsetof(MaterialBlockData, metallic), 12u);
+    EXPECT_EQ(offsetof(MaterialBlockData, emissive), 16u);
+    EXPECT_EQ(offsetof(MaterialBlockData, roughness), 28u);
+    EXPECT_EQ(offsetof(MaterialBlockData, ao), 32u);
+    EXPECT_EQ(offsetof(MaterialBlockData, shadingModel), 60u);
+    EXPECT_EQ(offsetof(MaterialBlockData, hasAOMap), 80u);
+    EXPECT_EQ(sizeof(MaterialBlockData) % 16, 0u);
+}
+
+TEST(UniformBlocks, PacksScalarsAndMapPresence) {
+    Material m;
+    m.baseColor = glm::vec3(0.25f, 0.5f, 0.75f);
+    m.metallic = 0.8f;
+    m.roughness = 0.3f;
+    m.ao = 0.9f;
+    m.normalTex = 7;
+    m.aoTex = 9;
+    const MaterialBlockData b = PackMaterialBlock(m);
+    EXPECT_EQ(b.baseColor, m.baseColor);
+    EXPECT_FLOAT_EQ(b.metallic, 0.8f);
+    EXPECT_FLOAT_EQ(b.roughness, 0.3f);
+    EXPECT_FLOAT_EQ(b.ao, 0.9f);
+    EXPECT_EQ(b.hasNormalMap, 1);
+    EXPECT_EQ(b.hasMetallicMap, 0);
+    EXPECT_EQ(b.hasRoughnessMap, 0);
+    EXPECT_EQ(b.hasAOMap, 1);
+    EXPECT_EQ(b.shadingModel, 0);
+    EXPECT_EQ(b.alphaMode, 0);
+}
+
+// The block is what a batch's single bind uploads, so whatever the batch
+// key ignores must pack the same: toon parameters of a PBR material and
+// alpha parameters of an opaque one.
+TEST(UniformBlocks, UnusedParametersPackAsDefaults) {
+    Material a, b;
+    b.toonBands = 7;
+    b.toonRimStrength = 0.9f;
+    b.alphaCutoff = 0.1f;
+    b.opacity = 0.2f;
+    const MaterialBlockData pa = PackMaterialBlock(a), pb = PackMaterialBlock(b);
+    EXPECT_EQ(std::memcmp(&pa, &pb, sizeof(pa)), 0);
+
+    b.shadingModel = ShadingModel::Toon;
+    b.alphaMode = AlphaMode::Mask;
+    const MaterialBlockData toon = PackMaterialBlock(b);
+    EXPECT_EQ(toon.shadingModel, 1);
+    EXPECT_FLOAT_EQ(toon.toonBands, 7.f);
+    EXPECT_FLOAT_EQ(toon.toonRimStrength, 0.9f);
+    EXPECT_EQ(toon.alphaMode, 1);
+    EXPECT_FLOAT_EQ(toon.alphaCutoff, 0.1f);
+    EXPECT_FLOAT_EQ(toon.opacity, 0.2f);
+}
+
+// Making a material unique copies it; the copy must not share (and later
+// overwrite) the original's uniform buffer. No GL here: neither has one yet,
+// and copying one that does is the same member-wise rule.
+TEST(UniformBlocks, ACopiedMaterialStillCopiesItsValues) {
+    Material a;
+    a.baseColor = glm::vec3(0.1f, 0.2f, 0.3f);
+    a.toonBands = 3;
+    Material b = a;
+    EXPECT_EQ(b.baseColor, a.baseColor);
+    EXPECT_EQ(b.toonBands, 3);
+    b = Material{};
+    EXPECT_EQ(b.toonBands, Material{}.toonBands);
+}